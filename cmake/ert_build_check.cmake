@@ -30,6 +30,7 @@ check_function_exists( GetTempPath HAVE_WINDOWS_GET_TEMP_PATH )
 check_function_exists( fork HAVE_FORK )
 check_function_exists( getpwuid HAVE_GETPWUID )
 check_function_exists( fsync HAVE_FSYNC )
+check_function_exists( pipe2 HAVE_PIPE2 )
 check_function_exists( setenv HAVE_POSIX_SETENV )
 check_function_exists( chmod HAVE_CHMOD )
 check_function_exists( pthread_timedjoin_np HAVE_TIMEDJOIN)
@@ -16,21 +16,20 @@
    for more details.
 */
 
-#define  _GNU_SOURCE   /* Must define this to get access to pthread_rwlock_t */
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <unistd.h>
-#include <pthread.h>
 #include <glob.h>
 
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
 #include <ert/util/time_t_vector.h>
 #include <ert/util/statistics.h>
 #include <ert/util/vector.h>
-#include <ert/util/arg_pack.h>
-#include <ert/util/thread_pool.h>
+#include <ert/util/bool_vector.h>
 
 #include <ert/config/config_parser.h>
 #include <ert/config/config_content.h>
@@ -39,6 +38,7 @@
 #include <ert/config/config_content_node.h>
 
 #include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_ensemble.h>
 
 #define DEFAULT_NUM_INTERP  50
 #define SUMMARY_JOIN       ":"
@@ -53,15 +53,6 @@ typedef enum {
 } format_type;
 
 
-typedef struct {
-  ecl_sum_type             * ecl_sum;
-  double_vector_type       * interp_data;
-  const time_t_vector_type * interp_time;
-  time_t                     start_time;
-  time_t                     end_time;
-} sum_case_type;
-
-
 /**
    Microscopic data structure representing one column of data;
    i.e. one ECLIPSE summary key and one accompanying quantile value.
@@ -83,13 +74,12 @@ typedef struct  {
 
 
 typedef struct {
-  vector_type         * data;
-  time_t_vector_type  * interp_time;
-  int                   num_interp;
-  time_t                start_time;
-  time_t                end_time;
-  const ecl_sum_type  * refcase;     /* Pointer to an arbitrary ecl_sum instance in the ensemble - to have access to indexing functions. */
-  pthread_rwlock_t      rwlock;
+  ecl_sum_ensemble_type * data;
+  time_t_vector_type    * interp_time;
+  int                     num_interp;
+  time_t                  start_time;
+  time_t                  end_time;
+  const ecl_sum_type    * refcase;     /* Pointer to an arbitrary ecl_sum instance in the ensemble - to have access to indexing functions. */
 } ensemble_type;
 
 
@@ -121,63 +111,6 @@ static void quant_key_free__( void * qkey ) {
 
 /*****************************************************************/
 
-sum_case_type * sum_case_fread_alloc( const char * data_file , const time_t_vector_type * interp_time ) {
-  sum_case_type * sum_case = util_malloc( sizeof * sum_case );
-
-  sum_case->ecl_sum     = ecl_sum_fread_alloc_case( data_file , SUMMARY_JOIN );
-  sum_case->interp_data = double_vector_alloc(0 , 0);
-  sum_case->interp_time = interp_time;
-  sum_case->start_time  = ecl_sum_get_start_time( sum_case->ecl_sum );
-  sum_case->end_time    = ecl_sum_get_end_time( sum_case->ecl_sum );
-  return sum_case;
-}
-
-
-void sum_case_free( sum_case_type * sum_case) {
-  ecl_sum_free( sum_case->ecl_sum );
-  double_vector_free( sum_case->interp_data );
-  free( sum_case );
-}
-
-
-void sum_case_free__( void * sum_case) {
-  sum_case_free( (sum_case_type *) sum_case);
-}
-
-
-/*****************************************************************/
-
-
-void ensemble_add_case( ensemble_type * ensemble , const char * data_file ) {
-  sum_case_type * sum_case = sum_case_fread_alloc( data_file , ensemble->interp_time );
-
-  pthread_rwlock_wrlock( &ensemble->rwlock );
-  {
-    printf("Loading case: %s \n", data_file );
-    vector_append_owned_ref( ensemble->data , sum_case , sum_case_free__ );
-    if (ensemble->start_time > 0)
-      ensemble->start_time = util_time_t_min( ensemble->start_time , sum_case->start_time);
-    else
-      ensemble->start_time = ecl_sum_get_start_time( sum_case->ecl_sum );
-
-    ensemble->end_time   = util_time_t_max( ensemble->end_time   , sum_case->end_time);
-  }
-  pthread_rwlock_unlock( &ensemble->rwlock );
-
-}
-
-void * ensemble_add_case__( void * arg ) {
-  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
-  ensemble_type * ensemble = arg_pack_iget_ptr( arg , 0 );
-  const char * data_file   = arg_pack_iget_ptr( arg , 1 );
-  ensemble_add_case( ensemble , data_file );
-  arg_pack_free( arg_pack );
-  return NULL;
-}
-
-
-
-
 void ensemble_init_time_interp( ensemble_type * ensemble ) {
   int i;
   for (i = 0; i < ensemble->num_interp; i++)
@@ -188,17 +121,13 @@ void ensemble_init_time_interp( ensemble_type * ensemble ) {
 
 
 
-void ensemble_load_from_glob( ensemble_type * ensemble , const char * pattern , thread_pool_type * tp) {
+void ensemble_add_glob( stringlist_type * case_list , const char * pattern ) {
   glob_t pglob;
   int    i;
   glob( pattern , GLOB_NOSORT , NULL , &pglob );
 
-  for (i=0; i < pglob.gl_pathc; i++) {
-    arg_pack_type * arg_pack = arg_pack_alloc( );
-    arg_pack_append_ptr( arg_pack , ensemble );
-    arg_pack_append_owned_ptr( arg_pack , util_alloc_string_copy( pglob.gl_pathv[i] ) , free );
-    thread_pool_add_job( tp , ensemble_add_case__ , arg_pack );
-  }
+  for (i=0; i < pglob.gl_pathc; i++)
+    stringlist_append_copy( case_list , pglob.gl_pathv[i] );
 
   globfree( &pglob );
 }
@@ -211,9 +140,9 @@ ensemble_type * ensemble_alloc( ) {
   ensemble->num_interp  = DEFAULT_NUM_INTERP;
   ensemble->start_time  = -1;
   ensemble->end_time    = -1;
-  ensemble->data        = vector_alloc_new();
+  ensemble->data        = NULL;
+  ensemble->refcase     = NULL;
   ensemble->interp_time = time_t_vector_alloc( 0 , -1 );
-  pthread_rwlock_init( &ensemble->rwlock , NULL );
   return ensemble;
 }
 
@@ -223,28 +152,32 @@ void ensemble_init( ensemble_type * ensemble , config_content_type * config) {
   /*1 : Loading ensembles and settings from the config instance */
   /*1a: Loading the eclipse summary cases. */
   {
-    thread_pool_type * tp = thread_pool_alloc( LOAD_THREADS , true );
-    {
-      int i,j;
-      if (config_content_has_item( config , "CASE_LIST")) {
-        const config_content_item_type * case_item = config_content_get_item( config , "CASE_LIST" );
-        for (j=0; j < config_content_item_get_size( case_item ); j++) {
-          const config_content_node_type * case_node = config_content_item_iget_node( case_item , j );
-          for (i=0; i < config_content_node_get_size( case_node ); i++) {
-            const char * case_glob = config_content_node_iget( case_node , i );
-            ensemble_load_from_glob( ensemble , case_glob , tp);
-          }
+    stringlist_type * case_list = stringlist_alloc_new();
+    int i,j;
+    if (config_content_has_item( config , "CASE_LIST")) {
+      const config_content_item_type * case_item = config_content_get_item( config , "CASE_LIST" );
+      for (j=0; j < config_content_item_get_size( case_item ); j++) {
+        const config_content_node_type * case_node = config_content_item_iget_node( case_item , j );
+        for (i=0; i < config_content_node_get_size( case_node ); i++) {
+          const char * case_glob = config_content_node_iget( case_node , i );
+          ensemble_add_glob( case_list , case_glob );
         }
       }
-
     }
-    thread_pool_join( tp );
-    thread_pool_free( tp );
-  }
 
-  {
-    const sum_case_type * tmp = vector_iget_const( ensemble->data , 0 );
-    ensemble->refcase = tmp->ecl_sum;
+    ensemble->data = ecl_sum_ensemble_fread_alloc( case_list , SUMMARY_JOIN , LOAD_THREADS );
+    for (i=0; i < ecl_sum_ensemble_get_size( ensemble->data ); i++) {
+      const ecl_sum_type * ecl_sum = ecl_sum_ensemble_iget( ensemble->data , i );
+      if (ecl_sum) {
+        printf("Loading case: %s \n", ecl_sum_ensemble_iget_case( ensemble->data , i ));
+        if (ensemble->refcase == NULL)
+          ensemble->refcase = ecl_sum;
+      } else
+        fprintf(stderr,"** Warning: could not load summary case: %s \n", ecl_sum_ensemble_iget_case( ensemble->data , i ));
+    }
+    ensemble->start_time = ecl_sum_ensemble_get_start_time( ensemble->data );
+    ensemble->end_time   = ecl_sum_ensemble_get_end_time( ensemble->data );
+    stringlist_free( case_list );
   }
 
   /*1b: Other config settings */
@@ -254,7 +187,7 @@ void ensemble_init( ensemble_type * ensemble , config_content_type * config) {
 
   /*2: Remaining initialization */
   ensemble_init_time_interp( ensemble );
-  if (vector_get_size( ensemble->data ) < MIN_SIZE )
+  if (ecl_sum_ensemble_get_num_loaded( ensemble->data ) < MIN_SIZE )
     util_exit("Sorry - quantiles make no sense with with < %d realizations; should have ~> 100.\n" , MIN_SIZE);
 }
 
@@ -264,7 +197,8 @@ const ecl_sum_type * ensemble_get_refcase( const ensemble_type * ensemble ) {
 
 
 void ensemble_free( ensemble_type * ensemble ) {
-  vector_free( ensemble->data );
+  if (ensemble->data)
+    ecl_sum_ensemble_free( ensemble->data );
   time_t_vector_free( ensemble->interp_time );
   free( ensemble );
 }
@@ -634,12 +568,12 @@ void output_run_line( const output_type * output , ensemble_type * ensemble) {
     {
       bool OK = true;
 
-      for (int iens = 0; iens < vector_get_size( ensemble->data ); iens++) {
-        const sum_case_type * sum_case = vector_iget_const( ensemble->data , iens );
+      for (int iens = 0; iens < ecl_sum_ensemble_get_size( ensemble->data ); iens++) {
+        const ecl_sum_type * ecl_sum = ecl_sum_ensemble_iget( ensemble->data , iens );
 
-        if (!ecl_sum_has_general_var(sum_case->ecl_sum , qkey->sum_key)) {
+        if (ecl_sum && !ecl_sum_has_general_var(ecl_sum , qkey->sum_key)) {
           OK = false;
-          fprintf(stderr,"** Sorry: the case:%s does not have the summary key:%s \n", ecl_sum_get_case( sum_case->ecl_sum ), qkey->sum_key);
+          fprintf(stderr,"** Sorry: the case:%s does not have the summary key:%s \n", ecl_sum_get_case( ecl_sum ), qkey->sum_key);
         }
       }
 
@@ -657,42 +591,62 @@ void output_run_line( const output_type * output , ensemble_type * ensemble) {
 
        WWCT:OP_1:0.10  WWCT:OP_1:0.50  WWCT:OP_1:0.90
 
-       the interp_data_cache construction will ensure that the
-       underlying ecl_sum object is only queried once; and also the
-       sorting will be performed once.
+       the columns are grouped by summary key up front. That way the
+       underlying ecl_sum objects are only queried once per key and
+       time step, and all the quantiles of one key are evaluated in one
+       pass with statistics_empirical_quantiles().
     */
 
-    hash_type * interp_data_cache = hash_alloc();
+    stringlist_type * sum_keys    = stringlist_alloc_new();
+    vector_type * key_columns     = vector_alloc_new();
+    vector_type * key_quantiles   = vector_alloc_new();
+    double_vector_type * interp_data = double_vector_alloc(0 , 0);
+    double_vector_type * column      = double_vector_alloc(0 , 0);
+    bool_vector_type   * valid       = bool_vector_alloc(0 , false);
+    double_vector_type * quantiles   = double_vector_alloc(0 , 0);
+
+    for (column_nr = 0; column_nr < vector_get_size( output->keys ); column_nr++) {
+      const quant_key_type * qkey = vector_iget( output->keys , column_nr );
+      int key_nr = stringlist_find_first( sum_keys , qkey->sum_key );
+
+      if (key_nr < 0) {
+        key_nr = stringlist_get_size( sum_keys );
+        stringlist_append_copy( sum_keys , qkey->sum_key );
+        vector_append_owned_ref( key_columns   , int_vector_alloc(0,0)    , int_vector_free__ );
+        vector_append_owned_ref( key_quantiles , double_vector_alloc(0,0) , double_vector_free__ );
+      }
+
+      int_vector_append( vector_iget( key_columns , key_nr ) , column_nr );
+      double_vector_append( vector_iget( key_quantiles , key_nr ) , qkey->quantile );
+    }
 
     for (row_nr = 0; row_nr < data_rows; row_nr++) {
       time_t interp_time = time_t_vector_iget( ensemble->interp_time , row_nr);
-      for (column_nr = 0; column_nr < vector_get_size( output->keys ); column_nr++) {
-        const quant_key_type * qkey = vector_iget( output->keys , column_nr );
-        double_vector_type * interp_data;
-
-        /* Check if we have the vector in the cache table - if not create it. */
-        if (!hash_has_key( interp_data_cache , qkey->sum_key)) {
-          interp_data = double_vector_alloc(0 , 0);
-          hash_insert_hash_owned_ref( interp_data_cache , qkey->sum_key , interp_data , double_vector_free__);
+      for (int key_nr = 0; key_nr < stringlist_get_size( sum_keys ); key_nr++) {
+        const char * sum_key = stringlist_iget( sum_keys , key_nr );
+        const int_vector_type * columns = vector_iget_const( key_columns , key_nr );
+
+        /* We allow the different simulations to have differing length; only the valid values are used. */
+        double_vector_reset( interp_data );
+        ecl_sum_ensemble_get_column( ensemble->data , sum_key , interp_time , column , valid );
+        for (int iens = 0; iens < double_vector_size( column ); iens++) {
+          if (bool_vector_iget( valid , iens ))
+            double_vector_append( interp_data , double_vector_iget( column , iens ));
         }
-        interp_data = hash_get( interp_data_cache , qkey->sum_key );
-
-        /* Check if the vector has data - if not initialize it. */
-        if (double_vector_size( interp_data ) == 0) {
-          for (int iens = 0; iens < vector_get_size( ensemble->data ); iens++) {
-            const sum_case_type * sum_case = vector_iget_const( ensemble->data , iens );
-
-            if ((interp_time >= sum_case->start_time) && (interp_time <= sum_case->end_time))  /* We allow the different simulations to have differing length */
-              double_vector_append( interp_data , ecl_sum_get_general_var_from_sim_time( sum_case->ecl_sum , interp_time , qkey->sum_key)) ;
 
-            double_vector_sort( interp_data );
-          }
-        }
-        data[row_nr][column_nr] = statistics_empirical_quantile__( interp_data , qkey->quantile );
+        statistics_empirical_quantiles( interp_data , vector_iget_const( key_quantiles , key_nr ) , quantiles );
+        for (int iq = 0; iq < int_vector_size( columns ); iq++)
+          data[row_nr][int_vector_iget( columns , iq )] = double_vector_iget( quantiles , iq );
       }
-      hash_apply( interp_data_cache , double_vector_reset__ );
     }
-    hash_free( interp_data_cache );
+
+    double_vector_free( quantiles );
+    bool_vector_free( valid );
+    double_vector_free( column );
+    double_vector_free( interp_data );
+    vector_free( key_quantiles );
+    vector_free( key_columns );
+    stringlist_free( sum_keys );
   }
 
   output_save( output , ensemble , (const double **) data);
@@ -19,35 +19,126 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <ert/util/ert_api_config.h>
+
+#ifdef ERT_HAVE_GETOPT
+#include <getopt.h>
+#include <sys/time.h>
+#endif
+
 #include <ert/util/util.h>
 
 #include <ert/ecl/ecl_grid.h>
 
 
+static void print_usage_and_exit(const char * prog) {
+  fprintf(stderr,"%s: [--threads=N] [--benchmark=N] filename [filename2] \n",prog);
+  fprintf(stderr,"\n");
+  fprintf(stderr,"  --threads=N   : Use N threads to initialise the cells when loading the grid.\n");
+  fprintf(stderr,"  --benchmark=N : Load the grid N times and report the load times.\n");
+  exit(1);
+}
+
+
+#ifdef ERT_HAVE_GETOPT
+
+static double wall_time( ) {
+  struct timeval tv;
+  gettimeofday( &tv , NULL );
+  return tv.tv_sec + 1e-6 * tv.tv_usec;
+}
+
+
+static void benchmark_load( const char * grid_file , int repeat ) {
+  double min_time = 0;
+  double sum_time = 0;
+  int i;
+
+  printf("Loading %s %d times with %d thread(s)\n", grid_file , repeat , ecl_grid_get_num_threads());
+  for (i = 0; i < repeat; i++) {
+    double start_time = wall_time();
+    ecl_grid_type * ecl_grid = ecl_grid_alloc( grid_file );
+    double load_time = wall_time() - start_time;
+
+    if (ecl_grid == NULL)
+      util_exit("Failed to load grid: %s\n", grid_file);
+
+    ecl_grid_free( ecl_grid );
+    printf("  load %d: %8.3f s\n", i + 1 , load_time);
+    if ((i == 0) || (load_time < min_time))
+      min_time = load_time;
+    sum_time += load_time;
+  }
+  printf("Load time min: %.3f s  avg: %.3f s\n\n", min_time , sum_time / repeat);
+}
+
+#endif
 
 
 int main(int argc, char ** argv) {
-  if (argc < 2) {
-    fprintf(stderr,"%s: filename \n",argv[0]);
-    exit(1);
+  int arg_offset = 1;
+  int benchmark_repeat = 0;
+
+#ifdef ERT_HAVE_GETOPT
+  {
+    static struct option long_options[] = {
+      {"threads"   , 1 , 0 , 't'} ,
+      {"benchmark" , 1 , 0 , 'b'} ,
+      {"help"      , 0 , 0 , 'h'} ,
+      { 0          , 0 , 0 ,   0} };
+
+    while (1) {
+      int c;
+      int option_index = 0;
+
+      c = getopt_long (argc, argv, "t:b:h", long_options, &option_index);
+      if (c == -1)
+        break;
+
+      switch (c) {
+      case 't':
+        {
+          int num_threads;
+          if (!util_sscanf_int( optarg , &num_threads ) || (num_threads < 1))
+            print_usage_and_exit( argv[0] );
+          ecl_grid_set_num_threads( num_threads );
+        }
+        break;
+      case 'b':
+        if (!util_sscanf_int( optarg , &benchmark_repeat ) || (benchmark_repeat < 1))
+          print_usage_and_exit( argv[0] );
+        break;
+      default:
+        print_usage_and_exit( argv[0] );
+      }
+    }
+    arg_offset = optind;
   }
+#endif
+
+  if (argc <= arg_offset)
+    print_usage_and_exit( argv[0] );
 
   {
     ecl_grid_type * ecl_grid;
-    const char    * grid_file = argv[1];
+    const char    * grid_file = argv[arg_offset];
 
+#ifdef ERT_HAVE_GETOPT
+    if (benchmark_repeat > 0)
+      benchmark_load( grid_file , benchmark_repeat );
+#endif
 
     ecl_grid = ecl_grid_alloc(grid_file );
     ecl_grid_summarize( ecl_grid );
-    if (argc >= 3) {
-      ecl_grid_type * grid2 = ecl_grid_alloc( argv[2] );
+    if (argc >= arg_offset + 2) {
+      ecl_grid_type * grid2 = ecl_grid_alloc( argv[arg_offset + 1] );
 
       if (ecl_grid_compare( ecl_grid , grid2 , true , false , false))
-        printf("\nThe grids %s %s are IDENTICAL.\n" , argv[1] , argv[2]);
+        printf("\nThe grids %s %s are IDENTICAL.\n" , argv[arg_offset] , argv[arg_offset + 1]);
       else {
         printf("\n");
         ecl_grid_summarize( grid2 );
-        printf("\nThe grids %s %s are DIFFERENT.\n", argv[1] , argv[2]);
+        printf("\nThe grids %s %s are DIFFERENT.\n", argv[arg_offset] , argv[arg_offset + 1]);
       }
       ecl_grid_free( grid2 );
     }
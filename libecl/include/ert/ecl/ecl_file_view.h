@@ -48,6 +48,7 @@ typedef enum {
 
 
 typedef struct ecl_file_view_struct ecl_file_view_type;
+typedef struct ecl_file_view_block_iter_struct ecl_file_view_block_iter_type;
 
   bool ecl_file_view_flags_set( const ecl_file_view_type * file_view, int query_flags);
   bool ecl_file_view_check_flags( int state_flags , int query_flags);
@@ -72,6 +73,7 @@ typedef struct ecl_file_view_struct ecl_file_view_type;
   int ecl_file_view_iget_named_size( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type * old_kw , ecl_kw_type * new_kw , bool insert_copy);
   bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view );
+  void ecl_file_view_unload_all( ecl_file_view_type * ecl_file_view );
   void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw);
   void ecl_file_view_free( ecl_file_view_type * ecl_file_view );
   void ecl_file_view_free__( void * arg );
@@ -85,6 +87,10 @@ typedef struct ecl_file_view_struct ecl_file_view_type;
   ecl_file_view_type * ecl_file_view_alloc_blockview(const ecl_file_view_type * ecl_file_view , const char * header, int occurence);
   ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * ecl_file_view , const char * start_kw, const char * end_kw, int occurence);
 
+  ecl_file_view_block_iter_type * ecl_file_view_alloc_block_iter( const ecl_file_view_type * ecl_file_view , const char * start_kw , const char * end_kw);
+  ecl_file_view_type * ecl_file_view_block_iter_next( ecl_file_view_block_iter_type * iter );
+  void ecl_file_view_block_iter_free( ecl_file_view_block_iter_type * iter );
+
   void ecl_file_view_add_child( ecl_file_view_type * parent , ecl_file_view_type * child);
   bool ecl_file_view_drop_flag( ecl_file_view_type * file_view , int flag);
   void ecl_file_view_add_flag( ecl_file_view_type * file_view , int flag);
@@ -0,0 +1,45 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_smspec_pool.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_SMSPEC_POOL_H
+#define ERT_ECL_SMSPEC_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ert/util/stringlist.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/ecl_sum.h>
+
+  typedef struct ecl_smspec_pool_struct ecl_smspec_pool_type;
+
+  ecl_smspec_pool_type * ecl_smspec_pool_alloc( const char * key_join_string );
+  void                   ecl_smspec_pool_free( ecl_smspec_pool_type * pool );
+  int                    ecl_smspec_pool_get_size( const ecl_smspec_pool_type * pool );
+  ecl_sum_type         * ecl_smspec_pool_fread_alloc_sum( ecl_smspec_pool_type * pool , const char * header_file , const stringlist_type * data_files );
+  ecl_sum_type         * ecl_smspec_pool_fread_alloc_case( ecl_smspec_pool_type * pool , const char * input_file );
+
+  UTIL_IS_INSTANCE_HEADER( ecl_smspec_pool );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -64,6 +64,8 @@ typedef struct ecl_sum_struct       ecl_sum_type;
 
   void           ecl_sum_set_unified( ecl_sum_type * ecl_sum , bool unified );
   void           ecl_sum_set_fmt_case( ecl_sum_type * ecl_sum , bool fmt_case );
+  bool           ecl_sum_get_unified( const ecl_sum_type * ecl_sum );
+  bool           ecl_sum_get_fmt_case( const ecl_sum_type * ecl_sum );
 
   int              ecl_sum_get_report_step_from_time( const ecl_sum_type * sum , time_t sim_time);
   int              ecl_sum_get_report_step_from_days( const ecl_sum_type * sum , double sim_days);
@@ -92,6 +94,7 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   void             ecl_sum_free__(void * );
   void             ecl_sum_free(ecl_sum_type * );
   ecl_sum_type   * ecl_sum_fread_alloc(const char * , const stringlist_type * data_files, const char * key_join_string);
+  ecl_sum_type   * ecl_sum_fread_alloc_shared_smspec(const char * header_file , const stringlist_type * data_files , const char * key_join_string , const ecl_smspec_type * smspec);
   ecl_sum_type   * ecl_sum_fread_alloc_case(const char *  , const char * key_join_string);
   ecl_sum_type   * ecl_sum_fread_alloc_case__(const char *  , const char * key_join_string , bool include_restart);
   bool             ecl_sum_case_exists( const char * input_file );
@@ -207,6 +210,8 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   bool                  ecl_sum_report_step_equal( const ecl_sum_type * ecl_sum1 , const ecl_sum_type * ecl_sum2);
   bool                  ecl_sum_report_step_compatible( const ecl_sum_type * ecl_sum1 , const ecl_sum_type * ecl_sum2);
   void                  ecl_sum_export_csv(const ecl_sum_type * ecl_sum , const char * filename  , const stringlist_type * var_list , const char * date_format , const char * sep);
+  void                  ecl_sum_export_resample_csv(const ecl_sum_type * ecl_sum , const char * filename , const time_t_vector_type * sim_time , const stringlist_type * var_list , const char * date_format , const char * sep);
+  void                  ecl_sum_export_resample_binary(const ecl_sum_type * ecl_sum , const char * filename , const time_t_vector_type * sim_time , const stringlist_type * var_list);
 
 
   double_vector_type * ecl_sum_alloc_seconds_solution( const ecl_sum_type * ecl_sum , const char * gen_key , double cmp_value , bool rates_clamp_lower);
@@ -91,6 +91,9 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   bool                     ecl_sum_data_report_step_equal( const ecl_sum_data_type * data1 , const ecl_sum_data_type * data2);
   bool                     ecl_sum_data_report_step_compatible( const ecl_sum_data_type * data1 , const ecl_sum_data_type * data2);
   void                     ecl_sum_data_fwrite_interp_csv_line(const ecl_sum_data_type * data , time_t sim_time, const ecl_sum_vector_type * keylist, FILE *fp);
+  void                     ecl_sum_data_resample( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , double * values);
+  void                     ecl_sum_data_fwrite_resample_csv( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , const char * date_format , const char * sep , FILE * stream);
+  void                     ecl_sum_data_fwrite_resample_binary( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , FILE * stream);
 
   double_vector_type * ecl_sum_data_alloc_seconds_solution( const ecl_sum_data_type * data , const smspec_node_type * node , double value, bool rates_clamp_lower);
 
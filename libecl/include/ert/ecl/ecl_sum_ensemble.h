@@ -0,0 +1,55 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_ensemble.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_SUM_ENSEMBLE_H
+#define ERT_ECL_SUM_ENSEMBLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/stringlist.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/bool_vector.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_sum.h>
+
+  typedef struct ecl_sum_ensemble_struct ecl_sum_ensemble_type;
+
+  ecl_sum_ensemble_type * ecl_sum_ensemble_fread_alloc( const stringlist_type * case_list , const char * key_join_string , int num_threads);
+  void                    ecl_sum_ensemble_free( ecl_sum_ensemble_type * ensemble );
+  int                     ecl_sum_ensemble_get_size( const ecl_sum_ensemble_type * ensemble );
+  int                     ecl_sum_ensemble_get_num_loaded( const ecl_sum_ensemble_type * ensemble );
+  int                     ecl_sum_ensemble_get_num_layouts( const ecl_sum_ensemble_type * ensemble );
+  const ecl_sum_type    * ecl_sum_ensemble_iget( const ecl_sum_ensemble_type * ensemble , int iens);
+  const char            * ecl_sum_ensemble_iget_case( const ecl_sum_ensemble_type * ensemble , int iens);
+  time_t                  ecl_sum_ensemble_get_start_time( const ecl_sum_ensemble_type * ensemble );
+  time_t                  ecl_sum_ensemble_get_end_time( const ecl_sum_ensemble_type * ensemble );
+  bool                    ecl_sum_ensemble_has_general_var( const ecl_sum_ensemble_type * ensemble , const char * gen_key );
+  int                     ecl_sum_ensemble_get_column( const ecl_sum_ensemble_type * ensemble , const char * gen_key , time_t sim_time , double_vector_type * values , bool_vector_type * valid);
+
+  UTIL_IS_INSTANCE_HEADER( ecl_sum_ensemble );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
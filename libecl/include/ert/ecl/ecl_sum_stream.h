@@ -0,0 +1,47 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_stream.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_SUM_STREAM_H
+#define ERT_ECL_SUM_STREAM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_tstep.h>
+
+typedef struct ecl_sum_stream_struct ecl_sum_stream_type;
+
+  ecl_sum_stream_type * ecl_sum_stream_alloc( const ecl_sum_type * ecl_sum , bool append );
+  void                  ecl_sum_stream_free( ecl_sum_stream_type * stream );
+  ecl_sum_tstep_type  * ecl_sum_stream_add_tstep( ecl_sum_stream_type * stream , int report_step , double sim_seconds );
+  void                  ecl_sum_stream_flush( ecl_sum_stream_type * stream );
+  int                   ecl_sum_stream_get_report_step( const ecl_sum_stream_type * stream );
+  int                   ecl_sum_stream_get_ministep( const ecl_sum_stream_type * stream );
+
+  UTIL_IS_INSTANCE_HEADER( ecl_sum_stream );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
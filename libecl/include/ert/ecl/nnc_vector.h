@@ -34,6 +34,7 @@ extern "C" {
   int                       nnc_vector_iget_grid_index( const nnc_vector_type * nnc_vector , int index );
   nnc_vector_type         * nnc_vector_alloc(int lgr_nr);
   nnc_vector_type         * nnc_vector_alloc_copy(const nnc_vector_type * src_vector);
+  nnc_vector_type         * nnc_vector_alloc_view(int lgr_nr , int * grid_index , int * nnc_index , int size);
   void                      nnc_vector_free( nnc_vector_type * nnc_vector );
   void                      nnc_vector_add_nnc(nnc_vector_type * nnc_vector, int global_cell_number, int nnc_index);
   const int_vector_type   * nnc_vector_get_grid_index_list(const nnc_vector_type * nnc_vector);
@@ -608,6 +608,41 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
 }
 
 
+/*
+  Will open a new read-only ecl_file instance for the same file as
+  @src, with a copy of the keyword index of @src instead of scanning
+  the file again. The new instance has its own fortio, so that the two
+  instances can be used from different threads; the copy must be made
+  while @src is not used by other threads. The file must not have
+  been modified after @src was opened.
+*/
+
+ecl_file_type * ecl_file_open_index_copy( const ecl_file_type * src , int flags) {
+  fortio_type * fortio;
+
+  if (ecl_file_view_check_flags(flags , ECL_FILE_WRITABLE))
+    util_abort("%s: the copy can not be opened writable \n",__func__);
+
+  fortio = fortio_open_reader( fortio_filename_ref( src->fortio ) , fortio_fmt_file( src->fortio ) , ECL_ENDIAN_FLIP);
+  if (fortio) {
+    ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
+    ecl_file->fortio = fortio;
+    ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+
+    for (int index = 0; index < ecl_file_view_get_size( src->global_view ); index++) {
+      const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( src->global_view , index );
+      ecl_file_view_add_kw( ecl_file->global_view , ecl_file_kw_alloc_copy( file_kw ));
+    }
+    ecl_file_select_global( ecl_file );
+
+    if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
+      fortio_fclose_stream( ecl_file->fortio );
+
+    return ecl_file;
+  } else
+    return NULL;
+}
+
 
 
 
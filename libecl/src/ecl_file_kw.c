@@ -207,7 +207,13 @@ static void ecl_file_kw_assert_kw( const ecl_file_kw_type * file_kw ) {
 }
 
 
-static void ecl_file_kw_drop_kw( ecl_file_kw_type * file_kw , inv_map_type * inv_map ) {
+/*
+  Will free the in memory ecl_kw instance of this file_kw, if it has
+  been loaded; the next ecl_file_kw_get_kw() call will load it from
+  file again.
+*/
+
+void ecl_file_kw_drop_kw( ecl_file_kw_type * file_kw , inv_map_type * inv_map ) {
   if (file_kw->kw != NULL) {
     inv_map_drop_kw( inv_map , file_kw->kw );
     ecl_kw_free( file_kw->kw );
@@ -30,10 +30,22 @@
 #include <ert/ecl/ecl_type.h>
 
 
+/*
+  Block views (i.e. views created with one of the blockview functions)
+  do not have a kw_list of their own, they are a (kw_offset, kw_size)
+  slice of the kw_list of the view they were created from. The
+  kw_index and distinct_kw fields of a block view are only built on
+  first use.
+*/
+
 struct ecl_file_view_struct {
   vector_type       * kw_list;      /* This is a vector of ecl_file_kw instances corresponding to the content of the file. */
+  bool                kw_list_owner;/* Is the kw_list vector owned by this view - false for block views. */
+  int                 kw_offset;    /* The view covers the elements [kw_offset, kw_offset + kw_size) of kw_list. */
+  int                 kw_size;
   hash_type         * kw_index;     /* A hash table with integer vectors of indices - see comment below. */
   stringlist_type   * distinct_kw;  /* A stringlist of the keywords occuring in the file - each string occurs ONLY ONCE. */
+  bool                index_valid;  /* Are kw_index and distinct_kw up to date? */
   fortio_type       * fortio;       /* The same fortio instance pointer as in the ecl_file styructure. */
   bool                owner;        /* Is this map the owner of the ecl_file_kw instances; only true for the global_map. */
   inv_map_type      * inv_map;      /* Shared reference owned by the ecl_file structure. */
@@ -42,6 +54,15 @@ struct ecl_file_view_struct {
 };
 
 
+struct ecl_file_view_block_iter_struct {
+  const ecl_file_view_type * parent;
+  const int_vector_type    * start_list;  /* The indices of the start_kw occurences in the parent. */
+  char                     * end_kw;
+  int                        occurence;
+  ecl_file_view_type       * block_view;  /* The block view which is recycled for all the blocks. */
+};
+
+
 
 /*****************************************************************/
 /* Here comes the functions related to the index ecl_file_view. These
@@ -66,11 +87,15 @@ const char * ecl_file_view_get_src_file( const ecl_file_view_type * file_view )
 }
 
 
-ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner ) {
+static ecl_file_view_type * ecl_file_view_alloc__( vector_type * kw_list , fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner ) {
   ecl_file_view_type * ecl_file_view  = util_malloc( sizeof * ecl_file_view );
-  ecl_file_view->kw_list              = vector_alloc_new();
+  ecl_file_view->kw_list_owner        = (kw_list == NULL);
+  ecl_file_view->kw_list              = ecl_file_view->kw_list_owner ? vector_alloc_new() : kw_list;
+  ecl_file_view->kw_offset            = 0;
+  ecl_file_view->kw_size              = 0;
   ecl_file_view->kw_index             = hash_alloc();
   ecl_file_view->distinct_kw          = stringlist_alloc_new();
+  ecl_file_view->index_valid          = false;
   ecl_file_view->child_list           = vector_alloc_new();
   ecl_file_view->owner                = owner;
   ecl_file_view->fortio               = fortio;
@@ -79,7 +104,25 @@ ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , i
   return ecl_file_view;
 }
 
+
+ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner ) {
+  return ecl_file_view_alloc__( NULL , fortio , flags , inv_map , owner );
+}
+
+
+/*
+  The index of a block view is built on first use; the const cast is
+  ok because the index is a pure function of the (immutable) slice.
+*/
+
+static void ecl_file_view_assert_index( const ecl_file_view_type * ecl_file_view ) {
+  if (!ecl_file_view->index_valid)
+    ecl_file_view_make_index( (ecl_file_view_type *) ecl_file_view );
+}
+
+
 int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith) {
+  ecl_file_view_assert_index( ecl_file_view );
   const int_vector_type * index_vector = hash_get(ecl_file_view->kw_index , kw);
   int global_index = int_vector_iget( index_vector , ith);
   return global_index;
@@ -101,8 +144,8 @@ void ecl_file_view_make_index( ecl_file_view_type * ecl_file_view ) {
   hash_clear( ecl_file_view->kw_index );
   {
     int i;
-    for (i=0; i < vector_get_size( ecl_file_view->kw_list ); i++) {
-      const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , i);
+    for (i=0; i < ecl_file_view->kw_size; i++) {
+      const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , i);
       const char             * header  = ecl_file_kw_get_header( file_kw );
       if ( !hash_has_key( ecl_file_view->kw_index , header )) {
         int_vector_type * index_vector = int_vector_alloc( 0 , -1 );
@@ -116,16 +159,23 @@ void ecl_file_view_make_index( ecl_file_view_type * ecl_file_view ) {
       }
     }
   }
+  hash_freeze( ecl_file_view->kw_index );
+  ecl_file_view->index_valid = true;
 }
 
 bool ecl_file_view_has_kw( const ecl_file_view_type * ecl_file_view, const char * kw) {
+  ecl_file_view_assert_index( ecl_file_view );
   return hash_has_key( ecl_file_view->kw_index , kw );
 }
 
 
 ecl_file_kw_type * ecl_file_view_iget_file_kw( const ecl_file_view_type * ecl_file_view , int global_index) {
-  ecl_file_kw_type * file_kw = vector_iget( ecl_file_view->kw_list , global_index);
-  return file_kw;
+  if ((global_index < 0) || (global_index >= ecl_file_view->kw_size))
+    util_abort("%s: index:%d invalid - view size:%d \n",__func__ , global_index , ecl_file_view->kw_size);
+  {
+    ecl_file_kw_type * file_kw = vector_iget( ecl_file_view->kw_list , ecl_file_view->kw_offset + global_index);
+    return file_kw;
+  }
 }
 
 ecl_file_kw_type * ecl_file_view_iget_named_file_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith) {
@@ -193,15 +243,17 @@ int ecl_file_view_find_kw_value( const ecl_file_view_type * ecl_file_view , cons
 }
 
 const char * ecl_file_view_iget_distinct_kw( const ecl_file_view_type * ecl_file_view , int index) {
+  ecl_file_view_assert_index( ecl_file_view );
   return stringlist_iget( ecl_file_view->distinct_kw , index);
 }
 
 int ecl_file_view_get_num_distinct_kw( const ecl_file_view_type * ecl_file_view ) {
+  ecl_file_view_assert_index( ecl_file_view );
   return stringlist_get_size( ecl_file_view->distinct_kw );
 }
 
 int ecl_file_view_get_size( const ecl_file_view_type * ecl_file_view ) {
-  return vector_get_size( ecl_file_view->kw_list );
+  return ecl_file_view->kw_size;
 }
 
 
@@ -249,8 +301,8 @@ int ecl_file_view_iget_named_size( const ecl_file_view_type * ecl_file_view , co
 
 void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type * old_kw , ecl_kw_type * new_kw , bool insert_copy) {
   int index = 0;
-  while (index < vector_get_size( ecl_file_view->kw_list )) {
-    ecl_file_kw_type * ikw = vector_iget( ecl_file_view->kw_list , index );
+  while (index < ecl_file_view->kw_size) {
+    ecl_file_kw_type * ikw = ecl_file_view_iget_file_kw( ecl_file_view , index );
     if (ecl_file_kw_ptr_eq( ikw , old_kw)) {
       /*
          Found it; observe that the vector_iset() function will
@@ -276,8 +328,8 @@ bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
 
   if (fortio_assert_stream_open( ecl_file_view->fortio )) {
     int index;
-    for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
-      ecl_file_kw_type * ikw = vector_iget( ecl_file_view->kw_list , index );
+    for (index = 0; index < ecl_file_view->kw_size; index++) {
+      ecl_file_kw_type * ikw = ecl_file_view_iget_file_kw( ecl_file_view , index );
       ecl_file_kw_get_kw( ikw , ecl_file_view->fortio , ecl_file_view->inv_map);
     }
     loadOK = true;
@@ -290,22 +342,45 @@ bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
 }
 
 
+/*
+  Will free all the loaded ecl_kw instances in the view; ecl_kw
+  pointers obtained from the view before this call are invalid
+  afterwards. Keywords which have been modified in memory are reloaded
+  from file on next access, i.e. the modifications are lost.
+*/
+
+void ecl_file_view_unload_all( ecl_file_view_type * ecl_file_view ) {
+  int index;
+  for (index = 0; index < ecl_file_view->kw_size; index++) {
+    ecl_file_kw_type * ikw = ecl_file_view_iget_file_kw( ecl_file_view , index );
+    ecl_file_kw_drop_kw( ikw , ecl_file_view->inv_map );
+  }
+}
+
+
 /*****************************************************************/
 
 
 
 void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw) {
+  if (!ecl_file_view->kw_list_owner)
+    util_abort("%s: can not add keywords to a block view \n",__func__);
+
   if (ecl_file_view->owner)
     vector_append_owned_ref( ecl_file_view->kw_list , file_kw , ecl_file_kw_free__ );
   else
     vector_append_ref( ecl_file_view->kw_list , file_kw);
+
+  ecl_file_view->kw_size = vector_get_size( ecl_file_view->kw_list );
+  ecl_file_view->index_valid = false;
 }
 
 void ecl_file_view_free( ecl_file_view_type * ecl_file_view ) {
   vector_free( ecl_file_view->child_list );
   hash_free( ecl_file_view->kw_index );
   stringlist_free( ecl_file_view->distinct_kw );
-  vector_free( ecl_file_view->kw_list );
+  if (ecl_file_view->kw_list_owner)
+    vector_free( ecl_file_view->kw_list );
   free( ecl_file_view );
 }
 
@@ -316,7 +391,7 @@ void ecl_file_view_free__( void * arg ) {
 
 
 int ecl_file_view_get_num_named_kw(const ecl_file_view_type * ecl_file_view , const char * kw) {
-  if (hash_has_key(ecl_file_view->kw_index , kw)) {
+  if (ecl_file_view_has_kw( ecl_file_view , kw )) {
     const int_vector_type * index_vector = hash_get(ecl_file_view->kw_index , kw);
     return int_vector_size( index_vector );
   } else
@@ -325,7 +400,7 @@ int ecl_file_view_get_num_named_kw(const ecl_file_view_type * ecl_file_view , co
 
 void ecl_file_view_fwrite( const ecl_file_view_type * ecl_file_view , fortio_type * target , int offset) {
   int index;
-  for (index = offset; index < vector_get_size( ecl_file_view->kw_list ); index++) {
+  for (index = offset; index < ecl_file_view->kw_size; index++) {
     ecl_kw_type * ecl_kw = ecl_file_view_iget_kw( ecl_file_view , index );
     ecl_kw_fwrite( ecl_kw , target );
   }
@@ -335,8 +410,9 @@ void ecl_file_view_fwrite( const ecl_file_view_type * ecl_file_view , fortio_typ
 
 
 int ecl_file_view_iget_occurence( const ecl_file_view_type * ecl_file_view , int global_index) {
-  const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , global_index);
+  const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , global_index);
   const char * header              = ecl_file_kw_get_header( file_kw );
+  ecl_file_view_assert_index( ecl_file_view );
   const int_vector_type * index_vector = hash_get( ecl_file_view->kw_index , header );
   const int * index_data = int_vector_get_const_ptr( index_vector );
 
@@ -356,8 +432,8 @@ int ecl_file_view_iget_occurence( const ecl_file_view_type * ecl_file_view , int
 
 void ecl_file_view_fprintf_kw_list(const ecl_file_view_type * ecl_file_view , FILE * stream) {
   int i;
-  for (i=0; i < vector_get_size( ecl_file_view->kw_list ); i++) {
-    const ecl_file_kw_type * file_kw = vector_iget_const( ecl_file_view->kw_list , i );
+  for (i=0; i < ecl_file_view->kw_size; i++) {
+    const ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , i );
     fprintf(stream , "%-8s %7d:%s\n",
             ecl_file_kw_get_header( file_kw ) ,
             ecl_file_kw_get_size( file_kw ) ,
@@ -366,35 +442,63 @@ void ecl_file_view_fprintf_kw_list(const ecl_file_view_type * ecl_file_view , FI
 }
 
 
+/*
+  Returns the index of the first @end_kw occurence after @start_index,
+  or the size of the view if there is no such keyword. The search is a
+  bisection in the index list of @end_kw, i.e. the keywords of the
+  block are never inspected one by one.
+*/
+
+static int ecl_file_view_find_block_end( const ecl_file_view_type * ecl_file_view , const char * end_kw , int start_index) {
+  int block_end = ecl_file_view->kw_size;
+
+  if (end_kw && ecl_file_view_has_kw( ecl_file_view , end_kw )) {
+    const int_vector_type * index_vector = hash_get( ecl_file_view->kw_index , end_kw );
+    const int * index_data = int_vector_get_const_ptr( index_vector );
+    int lower = 0;
+    int upper = int_vector_size( index_vector );
+
+    while (lower < upper) {
+      int mid = lower + (upper - lower) / 2;
+      if (index_data[mid] <= start_index)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+    if (lower < int_vector_size( index_vector ))
+      block_end = index_data[lower];
+  }
+  return block_end;
+}
+
+
+/*
+  Will point @block_view to the slice [start_index, end_index) of
+  @ecl_file_view; the index of the block view is invalidated and
+  rebuilt on first use.
+*/
+
+static void ecl_file_view_set_block( ecl_file_view_type * block_view , const ecl_file_view_type * ecl_file_view , int start_index , int end_index) {
+  block_view->kw_offset = ecl_file_view->kw_offset + start_index;
+  block_view->kw_size = end_index - start_index;
+  block_view->index_valid = false;
+}
+
+
 ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * ecl_file_view , const char * start_kw, const char * end_kw, int occurence) {
   if ((start_kw != NULL) && ecl_file_view_get_num_named_kw( ecl_file_view , start_kw ) <= occurence)
     return NULL;
 
-
-  ecl_file_view_type * block_map = ecl_file_view_alloc( ecl_file_view->fortio , ecl_file_view->flags , ecl_file_view->inv_map , false);
-  int kw_index = 0;
-  if (start_kw)
-    kw_index = ecl_file_view_get_global_index( ecl_file_view , start_kw , occurence );
-
   {
-    ecl_file_kw_type * file_kw = vector_iget( ecl_file_view->kw_list , kw_index );
-    while (true) {
-      ecl_file_view_add_kw( block_map , file_kw );
+    ecl_file_view_type * block_map = ecl_file_view_alloc__( ecl_file_view->kw_list , ecl_file_view->fortio , ecl_file_view->flags , ecl_file_view->inv_map , false);
+    int start_index = 0;
+    if (start_kw)
+      start_index = ecl_file_view_get_global_index( ecl_file_view , start_kw , occurence );
 
-      kw_index++;
-      if (kw_index == vector_get_size( ecl_file_view->kw_list ))
-        break;
-      else {
-        if (end_kw) {
-          file_kw = vector_iget(ecl_file_view->kw_list , kw_index);
-          if (strcmp( end_kw , ecl_file_kw_get_header( file_kw )) == 0)
-            break;
-        }
-      }
-    }
+    ecl_file_view_set_block( block_map , ecl_file_view , start_index , ecl_file_view_find_block_end( ecl_file_view , end_kw , start_index ));
+    return block_map;
   }
-  ecl_file_view_make_index( block_map );
-  return block_map;
 }
 
 /**
@@ -425,6 +529,61 @@ ecl_file_view_type * ecl_file_view_add_blockview2(const ecl_file_view_type * ecl
 }
 
 
+/*
+  The block iterator will visit all the blocks starting with @start_kw
+  and ending before the next @end_kw, i.e. the same blocks as
+  ecl_file_view_alloc_blockview2() for occurence = 0,1,2,... The
+  iterator has one block view which is recycled for all the blocks,
+  the view returned from ecl_file_view_block_iter_next() is owned by
+  the iterator and only valid until the next call. Typical use:
+
+     ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( rst_view , SEQNUM_KW , SEQNUM_KW );
+     ecl_file_view_type * step_view;
+
+     while ((step_view = ecl_file_view_block_iter_next( iter )))
+        ....
+
+     ecl_file_view_block_iter_free( iter );
+*/
+
+ecl_file_view_block_iter_type * ecl_file_view_alloc_block_iter( const ecl_file_view_type * ecl_file_view , const char * start_kw , const char * end_kw) {
+  ecl_file_view_block_iter_type * iter = util_malloc( sizeof * iter );
+  iter->parent = ecl_file_view;
+  iter->start_list = NULL;
+  iter->end_kw = util_alloc_string_copy( end_kw );
+  iter->occurence = 0;
+  iter->block_view = ecl_file_view_alloc__( ecl_file_view->kw_list , ecl_file_view->fortio , ecl_file_view->flags , ecl_file_view->inv_map , false);
+
+  if (ecl_file_view_has_kw( ecl_file_view , start_kw ))
+    iter->start_list = hash_get( ecl_file_view->kw_index , start_kw );
+
+  return iter;
+}
+
+
+ecl_file_view_type * ecl_file_view_block_iter_next( ecl_file_view_block_iter_type * iter ) {
+  if ((iter->start_list == NULL) || (iter->occurence >= int_vector_size( iter->start_list )))
+    return NULL;
+
+  {
+    int start_index = int_vector_iget( iter->start_list , iter->occurence );
+    int end_index = ecl_file_view_find_block_end( iter->parent , iter->end_kw , start_index );
+
+    vector_clear( iter->block_view->child_list );
+    ecl_file_view_set_block( iter->block_view , iter->parent , start_index , end_index );
+    iter->occurence++;
+    return iter->block_view;
+  }
+}
+
+
+void ecl_file_view_block_iter_free( ecl_file_view_block_iter_type * iter ) {
+  ecl_file_view_free( iter->block_view );
+  util_safe_free( iter->end_kw );
+  free( iter );
+}
+
+
 
 /*****************************************************************/
 /*                   R E S T A R T   F I L E S                   */
@@ -696,45 +855,40 @@ bool ecl_file_view_has_sim_days( const ecl_file_view_type * ecl_file_view , doub
 
 
 int ecl_file_view_seqnum_index_from_sim_time( ecl_file_view_type * parent_map , time_t sim_time) {
-  int num_seqnum = ecl_file_view_get_num_named_kw( parent_map , SEQNUM_KW );
+  ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( parent_map , SEQNUM_KW , SEQNUM_KW );
   ecl_file_view_type * seqnum_map;
+  int seqnum_index = -1;
+  int s_idx = 0;
 
-  for (int s_idx = 0; s_idx < num_seqnum; s_idx++) {
-    seqnum_map = ecl_file_view_alloc_blockview( parent_map , SEQNUM_KW , s_idx );
-
-    if (!seqnum_map)
-      continue;
-
-    bool sim = ecl_file_view_has_sim_time( seqnum_map , sim_time);
-    ecl_file_view_free( seqnum_map );
-    if (sim)
-      return s_idx;
+  while ((seqnum_map = ecl_file_view_block_iter_next( iter ))) {
+    if (ecl_file_view_has_sim_time( seqnum_map , sim_time)) {
+      seqnum_index = s_idx;
+      break;
+    }
+    s_idx++;
   }
-  return -1;
+
+  ecl_file_view_block_iter_free( iter );
+  return seqnum_index;
 }
 
 
 int ecl_file_view_seqnum_index_from_sim_days( ecl_file_view_type * file_view , double sim_days) {
-  int num_seqnum = ecl_file_view_get_num_named_kw( file_view , SEQNUM_KW );
-  int seqnum_index = 0;
+  ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( file_view , SEQNUM_KW , SEQNUM_KW );
   ecl_file_view_type * seqnum_map;
+  int seqnum_index = -1;
+  int s_idx = 0;
 
-  while (true) {
-    seqnum_map = ecl_file_view_alloc_blockview( file_view , SEQNUM_KW , seqnum_index);
-
-    if (seqnum_map != NULL) {
-      if (ecl_file_view_has_sim_days( seqnum_map , sim_days)) {
-        ecl_file_view_free( seqnum_map );
-        return seqnum_index;
-      } else {
-        ecl_file_view_free( seqnum_map );
-        seqnum_index++;
-      }
+  while ((seqnum_map = ecl_file_view_block_iter_next( iter ))) {
+    if (ecl_file_view_has_sim_days( seqnum_map , sim_days)) {
+      seqnum_index = s_idx;
+      break;
     }
-
-    if (num_seqnum == seqnum_index)
-      return -1;
+    s_idx++;
   }
+
+  ecl_file_view_block_iter_free( iter );
+  return seqnum_index;
 }
 
 
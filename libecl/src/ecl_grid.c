@@ -22,12 +22,17 @@
 #include <stdbool.h>
 #include <math.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/hash.h>
 #include <ert/util/vector.h>
 #include <ert/util/stringlist.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/geometry/geo_util.h>
 #include <ert/geometry/geo_polygon.h>
@@ -361,10 +366,27 @@
   in to assemble information of the NNC. The NNC information is
   organized as follows:
 
-       For cells with NNC's attached the information is kept in a
-       nnc_info_type structure. For a particular cell the nnc_info
-       structure keeps track of which other cells this particular cell
-       is connected to, on a per grid (i.e. LGR) basis.
+       All the NNC's of a grid are stored at the grid level in
+       compressed sparse row (CSR) form, i.e. the connections of cell
+       g are found in the range [offset[g], offset[g+1]) of flat
+       arrays with lgr_nr, global index and nnc index of the cell in
+       the other end of the connection. Within one cell the
+       connections are ordered by lgr_nr. Bulk consumers can iterate
+       over the CSR arrays directly with ecl_grid_get_nnc_csr().
+
+       For cells with NNC's attached the information can also be
+       accessed as a nnc_info_type structure. For a particular cell the
+       nnc_info structure keeps track of which other cells this
+       particular cell is connected to, on a per grid (i.e. LGR)
+       basis. The nnc_info instances are light weight views into the
+       CSR arrays, created on demand.
+
+       The CSR index and the nnc_info views are built under a lock,
+       so several threads can query the nnc information of a shared
+       grid; adding connections must not run concurrently with any
+       queries. For a grid without NNC's no index is allocated, and
+       the offset pointer returned from ecl_grid_get_nnc_csr() is
+       NULL.
 
        In the nnc_info structure the different grids are identified
        through the lgr_nr.
@@ -715,7 +737,6 @@ struct ecl_cell_struct {
   int                    host_cell;          /* the global index of the host cell for an lgr cell, set to -1 for normal cells. */
   int                    coarse_group;       /* The index of the coarse group holding this cell -1 for non-coarsened cells. */
   int                    cell_flags;
-  nnc_info_type        * nnc_info;           /* Non-neighbour connection info*/
 };
 
 
@@ -726,6 +747,31 @@ static const float * ecl_grid_get_mapaxes( const ecl_grid_type * grid );
 
 #define ECL_GRID_ID       991010
 
+
+/*
+  The nnc connections of a grid in compressed sparse row form, see the
+  'About nnc' comment above. The connections are accumulated in the
+  *_list vectors, which are sorted in place and indexed with the
+  offset array on demand; adding a new connection invalidates the
+  offset array and the nnc_info views. The index is built, and the
+  views created, with the lock held.
+*/
+
+typedef struct {
+  int                   size;             /* The number of cells in the grid. */
+  int_vector_type     * cell_list;        /* Global index of the cell holding the connection. */
+  int_vector_type     * lgr_nr_list;      /* lgr_nr of the grid in the other end of the connection. */
+  int_vector_type     * grid_index_list;  /* Global index of the cell in the other end of the connection. */
+  int_vector_type     * nnc_index_list;   /* Index into the NNC1/NNC2 like keywords the connection was loaded from. */
+  bool                  indexed;          /* False when the lists must be re-sorted. */
+  int                 * offset;           /* size + 1 elements - NULL if there are no connections. */
+  nnc_info_type      ** info_list;        /* size elements - nnc_info views created on demand. */
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t       lock;
+#endif
+} ecl_grid_nnc_type;
+
+
 struct ecl_grid_struct {
   UTIL_TYPE_ID_DECLARATION;
   int                   lgr_nr;        /* EGRID files: corresponds to item 4 in gridhead - 0 for the main grid.
@@ -782,9 +828,10 @@ struct ecl_grid_struct {
 
   ert_ecl_unit_enum     unit_system;
   int                   eclipse_version;
+  ecl_grid_nnc_type   * nnc;
 };
 
-static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2,  bool include_nnc , bool * equal) {
+static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2, bool * equal) {
   int i;
 
   if (c1->active != c2->active)
@@ -808,12 +855,6 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
       point_compare( &c1->corner_list[i] , &c2->corner_list[i] , equal );
 
   }
-
-  if (include_nnc) {
-    if (*equal)
-      *equal = nnc_info_equal( c1->nnc_info , c2->nnc_info );
-  }
-
 }
 
 
@@ -1103,8 +1144,6 @@ static void ecl_cell_init( ecl_cell_type * cell , bool init_valid) {
   cell->active_index[FRACTURE_INDEX] = -1;
   if (init_valid)
     cell->cell_flags = CELL_FLAG_VALID;
-
-  cell->nnc_info = NULL;
 }
 
 
@@ -1524,34 +1563,379 @@ static ecl_cell_type * ecl_grid_get_cell(const ecl_grid_type * grid , int global
 }
 
 
+/*****************************************************************/
+/*
+  The per cell initialisation when a grid is loaded - the corner
+  points, the active flags and the taint heuristics - is independent
+  from cell to cell, and can be distributed over several threads. The
+  number of threads is a process wide setting, by default the grids
+  are loaded with one thread. Grids with less than
+  ECL_GRID_PARALLEL_MIN_SIZE cells are always initialised serially.
+
+  The cell center and volume are not part of the initialisation; they
+  are calculated on demand, see ecl_cell_assert_center() and
+  ecl_cell_get_volume().
+*/
+
+#define ECL_GRID_PARALLEL_MIN_SIZE  100000
+#define ECL_GRID_CELL_BLOCK_SIZE      4096
+
+typedef void (ecl_grid_index_ftype) (int index , void * arg);
+
+static int ecl_grid_num_threads = 1;
+
+
+void ecl_grid_set_num_threads( int num_threads ) {
+  if (num_threads < 1)
+    util_abort("%s: invalid number of threads:%d \n",__func__ , num_threads);
+
+  ecl_grid_num_threads = num_threads;
+}
+
+
+int ecl_grid_get_num_threads( void ) {
+  return ecl_grid_num_threads;
+}
+
+
+static void ecl_grid_parallel_for( const ecl_grid_type * grid , int begin , int end , ecl_grid_index_ftype * func , void * arg) {
+#ifdef ERT_HAVE_THREAD_POOL
+  if ((ecl_grid_num_threads > 1) && (grid->size >= ECL_GRID_PARALLEL_MIN_SIZE) && (end - begin > 1)) {
+    thread_pool_type * tp = thread_pool_alloc( util_int_min( ecl_grid_num_threads , end - begin ) , true );
+    thread_pool_parallel_for( tp , begin , end , func , arg );
+    thread_pool_free( tp );
+    return;
+  }
+#endif
+  {
+    int index;
+#pragma omp parallel for
+    for (index = begin; index < end; index++)
+      func( index , arg );
+  }
+}
+
+
+static int ecl_grid_get_num_cell_blocks( const ecl_grid_type * grid ) {
+  return (grid->size + ECL_GRID_CELL_BLOCK_SIZE - 1) / ECL_GRID_CELL_BLOCK_SIZE;
+}
+
+
 /**
    this function uses heuristics (ahhh - i hate it) in an attempt to
    mark cells with fucked geometry - see further comments in the
    function ecl_cell_taint_cell() which actually does it.
 */
 
-static void ecl_grid_taint_cells( ecl_grid_type * ecl_grid ) {
+static void ecl_grid_taint_cell_block( int block , void * arg ) {
+  ecl_grid_type * ecl_grid = arg;
+  int index1 = block * ECL_GRID_CELL_BLOCK_SIZE;
+  int index2 = util_int_min( ecl_grid->size , index1 + ECL_GRID_CELL_BLOCK_SIZE );
   int index;
-  for (index = 0; index < ecl_grid->size; index++) {
+  for (index = index1; index < index2; index++) {
     ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , index );
     ecl_cell_taint_cell( cell );
   }
 }
 
 
+static void ecl_grid_taint_cells( ecl_grid_type * ecl_grid ) {
+  ecl_grid_parallel_for( ecl_grid , 0 , ecl_grid_get_num_cell_blocks( ecl_grid ) , ecl_grid_taint_cell_block , ecl_grid );
+}
+
+
 static void ecl_grid_free_cells( ecl_grid_type * grid ) {
   if (!grid->cells)
     return;
 
-  for (int i=0; i < grid->size; i++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
-    if (cell->nnc_info)
-      nnc_info_free(cell->nnc_info);
-  }
   free( grid->cells );
+}
+
+/*****************************************************************/
+/* Grid level storage of the nnc connections, see the 'About nnc'
+   comment at the top of the file.                               */
+
+static ecl_grid_nnc_type * ecl_grid_nnc_alloc( int size ) {
+  ecl_grid_nnc_type * nnc = util_malloc( sizeof * nnc );
+  nnc->size            = size;
+  nnc->cell_list       = int_vector_alloc( 0 , 0 );
+  nnc->lgr_nr_list     = int_vector_alloc( 0 , 0 );
+  nnc->grid_index_list = int_vector_alloc( 0 , 0 );
+  nnc->nnc_index_list  = int_vector_alloc( 0 , 0 );
+  nnc->indexed         = false;
+  nnc->offset          = NULL;
+  nnc->info_list       = NULL;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &nnc->lock , NULL );
+#endif
+  return nnc;
+}
+
+
+static void ecl_grid_nnc_lock( ecl_grid_nnc_type * nnc ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &nnc->lock );
+#endif
+}
+
+
+static void ecl_grid_nnc_unlock( ecl_grid_nnc_type * nnc ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &nnc->lock );
+#endif
+}
+
+
+static void ecl_grid_nnc_free_index( ecl_grid_nnc_type * nnc ) {
+  if (nnc->info_list) {
+    int g;
+    for (g = 0; g < nnc->size; g++)
+      if (nnc->info_list[g])
+        nnc_info_free( nnc->info_list[g] );
+
+    free( nnc->info_list );
+    nnc->info_list = NULL;
+  }
+  util_safe_free( nnc->offset );
+  nnc->offset = NULL;
+  nnc->indexed = false;
+}
+
+
+static void ecl_grid_nnc_free( ecl_grid_nnc_type * nnc ) {
+  ecl_grid_nnc_free_index( nnc );
+  int_vector_free( nnc->cell_list );
+  int_vector_free( nnc->lgr_nr_list );
+  int_vector_free( nnc->grid_index_list );
+  int_vector_free( nnc->nnc_index_list );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &nnc->lock );
+#endif
+  free( nnc );
+}
+
+
+static void ecl_grid_nnc_copy( ecl_grid_nnc_type * target , const ecl_grid_nnc_type * src ) {
+  ecl_grid_nnc_free_index( target );
+  int_vector_memcpy( target->cell_list , src->cell_list );
+  int_vector_memcpy( target->lgr_nr_list , src->lgr_nr_list );
+  int_vector_memcpy( target->grid_index_list , src->grid_index_list );
+  int_vector_memcpy( target->nnc_index_list , src->nnc_index_list );
+}
+
+
+static void ecl_grid_nnc_add( ecl_grid_nnc_type * nnc , int cell_index , int lgr_nr , int grid_index , int nnc_index) {
+  ecl_grid_nnc_free_index( nnc );
+  int_vector_append( nnc->cell_list , cell_index );
+  int_vector_append( nnc->lgr_nr_list , lgr_nr );
+  int_vector_append( nnc->grid_index_list , grid_index );
+  int_vector_append( nnc->nnc_index_list , nnc_index );
+}
+
+
+static int ecl_grid_nnc_get_size( const ecl_grid_nnc_type * nnc ) {
+  return int_vector_size( nnc->cell_list );
+}
+
+
+static void ecl_grid_nnc_permute( int_vector_type * list , const int * perm , int * tmp ) {
+  int * data = int_vector_get_ptr( list );
+  int size = int_vector_size( list );
+  int i;
+
+  for (i = 0; i < size; i++)
+    tmp[i] = data[perm[i]];
+
+  memcpy( data , tmp , size * sizeof * data );
+}
+
+
+/*
+  Will sort the connections on (cell , lgr_nr) and initialize the
+  offset array. The sorting is done with two passes of stable counting
+  sort, i.e. the connections from one cell to one lgr will retain the
+  order they were added in. Connections loaded from file are normally
+  already sorted, and then the permutation is skipped altogether.
+  Must be called with the lock held.
+*/
+
+static void ecl_grid_nnc_build_index( ecl_grid_nnc_type * nnc ) {
+  const int num_nnc = ecl_grid_nnc_get_size( nnc );
+  const int * cell   = int_vector_get_const_ptr( nnc->cell_list );
+  const int * lgr_nr = int_vector_get_const_ptr( nnc->lgr_nr_list );
+  bool sorted = true;
+  int g,i;
+
+  if (num_nnc == 0) {
+    nnc->indexed = true;
+    return;
+  }
+
+  nnc->offset = util_calloc( nnc->size + 1 , sizeof * nnc->offset );
+  nnc->info_list = util_calloc( nnc->size , sizeof * nnc->info_list );
+  for (g = 0; g < nnc->size; g++) {
+    nnc->offset[g] = 0;
+    nnc->info_list[g] = NULL;
+  }
+  nnc->offset[nnc->size] = 0;
+
+  for (i = 0; i < num_nnc; i++) {
+    nnc->offset[ cell[i] + 1 ]++;
+    if (i > 0) {
+      if ((cell[i - 1] > cell[i]) || ((cell[i - 1] == cell[i]) && (lgr_nr[i - 1] > lgr_nr[i])))
+        sorted = false;
+    }
+  }
+
+  for (g = 0; g < nnc->size; g++)
+    nnc->offset[g + 1] += nnc->offset[g];
+
+  if (!sorted) {
+    int num_lgr = int_vector_get_max( nnc->lgr_nr_list ) + 1;
+    int * perm1 = util_calloc( num_nnc , sizeof * perm1 );
+    int * perm2 = util_calloc( num_nnc , sizeof * perm2 );
+    int * pos   = util_calloc( util_int_max( num_lgr , nnc->size ) , sizeof * pos );
+
+    /* Pass 1: stable sort on lgr_nr. */
+    for (i = 0; i < num_lgr; i++)
+      pos[i] = 0;
+
+    for (i = 0; i < num_nnc; i++)
+      if (lgr_nr[i] + 1 < num_lgr)
+        pos[ lgr_nr[i] + 1 ]++;
+
+    for (i = 1; i < num_lgr; i++)
+      pos[i] += pos[i - 1];
 
+    for (i = 0; i < num_nnc; i++)
+      perm1[ pos[ lgr_nr[i] ]++ ] = i;
+
+    /* Pass 2: stable sort on cell - the start positions are the offsets. */
+    memcpy( pos , nnc->offset , nnc->size * sizeof * pos );
+    for (i = 0; i < num_nnc; i++) {
+      int index = perm1[i];
+      perm2[ pos[ cell[index] ]++ ] = index;
+    }
+
+    ecl_grid_nnc_permute( nnc->cell_list , perm2 , perm1 );
+    ecl_grid_nnc_permute( nnc->lgr_nr_list , perm2 , perm1 );
+    ecl_grid_nnc_permute( nnc->grid_index_list , perm2 , perm1 );
+    ecl_grid_nnc_permute( nnc->nnc_index_list , perm2 , perm1 );
+
+    free( pos );
+    free( perm2 );
+    free( perm1 );
+  }
+  nnc->indexed = true;
+}
+
+
+static void ecl_grid_nnc_assert_index__( ecl_grid_nnc_type * nnc ) {
+  if (!nnc->indexed)
+    ecl_grid_nnc_build_index( nnc );
+}
+
+
+static void ecl_grid_nnc_assert_index( ecl_grid_nnc_type * nnc ) {
+  ecl_grid_nnc_lock( nnc );
+  ecl_grid_nnc_assert_index__( nnc );
+  ecl_grid_nnc_unlock( nnc );
+}
+
+
+/*
+  The nnc_info instance is created on first access as a view into the
+  sorted connection lists; one nnc_vector for each range of
+  connections to the same lgr.
+*/
+
+static const nnc_info_type * ecl_grid_nnc_get_info( ecl_grid_nnc_type * nnc , int lgr_nr , int global_index ) {
+  const nnc_info_type * nnc_info = NULL;
+
+  ecl_grid_nnc_lock( nnc );
+  ecl_grid_nnc_assert_index__( nnc );
+  if (nnc->offset) {
+    int start = nnc->offset[ global_index ];
+    int end   = nnc->offset[ global_index + 1 ];
+
+    if ((start < end) && !nnc->info_list[ global_index ]) {
+      nnc_info_type * new_info = nnc_info_alloc( lgr_nr );
+      int * lgr_nr_list = int_vector_get_ptr( nnc->lgr_nr_list );
+      int * grid_index  = int_vector_get_ptr( nnc->grid_index_list );
+      int * nnc_index   = int_vector_get_ptr( nnc->nnc_index_list );
+
+      while (start < end) {
+        int stop = start + 1;
+        while ((stop < end) && (lgr_nr_list[stop] == lgr_nr_list[start]))
+          stop++;
+
+        nnc_info_add_vector( new_info , nnc_vector_alloc_view( lgr_nr_list[start] , &grid_index[start] , &nnc_index[start] , stop - start ));
+        start = stop;
+      }
+      nnc->info_list[ global_index ] = new_info;
+    }
+    nnc_info = nnc->info_list[ global_index ];
+  }
+  ecl_grid_nnc_unlock( nnc );
+
+  return nnc_info;
+}
+
+
+static void ecl_grid_nnc_get_range( const ecl_grid_nnc_type * nnc , int global_index , int * offset , int * size) {
+  if (nnc->offset) {
+    *offset = nnc->offset[ global_index ];
+    *size   = nnc->offset[ global_index + 1 ] - *offset;
+  } else {
+    *offset = 0;
+    *size   = 0;
+  }
+}
+
+
+static bool ecl_grid_nnc_cell_equal( ecl_grid_nnc_type * nnc1 , ecl_grid_nnc_type * nnc2 , int global_index) {
+  ecl_grid_nnc_assert_index( nnc1 );
+  ecl_grid_nnc_assert_index( nnc2 );
+  {
+    int offset1 , offset2 , size , size2;
+
+    ecl_grid_nnc_get_range( nnc1 , global_index , &offset1 , &size );
+    ecl_grid_nnc_get_range( nnc2 , global_index , &offset2 , &size2 );
+    if (size != size2)
+      return false;
+
+    if (size == 0)
+      return true;
+
+    if (memcmp( int_vector_get_const_ptr( nnc1->lgr_nr_list ) + offset1 , int_vector_get_const_ptr( nnc2->lgr_nr_list ) + offset2 , size * sizeof(int)) != 0)
+      return false;
+
+    if (memcmp( int_vector_get_const_ptr( nnc1->grid_index_list ) + offset1 , int_vector_get_const_ptr( nnc2->grid_index_list ) + offset2 , size * sizeof(int)) != 0)
+      return false;
+
+    if (memcmp( int_vector_get_const_ptr( nnc1->nnc_index_list ) + offset1 , int_vector_get_const_ptr( nnc2->nnc_index_list ) + offset2 , size * sizeof(int)) != 0)
+      return false;
+
+    return true;
+  }
 }
 
+/*****************************************************************/
+
+
+static void ecl_grid_init_cell_block( int block , void * arg ) {
+  ecl_grid_type * grid = arg;
+  const ecl_cell_type * cell0 = ecl_grid_get_cell( grid , 0 );
+  int index1 = util_int_max( 1 , block * ECL_GRID_CELL_BLOCK_SIZE );
+  int index2 = util_int_min( grid->size , (block + 1) * ECL_GRID_CELL_BLOCK_SIZE );
+  int i;
+  for (i=index1; i < index2; i++) {
+    ecl_cell_type * target_cell = ecl_grid_get_cell( grid , i );
+    ecl_cell_memcpy( target_cell , cell0 );
+  }
+}
+
+
 static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
   grid->cells = malloc(grid->size * sizeof * grid->cells );
   if (!grid->cells)
@@ -1560,13 +1944,7 @@ static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
   {
     ecl_cell_type * cell0 = ecl_grid_get_cell( grid , 0 );
     ecl_cell_init( cell0 , init_valid );
-    {
-      int i;
-      for (i=1; i < grid->size; i++) {
-        ecl_cell_type * target_cell = ecl_grid_get_cell( grid , i );
-        ecl_cell_memcpy( target_cell , cell0 );
-      }
-    }
+    ecl_grid_parallel_for( grid , 0 , ecl_grid_get_num_cell_blocks( grid ) , ecl_grid_init_cell_block , grid );
     return true;
   }
 }
@@ -1644,6 +2022,7 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
   grid->children        = hash_alloc();
   grid->coarse_cells    = vector_alloc_new();
   grid->eclipse_version = 0;
+  grid->nnc             = ecl_grid_nnc_alloc( grid->size );
 
   /* This is the large allocation - which can potentially fail. */
   if (!ecl_grid_alloc_cells( grid , init_valid )) {
@@ -2337,12 +2716,24 @@ static void ecl_grid_init_GRDECL_data_jslice(ecl_grid_type * ecl_grid ,  const f
 }
 
 
+typedef struct {
+  ecl_grid_type * ecl_grid;
+  const float   * zcorn;
+  const float   * coord;
+  const int     * actnum;
+  const int     * corsnum;
+} ecl_grid_GRDECL_arg_type;
+
+
+static void ecl_grid_init_GRDECL_data_jslice__( int j , void * arg ) {
+  ecl_grid_GRDECL_arg_type * GRDECL_arg = arg;
+  ecl_grid_init_GRDECL_data_jslice( GRDECL_arg->ecl_grid , GRDECL_arg->zcorn , GRDECL_arg->coord , GRDECL_arg->actnum , GRDECL_arg->corsnum , j );
+}
+
+
 void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid ,  const float * zcorn , const float * coord , const int * actnum, const int * corsnum) {
-  const int ny = ecl_grid->ny;
-  int j;
-#pragma omp parallel for
-  for ( j=0; j < ny; j++)
-    ecl_grid_init_GRDECL_data_jslice( ecl_grid , zcorn, coord , actnum , corsnum , j );
+  ecl_grid_GRDECL_arg_type arg = { ecl_grid , zcorn , coord , actnum , corsnum };
+  ecl_grid_parallel_for( ecl_grid , 0 , ecl_grid->ny , ecl_grid_init_GRDECL_data_jslice__ , &arg );
 }
 
 
@@ -2399,9 +2790,8 @@ static void ecl_grid_copy_content( ecl_grid_type * target_grid , const ecl_grid_
     const ecl_cell_type * src_cell = ecl_grid_get_cell( src_grid , global_index );
 
     ecl_cell_memcpy( target_cell , src_cell );
-    if (src_cell->nnc_info)
-      target_cell->nnc_info = nnc_info_alloc_copy( src_cell->nnc_info );
   }
+  ecl_grid_nnc_copy( target_grid->nnc , src_grid->nnc );
   ecl_grid_copy_mapaxes( target_grid , src_grid );
 
   target_grid->parent_name = util_alloc_string_copy( src_grid->parent_name );
@@ -2614,13 +3004,6 @@ ecl_grid_type * ecl_grid_alloc_GRDECL_kw( int nx, int ny , int nz ,
 
 
 
-static void ecl_grid_init_cell_nnc_info(ecl_grid_type * ecl_grid, int global_index) {
-  ecl_cell_type * grid_cell = ecl_grid_get_cell(ecl_grid, global_index);
-
-  if (!grid_cell->nnc_info)
-    grid_cell->nnc_info = nnc_info_alloc(ecl_grid->lgr_nr);
-}
-
 /*
   The function ecl_grid_add_self_nnc() will add a NNC connection
   between two cells in the same grid. Observe that there are two
@@ -2665,9 +3048,7 @@ static void ecl_grid_init_cell_nnc_info(ecl_grid_type * ecl_grid, int global_ind
 */
 
 void ecl_grid_add_self_nnc( ecl_grid_type * grid, int cell_index1, int cell_index2, int nnc_index) {
-  ecl_cell_type * grid_cell = ecl_grid_get_cell(grid, cell_index1);
-  ecl_grid_init_cell_nnc_info(grid, cell_index1);
-  nnc_info_add_nnc(grid_cell->nnc_info, grid->lgr_nr, cell_index2, nnc_index);
+  ecl_grid_nnc_add( grid->nnc , cell_index1 , grid->lgr_nr , cell_index2 , nnc_index );
 }
 
 /*
@@ -2728,11 +3109,7 @@ static void ecl_grid_init_nnc_cells( ecl_grid_type * grid1, ecl_grid_type * grid
 
 
 
-    {
-      ecl_cell_type * grid1_cell = ecl_grid_get_cell(grid1, grid1_cell_index);
-      ecl_grid_init_cell_nnc_info(grid1, grid1_cell_index);
-      nnc_info_add_nnc(grid1_cell->nnc_info, grid2->lgr_nr, grid2_cell_index , nnc_index);
-    }
+    ecl_grid_nnc_add( grid1->nnc , grid1_cell_index , grid2->lgr_nr , grid2_cell_index , nnc_index );
   }
 }
 
@@ -2809,6 +3186,22 @@ static void ecl_grid_init_nnc_amalgamated(ecl_grid_type * main_grid, ecl_file_ty
 }
 
 
+/*
+  Sorts and indexes the nnc connections of the main grid and all the
+  lgrs up front, so that the (const) query functions on a freshly
+  loaded grid only need to read the nnc storage.
+*/
+static void ecl_grid_init_nnc_index(ecl_grid_type * main_grid) {
+  int grid_nr;
+
+  ecl_grid_nnc_assert_index( main_grid->nnc );
+  for (grid_nr = 0; grid_nr < vector_get_size( main_grid->LGR_list ); grid_nr++) {
+    ecl_grid_type * lgr_grid = vector_iget( main_grid->LGR_list , grid_nr );
+    ecl_grid_nnc_assert_index( lgr_grid->nnc );
+  }
+}
+
+
 
 
 /**
@@ -2908,6 +3301,7 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
       main_grid->name = util_alloc_string_copy( grid_file );
       ecl_grid_init_nnc(main_grid, ecl_file);
       ecl_grid_init_nnc_amalgamated(main_grid, ecl_file);
+      ecl_grid_init_nnc_index(main_grid);
 
       ecl_file_close( ecl_file );
       return main_grid;
@@ -3689,14 +4083,16 @@ static bool ecl_grid_compare_cells(const ecl_grid_type * g1 , const ecl_grid_typ
     bool this_equal = true;
     ecl_cell_type *c1 = ecl_grid_get_cell( g1 , g );
     ecl_cell_type *c2 = ecl_grid_get_cell( g2 , g );
-    ecl_cell_compare(c1 , c2 ,  include_nnc , &this_equal);
+    ecl_cell_compare(c1 , c2 , &this_equal);
+    if (include_nnc && this_equal)
+      this_equal = ecl_grid_nnc_cell_equal( g1->nnc , g2->nnc , g );
 
     if (!this_equal) {
       if (verbose) {
         int i,j,k;
         ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
 
-        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_cell_get_volume( c1 ));
+        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , ecl_grid_nnc_cell_equal( g1->nnc , g2->nnc , g ) , ecl_cell_get_volume( c1 ));
         printf("-----------------------------------------------------------------\n");
         ecl_cell_dump_ascii( c1 , i , j , k , stdout , NULL);
         printf("-----------------------------------------------------------------\n");
@@ -4416,6 +4812,7 @@ int ecl_grid_get_block_count3d(const ecl_grid_type * grid , int i , int j, int k
 
 void ecl_grid_free(ecl_grid_type * grid) {
   ecl_grid_free_cells( grid );
+  ecl_grid_nnc_free( grid->nnc );
   util_safe_free(grid->index_map);
   util_safe_free(grid->inv_index_map);
 
@@ -4983,9 +5380,14 @@ double ecl_grid_get_cell_dy1A( const ecl_grid_type * grid , int active_index) {
 }
 
 
+/*
+  The nnc_info instance returned is a view into the nnc storage of the
+  grid; it is invalidated if more nnc connections are added to the
+  grid.
+*/
+
 const nnc_info_type * ecl_grid_get_cell_nnc_info1( const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  return cell->nnc_info;
+  return ecl_grid_nnc_get_info( grid->nnc , grid->lgr_nr , global_index );
 }
 
 const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid , int i , int j , int k) {
@@ -4994,6 +5396,24 @@ const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid ,
 }
 
 
+/*
+  Direct access to the nnc connections held by the cells of this grid
+  in compressed sparse row form: the connections of cell g are found
+  in the range [offset[g], offset[g+1]) of the lgr_nr, grid_index and
+  nnc_index arrays. If the grid has no nnc connections offset is
+  NULL. The pointers are invalidated if more nnc connections are
+  added to the grid.
+*/
+
+void ecl_grid_get_nnc_csr( const ecl_grid_type * grid , const int ** offset , const int ** lgr_nr , const int ** grid_index , const int ** nnc_index) {
+  ecl_grid_nnc_assert_index( grid->nnc );
+  *offset     = grid->nnc->offset;
+  *lgr_nr     = int_vector_get_const_ptr( grid->nnc->lgr_nr_list );
+  *grid_index = int_vector_get_const_ptr( grid->nnc->grid_index_list );
+  *nnc_index  = int_vector_get_const_ptr( grid->nnc->nnc_index_list );
+}
+
+
 /*****************************************************************/
 /* Functions to query whether a cell is active or not.           */
 
@@ -6489,19 +6909,17 @@ static void  ecl_grid_fwrite_self_nnc( const ecl_grid_type * grid , fortio_type
   const int default_index = 1;
   int_vector_type * g1 = int_vector_alloc(0 , default_index );
   int_vector_type * g2 = int_vector_alloc(0 , default_index );
-  int g;
+  const int * cell_list       = int_vector_get_const_ptr( grid->nnc->cell_list );
+  const int * lgr_nr_list     = int_vector_get_const_ptr( grid->nnc->lgr_nr_list );
+  const int * grid_index_list = int_vector_get_const_ptr( grid->nnc->grid_index_list );
+  const int * nnc_index_list  = int_vector_get_const_ptr( grid->nnc->nnc_index_list );
+  int i;
 
-  for (g=0; g < ecl_grid_get_global_size(grid); g++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
-    const nnc_info_type * nnc_info = cell->nnc_info;
-    if (nnc_info) {
-      const nnc_vector_type * nnc_vector = nnc_info_get_self_vector(nnc_info);
-      int i;
-      for (i = 0; i < nnc_vector_get_size( nnc_vector ); i++) {
-        int nnc_index = nnc_vector_iget_nnc_index( nnc_vector , i );
-        int_vector_iset( g1 , nnc_index , 1 + g );
-        int_vector_iset( g2 , nnc_index , 1 + nnc_vector_iget_grid_index( nnc_vector , i ));
-      }
+  for (i=0; i < ecl_grid_nnc_get_size( grid->nnc ); i++) {
+    if (lgr_nr_list[i] == grid->lgr_nr) {
+      int nnc_index = nnc_index_list[i];
+      int_vector_iset( g1 , nnc_index , 1 + cell_list[i] );
+      int_vector_iset( g2 , nnc_index , 1 + grid_index_list[i] );
     }
   }
   {
@@ -6784,14 +7202,7 @@ bool ecl_grid_dual_grid( const ecl_grid_type * ecl_grid ) {
 }
 
 static int ecl_grid_get_num_nnc__( const ecl_grid_type * grid ) {
-  int g;
-  int num_nnc = 0;
-  for (g = 0; g < grid->size; g++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , g );
-    if (nnc_info)
-      num_nnc += nnc_info_get_total_size( nnc_info );
-  }
-  return num_nnc;
+  return ecl_grid_nnc_get_size( grid->nnc );
 }
 
 
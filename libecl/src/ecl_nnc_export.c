@@ -16,13 +16,16 @@
    for more detals.
 */
 #include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 
+#include <ert/util/util.h>
 #include <ert/util/int_vector.h>
+#include <ert/util/vector.h>
 
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_grid.h>
 #include <ert/ecl/ecl_nnc_export.h>
-#include <ert/ecl/nnc_info.h>
 #include <ert/ecl/ecl_kw_magic.h>
 
 
@@ -33,51 +36,61 @@ int ecl_nnc_export_get_size( const ecl_grid_type * grid ) {
 
 
 
+/*
+  The transmissibility keyword for a (lgr_nr1 , lgr_nr2) pair is the
+  same for all the cells in the grid; the lookup in the INIT file is
+  therefor only done once for each lgr_nr2 value and cached in the
+  tran_list vector.
+*/
+
 static int  ecl_nnc_export__( const ecl_grid_type * grid , int lgr_index1 , const ecl_file_type * init_file , ecl_nnc_type * nnc_data, int * nnc_offset) {
   int nnc_index = *nnc_offset;
   int lgr_nr1 = ecl_grid_get_lgr_nr( grid );
   int global_index1;
   int valid_trans = 0 ;
   const ecl_grid_type * global_grid = ecl_grid_get_global_grid( grid );
+  vector_type * tran_list = vector_alloc_new();
+  int_vector_type * tran_loaded = int_vector_alloc( 0 , 0 );
+  const int * offset;
+  const int * lgr_nr;
+  const int * grid_index;
+  const int * input_index;
 
   if (!global_grid)
     global_grid = grid;
 
-
-  for (global_index1 = 0; global_index1 < ecl_grid_get_global_size( grid ); global_index1++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , global_index1 );
-    if (nnc_info) {
-      int lgr_index2;
-      for (lgr_index2=0; lgr_index2 < nnc_info_get_size( nnc_info ); lgr_index2++) {
-        const nnc_vector_type * nnc_vector = nnc_info_iget_vector( nnc_info , lgr_index2 );
-        const int_vector_type * grid2_index_list = nnc_vector_get_grid_index_list( nnc_vector );
-        const int_vector_type * nnc_index_list = nnc_vector_get_nnc_index_list( nnc_vector );
-        int lgr_nr2 = nnc_vector_get_lgr_nr( nnc_vector );
-        const ecl_kw_type * tran_kw = ecl_nnc_export_get_tranx_kw(global_grid  , init_file , lgr_nr1 , lgr_nr2 );
-
-        int index2;
-        ecl_nnc_type nnc;
-
-        nnc.grid_nr1 = lgr_nr1;
-        nnc.grid_nr2 = lgr_nr2;
-        nnc.global_index1 = global_index1;
-
-        for (index2 = 0; index2 < nnc_vector_get_size( nnc_vector ); index2++) {
-          nnc.global_index2 = int_vector_iget( grid2_index_list , index2 );
-          nnc.input_index = int_vector_iget( nnc_index_list, index2 );
-          if(tran_kw) {
-            nnc.trans = ecl_kw_iget_as_double(tran_kw, nnc.input_index);
-            valid_trans++;
-          }else{
-            nnc.trans = ERT_ECL_DEFAULT_NNC_TRANS;
-          }
-
-          nnc_data[nnc_index] = nnc;
-          nnc_index++;
-        }
+  ecl_grid_get_nnc_csr( grid , &offset , &lgr_nr , &grid_index , &input_index );
+  for (global_index1 = 0; (offset != NULL) && (global_index1 < ecl_grid_get_global_size( grid )); global_index1++) {
+    int index2;
+    for (index2 = offset[global_index1]; index2 < offset[global_index1 + 1]; index2++) {
+      int lgr_nr2 = lgr_nr[index2];
+      const ecl_kw_type * tran_kw;
+      ecl_nnc_type nnc;
+
+      if (!int_vector_safe_iget( tran_loaded , lgr_nr2 )) {
+        vector_iset_ref( tran_list , lgr_nr2 , ecl_nnc_export_get_tranx_kw(global_grid  , init_file , lgr_nr1 , lgr_nr2 ));
+        int_vector_iset( tran_loaded , lgr_nr2 , 1 );
+      }
+      tran_kw = vector_iget_const( tran_list , lgr_nr2 );
+
+      nnc.grid_nr1 = lgr_nr1;
+      nnc.grid_nr2 = lgr_nr2;
+      nnc.global_index1 = global_index1;
+      nnc.global_index2 = grid_index[index2];
+      nnc.input_index = input_index[index2];
+      if(tran_kw) {
+        nnc.trans = ecl_kw_iget_as_double(tran_kw, nnc.input_index);
+        valid_trans++;
+      }else{
+        nnc.trans = ERT_ECL_DEFAULT_NNC_TRANS;
       }
+
+      nnc_data[nnc_index] = nnc;
+      nnc_index++;
     }
   }
+  int_vector_free( tran_loaded );
+  vector_free( tran_list );
   *nnc_offset = nnc_index;
   return valid_trans;
 }
@@ -151,33 +164,126 @@ static int ecl_nnc_sort_cmp__( const void * nnc1 , const void * nnc2) {
 }
 
 
+/*
+  The nnc list is sorted with a LSD radix sort, i.e. a sequence of
+  stable counting sort passes over 16 bit digits of the keys, starting
+  with the least significant key global_index2 and ending with
+  grid_nr1. The keys are offset with their minimum value, and only the
+  digits actually in use are sorted; i.e. the grid numbers will
+  typically require one pass (or none in a grid without LGRs) and the
+  global indices two passes. The result is identical to sorting with
+  ecl_nnc_sort_cmp().
+*/
+
+#define ECL_NNC_RADIX_BITS     16
+#define ECL_NNC_RADIX_SIZE     (1 << ECL_NNC_RADIX_BITS)
+#define ECL_NNC_RADIX_MIN_SIZE 256
+
+static int ecl_nnc_get_key( const ecl_nnc_type * nnc , size_t key_offset) {
+  return *((const int *) ((const char *) nnc + key_offset));
+}
+
+
+static void ecl_nnc_radix_pass( const ecl_nnc_type * src , ecl_nnc_type * target , int size , size_t key_offset , int min_key , int shift , int * count) {
+  int i;
+
+  memset( count , 0 , ECL_NNC_RADIX_SIZE * sizeof * count );
+  for (i=0; i < size; i++) {
+    unsigned int key = ecl_nnc_get_key( &src[i] , key_offset ) - min_key;
+    count[ (key >> shift) & (ECL_NNC_RADIX_SIZE - 1) ]++;
+  }
+
+  {
+    int offset = 0;
+    for (i=0; i < ECL_NNC_RADIX_SIZE; i++) {
+      int bucket_size = count[i];
+      count[i] = offset;
+      offset += bucket_size;
+    }
+  }
+
+  for (i=0; i < size; i++) {
+    unsigned int key = ecl_nnc_get_key( &src[i] , key_offset ) - min_key;
+    target[ count[ (key >> shift) & (ECL_NNC_RADIX_SIZE - 1) ]++ ] = src[i];
+  }
+}
+
+
 void ecl_nnc_sort( ecl_nnc_type * nnc_list , int size) {
-  qsort( nnc_list , size , sizeof * nnc_list , ecl_nnc_sort_cmp__ );
+  if (size < ECL_NNC_RADIX_MIN_SIZE)
+    qsort( nnc_list , size , sizeof * nnc_list , ecl_nnc_sort_cmp__ );
+  else {
+    const size_t key_offsets[4] = { offsetof( ecl_nnc_type , global_index2 ),
+                                    offsetof( ecl_nnc_type , global_index1 ),
+                                    offsetof( ecl_nnc_type , grid_nr2 ),
+                                    offsetof( ecl_nnc_type , grid_nr1 ) };
+    ecl_nnc_type * work = util_malloc( size * sizeof * work );
+    int * count = util_malloc( ECL_NNC_RADIX_SIZE * sizeof * count );
+    ecl_nnc_type * src = nnc_list;
+    ecl_nnc_type * target = work;
+
+    for (int ikey = 0; ikey < 4; ikey++) {
+      size_t key_offset = key_offsets[ikey];
+      int min_key = ecl_nnc_get_key( &nnc_list[0] , key_offset );
+      int max_key = min_key;
+
+      for (int i=1; i < size; i++) {
+        int key = ecl_nnc_get_key( &nnc_list[i] , key_offset );
+        if (key < min_key)
+          min_key = key;
+        if (key > max_key)
+          max_key = key;
+      }
+
+      {
+        unsigned int range = (unsigned int) max_key - (unsigned int) min_key;
+        int shift = 0;
+        while (range > 0) {
+          ecl_nnc_radix_pass( src , target , size , key_offset , min_key , shift , count );
+          {
+            ecl_nnc_type * tmp = src;
+            src = target;
+            target = tmp;
+          }
+          shift += ECL_NNC_RADIX_BITS;
+          range >>= ECL_NNC_RADIX_BITS;
+        }
+      }
+    }
+
+    if (src != nnc_list)
+      memcpy( nnc_list , src , size * sizeof * nnc_list );
+
+    free( count );
+    free( work );
+  }
 }
 
 
 
+/*
+  The scanning of the INIT file in the functions below is based on the
+  keyword headers only; the data is only loaded for the small
+  LGRJOIN and LGRHEADI keywords which must be inspected, and for the
+  transmissibility keyword which is returned.
+*/
+
 ecl_kw_type * ecl_nnc_export_get_tranll_kw( const ecl_grid_type * grid , const ecl_file_type * init_file ,  int lgr_nr1, int lgr_nr2 ) {
   const char * lgr_name1 = ecl_grid_get_lgr_name( grid , lgr_nr1 );
   const char * lgr_name2 = ecl_grid_get_lgr_name( grid , lgr_nr2 );
 
   ecl_kw_type * tran_kw = NULL;
   const int file_num_kw = ecl_file_get_size( init_file );
-  int global_kw_index = 0;
+  int global_kw_index;
 
-  while (true) {
-    if (global_kw_index >= file_num_kw)
-      break;
-    {
+  for (global_kw_index = 0; global_kw_index < file_num_kw; global_kw_index++) {
+    if (strcmp( LGRJOIN_KW , ecl_file_iget_header( init_file , global_kw_index )) == 0) {
       ecl_kw_type * ecl_kw = ecl_file_iget_kw( init_file , global_kw_index );
-      if (strcmp( LGRJOIN_KW , ecl_kw_get_header( ecl_kw)) == 0) {
 
-        if (ecl_kw_icmp_string( ecl_kw , 0 , lgr_name1) && ecl_kw_icmp_string( ecl_kw , 1 , lgr_name2)) {
-          tran_kw = ecl_file_iget_kw( init_file , global_kw_index + 1);
-          break;
-        }
+      if (ecl_kw_icmp_string( ecl_kw , 0 , lgr_name1) && ecl_kw_icmp_string( ecl_kw , 1 , lgr_name2)) {
+        tran_kw = ecl_file_iget_kw( init_file , global_kw_index + 1);
+        break;
       }
-      global_kw_index++;
     }
   }
 
@@ -197,18 +303,17 @@ ecl_kw_type * ecl_nnc_export_get_tran_kw( const ecl_file_type * init_file , cons
     if ((strcmp(kw , TRANNNC_KW) == 0) ||
         (strcmp(kw , TRANGL_KW) == 0)) {
       const int file_num_kw = ecl_file_get_size( init_file );
-      int global_kw_index = 0;
-      bool finished = false;
+      int global_kw_index;
       bool correct_lgrheadi = false;
       int head_index = 0;
       int steps = 0;
 
 
-      while(!finished){
-        ecl_kw_type * ecl_kw = ecl_file_iget_kw( init_file , global_kw_index );
-        const char *current_kw = ecl_kw_get_header(ecl_kw);
+      for (global_kw_index = 0; global_kw_index < file_num_kw; global_kw_index++) {
+        const char *current_kw = ecl_file_iget_header( init_file , global_kw_index );
         if (strcmp( LGRHEADI_KW , current_kw) == 0) {
-          if (ecl_kw_iget_int( ecl_kw , LGRHEADI_LGR_NR_INDEX) == lgr_nr) {
+          ecl_kw_type * lgrheadi_kw = ecl_file_iget_kw( init_file , global_kw_index );
+          if (ecl_kw_iget_int( lgrheadi_kw , LGRHEADI_LGR_NR_INDEX) == lgr_nr) {
             correct_lgrheadi = true;
             head_index = global_kw_index;
           }else{
@@ -219,15 +324,11 @@ ecl_kw_type * ecl_nnc_export_get_tran_kw( const ecl_file_type * init_file , cons
           if (strcmp(kw, current_kw) == 0) {
             steps  = global_kw_index - head_index; /* This is to calculate who fare from lgrheadi we found the TRANGL/TRANNNC key word */
             if(steps == 3 || steps == 4 || steps == 6) { /* We only support a file format where TRANNNC is 3 steps and TRANGL is 4 or 6 steps from LGRHEADI */
-              tran_kw = ecl_kw;
-              finished = true;
+              tran_kw = ecl_file_iget_kw( init_file , global_kw_index );
               break;
             }
           }
         }
-        global_kw_index++;
-        if (global_kw_index == file_num_kw)
-          finished = true;
       }
     }
   }
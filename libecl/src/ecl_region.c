@@ -19,12 +19,14 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
 
 #include <ert/util/int_vector.h>
 #include <ert/util/util.h>
 
 #include <ert/geometry/geo_util.h>
 #include <ert/geometry/geo_polygon.h>
+#include <ert/geometry/geo_prepared_polygon.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_grid.h>
@@ -93,14 +95,28 @@
 
 #define ECL_REGION_TYPE_ID 1106377
 
+/*
+  The selection is stored as a packed bitset with one bit per global
+  cell; the bits beyond grid_vol in the last word are always zero. The
+  index lists are maintained incrementally: every operation which
+  actually changes a word of the bitset extends the dirty word range
+  [dirty_lo, dirty_hi) of the lists, and when the lists are requested
+  only the part of the lists covering the dirty range is rebuilt.
+*/
+
+#define ECL_REGION_WORD_BITS 64
+
+typedef uint64_t ecl_region_word_type;
+
 struct ecl_region_struct {
   UTIL_TYPE_ID_DECLARATION;
-  bool                * active_mask;          /* This marks active|inactive in the region, which is unrelated to active in the grid. */
-  int_vector_type     * global_index_list;    /* This is a list of the cells in the region - irrespective of whether they are active in the grid or not. */
-  int_vector_type     * active_index_list;    /* This means cells in the region which are also active in the grid */
-  int_vector_type     * global_active_list;   /* This is a list of (maximum) nactive elements, where the values are in the [0,..nx*ny*nz) range. */
-  bool                  global_index_list_valid;
-  bool                  active_index_list_valid;
+  ecl_region_word_type * select_mask;       /* This marks active|inactive in the region, which is unrelated to active in the grid. */
+  int                    num_words;
+  int_vector_type      * global_index_list;    /* This is a list of the cells in the region - irrespective of whether they are active in the grid or not. */
+  int_vector_type      * active_index_list;    /* This means cells in the region which are also active in the grid */
+  int_vector_type      * global_active_list;   /* This is a list of (maximum) nactive elements, where the values are in the [0,..nx*ny*nz) range. */
+  int                    global_dirty_lo , global_dirty_hi;   /* Word range where global_index_list is out of date. */
+  int                    active_dirty_lo , active_dirty_hi;   /* Word range where active_index_list and global_active_list are out of date. */
 
   char                * name;                 /* User name attached to region will typically be NULL. */
   bool                  preselect;
@@ -116,9 +132,145 @@ UTIL_IS_INSTANCE_FUNCTION( ecl_region , ECL_REGION_TYPE_ID)
 UTIL_SAFE_CAST_FUNCTION( ecl_region , ECL_REGION_TYPE_ID)
 
 
+static void ecl_region_invalidate_words( ecl_region_type * region , int word1 , int word2) {
+  if (region->global_dirty_lo >= region->global_dirty_hi) {
+    region->global_dirty_lo = word1;
+    region->global_dirty_hi = word2;
+  } else {
+    region->global_dirty_lo = util_int_min( region->global_dirty_lo , word1 );
+    region->global_dirty_hi = util_int_max( region->global_dirty_hi , word2 );
+  }
+
+  if (region->active_dirty_lo >= region->active_dirty_hi) {
+    region->active_dirty_lo = word1;
+    region->active_dirty_hi = word2;
+  } else {
+    region->active_dirty_lo = util_int_min( region->active_dirty_lo , word1 );
+    region->active_dirty_hi = util_int_max( region->active_dirty_hi , word2 );
+  }
+}
+
+
 static void ecl_region_invalidate_index_list( ecl_region_type * region ) {
-  region->global_index_list_valid  = false;
-  region->active_index_list_valid  = false;
+  ecl_region_invalidate_words( region , 0 , region->num_words );
+}
+
+
+/*
+  Mask with the valid bits of word nr @word set, i.e. all bits except
+  for the bits beyond grid_vol in the last word.
+*/
+
+static ecl_region_word_type ecl_region_valid_bits( const ecl_region_type * region , int word ) {
+  int tail_bits = region->grid_vol - word * ECL_REGION_WORD_BITS;
+  if (tail_bits >= ECL_REGION_WORD_BITS)
+    return ~((ecl_region_word_type) 0);
+  else
+    return (((ecl_region_word_type) 1) << tail_bits) - 1;
+}
+
+
+static void ecl_region_set_word( ecl_region_type * region , int word , ecl_region_word_type value) {
+  if (region->select_mask[word] != value) {
+    region->select_mask[word] = value;
+    ecl_region_invalidate_words( region , word , word + 1);
+  }
+}
+
+
+/*
+  Will select (or deselect) all the cells in the word nr @word which
+  have a bit set in @hits.
+*/
+
+static void ecl_region_apply_word( ecl_region_type * region , int word , ecl_region_word_type hits , bool select) {
+  if (hits) {
+    if (select)
+      ecl_region_set_word( region , word , region->select_mask[word] | hits );
+    else
+      ecl_region_set_word( region , word , region->select_mask[word] & ~hits );
+  }
+}
+
+
+static bool ecl_region_get_bit( const ecl_region_type * region , int global_index) {
+  int word = global_index / ECL_REGION_WORD_BITS;
+  int bit  = global_index % ECL_REGION_WORD_BITS;
+  return (region->select_mask[word] >> bit) & 1;
+}
+
+
+static void ecl_region_set_bit( ecl_region_type * region , int global_index , bool select) {
+  int word = global_index / ECL_REGION_WORD_BITS;
+  int bit  = global_index % ECL_REGION_WORD_BITS;
+  ecl_region_apply_word( region , word , ((ecl_region_word_type) 1) << bit , select );
+}
+
+
+/*
+  Will select (or deselect) all the cells in the global index range
+  [global_index1, global_index2).
+*/
+
+static void ecl_region_set_range( ecl_region_type * region , int global_index1 , int global_index2 , bool select) {
+  while (global_index1 < global_index2) {
+    int word = global_index1 / ECL_REGION_WORD_BITS;
+    int bit1 = global_index1 % ECL_REGION_WORD_BITS;
+    int bit2 = util_int_min( ECL_REGION_WORD_BITS , bit1 + (global_index2 - global_index1));
+    ecl_region_word_type hits = ~((ecl_region_word_type) 0) << bit1;
+
+    if (bit2 < ECL_REGION_WORD_BITS)
+      hits &= (((ecl_region_word_type) 1) << bit2) - 1;
+
+    ecl_region_apply_word( region , word , hits , select );
+    global_index1 += bit2 - bit1;
+  }
+}
+
+
+/*
+  Will select (or deselect) the cells in the active index range
+  [active_offset, active_offset + 64) which have a bit set in @hits.
+*/
+
+static void ecl_region_apply_active_hits( ecl_region_type * region , int active_offset , ecl_region_word_type hits , bool select) {
+  int bit = 0;
+  while (hits) {
+    if (hits & 1) {
+      int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_offset + bit );
+      ecl_region_set_bit( region , global_index , select );
+    }
+    hits >>= 1;
+    bit++;
+  }
+}
+
+
+/*
+  Evaluates the condition @cond for all elements index = 0,1,...,size
+  of a keyword, 64 elements at a time, and selects/deselects the cells
+  where the condition holds. The keyword is either a global keyword,
+  where index is a global index and the result maps directly onto a
+  word of the bitset, or an active keyword where index is an active
+  index.
+*/
+
+#define ECL_REGION_SELECT_KW( region , global_kw , size , cond , select )                    \
+{                                                                                             \
+  int offset;                                                                                 \
+  for (offset = 0; offset < (size); offset += ECL_REGION_WORD_BITS) {                        \
+    int block_size = util_int_min( ECL_REGION_WORD_BITS , (size) - offset );                 \
+    ecl_region_word_type hits = 0;                                                            \
+    int bit;                                                                                  \
+    for (bit = 0; bit < block_size; bit++) {                                                  \
+      int index = offset + bit;                                                               \
+      hits |= ((ecl_region_word_type) (cond)) << bit;                                         \
+    }                                                                                         \
+    if (global_kw)                                                                            \
+      ecl_region_apply_word( region , offset / ECL_REGION_WORD_BITS , hits , select );       \
+    else                                                                                      \
+      ecl_region_apply_active_hits( region , offset , hits , select );                       \
+  }                                                                                           \
 }
 
 
@@ -142,13 +294,18 @@ ecl_region_type * ecl_region_alloc( const ecl_grid_type * ecl_grid , bool presel
   region->parent_grid = ecl_grid;
   ecl_grid_get_dims( ecl_grid , &region->grid_nx , &region->grid_ny , &region->grid_nz , &region->grid_active);
   region->grid_vol          = region->grid_nx * region->grid_ny * region->grid_nz;
-  region->active_mask       = util_calloc(region->grid_vol , sizeof * region->active_mask );
+  region->num_words         = (region->grid_vol + ECL_REGION_WORD_BITS - 1) / ECL_REGION_WORD_BITS;
+  region->select_mask       = util_calloc( util_int_max( 1 , region->num_words ) , sizeof * region->select_mask );
   region->active_index_list  = int_vector_alloc(0 , 0);
   region->global_index_list  = int_vector_alloc(0 , 0);
   region->global_active_list = int_vector_alloc(0 , 0);
   region->preselect          = preselect;
   region->name               = NULL;
-  ecl_region_reset( region );  /* This MUST be called to ensure that xxx_valid is correctly initialized. */
+  region->global_dirty_lo    = 0;
+  region->global_dirty_hi    = 0;
+  region->active_dirty_lo    = 0;
+  region->active_dirty_hi    = 0;
+  ecl_region_reset( region );  /* This MUST be called to ensure that the mask and the dirty ranges are correctly initialized. */
   return region;
 }
 
@@ -159,14 +316,14 @@ ecl_region_type * ecl_region_alloc( const ecl_grid_type * ecl_grid , bool presel
 
 ecl_region_type * ecl_region_alloc_copy( const ecl_region_type * ecl_region ) {
   ecl_region_type * new_region = ecl_region_alloc( ecl_region->parent_grid , ecl_region->preselect );
-  memcpy( new_region->active_mask , ecl_region->active_mask , ecl_region->grid_vol * sizeof * ecl_region->active_mask );
+  memcpy( new_region->select_mask , ecl_region->select_mask , ecl_region->num_words * sizeof * ecl_region->select_mask );
   ecl_region_invalidate_index_list( new_region );
   return new_region;
 }
 
 
 void ecl_region_free( ecl_region_type * region ) {
-  free( region->active_mask );
+  free( region->select_mask );
   int_vector_free( region->active_index_list );
   int_vector_free( region->global_index_list );
   int_vector_free( region->global_active_list );
@@ -184,37 +341,105 @@ void ecl_region_free__( void * __region ) {
 
 /*****************************************************************/
 
+/*
+  Returns the position of the first element in the sorted list which
+  is >= value.
+*/
 
-static void ecl_region_assert_global_index_list( ecl_region_type * region ) {
-  if (!region->global_index_list_valid) {
-    int global_index;
+static int ecl_region_lower_bound( const int_vector_type * list , int value) {
+  const int * data = int_vector_get_const_ptr( list );
+  int lo = 0;
+  int hi = int_vector_size( list );
+
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (data[mid] < value)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+
+/*
+  The lists are sorted in global index order; the elements in the
+  global index range corresponding to the dirty words are removed,
+  and the selected cells in that range are inserted instead.
+*/
 
-    int_vector_reset( region->global_index_list  );
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      if (region->active_mask[ global_index ])
-        int_vector_append( region->global_index_list , global_index );
+static void ecl_region_assert_global_index_list( ecl_region_type * region ) {
+  if (region->global_dirty_lo < region->global_dirty_hi) {
+    int global1 = region->global_dirty_lo * ECL_REGION_WORD_BITS;
+    int global2 = util_int_min( region->grid_vol , region->global_dirty_hi * ECL_REGION_WORD_BITS );
+    int pos1 = ecl_region_lower_bound( region->global_index_list , global1 );
+    int pos2 = ecl_region_lower_bound( region->global_index_list , global2 );
+    int tail_size = int_vector_size( region->global_index_list ) - pos2;
+    int * tail = util_malloc( util_int_max( 1 , tail_size ) * sizeof * tail );
+
+    memcpy( tail , &int_vector_get_const_ptr( region->global_index_list )[pos2] , tail_size * sizeof * tail );
+    int_vector_resize( region->global_index_list , pos1 );
+    {
+      int word;
+      for (word = region->global_dirty_lo; word < region->global_dirty_hi; word++) {
+        ecl_region_word_type bits = region->select_mask[word];
+        int global_index = word * ECL_REGION_WORD_BITS;
+        while (bits) {
+          if (bits & 1)
+            int_vector_append( region->global_index_list , global_index );
+          bits >>= 1;
+          global_index++;
+        }
+      }
+    }
+    int_vector_append_many( region->global_index_list , tail , tail_size );
+    free( tail );
 
-    region->global_index_list_valid = true;
+    region->global_dirty_lo = 0;
+    region->global_dirty_hi = 0;
   }
 }
 
 
 static void ecl_region_assert_active_index_list( ecl_region_type * region ) {
-  if (!region->active_index_list_valid) {
-    int global_index;
-
-    int_vector_reset( region->active_index_list  );
-    int_vector_reset( region->global_active_list );
-    for (global_index = 0; global_index < region->grid_vol; global_index++) {
-      if (region->active_mask[ global_index ]) {
-        int active_index = ecl_grid_get_active_index1( region->parent_grid , global_index );
-        if (active_index >= 0) {
-          int_vector_append( region->active_index_list , active_index );
-          int_vector_append( region->global_active_list , global_index );
+  if (region->active_dirty_lo < region->active_dirty_hi) {
+    int global1 = region->active_dirty_lo * ECL_REGION_WORD_BITS;
+    int global2 = util_int_min( region->grid_vol , region->active_dirty_hi * ECL_REGION_WORD_BITS );
+    int pos1 = ecl_region_lower_bound( region->global_active_list , global1 );
+    int pos2 = ecl_region_lower_bound( region->global_active_list , global2 );
+    int tail_size = int_vector_size( region->global_active_list ) - pos2;
+    int * global_tail = util_malloc( util_int_max( 1 , tail_size ) * sizeof * global_tail );
+    int * active_tail = util_malloc( util_int_max( 1 , tail_size ) * sizeof * active_tail );
+
+    memcpy( global_tail , &int_vector_get_const_ptr( region->global_active_list )[pos2] , tail_size * sizeof * global_tail );
+    memcpy( active_tail , &int_vector_get_const_ptr( region->active_index_list )[pos2] , tail_size * sizeof * active_tail );
+    int_vector_resize( region->global_active_list , pos1 );
+    int_vector_resize( region->active_index_list , pos1 );
+    {
+      int word;
+      for (word = region->active_dirty_lo; word < region->active_dirty_hi; word++) {
+        ecl_region_word_type bits = region->select_mask[word];
+        int global_index = word * ECL_REGION_WORD_BITS;
+        while (bits) {
+          if (bits & 1) {
+            int active_index = ecl_grid_get_active_index1( region->parent_grid , global_index );
+            if (active_index >= 0) {
+              int_vector_append( region->active_index_list , active_index );
+              int_vector_append( region->global_active_list , global_index );
+            }
+          }
+          bits >>= 1;
+          global_index++;
         }
       }
     }
-    region->active_index_list_valid = true;
+    int_vector_append_many( region->global_active_list , global_tail , tail_size );
+    int_vector_append_many( region->active_index_list , active_tail , tail_size );
+    free( global_tail );
+    free( active_tail );
+
+    region->active_dirty_lo = 0;
+    region->active_dirty_hi = 0;
   }
 }
 
@@ -276,9 +501,9 @@ static void ecl_region_assert_kw( const ecl_region_type * region , const ecl_kw_
 /*****************************************************************/
 
 void ecl_region_reset( ecl_region_type * ecl_region ) {
-  int i;
-  for (i=0; i < ecl_region->grid_vol; i++)
-    ecl_region->active_mask[i] = ecl_region->preselect;
+  int word;
+  for (word = 0; word < ecl_region->num_words; word++)
+    ecl_region->select_mask[word] = ecl_region->preselect ? ecl_region_valid_bits( ecl_region , word ) : 0;
   ecl_region_invalidate_index_list( ecl_region );
 }
 
@@ -287,8 +512,7 @@ void ecl_region_reset( ecl_region_type * ecl_region ) {
 
 static void ecl_region_select_cell__( ecl_region_type * region , int i , int j , int k, bool select) {
   int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-  region->active_mask[global_index] = select;
-  ecl_region_invalidate_index_list( region );
+  ecl_region_set_bit( region , global_index , select );
 }
 
 
@@ -310,23 +534,9 @@ static void ecl_region_select_equal__( ecl_region_type * region , const ecl_kw_t
     util_abort("%s: sorry - select by equality is only supported for integer keywords \n",__func__);
   {
     const int * kw_data = ecl_kw_get_int_ptr( ecl_kw );
-    if (global_kw) {
-      int global_index;
-      for (global_index = 0; global_index < region->grid_vol; global_index++) {
-        if (kw_data[ global_index ] == value)
-          region->active_mask[ global_index ] = select;
-      }
-    } else {
-      int active_index;
-      for (active_index = 0; active_index < region->grid_active; active_index++) {
-        if (kw_data[active_index] == value) {
-          int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
-        }
-      }
-    }
+    int kw_size = ecl_kw_get_size( ecl_kw );
+    ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] == value , select );
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -347,23 +557,9 @@ static void ecl_region_select_bool_equal__( ecl_region_type * region , const ecl
   if (!ecl_type_is_bool(ecl_kw_get_data_type( ecl_kw )))
     util_abort("%s: sorry - select by equality is only supported for boolean keywords \n",__func__);
   {
-    if (global_kw) {
-      int global_index;
-      for (global_index = 0; global_index < region->grid_vol; global_index++) {
-        if (ecl_kw_iget_bool(ecl_kw , global_index) == value)
-          region->active_mask[ global_index ] = select;
-      }
-    } else {
-      int active_index;
-      for (active_index = 0; active_index < region->grid_active; active_index++) {
-        if (ecl_kw_iget_bool(ecl_kw , active_index) == value) {
-          int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
-        }
-      }
-    }
+    int kw_size = ecl_kw_get_size( ecl_kw );
+    ECL_REGION_SELECT_KW( region , global_kw , kw_size , ecl_kw_iget_bool( ecl_kw , index ) == value , select );
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -396,23 +592,9 @@ static void ecl_region_select_in_interval__( ecl_region_type * region , const ec
     util_abort("%s: sorry - select by in_interval is only supported for float keywords \n",__func__);
   {
     const float * kw_data = ecl_kw_get_float_ptr( ecl_kw );
-    if (global_kw) {
-      int global_index;
-      for (global_index = 0; global_index < region->grid_vol; global_index++) {
-        if (kw_data[ global_index ] >= min_value && kw_data[ global_index ] < max_value)
-          region->active_mask[ global_index ] = select;
-      }
-    } else {
-      int active_index;
-      for (active_index = 0; active_index < region->grid_active; active_index++) {
-        if (kw_data[ active_index ] >= min_value && kw_data[ active_index ] < max_value) {
-          int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
-        }
-      }
-    }
+    int kw_size = ecl_kw_get_size( ecl_kw );
+    ECL_REGION_SELECT_KW( region , global_kw , kw_size , (kw_data[index] >= min_value) & (kw_data[index] < max_value) , select );
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -427,19 +609,13 @@ void ecl_region_deselect_in_interval( ecl_region_type * region , const ecl_kw_ty
 
 /*****************************************************************/
 
-/**
-   This is waaaay to fucking large:
-
-   Float / Int / double *  Active / Global  *  More / Less ==> In total 12 code blocks written out ...
-*/
-
-
 /*
   NBNBNBNB: Select >= on float values and select > on integer!!!!!!
 */
 static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl_kw_type * ecl_kw, float limit , bool select_less , bool select) {
   bool global_kw;
   ecl_data_type data_type = ecl_kw_get_data_type( ecl_kw );
+  int kw_size = ecl_kw_get_size( ecl_kw );
   ecl_region_assert_kw( region , ecl_kw , &global_kw);
   if (!ecl_type_is_numeric(data_type))
     util_abort("%s: sorry - select by in_interval is only supported for float and integer keywords \n",__func__);
@@ -448,96 +624,26 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
     if (ecl_type_is_float(data_type)) {
       const float * kw_data = ecl_kw_get_float_ptr( ecl_kw );
       float float_limit = limit;
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw_data[ global_index ] < float_limit)
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw_data[ global_index ] >= float_limit)
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw_data[ active_index ] < float_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw_data[ active_index ] >= float_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] < float_limit , select )
+      else
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] >= float_limit , select )
     } else if (ecl_type_is_int(data_type)) {
       const int * kw_data = ecl_kw_get_int_ptr( ecl_kw );
       int int_limit = (int) limit;
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw_data[ global_index ] < int_limit)
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw_data[ global_index ] > int_limit)
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw_data[ active_index ] < int_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw_data[ active_index ] > int_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] < int_limit , select )
+      else
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] > int_limit , select )
     } else if (ecl_type_is_double(data_type)) {
       const double * kw_data = ecl_kw_get_double_ptr( ecl_kw );
       double double_limit = (double) limit;
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw_data[ global_index ] < double_limit)
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw_data[ global_index ] >= double_limit)
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw_data[ active_index ] < double_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw_data[ active_index ] >= double_limit) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] < double_limit , select )
+      else
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw_data[index] >= double_limit , select )
     }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -573,38 +679,15 @@ static void ecl_region_cmp_select__( ecl_region_type * region , const ecl_kw_typ
 
       const float * kw1_data = ecl_kw_get_float_ptr( kw1 );
       const float * kw2_data = ecl_kw_get_float_ptr( kw2 );
+      int kw_size = ecl_kw_get_size( kw1 );
 
-      if (global_kw) {
-        int global_index;
-        for (global_index = 0; global_index < region->grid_vol; global_index++) {
-          if (select_less) {
-            if (kw1_data[ global_index ] < kw2_data[ global_index ])
-              region->active_mask[ global_index ] = select;
-          } else {
-            if (kw1_data[ global_index ] >= kw2_data[ global_index ] )
-              region->active_mask[ global_index ] = select;
-          }
-        }
-      } else {
-        int active_index;
-        for (active_index = 0; active_index < region->grid_active; active_index++) {
-          if (select_less) {
-            if (kw1_data[ active_index ] < kw2_data[ active_index] ) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          } else {
-            if (kw1_data[ active_index ] >= kw2_data[ active_index ]) {
-              int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
-      }
+      if (select_less)
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw1_data[index] < kw2_data[index] , select )
+      else
+        ECL_REGION_SELECT_KW( region , global_kw , kw_size , kw1_data[index] >= kw2_data[index] , select )
     } else
       util_abort("%s: type/size mismatch between keywords. \n",__func__);
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 void ecl_region_cmp_select_less( ecl_region_type * ecl_region , const ecl_kw_type * kw1 , const ecl_kw_type * kw2) {
@@ -639,9 +722,7 @@ static void ecl_region_select_from_box__( ecl_region_type * region , const ecl_b
   int box_index;
 
   for (box_index = 0; box_index < box_size; box_index++)
-    region->active_mask[ active_list[box_index] ] = select;
-
-  ecl_region_invalidate_index_list( region );
+    ecl_region_set_bit( region , active_list[box_index] , select );
 }
 
 
@@ -699,15 +780,13 @@ static void ecl_region_select_i1i2__( ecl_region_type * region , int i1 , int i2
   i1 = util_int_max(0 , i1);
   i2 = util_int_min(region->grid_nx - 1 , i2);
   {
-    int i,j,k;
+    int j,k;
     for (k = 0; k < region->grid_nz; k++)
-      for (j = 0; j < region->grid_ny; j++)
-        for (i = i1; i <= i2; i++) {
-          int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
-        }
+      for (j = 0; j < region->grid_ny; j++) {
+        int global_index = ecl_grid_get_global_index3( region->parent_grid , i1,j,k);
+        ecl_region_set_range( region , global_index , global_index + (i2 - i1 + 1) , select );
+      }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -739,15 +818,12 @@ static void ecl_region_select_j1j2__( ecl_region_type * region , int j1 , int j2
   j1 = util_int_max(0 , j1);
   j2 = util_int_min(region->grid_ny - 1 , j2);
   {
-    int i,j,k;
-    for (k = 0; k < region->grid_nz; k++)
-      for ( j = j1; j <= j2; j++)
-        for ( i = 0; i < region->grid_nx; i++) {
-          int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
-        }
+    int k;
+    for (k = 0; k < region->grid_nz; k++) {
+      int global_index = ecl_grid_get_global_index3( region->parent_grid , 0,j1,k);
+      ecl_region_set_range( region , global_index , global_index + (j2 - j1 + 1) * region->grid_nx , select );
+    }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -778,15 +854,9 @@ static void ecl_region_select_k1k2__( ecl_region_type * region , int k1 , int k2
   k1 = util_int_max(0 , k1);
   k2 = util_int_min(region->grid_nz - 1 , k2);
   {
-    int i,j,k;
-    for (k = k1; k <= k2; k++)
-      for (j = 0; j < region->grid_ny; j++)
-        for (i = 0; i < region->grid_nx; i++) {
-          int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
-        }
+    int global_index = ecl_grid_get_global_index3( region->parent_grid , 0,0,k1);
+    ecl_region_set_range( region , global_index , global_index + (k2 - k1 + 1) * region->grid_nx * region->grid_ny , select );
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -815,14 +885,13 @@ static void ecl_region_select_from_depth__( ecl_region_type * region , double de
     if (select_deep) {
       // The select/deselect mechanism should be applied to deep cells.
       if (cell_depth >= depth_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to shallow cells.
       if (cell_depth <= depth_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -853,14 +922,13 @@ static void ecl_region_select_from_volume__( ecl_region_type * region , double v
     if (select_small) {
       // The select/deselect mechanism should be applied to small cells.
       if (cell_size <= volum_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to large cells.
       if (cell_size >= volum_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -889,14 +957,13 @@ static void ecl_region_select_from_dz__( ecl_region_type * region , double dz_li
     if (select_thin) {
       // The select/deselect mechanism should be applied to thin cells.
       if (cell_dz <= dz_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to thick cells.
       if (cell_dz >= dz_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -921,13 +988,12 @@ static void ecl_region_select_active_cells__( ecl_region_type * ecl_region , boo
   for (global_index = 0; global_index < ecl_region->grid_vol; global_index++) {
     if (select_active) {
       if (ecl_grid_get_active_index1( ecl_region->parent_grid , global_index) >= 0)
-        ecl_region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( ecl_region , global_index , select );
     } else {
       if (ecl_grid_get_active_index1( ecl_region->parent_grid , global_index) < 0)
-        ecl_region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( ecl_region , global_index , select );
     }
   }
-  ecl_region_invalidate_index_list( ecl_region );
 }
 
 
@@ -954,10 +1020,9 @@ void ecl_region_deselect_inactive_cells( ecl_region_type * region ) {
 
 static void ecl_region_select_global_index__( ecl_region_type * region , int global_index , bool select) {
   if ((global_index >= 0) && (global_index < region->grid_vol))
-    region->active_mask[ global_index ] = select;
+    ecl_region_set_bit( region , global_index , select );
   else
     util_abort("%s: global_index:%d invalid - legal interval: [0,%d) \n",__func__ , global_index , region->grid_vol);
-  ecl_region_invalidate_index_list( region );
 }
 
 void ecl_region_select_global_index( ecl_region_type * region , int global_index) {
@@ -993,9 +1058,9 @@ static void ecl_region_cylinder_select__( ecl_region_type * region , double x0 ,
       if ((z >= z1) && (z <= z2)) {
         double pointR2 = (x - x0) * (x - x0) + (y - y0) * (y - y0);
         if ((pointR2 < R2) && (select_inside))
-          region->active_mask[ global_index ] = select;
+          ecl_region_set_bit( region , global_index , select );
         else if ((pointR2 > R2) && (!select_inside))
-          region->active_mask[ global_index ] = select;
+          ecl_region_set_bit( region , global_index , select );
       }
     }
   } else {
@@ -1020,14 +1085,13 @@ static void ecl_region_cylinder_select__( ecl_region_type * region , double x0 ,
             int k;
             for (k=0; k < nz; k++) {
               int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-              region->active_mask[ global_index ] = select;
+              ecl_region_set_bit( region , global_index , select );
             }
           }
         }
       }
     }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -1074,12 +1138,11 @@ static void ecl_region_plane_select__( ecl_region_type * region, const double n[
       ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
       D = a*x + b*y + c*z + d;
       if ((D >= 0) && (select_above))
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
       else if ((D < 0) && (!select_above))
-        region->active_mask[ global_index ] = select;
+        ecl_region_set_bit( region , global_index , select );
     }
   }
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -1130,28 +1193,49 @@ static void ecl_region_polygon_select__( ecl_region_type * region ,
   const int define_k = 0;                  // The k-level where the polygon is checked.
   const int k1       = 0;                  // Selection range in k
   const int k2       = region->grid_nz;
+  const int num_columns = region->grid_nx * region->grid_ny;
+
+  geo_prepared_polygon_type * prepared = geo_prepared_polygon_alloc( polygon );
+  double * x = util_malloc( num_columns * sizeof * x );
+  double * y = util_malloc( num_columns * sizeof * y );
+  bool * inside = util_malloc( num_columns * sizeof * inside );
 
   {
     int i,j;
     for (i=0; i < region->grid_nx; i++) {
       for (j=0; j < region->grid_ny; j++) {
-        double x,y,z;
-        bool inside;
+        double z;
+        int column = i * region->grid_ny + j;
         int global_index = ecl_grid_get_global_index3( region->parent_grid , i , j , define_k);
 
-        ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
-        inside = geo_polygon_contains_point( polygon , x , y );
+        ecl_grid_get_xyz1( region->parent_grid , global_index , &x[column] , &y[column] , &z);
+      }
+    }
+  }
+
+  geo_prepared_polygon_contains_points( prepared , num_columns , x , y , inside );
+
+  {
+    int i,j;
+    for (i=0; i < region->grid_nx; i++) {
+      for (j=0; j < region->grid_ny; j++) {
+        int column = i * region->grid_ny + j;
 
-        if (select_inside == inside) {
+        if (select_inside == inside[column]) {
           int k;
           for (k=k1; k < k2; k++) {
-            global_index = ecl_grid_get_global_index3( region->parent_grid , i , j , k);
-            region->active_mask[ global_index ] = select;
+            int global_index = ecl_grid_get_global_index3( region->parent_grid , i , j , k);
+            ecl_region_set_bit( region , global_index , select );
           }
         }
       }
     }
   }
+
+  free( inside );
+  free( y );
+  free( x );
+  geo_prepared_polygon_free( prepared );
 }
 
 void ecl_region_select_inside_polygon( ecl_region_type * region , const geo_polygon_type * polygon) {
@@ -1178,10 +1262,9 @@ void ecl_region_deselect_outside_polygon( ecl_region_type * region , const geo_p
 static void ecl_region_select_active_index__( ecl_region_type * region , int active_index , bool select) {
   if ((active_index >= 0) && (active_index < region->grid_active)) {
     int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index);
-    region->active_mask[ global_index ] = select;
+    ecl_region_set_bit( region , global_index , select );
   } else
     util_abort("%s: active_index:%d invalid - legal interval: [0,%d) \n",__func__ , active_index , region->grid_vol);
-  ecl_region_invalidate_index_list( region );
 }
 
 
@@ -1206,13 +1289,10 @@ static void ecl_region_select_from_layer__( ecl_region_type * region , const lay
     int index;
     for (index = 0; index < int_vector_size( i_list ); index++) {
       int global_index = ecl_grid_get_global_index3( region->parent_grid , i[index] , j[index] , k);
-      region->active_mask[ global_index ] = select;
+      ecl_region_set_bit( region , global_index , select );
     }
 
   }
-  if (int_vector_size( i_list ) > 0)
-    ecl_region_invalidate_index_list( region );
-
   int_vector_free( i_list );
   int_vector_free( j_list );
 }
@@ -1229,10 +1309,9 @@ void ecl_region_deselect_from_layer( ecl_region_type * region , const layer_type
 /*****************************************************************/
 
 static void ecl_region_select_all__( ecl_region_type * region , bool select) {
-  int global_index;
-  for (global_index = 0; global_index < region->grid_vol; global_index++)
-    region->active_mask[ global_index ] = select;
-  ecl_region_invalidate_index_list( region );
+  int word;
+  for (word = 0; word < region->num_words; word++)
+    ecl_region_set_word( region , word , select ? ecl_region_valid_bits( region , word ) : 0 );
 }
 
 
@@ -1248,10 +1327,9 @@ void ecl_region_deselect_all( ecl_region_type * region ) {
 /*****************************************************************/
 
 void ecl_region_invert_selection( ecl_region_type * region ) {
-  int global_index;
-  for (global_index = 0; global_index < region->grid_vol; global_index++)
-    region->active_mask[ global_index ] = !region->active_mask[ global_index ];
-  ecl_region_invalidate_index_list( region );
+  int word;
+  for (word = 0; word < region->num_words; word++)
+    ecl_region_set_word( region , word , ~region->select_mask[word] & ecl_region_valid_bits( region , word ));
 }
 
 
@@ -1264,18 +1342,18 @@ void ecl_region_invert_selection( ecl_region_type * region ) {
 
 bool ecl_region_contains_ijk( const ecl_region_type * ecl_region , int i , int j , int k) {
   int global_index = ecl_grid_get_global_index3( ecl_region->parent_grid , i , j , k );
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_get_bit( ecl_region , global_index );
 }
 
 
 bool ecl_region_contains_global( const ecl_region_type * ecl_region , int global_index) {
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_get_bit( ecl_region , global_index );
 }
 
 
 bool ecl_region_contains_active( const ecl_region_type * ecl_region , int active_index) {
   int global_index = ecl_grid_get_global_index1A( ecl_region->parent_grid , active_index );
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_get_bit( ecl_region , global_index );
 }
 
 
@@ -1294,11 +1372,9 @@ bool ecl_region_contains_active( const ecl_region_type * ecl_region , int active
 
 void ecl_region_intersection( ecl_region_type * region , const ecl_region_type * new_region ) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] = (region->active_mask[global_index] && new_region->active_mask[global_index]);
-
-    ecl_region_invalidate_index_list( region );
+    int word;
+    for (word = 0; word < region->num_words; word++)
+      ecl_region_set_word( region , word , region->select_mask[word] & new_region->select_mask[word] );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1312,11 +1388,9 @@ void ecl_region_intersection( ecl_region_type * region , const ecl_region_type *
 */
 void ecl_region_union( ecl_region_type * region , const ecl_region_type * new_region ) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] = (region->active_mask[global_index] || new_region->active_mask[global_index]);
-
-    ecl_region_invalidate_index_list( region );
+    int word;
+    for (word = 0; word < region->num_words; word++)
+      ecl_region_set_word( region , word , region->select_mask[word] | new_region->select_mask[word] );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1330,11 +1404,9 @@ void ecl_region_union( ecl_region_type * region , const ecl_region_type * new_re
 */
 void ecl_region_subtract( ecl_region_type * region , const ecl_region_type * new_region) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] &= !new_region->active_mask[global_index];
-
-    ecl_region_invalidate_index_list( region );
+    int word;
+    for (word = 0; word < region->num_words; word++)
+      ecl_region_set_word( region , word , region->select_mask[word] & ~new_region->select_mask[word] );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1348,11 +1420,9 @@ void ecl_region_subtract( ecl_region_type * region , const ecl_region_type * new
 */
 void ecl_region_xor( ecl_region_type * region , const ecl_region_type * new_region) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] ^= !new_region->active_mask[global_index];
-
-    ecl_region_invalidate_index_list( region );
+    int word;
+    for (word = 0; word < region->num_words; word++)
+      ecl_region_set_word( region , word , (region->select_mask[word] ^ ~new_region->select_mask[word]) & ecl_region_valid_bits( region , word ) );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1485,7 +1555,7 @@ const char * ecl_region_get_name( const ecl_region_type * region ) {
 
 bool ecl_region_equal( const ecl_region_type * region1 , const ecl_region_type * region2) {
   if (region1->parent_grid == region2->parent_grid) {  // Must be exactly the same grid instance to compare as equal.
-    if (memcmp(region1->active_mask , region2->active_mask , region1->grid_vol * sizeof * region1->active_mask ) == 0)
+    if (memcmp(region1->select_mask , region2->select_mask , region1->num_words * sizeof * region1->select_mask ) == 0)
       return true;
     else
       return false;
@@ -92,31 +92,25 @@ static void ecl_rft_file_add_node(ecl_rft_file_type * rft_vector , const ecl_rft
 ecl_rft_file_type * ecl_rft_file_alloc(const char * filename) {
   ecl_rft_file_type * rft_vector = ecl_rft_file_alloc_empty( filename );
   ecl_file_type * ecl_file       = ecl_file_open( filename , 0);
+  ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( ecl_file_get_global_view( ecl_file ) , TIME_KW , TIME_KW );
+  ecl_file_view_type * rft_view;
   int global_index = 0;
-  int block_nr = 0;
-
-  while (true) {
-    ecl_file_view_type * rft_view = ecl_file_alloc_global_blockview(ecl_file, TIME_KW, block_nr);
-
-    if (rft_view) {
-      ecl_rft_node_type * rft_node = ecl_rft_node_alloc( rft_view );
-      if (rft_node != NULL) {
-        const char * well_name = ecl_rft_node_get_well_name( rft_node );
-        ecl_rft_file_add_node(rft_vector , rft_node);
-        if (!hash_has_key( rft_vector->well_index , well_name))
-          hash_insert_hash_owned_ref( rft_vector->well_index , well_name , int_vector_alloc( 0 , 0 ) , int_vector_free__);
-        {
-          int_vector_type * index_list = hash_get( rft_vector->well_index , well_name );
-          int_vector_append(index_list , global_index);
-        }
-        global_index++;
-      }
-    } else
-      break;
 
-    block_nr++;
-    ecl_file_view_free( rft_view );
+  while ((rft_view = ecl_file_view_block_iter_next( iter ))) {
+    ecl_rft_node_type * rft_node = ecl_rft_node_alloc( rft_view );
+    if (rft_node != NULL) {
+      const char * well_name = ecl_rft_node_get_well_name( rft_node );
+      ecl_rft_file_add_node(rft_vector , rft_node);
+      if (!hash_has_key( rft_vector->well_index , well_name))
+        hash_insert_hash_owned_ref( rft_vector->well_index , well_name , int_vector_alloc( 0 , 0 ) , int_vector_free__);
+      {
+        int_vector_type * index_list = hash_get( rft_vector->well_index , well_name );
+        int_vector_append(index_list , global_index);
+      }
+      global_index++;
+    }
   }
+  ecl_file_view_block_iter_free( iter );
   ecl_file_close( ecl_file );
   return rft_vector;
 }
@@ -329,8 +329,15 @@ int ecl_smspec_num_nodes( const ecl_smspec_type * smspec) {
   timestep has been added.
 */
 
+/*
+  An smspec instance can be shared between several ecl_sum instances
+  loading data concurrently; the flag is therefor only written when it
+  actually changes.
+*/
+
 void ecl_smspec_lock( ecl_smspec_type * smspec ) {
-  smspec->locked = true;
+  if (!smspec->locked)
+    smspec->locked = true;
 }
 
 
@@ -1165,6 +1172,24 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
 
 
 
+/*
+  Freezes the lookup table @hash, and the nested lookup tables @depth
+  levels down, so that the key lookups in a loaded smspec do not take
+  any locks.
+*/
+
+static void ecl_smspec_freeze_index( hash_type * hash , int depth ) {
+  hash_freeze( hash );
+  if (depth > 0) {
+    hash_iter_type * iter = hash_iter_alloc( hash );
+    while (!hash_iter_is_complete( iter ))
+      ecl_smspec_freeze_index( hash_iter_get_next_value( iter ) , depth - 1 );
+    hash_iter_free( iter );
+  }
+}
+
+
+
 ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart) {
   ecl_smspec_type *ecl_smspec;
 
@@ -1206,6 +1231,15 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
       util_abort("%s: Sorry the SMSPEC file seems to lack all time information, need either TIME, or DAY/MONTH/YEAR information. Can not proceed.",__func__);
       return NULL;
     }
+
+    ecl_smspec_freeze_index( ecl_smspec->well_var_index , 1 );
+    ecl_smspec_freeze_index( ecl_smspec->well_completion_var_index , 2 );
+    ecl_smspec_freeze_index( ecl_smspec->group_var_index , 1 );
+    ecl_smspec_freeze_index( ecl_smspec->field_var_index , 0 );
+    ecl_smspec_freeze_index( ecl_smspec->region_var_index , 1 );
+    ecl_smspec_freeze_index( ecl_smspec->misc_var_index , 0 );
+    ecl_smspec_freeze_index( ecl_smspec->block_var_index , 1 );
+    ecl_smspec_freeze_index( ecl_smspec->gen_var_index , 0 );
     return ecl_smspec;
   } else {
     /** Failed to load from disk. */
@@ -1683,7 +1717,11 @@ void ecl_smspec_select_matching_general_var_list( const ecl_smspec_type * smspec
   for (i=0; i < stringlist_get_size( keys ); i++)
     hash_insert_int( ex_keys , stringlist_iget( keys , i ) , 1);
 
-  {
+  if ((pattern != NULL) && (pattern[ strcspn( pattern , "*?[\\" ) ] == '\0')) {
+    /* No glob characters in the pattern; it can only match itself. */
+    if (hash_has_key( smspec->gen_var_index , pattern ) && !hash_has_key( ex_keys , pattern ))
+      stringlist_append_copy( keys , pattern );
+  } else {
     hash_iter_type * iter = hash_iter_alloc( smspec->gen_var_index );
     while (!hash_iter_is_complete( iter )) {
       const char * key = hash_iter_get_next_key( iter );
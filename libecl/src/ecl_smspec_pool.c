@@ -0,0 +1,230 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_smspec_pool.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/hash.h>
+#include <ert/util/stringlist.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#endif
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec_pool.h>
+
+/*
+  The SMSPEC files of the realizations in an ensemble are in most
+  cases identical. The ecl_smspec_pool keeps one internalized
+  ecl_smspec instance for each distinct SMSPEC file content, and the
+  ecl_sum instances loaded through the pool share that smspec instead
+  of parsing the header and building the smspec indices again.
+
+  The SMSPEC file is identified by its byte content; the content is
+  hashed for the lookup and compared in full on a hit. An SMSPEC file
+  with a RESTART reference to another case is never shared, because
+  the restart case is resolved relative to the location of the file.
+
+  The ecl_sum instances returned from the pool borrow the smspec, and
+  must be freed before the pool is freed. The pool can be used from
+  several threads concurrently.
+*/
+
+#define ECL_SMSPEC_POOL_TYPE_ID 6613087
+#define MAX_LAYOUTS             64
+
+typedef struct {
+  int               size;
+  char            * content;
+  ecl_smspec_type * smspec;    /* NULL if the SMSPEC file can not be shared. */
+} smspec_layout_type;
+
+
+struct ecl_smspec_pool_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  char            * key_join_string;
+  hash_type       * layouts;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t   lock;
+#endif
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_smspec_pool , ECL_SMSPEC_POOL_TYPE_ID )
+
+
+static void smspec_layout_free( smspec_layout_type * layout ) {
+  if (layout->smspec)
+    ecl_smspec_free( layout->smspec );
+  free( layout->content );
+  free( layout );
+}
+
+
+static void smspec_layout_free__( void * arg ) {
+  smspec_layout_free( arg );
+}
+
+
+static char * ecl_smspec_pool_alloc_signature( const char * content , int size ) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (int i = 0; i < size; i++) {
+    hash ^= (unsigned char) content[i];
+    hash *= 1099511628211ULL;
+  }
+  return util_alloc_sprintf("%d:%016llx" , size , (unsigned long long) hash);
+}
+
+
+ecl_smspec_pool_type * ecl_smspec_pool_alloc( const char * key_join_string ) {
+  ecl_smspec_pool_type * pool = util_malloc( sizeof * pool );
+  UTIL_TYPE_ID_INIT( pool , ECL_SMSPEC_POOL_TYPE_ID );
+  pool->key_join_string = util_alloc_string_copy( key_join_string );
+  pool->layouts = hash_alloc();
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &pool->lock , NULL );
+#endif
+  return pool;
+}
+
+
+void ecl_smspec_pool_free( ecl_smspec_pool_type * pool ) {
+  hash_free( pool->layouts );
+  free( pool->key_join_string );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &pool->lock );
+#endif
+  free( pool );
+}
+
+
+/*
+  Returns the number of distinct SMSPEC layouts which have been
+  internalized by the pool.
+*/
+
+int ecl_smspec_pool_get_size( const ecl_smspec_pool_type * pool ) {
+  return hash_get_size( pool->layouts );
+}
+
+
+/*
+  Will return the shared smspec for the SMSPEC file @header_file, or
+  NULL if the file can not be shared. The content of the file is read
+  outside the lock, whereas the parsing of a new layout is done while
+  holding the lock, so that concurrent loaders of the same layout wait
+  for the first one instead of parsing the header several times.
+*/
+
+static const ecl_smspec_type * ecl_smspec_pool_get_smspec( ecl_smspec_pool_type * pool , const char * header_file ) {
+  const ecl_smspec_type * smspec = NULL;
+  int size;
+  char * content = util_fread_alloc_file_content( header_file , &size );
+  char * signature = ecl_smspec_pool_alloc_signature( content , size );
+
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &pool->lock );
+#endif
+  if (hash_has_key( pool->layouts , signature )) {
+    const smspec_layout_type * layout = hash_get( pool->layouts , signature );
+    if ((layout->size == size) && (memcmp( layout->content , content , size ) == 0))
+      smspec = layout->smspec;
+    free( content );
+  } else if (hash_get_size( pool->layouts ) < MAX_LAYOUTS) {
+    smspec_layout_type * layout = util_malloc( sizeof * layout );
+    layout->size = size;
+    layout->content = content;
+    layout->smspec = ecl_smspec_fread_alloc( header_file , pool->key_join_string , true );
+
+    if (layout->smspec && ecl_smspec_get_restart_case( layout->smspec )) {
+      ecl_smspec_free( layout->smspec );
+      layout->smspec = NULL;
+    }
+
+    /*
+      The smspec is locked up front; the ecl_sum_data loader will lock
+      it when data has been loaded, and the flag should not be
+      modified while several threads are using the smspec.
+    */
+    if (layout->smspec)
+      ecl_smspec_lock( layout->smspec );
+
+    hash_insert_hash_owned_ref( pool->layouts , signature , layout , smspec_layout_free__ );
+    smspec = layout->smspec;
+  } else
+    free( content );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &pool->lock );
+#endif
+
+  free( signature );
+  return smspec;
+}
+
+
+/*
+  Equivalent to ecl_sum_fread_alloc(), but the returned ecl_sum
+  instance will use a shared smspec when possible. Returns NULL if the
+  data can not be loaded.
+*/
+
+ecl_sum_type * ecl_smspec_pool_fread_alloc_sum( ecl_smspec_pool_type * pool , const char * header_file , const stringlist_type * data_files ) {
+  const ecl_smspec_type * smspec = ecl_smspec_pool_get_smspec( pool , header_file );
+  if (smspec)
+    return ecl_sum_fread_alloc_shared_smspec( header_file , data_files , pool->key_join_string , smspec );
+  else
+    return ecl_sum_fread_alloc( header_file , data_files , pool->key_join_string );
+}
+
+
+/*
+  Equivalent to ecl_sum_fread_alloc_case(); a case with restart
+  history is loaded with a private smspec through
+  ecl_sum_fread_alloc_case().
+*/
+
+ecl_sum_type * ecl_smspec_pool_fread_alloc_case( ecl_smspec_pool_type * pool , const char * input_file ) {
+  ecl_sum_type * ecl_sum = NULL;
+  char * path , * base , * ext;
+  char * header_file = NULL;
+  stringlist_type * data_files = stringlist_alloc_new();
+
+  util_alloc_file_components( input_file , &path , &base , &ext );
+  ecl_util_alloc_summary_files( path , base , ext , &header_file , data_files );
+  if ((header_file != NULL) && (stringlist_get_size( data_files ) > 0)) {
+    const ecl_smspec_type * smspec = ecl_smspec_pool_get_smspec( pool , header_file );
+    if (smspec) {
+      ecl_sum = ecl_sum_fread_alloc_shared_smspec( header_file , data_files , pool->key_join_string , smspec );
+      if (ecl_sum)
+        ecl_sum_set_case( ecl_sum , input_file );
+    } else
+      ecl_sum = ecl_sum_fread_alloc_case( input_file , pool->key_join_string );
+  }
+
+  util_safe_free( header_file );
+  util_safe_free( path );
+  util_safe_free( base );
+  util_safe_free( ext );
+  stringlist_free( data_files );
+  return ecl_sum;
+}
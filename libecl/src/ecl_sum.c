@@ -37,6 +37,7 @@
 #include <ert/ecl/ecl_sum.h>
 #include <ert/ecl/ecl_smspec.h>
 #include <ert/ecl/ecl_sum_data.h>
+#include <ert/ecl/ecl_sum_vector.h>
 #include <ert/ecl/smspec_node.h>
 
 
@@ -94,6 +95,8 @@
 struct ecl_sum_struct {
   UTIL_TYPE_ID_DECLARATION;
   ecl_smspec_type   * smspec;     /* Internalized version of the SMSPEC file. */
+  bool                shared_smspec; /* If true the smspec is owned by someone else, e.g. an ecl_smspec_pool instance. */
+  char              * header_file;   /* The header file this case was loaded from - can be NULL. */
   ecl_sum_data_type * data;       /* The data - can be NULL. */
 
 
@@ -162,6 +165,8 @@ static ecl_sum_type * ecl_sum_alloc__( const char * input_arg , const char * key
 
   ecl_sum->smspec = NULL;
   ecl_sum->data   = NULL;
+  ecl_sum->shared_smspec = false;
+  ecl_sum->header_file   = NULL;
 
   return ecl_sum;
 }
@@ -192,14 +197,14 @@ static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
 
 
 
-static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
-  ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
-  if (ecl_sum->smspec) {
+static bool ecl_sum_fread_data_files(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
+  {
     bool fmt_file;
     ecl_util_get_file_type( header_file , &fmt_file , NULL);
     ecl_sum_set_fmt_case( ecl_sum , fmt_file );
-  } else
-    return false;
+  }
+  util_safe_free( ecl_sum->header_file );
+  ecl_sum->header_file = util_alloc_realpath( header_file );
 
   if (ecl_sum_fread_data( ecl_sum , data_files , include_restart )) {
     ecl_file_enum file_type = ecl_util_get_file_type( stringlist_iget( data_files , 0 ) , NULL , NULL);
@@ -213,6 +218,18 @@ static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , con
   } else
     return false;
 
+  return true;
+}
+
+
+static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
+  ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
+  if (ecl_sum->smspec == NULL)
+    return false;
+
+  if (!ecl_sum_fread_data_files( ecl_sum , header_file , data_files , include_restart ))
+    return false;
+
   if (include_restart && ecl_smspec_get_restart_case( ecl_sum->smspec ))
     ecl_sum_fread_history( ecl_sum );
 
@@ -254,6 +271,29 @@ ecl_sum_type * ecl_sum_fread_alloc(const char *header_file , const stringlist_ty
   return ecl_sum;
 }
 
+
+/**
+   Will load the summary data in @data_files using an smspec instance
+   which has already been loaded, typically from an identical SMSPEC
+   file in another case. The ecl_sum instance does NOT take ownership
+   of the smspec, which must stay alive for the lifetime of the
+   ecl_sum instance. Restart history is not loaded; the function
+   returns NULL if the data can not be loaded.
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_shared_smspec(const char *header_file , const stringlist_type *data_files , const char * key_join_string , const ecl_smspec_type * smspec) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc__( header_file , key_join_string );
+  ecl_sum->smspec = (ecl_smspec_type *) smspec;
+  ecl_sum->shared_smspec = true;
+
+  if (ecl_sum_fread_data_files( ecl_sum , header_file , data_files , false ))
+    return ecl_sum;
+  else {
+    ecl_sum_free( ecl_sum );
+    return NULL;
+  }
+}
+
 /*****************************************************************/
 
 void ecl_sum_set_unified( ecl_sum_type * ecl_sum , bool unified ) {
@@ -266,6 +306,16 @@ void ecl_sum_set_fmt_case( ecl_sum_type * ecl_sum , bool fmt_case ) {
 }
 
 
+bool ecl_sum_get_unified( const ecl_sum_type * ecl_sum ) {
+  return ecl_sum->unified;
+}
+
+
+bool ecl_sum_get_fmt_case( const ecl_sum_type * ecl_sum ) {
+  return ecl_sum->fmt_case;
+}
+
+
 void ecl_sum_init_var( ecl_sum_type * ecl_sum , smspec_node_type * smspec_node , const char * keyword , const char * wgname , int num , const char * unit) {
   ecl_smspec_init_var( ecl_sum->smspec , smspec_node , keyword , wgname , num, unit );
 }
@@ -345,9 +395,11 @@ void ecl_sum_free( ecl_sum_type * ecl_sum ) {
   if (ecl_sum->data != NULL)
     ecl_sum_free_data( ecl_sum );
 
-  if (ecl_sum->smspec != NULL)
+  if ((ecl_sum->smspec != NULL) && !ecl_sum->shared_smspec)
     ecl_smspec_free( ecl_sum->smspec );
 
+  util_safe_free( ecl_sum->header_file );
+
   util_safe_free( ecl_sum->path );
   util_safe_free( ecl_sum->ext );
   util_safe_free( ecl_sum->abs_path );
@@ -1051,6 +1103,84 @@ void ecl_sum_export_csv(const ecl_sum_type * ecl_sum , const char * filename  ,
 
 
 
+/*
+  Creates the key list used by the resample export functions; keys
+  which are not found in the summary are skipped with a warning. The
+  keys which are found are appended to @found_keys.
+*/
+
+static ecl_sum_vector_type * ecl_sum_alloc_resample_keylist( const ecl_sum_type * ecl_sum , const stringlist_type * var_list , stringlist_type * found_keys) {
+  ecl_sum_vector_type * keylist = ecl_sum_vector_alloc( ecl_sum );
+  int ivar;
+  for (ivar = 0; ivar < stringlist_get_size( var_list ); ivar++) {
+    const char * var = stringlist_iget( var_list , ivar );
+    if (ecl_sum_vector_add_key( keylist , var ))
+      stringlist_append_ref( found_keys , var );
+    else
+      fprintf(stderr,"** Warning: could not find variable: \'%s\' in summary file \n", var);
+  }
+  return keylist;
+}
+
+
+/**
+   Exports the variables in @var_list, resampled to the sorted times
+   in @sim_time, as CSV. The first column is the date formatted with
+   @date_format, and the first line is a header with the variable
+   names.
+*/
+
+void ecl_sum_export_resample_csv(const ecl_sum_type * ecl_sum , const char * filename , const time_t_vector_type * sim_time , const stringlist_type * var_list , const char * date_format , const char * sep) {
+  FILE * stream = util_mkdir_fopen(filename , "w");
+  stringlist_type * found_keys = stringlist_alloc_new( );
+  ecl_sum_vector_type * keylist = ecl_sum_alloc_resample_keylist( ecl_sum , var_list , found_keys );
+
+  fprintf(stream , "DATE");
+  {
+    int i;
+    for (i = 0; i < stringlist_get_size( found_keys ); i++)
+      fprintf(stream , "%s%s" , sep , stringlist_iget( found_keys , i ));
+  }
+  fprintf(stream , "\n");
+
+  ecl_sum_data_fwrite_resample_csv( ecl_sum->data , sim_time , keylist , date_format , sep , stream );
+
+  ecl_sum_vector_free( keylist );
+  stringlist_free( found_keys );
+  fclose( stream );
+}
+
+
+/**
+   As ecl_sum_export_resample_csv(), but the values are written as
+   native doubles without any header; the file holds
+   time_t_vector_size( sim_time ) rows of one value for each of the
+   variables in @var_list, in that order. Since the file does not
+   describe its own layout, all the variables must exist in the
+   summary; the function will abort otherwise.
+*/
+
+void ecl_sum_export_resample_binary(const ecl_sum_type * ecl_sum , const char * filename , const time_t_vector_type * sim_time , const stringlist_type * var_list) {
+  ecl_sum_vector_type * keylist = ecl_sum_vector_alloc( ecl_sum );
+  {
+    int ivar;
+    for (ivar = 0; ivar < stringlist_get_size( var_list ); ivar++) {
+      const char * var = stringlist_iget( var_list , ivar );
+      if (!ecl_sum_vector_add_key( keylist , var ))
+        util_abort("%s: could not find variable: \'%s\' in summary file \n",__func__ , var);
+    }
+  }
+
+  {
+    FILE * stream = util_mkdir_fopen(filename , "w");
+    ecl_sum_data_fwrite_resample_binary( ecl_sum->data , sim_time , keylist , stream );
+    fclose( stream );
+  }
+  ecl_sum_vector_free( keylist );
+}
+
+
+
 const char * ecl_sum_get_case(const ecl_sum_type * ecl_sum) {
   return ecl_sum->ecl_case;
 }
@@ -1092,7 +1222,8 @@ bool ecl_sum_same_case( const ecl_sum_type * ecl_sum , const char * input_file )
       bool   fmt_file = ecl_smspec_get_formatted( ecl_sum->smspec );
       char * header_file = ecl_util_alloc_exfilename( path , base , ECL_SUMMARY_HEADER_FILE , fmt_file , -1 );
       if (header_file != NULL) {
-        same_case = util_same_file( header_file , ecl_smspec_get_header_file( ecl_sum->smspec ));
+        const char * own_header = ecl_sum->header_file ? ecl_sum->header_file : ecl_smspec_get_header_file( ecl_sum->smspec );
+        same_case = util_same_file( header_file , own_header );
         free( header_file );
       }
     }
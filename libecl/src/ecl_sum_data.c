@@ -17,6 +17,7 @@
 */
 
 #include <string.h>
+#include <math.h>
 
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
@@ -1216,37 +1217,338 @@ double ecl_sum_data_interp_get(const ecl_sum_data_type * data , int time_index1
 }
 
 
-void ecl_sum_data_fwrite_interp_csv_line(const ecl_sum_data_type * data , time_t sim_time, const ecl_sum_vector_type * keylist, FILE *fp){
-    int num_keywords = ecl_sum_vector_get_size(keylist);
-    double weight1 , weight2;
-    int    time_index1 , time_index2;
-    double value = 0.0;
-    int i;
+/*****************************************************************/
+/*
+  Resampling of several keys to a common time axis
+  ------------------------------------------------
+
+  The functions below evaluate a list of keys (ecl_sum_vector) at a
+  sorted list of target times. For each target time the bracketing
+  ministeps and the interpolation weights are found once, and then
+  all the keys are evaluated from the same pair of ministeps. Since
+  the target times are sorted, the ministeps and the targets are
+  walked in one merge; no binary search is needed.
+
+  The results are identical to ecl_sum_data_get_from_sim_time():
+  rates are taken from the ministep covering the target time, and
+  other variables are interpolated linearly between the two
+  bracketing ministeps. At the first ministep, where there is no
+  previous ministep to interpolate from, the value of the first
+  ministep is used.
+*/
 
-    ecl_sum_data_init_interp_from_sim_time( data , sim_time , &time_index1 , &time_index2 , &weight1 , &weight2);
-    for(i = 0; i< num_keywords; i++  ){
-        bool is_rate = ecl_sum_vector_iget_is_rate(keylist, i);
-        int params_index = ecl_sum_vector_iget_param_index(keylist , i);
-        if(is_rate){
-            int time_index;
-            if (sim_time == time_interval_get_start( data->sim_time ))
-                time_index = 0;
-            else
-                time_index = ecl_sum_data_get_index_from_sim_time( data , sim_time );
+typedef struct {
+  int    index1;
+  int    index2;
+  double weight1;
+  double weight2;
+  int    rate_index;
+} ecl_sum_interp_type;
 
-           value = ecl_sum_data_iget( data , time_index , params_index);
-        } else {
-           value = ecl_sum_data_interp_get( data , time_index1 , time_index2 , weight1 , weight2 , params_index);
 
-        }
-        if(i == 0){
-            fprintf(fp , "%f",value);
-        }else{
-            fprintf(fp , ",%f",value);
-        }
+static void ecl_sum_data_init_interp( const ecl_sum_data_type * data , time_t sim_time , int index2 , ecl_sum_interp_type * interp) {
+  interp->index2 = index2;
+  if (sim_time == time_interval_get_start( data->sim_time ))
+    interp->rate_index = 0;
+  else
+    interp->rate_index = index2;
+
+  if (index2 == 0) {
+    interp->index1  = 0;
+    interp->weight1 = 1;
+    interp->weight2 = 0;
+  } else {
+    const ecl_sum_tstep_type * ministep1 = ecl_sum_data_iget_ministep( data , index2 - 1 );
+    const ecl_sum_tstep_type * ministep2 = ecl_sum_data_iget_ministep( data , index2 );
+    double  weight2    =  (sim_time - ecl_sum_tstep_get_sim_time( ministep1 ));
+    double  weight1    = -(sim_time - ecl_sum_tstep_get_sim_time( ministep2 ));
+
+    interp->index1  = index2 - 1;
+    interp->weight1 = weight1 / ( weight1 + weight2 );
+    interp->weight2 = weight2 / ( weight1 + weight2 );
+  }
+}
+
+
+static double ecl_sum_data_interp_value( const ecl_sum_tstep_type * ministep1 , const ecl_sum_tstep_type * ministep2 , const ecl_sum_tstep_type * rate_step , const ecl_sum_interp_type * interp , int params_index , bool is_rate) {
+  if (is_rate)
+    return ecl_sum_tstep_iget( rate_step , params_index );
+  else
+    return ecl_sum_tstep_iget( ministep1 , params_index ) * interp->weight1 + ecl_sum_tstep_iget( ministep2 , params_index ) * interp->weight2;
+}
+
+
+static void ecl_sum_data_interp_row( const ecl_sum_data_type * data , const ecl_sum_interp_type * interp , int num_keys , const int * params_index , const bool * is_rate , double * row) {
+  const ecl_sum_tstep_type * ministep1 = ecl_sum_data_iget_ministep( data , interp->index1 );
+  const ecl_sum_tstep_type * ministep2 = ecl_sum_data_iget_ministep( data , interp->index2 );
+  const ecl_sum_tstep_type * rate_step = ecl_sum_data_iget_ministep( data , interp->rate_index );
+  int i;
+
+  for (i = 0; i < num_keys; i++)
+    row[i] = ecl_sum_data_interp_value( ministep1 , ministep2 , rate_step , interp , params_index[i] , is_rate[i] );
+}
+
+
+typedef void (ecl_sum_resample_ftype) ( time_t sim_time , int num_keys , const double * row , void * arg );
+
+
+static void ecl_sum_data_resample__( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , ecl_sum_resample_ftype * emit_row , void * arg) {
+  int num_keys = ecl_sum_vector_get_size( keylist );
+  int num_ministep = vector_get_size( data->data );
+  int * params_index = util_calloc( num_keys , sizeof * params_index );
+  bool * is_rate = util_calloc( num_keys , sizeof * is_rate );
+  double * row = util_calloc( num_keys , sizeof * row );
+  int index = 0;
+  int i;
+
+  for (i = 0; i < num_keys; i++) {
+    params_index[i] = ecl_sum_vector_iget_param_index( keylist , i );
+    is_rate[i]      = ecl_sum_vector_iget_is_rate( keylist , i );
+  }
+
+  for (i = 0; i < time_t_vector_size( sim_time ); i++) {
+    time_t t = time_t_vector_iget( sim_time , i );
+    ecl_sum_interp_type interp;
+
+    if (!ecl_sum_data_check_sim_time( data , t ))
+      util_abort("%s: time:%d outside the simulated time interval [%d,%d] \n",__func__ , t , time_interval_get_start( data->sim_time ) , time_interval_get_end( data->sim_time ));
+
+    if ((i > 0) && (t < time_t_vector_iget( sim_time , i - 1 )))
+      util_abort("%s: the target times must be sorted \n",__func__);
+
+    while ((index < num_ministep - 1) && (ecl_sum_tstep_get_sim_time( ecl_sum_data_iget_ministep( data , index )) < t))
+      index++;
+
+    ecl_sum_data_init_interp( data , t , index , &interp );
+    ecl_sum_data_interp_row( data , &interp , num_keys , params_index , is_rate , row );
+    emit_row( t , num_keys , row , arg );
+  }
+
+  free( row );
+  free( is_rate );
+  free( params_index );
+}
+
+
+static void ecl_sum_data_resample_store( time_t sim_time , int num_keys , const double * row , void * arg ) {
+  double ** values = arg;
+  memcpy( *values , row , num_keys * sizeof * row );
+  *values += num_keys;
+}
+
+
+/**
+   Evaluates all the keys in @keylist at all the (sorted) times in
+   @sim_time. The results are stored row by row in @values, which must
+   hold time_t_vector_size( sim_time ) * ecl_sum_vector_get_size(
+   keylist ) elements; i.e. values[time_nr * num_keys + key_nr].
+*/
+
+void ecl_sum_data_resample( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , double * values) {
+  ecl_sum_data_resample__( data , sim_time , keylist , ecl_sum_data_resample_store , &values );
+}
+
+
+/*
+  Buffered formatting of the CSV output. The values are formatted
+  exactly as printf("%f"); the common case is formatted directly
+  from an integer, and only values which are very large, or so close
+  to a rounding boundary that the scaling could change the last
+  digit, are formatted with snprintf().
+*/
+
+#define CSV_BUFFER_SIZE       (1 << 16)
+#define CSV_LINE_BUFFER_SIZE  4096
+#define CSV_MAX_FIELD         400       /* printf("%f") of the largest double is ~317 characters. */
+
+typedef struct {
+  FILE       * stream;
+  char       * buffer;
+  int          capacity;
+  int          size;
+  const char * date_format;
+  const char * sep;
+} ecl_sum_csv_writer_type;
+
+
+static void ecl_sum_csv_writer_reserve( ecl_sum_csv_writer_type * writer , int length ) {
+  if (writer->size + length > writer->capacity) {
+    util_fwrite( writer->buffer , 1 , writer->size , writer->stream , __func__ );
+    writer->size = 0;
+  }
+}
+
+
+static void ecl_sum_csv_writer_add_string( ecl_sum_csv_writer_type * writer , const char * s ) {
+  int length = strlen( s );
+  if (length > writer->capacity) {
+    ecl_sum_csv_writer_reserve( writer , writer->capacity );
+    util_fwrite( s , 1 , length , writer->stream , __func__ );
+  } else {
+    ecl_sum_csv_writer_reserve( writer , length );
+    memcpy( &writer->buffer[writer->size] , s , length );
+    writer->size += length;
+  }
+}
+
+
+static void ecl_sum_csv_writer_add_double( ecl_sum_csv_writer_type * writer , double value ) {
+  char * p;
+  double scaled = value * 1e6;
+
+  ecl_sum_csv_writer_reserve( writer , CSV_MAX_FIELD );
+  p = &writer->buffer[writer->size];
+  if (fabs( scaled ) < 1e12) {
+    double rounded = nearbyint( scaled );
+    if (fabs( fabs( scaled - rounded ) - 0.5 ) > 1e-3) {
+      long long int ivalue = llabs( (long long int) rounded );
+      long long int int_part = ivalue / 1000000;
+      int frac_part = ivalue % 1000000;
+      char digits[24];
+      int num_digits = 0;
+      int i;
+
+      if (signbit( value ))
+        *p++ = '-';
+
+      do {
+        digits[num_digits++] = '0' + (int) (int_part % 10);
+        int_part /= 10;
+      } while (int_part > 0);
+
+      while (num_digits > 0)
+        *p++ = digits[--num_digits];
+
+      *p++ = '.';
+      for (i = 5; i >= 0; i--) {
+        p[i] = '0' + frac_part % 10;
+        frac_part /= 10;
+      }
+      p += 6;
+      writer->size = p - writer->buffer;
+      return;
     }
+  }
+
+  writer->size += snprintf( p , CSV_MAX_FIELD , "%f" , value );
+}
+
+
+static void ecl_sum_csv_writer_add_row( ecl_sum_csv_writer_type * writer , int num_keys , const double * row ) {
+  int i;
+  for (i = 0; i < num_keys; i++) {
+    if (i > 0)
+      ecl_sum_csv_writer_add_string( writer , writer->sep );
+    ecl_sum_csv_writer_add_double( writer , row[i] );
+  }
+}
+
+
+static void ecl_sum_csv_writer_emit_row( time_t sim_time , int num_keys , const double * row , void * arg ) {
+  ecl_sum_csv_writer_type * writer = arg;
+  if (writer->date_format) {
+    char date_string[128];
+    struct tm ts;
+    util_time_utc( &sim_time , &ts );
+    strftime( date_string , sizeof date_string , writer->date_format , &ts );
+    ecl_sum_csv_writer_add_string( writer , date_string );
+    if (num_keys > 0)
+      ecl_sum_csv_writer_add_string( writer , writer->sep );
+  }
+  ecl_sum_csv_writer_add_row( writer , num_keys , row );
+  ecl_sum_csv_writer_add_string( writer , "\n" );
+}
+
+
+/*
+  The @buffer, which must hold at least CSV_MAX_FIELD bytes, is owned
+  by the caller.
+*/
+
+static void ecl_sum_csv_writer_init( ecl_sum_csv_writer_type * writer , FILE * stream , char * buffer , int capacity , const char * date_format , const char * sep) {
+  writer->stream = stream;
+  writer->buffer = buffer;
+  writer->capacity = capacity;
+  writer->size = 0;
+  writer->date_format = date_format;
+  writer->sep = sep;
+}
+
+
+static void ecl_sum_csv_writer_flush( ecl_sum_csv_writer_type * writer ) {
+  if (writer->size > 0)
+    util_fwrite( writer->buffer , 1 , writer->size , writer->stream , __func__ );
+  writer->size = 0;
+}
+
+
+/**
+   Writes one CSV line for every time in the sorted vector @sim_time;
+   the line starts with the time formatted with strftime(@date_format)
+   - unless @date_format is NULL - followed by the values of all the
+   keys in @keylist. The fields are separated with @sep.
+*/
+
+void ecl_sum_data_fwrite_resample_csv( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , const char * date_format , const char * sep , FILE * stream) {
+  char * buffer = util_malloc( CSV_BUFFER_SIZE );
+  ecl_sum_csv_writer_type writer;
+
+  ecl_sum_csv_writer_init( &writer , stream , buffer , CSV_BUFFER_SIZE , date_format , sep );
+  ecl_sum_data_resample__( data , sim_time , keylist , ecl_sum_csv_writer_emit_row , &writer );
+  ecl_sum_csv_writer_flush( &writer );
+  free( buffer );
+}
+
+
+static void ecl_sum_data_resample_fwrite_row( time_t sim_time , int num_keys , const double * row , void * arg ) {
+  util_fwrite( row , sizeof * row , num_keys , arg , __func__ );
+}
+
+
+/**
+   Writes the resampled values as native doubles, row by row; i.e.
+   the same layout as ecl_sum_data_resample().
+*/
+
+void ecl_sum_data_fwrite_resample_binary( const ecl_sum_data_type * data , const time_t_vector_type * sim_time , const ecl_sum_vector_type * keylist , FILE * stream) {
+  ecl_sum_data_resample__( data , sim_time , keylist , ecl_sum_data_resample_fwrite_row , stream );
+}
+
+
+/*
+  Called once for every output row by e.g. EclSum.dumpCSVLine(), so the
+  row is formatted directly: one binary search for the ministep, and
+  no heap allocations.
+*/
+
+void ecl_sum_data_fwrite_interp_csv_line(const ecl_sum_data_type * data , time_t sim_time, const ecl_sum_vector_type * keylist, FILE *fp){
+  char buffer[CSV_LINE_BUFFER_SIZE];
+  ecl_sum_csv_writer_type writer;
+  ecl_sum_interp_type interp;
+
+  ecl_sum_data_init_interp( data , sim_time , ecl_sum_data_get_index_from_sim_time( data , sim_time ) , &interp );
+  ecl_sum_csv_writer_init( &writer , fp , buffer , sizeof buffer , NULL , "," );
+  {
+    const ecl_sum_tstep_type * ministep1 = ecl_sum_data_iget_ministep( data , interp.index1 );
+    const ecl_sum_tstep_type * ministep2 = ecl_sum_data_iget_ministep( data , interp.index2 );
+    const ecl_sum_tstep_type * rate_step = ecl_sum_data_iget_ministep( data , interp.rate_index );
+    int i;
+
+    for (i = 0; i < ecl_sum_vector_get_size( keylist ); i++) {
+      double value = ecl_sum_data_interp_value( ministep1 , ministep2 , rate_step , &interp ,
+                                                ecl_sum_vector_iget_param_index( keylist , i ) ,
+                                                ecl_sum_vector_iget_is_rate( keylist , i ));
+      if (i > 0)
+        ecl_sum_csv_writer_add_string( &writer , writer.sep );
+      ecl_sum_csv_writer_add_double( &writer , value );
+    }
+  }
+  ecl_sum_csv_writer_flush( &writer );
 }
 
+#undef CSV_BUFFER_SIZE
+#undef CSV_LINE_BUFFER_SIZE
+#undef CSV_MAX_FIELD
 
 
 
@@ -0,0 +1,235 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_ensemble.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/bool_vector.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/smspec_node.h>
+#include <ert/ecl/ecl_smspec_pool.h>
+#include <ert/ecl/ecl_sum_ensemble.h>
+
+/*
+  The ecl_sum_ensemble is a collection of ecl_sum instances for the
+  realizations of an ensemble. The cases are loaded concurrently, and
+  all the cases with identical SMSPEC files share one ecl_smspec
+  instance through an ecl_smspec_pool. Cases which can not be loaded
+  are represented with NULL.
+*/
+
+#define ECL_SUM_ENSEMBLE_TYPE_ID 6613088
+
+struct ecl_sum_ensemble_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                    size;
+  stringlist_type      * case_list;
+  ecl_sum_type        ** ecl_sum;
+  ecl_smspec_pool_type * smspec_pool;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_sum_ensemble , ECL_SUM_ENSEMBLE_TYPE_ID )
+
+
+static void ecl_sum_ensemble_load_case( int iens , void * arg ) {
+  ecl_sum_ensemble_type * ensemble = arg;
+  ensemble->ecl_sum[iens] = ecl_smspec_pool_fread_alloc_case( ensemble->smspec_pool , stringlist_iget( ensemble->case_list , iens ));
+}
+
+
+/*
+  Will load all the cases in @case_list using @num_threads threads;
+  the cases in the ensemble are in the same order as in case_list.
+*/
+
+ecl_sum_ensemble_type * ecl_sum_ensemble_fread_alloc( const stringlist_type * case_list , const char * key_join_string , int num_threads) {
+  ecl_sum_ensemble_type * ensemble = util_malloc( sizeof * ensemble );
+  UTIL_TYPE_ID_INIT( ensemble , ECL_SUM_ENSEMBLE_TYPE_ID );
+  ensemble->size = stringlist_get_size( case_list );
+  ensemble->case_list = stringlist_alloc_deep_copy( case_list );
+  ensemble->ecl_sum = util_calloc( util_int_max( 1 , ensemble->size ) , sizeof * ensemble->ecl_sum );
+  ensemble->smspec_pool = ecl_smspec_pool_alloc( key_join_string );
+
+  for (int iens = 0; iens < ensemble->size; iens++)
+    ensemble->ecl_sum[iens] = NULL;
+
+#ifdef ERT_HAVE_THREAD_POOL
+  if ((num_threads > 1) && (ensemble->size > 1)) {
+    thread_pool_type * tp = thread_pool_alloc( num_threads , true );
+    thread_pool_parallel_for( tp , 0 , ensemble->size , ecl_sum_ensemble_load_case , ensemble );
+    thread_pool_free( tp );
+  } else
+#endif
+  {
+    for (int iens = 0; iens < ensemble->size; iens++)
+      ecl_sum_ensemble_load_case( iens , ensemble );
+  }
+
+  return ensemble;
+}
+
+
+void ecl_sum_ensemble_free( ecl_sum_ensemble_type * ensemble ) {
+  for (int iens = 0; iens < ensemble->size; iens++) {
+    if (ensemble->ecl_sum[iens])
+      ecl_sum_free( ensemble->ecl_sum[iens] );
+  }
+  free( ensemble->ecl_sum );
+  ecl_smspec_pool_free( ensemble->smspec_pool );
+  stringlist_free( ensemble->case_list );
+  free( ensemble );
+}
+
+
+int ecl_sum_ensemble_get_size( const ecl_sum_ensemble_type * ensemble ) {
+  return ensemble->size;
+}
+
+
+int ecl_sum_ensemble_get_num_loaded( const ecl_sum_ensemble_type * ensemble ) {
+  int num_loaded = 0;
+  for (int iens = 0; iens < ensemble->size; iens++) {
+    if (ensemble->ecl_sum[iens])
+      num_loaded++;
+  }
+  return num_loaded;
+}
+
+
+/*
+  The number of distinct SMSPEC files found in the ensemble.
+*/
+
+int ecl_sum_ensemble_get_num_layouts( const ecl_sum_ensemble_type * ensemble ) {
+  return ecl_smspec_pool_get_size( ensemble->smspec_pool );
+}
+
+
+const ecl_sum_type * ecl_sum_ensemble_iget( const ecl_sum_ensemble_type * ensemble , int iens) {
+  if ((iens < 0) || (iens >= ensemble->size))
+    util_abort("%s: invalid index:%d  valid range: [0,%d) \n",__func__ , iens , ensemble->size);
+
+  return ensemble->ecl_sum[iens];
+}
+
+
+const char * ecl_sum_ensemble_iget_case( const ecl_sum_ensemble_type * ensemble , int iens) {
+  return stringlist_iget( ensemble->case_list , iens );
+}
+
+
+/*
+  The earliest start time and the latest end time of the loaded cases;
+  returns -1 if no cases have been loaded.
+*/
+
+time_t ecl_sum_ensemble_get_start_time( const ecl_sum_ensemble_type * ensemble ) {
+  time_t start_time = -1;
+  for (int iens = 0; iens < ensemble->size; iens++) {
+    const ecl_sum_type * ecl_sum = ensemble->ecl_sum[iens];
+    if (ecl_sum) {
+      if (start_time == -1)
+        start_time = ecl_sum_get_start_time( ecl_sum );
+      else
+        start_time = util_time_t_min( start_time , ecl_sum_get_start_time( ecl_sum ));
+    }
+  }
+  return start_time;
+}
+
+
+time_t ecl_sum_ensemble_get_end_time( const ecl_sum_ensemble_type * ensemble ) {
+  time_t end_time = -1;
+  for (int iens = 0; iens < ensemble->size; iens++) {
+    const ecl_sum_type * ecl_sum = ensemble->ecl_sum[iens];
+    if (ecl_sum)
+      end_time = util_time_t_max( end_time , ecl_sum_get_end_time( ecl_sum ));
+  }
+  return end_time;
+}
+
+
+/*
+  Returns true if all the loaded cases have the key @gen_key.
+*/
+
+bool ecl_sum_ensemble_has_general_var( const ecl_sum_ensemble_type * ensemble , const char * gen_key ) {
+  for (int iens = 0; iens < ensemble->size; iens++) {
+    const ecl_sum_type * ecl_sum = ensemble->ecl_sum[iens];
+    if (ecl_sum && !ecl_sum_has_general_var( ecl_sum , gen_key ))
+      return false;
+  }
+  return true;
+}
+
+
+/*
+  Will extract the value of @gen_key at @sim_time for all the cases in
+  the ensemble; the value for case iens is stored in element iens of
+  @values. Cases which are not loaded, do not have the key, or do not
+  cover @sim_time get the value zero and are marked as invalid in the
+  optional @valid vector. The return value is the number of valid
+  values.
+
+  The smspec node is only looked up once for each distinct smspec
+  instance in the ensemble.
+*/
+
+int ecl_sum_ensemble_get_column( const ecl_sum_ensemble_type * ensemble , const char * gen_key , time_t sim_time , double_vector_type * values , bool_vector_type * valid) {
+  const ecl_smspec_type * current_smspec = NULL;
+  const smspec_node_type * node = NULL;
+  int num_valid = 0;
+
+  double_vector_reset( values );
+  if (valid)
+    bool_vector_reset( valid );
+
+  for (int iens = 0; iens < ensemble->size; iens++) {
+    const ecl_sum_type * ecl_sum = ensemble->ecl_sum[iens];
+    bool iens_valid = false;
+    double value = 0;
+
+    if (ecl_sum) {
+      const ecl_smspec_type * smspec = ecl_sum_get_smspec( ecl_sum );
+      if (smspec != current_smspec) {
+        current_smspec = smspec;
+        node = ecl_sum_has_general_var( ecl_sum , gen_key ) ? ecl_sum_get_general_var_node( ecl_sum , gen_key ) : NULL;
+      }
+
+      if (node && (sim_time >= ecl_sum_get_start_time( ecl_sum )) && (sim_time <= ecl_sum_get_end_time( ecl_sum ))) {
+        value = ecl_sum_get_from_sim_time( ecl_sum , sim_time , node );
+        iens_valid = true;
+        num_valid++;
+      }
+    }
+
+    double_vector_iset( values , iens , value );
+    if (valid)
+      bool_vector_iset( valid , iens , iens_valid );
+  }
+  return num_valid;
+}
@@ -0,0 +1,285 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_stream.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_sum_stream.h>
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/ecl_sum_tstep.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+
+/*
+  The ecl_sum_stream writes the summary data of a case incrementally,
+  as the simulation proceeds. In contrast to the ecl_sum_data
+  implementation, which keeps all the timesteps in memory until
+  ecl_sum_fwrite() is called, the stream only holds on to the latest
+  timestep; memory usage is therefor proportional to the number of
+  summary variables, and independent of the number of timesteps.
+
+  The timestep returned from ecl_sum_stream_add_tstep() can be
+  updated with ecl_sum_tstep_set_from_node() and friends until the
+  next call to ecl_sum_stream_add_tstep(), ecl_sum_stream_flush() or
+  ecl_sum_stream_free(); at that point the MINISTEP and PARAMS
+  keywords are written to file and the timestep is discarded. A
+  SEQHDR keyword is written every time a new report step starts, and
+  the file is flushed to disk at the report step boundaries.
+
+  The layout of the summary case is taken from the ecl_sum instance
+  used to create the stream; no more variables can be added to it
+  after the stream has been created.
+
+  In append mode the stream continues an existing case: the number
+  of the last report step and ministep are read from the existing
+  file(s), and new timesteps are appended. When appending the SMSPEC
+  file must already describe the same variables as the ecl_sum
+  instance.
+*/
+
+#define ECL_SUM_STREAM_TYPE_ID 76098103
+
+struct ecl_sum_stream_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  const ecl_smspec_type * smspec;
+  char                  * ecl_case;
+  bool                    fmt_case;
+  bool                    unified;
+  fortio_type           * fortio;
+  ecl_sum_tstep_type    * tstep;        /* The pending timestep; written when the next timestep is added. */
+  int                     report_step;  /* The current report step; -1 before the first timestep. */
+  int                     ministep;     /* The ministep number of the last timestep; -1 before the first timestep. */
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_sum_stream , ECL_SUM_STREAM_TYPE_ID )
+
+
+/*
+  Reads the keyword headers of an existing summary file and updates
+  the report_step and ministep counters of the stream. Returns false
+  if the file does not contain any timesteps.
+*/
+
+static bool ecl_sum_stream_scan_file( ecl_sum_stream_type * stream , const char * filename , int report_step ) {
+  bool has_data = false;
+  if (util_file_exists( filename ) && util_file_size( filename ) > 0) {
+    ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+    if (ecl_file == NULL)
+      util_abort("%s: failed to open summary file:%s for appending \n",__func__ , filename );
+    {
+      int num_ministep = ecl_file_get_num_named_kw( ecl_file , MINISTEP_KW );
+      int num_params   = ecl_file_get_num_named_kw( ecl_file , PARAMS_KW );
+
+      if (num_ministep > 0 && num_params == num_ministep) {
+        const ecl_kw_type * ministep_kw = ecl_file_iget_named_kw( ecl_file , MINISTEP_KW , num_ministep - 1 );
+        const ecl_kw_type * params_kw   = ecl_file_iget_named_kw( ecl_file , PARAMS_KW , num_params - 1 );
+
+        if (ecl_kw_get_size( params_kw ) != int_vector_size( ecl_smspec_get_index_map( stream->smspec )))
+          util_abort("%s: the summary file:%s has %d variables - expected %d \n",__func__ , filename ,
+                     ecl_kw_get_size( params_kw ) , int_vector_size( ecl_smspec_get_index_map( stream->smspec )));
+
+        stream->ministep = ecl_kw_iget_int( ministep_kw , 0 );
+        if (stream->unified)
+          stream->report_step = ecl_file_get_num_named_kw( ecl_file , SEQHDR_KW );
+        else
+          stream->report_step = report_step;
+        has_data = true;
+      } else if (num_ministep > 0)
+        util_abort("%s: the summary file:%s is truncated \n",__func__ , filename );
+    }
+    ecl_file_close( ecl_file );
+  }
+  return has_data;
+}
+
+
+static stringlist_type * ecl_sum_stream_alloc_report_files( const ecl_sum_type * ecl_sum , bool fmt_case ) {
+  stringlist_type * filelist = stringlist_alloc_new( );
+  ecl_util_select_filelist( ecl_sum_get_path( ecl_sum ) , ecl_sum_get_base( ecl_sum ) , ECL_SUMMARY_FILE , fmt_case , filelist );
+  return filelist;
+}
+
+
+static bool ecl_sum_stream_init_append( ecl_sum_stream_type * stream , const ecl_sum_type * ecl_sum ) {
+  if (stream->unified) {
+    char * filename = ecl_util_alloc_filename( NULL , stream->ecl_case , ECL_UNIFIED_SUMMARY_FILE , stream->fmt_case , 0 );
+    bool has_data = ecl_sum_stream_scan_file( stream , filename , 0 );
+    free( filename );
+    return has_data;
+  } else {
+    stringlist_type * filelist = ecl_sum_stream_alloc_report_files( ecl_sum , stream->fmt_case );
+    bool has_data = false;
+    int size = stringlist_get_size( filelist );
+
+    if (size > 0) {
+      const char * filename = stringlist_iget( filelist , size - 1 );
+      has_data = ecl_sum_stream_scan_file( stream , filename , ecl_util_filename_report_nr( filename ));
+    }
+    stringlist_free( filelist );
+    return has_data;
+  }
+}
+
+
+/*
+  When a new case is started old summary files must be removed;
+  otherwise stale report files from a previous, longer, simulation
+  would be loaded together with the new files.
+*/
+
+static void ecl_sum_stream_init_new( ecl_sum_stream_type * stream , const ecl_sum_type * ecl_sum ) {
+  if (stream->unified) {
+    char * filename = ecl_util_alloc_filename( NULL , stream->ecl_case , ECL_UNIFIED_SUMMARY_FILE , stream->fmt_case , 0 );
+    util_unlink_existing( filename );
+    free( filename );
+  } else {
+    stringlist_type * filelist = ecl_sum_stream_alloc_report_files( ecl_sum , stream->fmt_case );
+    for (int i = 0; i < stringlist_get_size( filelist ); i++)
+      util_unlink_existing( stringlist_iget( filelist , i ));
+    stringlist_free( filelist );
+  }
+  ecl_sum_fwrite_smspec( ecl_sum );
+}
+
+
+ecl_sum_stream_type * ecl_sum_stream_alloc( const ecl_sum_type * ecl_sum , bool append ) {
+  ecl_sum_stream_type * stream = util_malloc( sizeof * stream );
+  UTIL_TYPE_ID_INIT( stream , ECL_SUM_STREAM_TYPE_ID );
+
+  stream->smspec      = ecl_sum_get_smspec( ecl_sum );
+  stream->ecl_case    = util_alloc_string_copy( ecl_sum_get_case( ecl_sum ));
+  stream->fmt_case    = ecl_sum_get_fmt_case( ecl_sum );
+  stream->unified     = ecl_sum_get_unified( ecl_sum );
+  stream->fortio      = NULL;
+  stream->tstep       = NULL;
+  stream->report_step = -1;
+  stream->ministep    = -1;
+
+  if (!append || !ecl_sum_stream_init_append( stream , ecl_sum ))
+    ecl_sum_stream_init_new( stream , ecl_sum );
+
+  return stream;
+}
+
+
+static void ecl_sum_stream_fopen( ecl_sum_stream_type * stream , int report_step ) {
+  if (stream->unified) {
+    if (stream->fortio != NULL)
+      return;
+  } else if (stream->fortio != NULL)
+    fortio_fclose( stream->fortio );
+
+  {
+    ecl_file_enum file_type = stream->unified ? ECL_UNIFIED_SUMMARY_FILE : ECL_SUMMARY_FILE;
+    char * filename = ecl_util_alloc_filename( NULL , stream->ecl_case , file_type , stream->fmt_case , report_step );
+
+    stream->fortio = fortio_open_append( filename , stream->fmt_case , ECL_ENDIAN_FLIP );
+    if (stream->fortio == NULL)
+      util_abort("%s: failed to open summary file:%s for writing \n",__func__ , filename );
+
+    free( filename );
+  }
+}
+
+
+static void ecl_sum_stream_fwrite_seqhdr( ecl_sum_stream_type * stream ) {
+  ecl_kw_type * seqhdr_kw = ecl_kw_alloc( SEQHDR_KW , SEQHDR_SIZE , ECL_INT );
+  ecl_kw_iset_int( seqhdr_kw , 0 , 0 );
+  ecl_kw_fwrite( seqhdr_kw , stream->fortio );
+  ecl_kw_free( seqhdr_kw );
+}
+
+
+static void ecl_sum_stream_fwrite_tstep( ecl_sum_stream_type * stream ) {
+  if (stream->tstep != NULL) {
+    ecl_sum_tstep_fwrite( stream->tstep , ecl_smspec_get_index_map( stream->smspec ) , stream->fortio );
+    ecl_sum_tstep_free( stream->tstep );
+    stream->tstep = NULL;
+  }
+}
+
+
+/*
+  Adds a new timestep to the stream; the previous timestep is written
+  to file. The report steps must be added in increasing order.
+*/
+
+ecl_sum_tstep_type * ecl_sum_stream_add_tstep( ecl_sum_stream_type * stream , int report_step , double sim_seconds ) {
+  if (report_step < stream->report_step)
+    util_abort("%s: report steps must be added in increasing order - current:%d new:%d \n",__func__ , stream->report_step , report_step );
+
+  ecl_sum_stream_fwrite_tstep( stream );
+  if (report_step > stream->report_step) {
+    if (stream->fortio != NULL)
+      fortio_fflush( stream->fortio );
+
+    ecl_sum_stream_fopen( stream , report_step );
+    ecl_sum_stream_fwrite_seqhdr( stream );
+    stream->report_step = report_step;
+  } else if (stream->fortio == NULL)
+    ecl_sum_stream_fopen( stream , report_step );   /* Appending to the last report step of an existing case. */
+
+  stream->ministep++;
+  stream->tstep = ecl_sum_tstep_alloc_new( report_step , stream->ministep , sim_seconds , stream->smspec );
+  return stream->tstep;
+}
+
+
+/*
+  Writes the pending timestep and flushes the file; the timestep
+  returned from the last call to ecl_sum_stream_add_tstep() can not be
+  used after this.
+*/
+
+void ecl_sum_stream_flush( ecl_sum_stream_type * stream ) {
+  if (stream->fortio != NULL) {
+    ecl_sum_stream_fwrite_tstep( stream );
+    fortio_fflush( stream->fortio );
+  }
+}
+
+
+int ecl_sum_stream_get_report_step( const ecl_sum_stream_type * stream ) {
+  return stream->report_step;
+}
+
+
+int ecl_sum_stream_get_ministep( const ecl_sum_stream_type * stream ) {
+  return stream->ministep;
+}
+
+
+void ecl_sum_stream_free( ecl_sum_stream_type * stream ) {
+  if (stream->fortio != NULL) {
+    ecl_sum_stream_fwrite_tstep( stream );
+    fortio_fclose( stream->fortio );
+  }
+  free( stream->ecl_case );
+  free( stream );
+}
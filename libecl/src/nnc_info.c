@@ -36,7 +36,6 @@ struct nnc_info_struct {
   int               lgr_nr;        /* The lgr_nr of the cell holding this nnc_info structure. */ 
 }; 
 
-static void nnc_info_add_vector( nnc_info_type * nnc_info , nnc_vector_type * nnc_vector);
 UTIL_IS_INSTANCE_FUNCTION( nnc_info , NNC_INFO_TYPE_ID )
 
 
@@ -125,7 +124,10 @@ nnc_vector_type * nnc_info_get_self_vector( const nnc_info_type * nnc_info ) {
   return nnc_info_get_vector( nnc_info , nnc_info->lgr_nr );
 }
 
-static void nnc_info_add_vector( nnc_info_type * nnc_info , nnc_vector_type * nnc_vector) {
+/*
+  The nnc_info instance takes ownership of the nnc_vector.
+*/
+void nnc_info_add_vector( nnc_info_type * nnc_info , nnc_vector_type * nnc_vector) {
   vector_append_owned_ref( nnc_info->lgr_list , nnc_vector , nnc_vector_free__ );
   int_vector_iset( nnc_info->lgr_index_map , nnc_vector_get_lgr_nr( nnc_vector ) , vector_get_size( nnc_info->lgr_list ) - 1 );
 }
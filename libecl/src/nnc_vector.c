@@ -53,6 +53,20 @@ nnc_vector_type * nnc_vector_alloc(int lgr_nr) {
   return nnc_vector; 
 }
 
+/*
+  Will create a read-only nnc_vector instance which is a view of
+  @size elements of externally owned grid_index and nnc_index data.
+*/
+
+nnc_vector_type * nnc_vector_alloc_view(int lgr_nr , int * grid_index , int * nnc_index , int size) {
+  nnc_vector_type * nnc_vector = util_malloc( sizeof * nnc_vector );
+  UTIL_TYPE_ID_INIT(nnc_vector , NNC_VECTOR_TYPE_ID);
+  nnc_vector->grid_index_list = int_vector_alloc_view( grid_index , size );
+  nnc_vector->nnc_index_list  = int_vector_alloc_view( nnc_index , size );
+  nnc_vector->lgr_nr = lgr_nr;
+  return nnc_vector;
+}
+
 nnc_vector_type * nnc_vector_alloc_copy(const nnc_vector_type * src_vector) {
   nnc_vector_type * copy_vector =  util_malloc( sizeof * src_vector );
   UTIL_TYPE_ID_INIT(copy_vector , NNC_VECTOR_TYPE_ID);
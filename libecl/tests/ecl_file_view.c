@@ -0,0 +1,182 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_view.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+
+#define NUM_BLOCKS 100
+
+
+/*
+  Block nr i contains: SEQNUM, i + 1 keywords DATA and a trailing
+  END keyword; the value of all keywords in the block is i.
+*/
+
+static void write_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  for (int block = 0; block < NUM_BLOCKS; block++) {
+    ecl_kw_type * seqnum_kw = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT );
+    ecl_kw_type * data_kw = ecl_kw_alloc( "DATA" , 1 , ECL_INT );
+    ecl_kw_type * end_kw = ecl_kw_alloc( "END" , 1 , ECL_INT );
+
+    ecl_kw_iset_int( seqnum_kw , 0 , block );
+    ecl_kw_iset_int( data_kw , 0 , block );
+    ecl_kw_iset_int( end_kw , 0 , block );
+
+    ecl_kw_fwrite( seqnum_kw , fortio );
+    for (int i = 0; i <= block; i++)
+      ecl_kw_fwrite( data_kw , fortio );
+    ecl_kw_fwrite( end_kw , fortio );
+
+    ecl_kw_free( seqnum_kw );
+    ecl_kw_free( data_kw );
+    ecl_kw_free( end_kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+static void assert_block( const ecl_file_view_type * block_view , int block , bool with_end ) {
+  int size = block + 2 + (with_end ? 1 : 0);
+
+  test_assert_int_equal( ecl_file_view_get_size( block_view ) , size );
+  test_assert_int_equal( ecl_file_view_get_num_named_kw( block_view , SEQNUM_KW ) , 1 );
+  test_assert_int_equal( ecl_file_view_get_num_named_kw( block_view , "DATA" ) , block + 1 );
+  test_assert_int_equal( ecl_file_view_get_num_distinct_kw( block_view ) , with_end ? 3 : 2 );
+  test_assert_string_equal( ecl_file_view_iget_header( block_view , 0 ) , SEQNUM_KW );
+  test_assert_int_equal( ecl_kw_iget_int( ecl_file_view_iget_named_kw( block_view , "DATA" , block ) , 0 ) , block );
+  test_assert_int_equal( ecl_file_view_get_global_index( block_view , "DATA" , 0 ) , 1 );
+  test_assert_int_equal( ecl_file_view_iget_occurence( block_view , block + 1 ) , block );
+
+  if (with_end) {
+    test_assert_string_equal( ecl_file_view_iget_header( block_view , size - 1 ) , "END" );
+    test_assert_true( ecl_file_view_has_kw( block_view , "END" ));
+  } else
+    test_assert_false( ecl_file_view_has_kw( block_view , "END" ));
+}
+
+
+void test_blockview( const ecl_file_type * ecl_file ) {
+  const ecl_file_view_type * global_view = ecl_file_get_global_view( (ecl_file_type *) ecl_file );
+
+  for (int block = 0; block < NUM_BLOCKS; block++) {
+    ecl_file_view_type * block_view = ecl_file_view_alloc_blockview( global_view , SEQNUM_KW , block );
+    assert_block( block_view , block , true );
+
+    {
+      ecl_file_view_type * sub_view = ecl_file_view_alloc_blockview2( block_view , SEQNUM_KW , "END" , 0 );
+      assert_block( sub_view , block , false );
+      ecl_file_view_free( sub_view );
+    }
+
+    ecl_file_view_free( block_view );
+  }
+  test_assert_NULL( ecl_file_view_alloc_blockview( global_view , SEQNUM_KW , NUM_BLOCKS ));
+}
+
+
+void test_block_iter( const ecl_file_type * ecl_file ) {
+  const ecl_file_view_type * global_view = ecl_file_get_global_view( (ecl_file_type *) ecl_file );
+  {
+    ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( global_view , SEQNUM_KW , SEQNUM_KW );
+    ecl_file_view_type * block_view;
+    int block = 0;
+
+    while ((block_view = ecl_file_view_block_iter_next( iter ))) {
+      assert_block( block_view , block , true );
+      ecl_file_view_add_blockview( block_view , "DATA" , 0 );
+      block++;
+    }
+    test_assert_int_equal( block , NUM_BLOCKS );
+    test_assert_NULL( ecl_file_view_block_iter_next( iter ));
+    ecl_file_view_block_iter_free( iter );
+  }
+
+  {
+    ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( global_view , SEQNUM_KW , "END" );
+    ecl_file_view_type * block_view;
+    int block = 0;
+
+    while ((block_view = ecl_file_view_block_iter_next( iter ))) {
+      assert_block( block_view , block , false );
+      block++;
+    }
+    test_assert_int_equal( block , NUM_BLOCKS );
+    ecl_file_view_block_iter_free( iter );
+  }
+
+  {
+    ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( global_view , "MISSING" , NULL );
+    test_assert_NULL( ecl_file_view_block_iter_next( iter ));
+    ecl_file_view_block_iter_free( iter );
+  }
+}
+
+
+void test_restart_view( ecl_file_type * ecl_file ) {
+  ecl_file_view_type * global_view = ecl_file_get_global_view( ecl_file );
+  ecl_file_view_type * block_view = ecl_file_view_add_restart_view( global_view , 17 , -1 , -1 , -1 );
+  assert_block( block_view , 17 , true );
+}
+
+
+/*
+  The copy has the same keywords as the source, and can still be read
+  when the source has been closed.
+*/
+
+void test_index_copy( const char * filename ) {
+  ecl_file_type * src = ecl_file_open( filename , 0 );
+  ecl_file_type * copy = ecl_file_open_index_copy( src , 0 );
+
+  test_assert_int_equal( ecl_file_get_size( copy ) , ecl_file_get_size( src ));
+  test_assert_string_equal( ecl_file_get_src_file( copy ) , ecl_file_get_src_file( src ));
+  ecl_file_close( src );
+
+  test_blockview( copy );
+  test_block_iter( copy );
+  ecl_file_close( copy );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_view");
+  write_file( "TEST.UNRST" );
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "TEST.UNRST" , 0 );
+
+    test_blockview( ecl_file );
+    test_block_iter( ecl_file );
+    test_restart_view( ecl_file );
+
+    ecl_file_close( ecl_file );
+  }
+  test_index_copy( "TEST.UNRST" );
+  test_work_area_free( work_area );
+  exit(0);
+}
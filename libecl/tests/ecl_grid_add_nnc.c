@@ -18,9 +18,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
 #include <ert/util/test_work_area.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/ecl/ecl_grid.h>
 
@@ -132,9 +136,143 @@ void list_test() {
 
 
 
+/*
+  The connections are added out of order; the grid level storage should
+  be ordered on cell, and retain the insertion order within one cell.
+*/
+void csr_test() {
+  ecl_grid_type * grid0 = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1, 1, NULL );
+  ecl_grid_add_self_nnc( grid0 , 8 , 9 , 2 );
+  ecl_grid_add_self_nnc( grid0 , 5 , 7 , 1 );
+  ecl_grid_add_self_nnc( grid0 , 5 , 6 , 0 );
+
+  test_assert_int_equal( 3 , ecl_grid_get_num_nnc( grid0 ));
+  {
+    const int * offset;
+    const int * lgr_nr;
+    const int * grid_index;
+    const int * nnc_index;
+
+    ecl_grid_get_nnc_csr( grid0 , &offset , &lgr_nr , &grid_index , &nnc_index );
+    test_assert_int_equal( 0 , offset[5] );
+    test_assert_int_equal( 2 , offset[6] );
+    test_assert_int_equal( 2 , offset[8] );
+    test_assert_int_equal( 3 , offset[9] );
+    test_assert_int_equal( 3 , offset[ ecl_grid_get_global_size( grid0 ) ] );
+
+    test_assert_int_equal( 7 , grid_index[0] );
+    test_assert_int_equal( 6 , grid_index[1] );
+    test_assert_int_equal( 9 , grid_index[2] );
+    test_assert_int_equal( 1 , nnc_index[0] );
+    test_assert_int_equal( 0 , nnc_index[1] );
+    test_assert_int_equal( 0 , lgr_nr[2] );
+  }
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid0 , 0 ));
+
+  /* Adding after a query must invalidate the index. */
+  ecl_grid_add_self_nnc( grid0 , 0 , 1 , 3 );
+  {
+    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid0 , 0 );
+    test_assert_not_NULL( nnc_info );
+    test_assert_int_equal( 1 , nnc_info_get_total_size( nnc_info ));
+    test_assert_int_equal( 2 , nnc_info_get_total_size( ecl_grid_get_cell_nnc_info1( grid0 , 5 )));
+  }
+
+  {
+    ecl_grid_type * grid1 = ecl_grid_alloc_copy( grid0 );
+    test_assert_true( ecl_grid_compare( grid0 , grid1 , true , true , false ));
+    ecl_grid_add_self_nnc( grid1 , 0 , 2 , 4 );
+    test_assert_false( ecl_grid_compare( grid0 , grid1 , true , true , false ));
+    ecl_grid_free( grid1 );
+  }
+  ecl_grid_free( grid0 );
+}
+
+
+void no_nnc_test() {
+  ecl_grid_type * grid0 = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1, 1, NULL );
+  ecl_grid_type * grid1 = ecl_grid_alloc_copy( grid0 );
+  const int * offset;
+  const int * lgr_nr;
+  const int * grid_index;
+  const int * nnc_index;
+
+  ecl_grid_get_nnc_csr( grid0 , &offset , &lgr_nr , &grid_index , &nnc_index );
+  test_assert_NULL( offset );
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid0 , 5 ));
+  test_assert_true( ecl_grid_compare( grid0 , grid1 , true , true , false ));
+
+  ecl_grid_add_self_nnc( grid1 , 5 , 6 , 0 );
+  test_assert_false( ecl_grid_compare( grid0 , grid1 , true , true , false ));
+
+  ecl_grid_free( grid1 );
+  ecl_grid_free( grid0 );
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+#define NUM_QUERIES 10000
+
+typedef struct {
+  const ecl_grid_type   * grid;
+  const nnc_info_type  ** info;
+} query_arg_type;
+
+
+static void query_nnc_info( int index , void * arg ) {
+  query_arg_type * query = arg;
+  int global_index = index % ecl_grid_get_global_size( query->grid );
+  query->info[index] = ecl_grid_get_cell_nnc_info1( query->grid , global_index );
+}
+
+
+/*
+  The nnc index and the nnc_info views of a shared grid are built
+  lazily by the first reader; concurrent readers must all see the
+  same, complete, nnc_info instances.
+*/
+
+void concurrent_test() {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1, 1, NULL );
+  const nnc_info_type ** info = util_calloc( NUM_QUERIES , sizeof * info );
+  query_arg_type query = { grid , info };
+  int g;
+
+  for (g = 0; g < ecl_grid_get_global_size( grid ) - 1; g += 3)
+    ecl_grid_add_self_nnc( grid , g , g + 1 , g );
+
+  {
+    thread_pool_type * tp = thread_pool_alloc( 8 , true );
+    thread_pool_parallel_for( tp , 0 , NUM_QUERIES , query_nnc_info , &query );
+    thread_pool_free( tp );
+  }
+
+  for (int i = 0; i < NUM_QUERIES; i++) {
+    int global_index = i % ecl_grid_get_global_size( grid );
+    test_assert_ptr_equal( info[i] , ecl_grid_get_cell_nnc_info1( grid , global_index ));
+    if ((global_index % 3) == 0 && (global_index < ecl_grid_get_global_size( grid ) - 1)) {
+      test_assert_not_NULL( info[i] );
+      test_assert_int_equal( 1 , nnc_info_get_total_size( info[i] ));
+    } else
+      test_assert_NULL( info[i] );
+  }
+
+  free( info );
+  ecl_grid_free( grid );
+}
+
+#endif
+
+
 int main( int argc , char ** argv) {
   simple_test();
   list_test();
   overwrite_test();
+  csr_test();
+  no_nnc_test();
+#ifdef ERT_HAVE_THREAD_POOL
+  concurrent_test();
+#endif
   exit(0);
 }
@@ -0,0 +1,90 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_load_threads.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+/*
+  The grid is large enough to be initialised with several threads;
+  the grid loaded with several threads must be identical to the grid
+  loaded with one thread.
+*/
+
+#define NX 61
+#define NY 47
+#define NZ 40
+
+
+static ecl_grid_type * load_grid( const char * filename , int num_threads ) {
+  ecl_grid_type * grid;
+  ecl_grid_set_num_threads( num_threads );
+  test_assert_int_equal( ecl_grid_get_num_threads( ) , num_threads );
+  grid = ecl_grid_alloc( filename );
+  test_assert_not_NULL( grid );
+  return grid;
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_grid_load_threads" );
+  int * actnum = util_calloc( NX * NY * NZ , sizeof * actnum );
+
+  for (int g = 0; g < NX * NY * NZ; g++)
+    actnum[g] = (g % 7) ? 1 : 0;
+
+  {
+    ecl_grid_type * src_grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 10 , 20 , 1 , actnum );
+    ecl_grid_fwrite_EGRID2( src_grid , "GRID.EGRID" , ECL_METRIC_UNITS );
+
+    {
+      ecl_grid_type * grid1 = load_grid( "GRID.EGRID" , 1 );
+      ecl_grid_type * grid4 = load_grid( "GRID.EGRID" , 4 );
+
+      test_assert_true( ecl_grid_compare( grid1 , grid4 , true , true , true ));
+      test_assert_int_equal( ecl_grid_get_active_size( grid4 ) , ecl_grid_get_active_size( src_grid ));
+
+      for (int g = 0; g < NX * NY * NZ; g += 97) {
+        double x1,y1,z1,x4,y4,z4;
+
+        test_assert_double_equal( ecl_grid_get_cell_volume1( grid4 , g ) , ecl_grid_get_cell_volume1( src_grid , g ));
+        test_assert_bool_equal( ecl_grid_cell_invalid1( grid4 , g ) , ecl_grid_cell_invalid1( grid1 , g ));
+        test_assert_int_equal( ecl_grid_get_active_index1( grid4 , g ) , ecl_grid_get_active_index1( src_grid , g ));
+
+        ecl_grid_get_xyz1( grid1 , g , &x1 , &y1 , &z1 );
+        ecl_grid_get_xyz1( grid4 , g , &x4 , &y4 , &z4 );
+        test_assert_double_equal( x1 , x4 );
+        test_assert_double_equal( y1 , y4 );
+        test_assert_double_equal( z1 , z4 );
+      }
+
+      ecl_grid_free( grid4 );
+      ecl_grid_free( grid1 );
+    }
+    ecl_grid_free( src_grid );
+  }
+
+  ecl_grid_set_num_threads( 1 );
+  free( actnum );
+  test_work_area_free( work_area );
+  exit(0);
+}
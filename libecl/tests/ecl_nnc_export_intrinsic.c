@@ -0,0 +1,164 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_nnc_export_intrinsic.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_nnc_export.h>
+
+
+
+static int cmp__( const void * nnc1 , const void * nnc2) {
+  return ecl_nnc_sort_cmp( nnc1 , nnc2 );
+}
+
+
+void test_sort() {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  const int size = 10000;
+  ecl_nnc_type * nnc_list1 = util_calloc( size , sizeof * nnc_list1 );
+  ecl_nnc_type * nnc_list2 = util_calloc( size , sizeof * nnc_list2 );
+
+  for (int i=0; i < size; i++) {
+    nnc_list1[i].grid_nr1 = rng_get_int( rng , 3 );
+    nnc_list1[i].grid_nr2 = rng_get_int( rng , 3 );
+    nnc_list1[i].global_index1 = rng_get_int( rng , 200000 );
+    nnc_list1[i].global_index2 = rng_get_int( rng , 100 );
+    nnc_list1[i].input_index = i;
+    nnc_list1[i].trans = i;
+  }
+  memcpy( nnc_list2 , nnc_list1 , size * sizeof * nnc_list1 );
+
+  ecl_nnc_sort( nnc_list1 , size );
+  qsort( nnc_list2 , size , sizeof * nnc_list2 , cmp__ );
+  for (int i=0; i < size; i++) {
+    test_assert_int_equal( 0 , ecl_nnc_sort_cmp( &nnc_list1[i] , &nnc_list2[i] ));
+    if (i > 0)
+      test_assert_true( ecl_nnc_sort_cmp( &nnc_list1[i-1] , &nnc_list1[i] ) <= 0 );
+  }
+
+  free( nnc_list2 );
+  free( nnc_list1 );
+  rng_free( rng );
+}
+
+
+void test_export() {
+  test_work_area_type * test_area = test_work_area_alloc("ecl_nnc_export");
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 100 , 100 , 10 , 1 , 1, 1, NULL );
+  const int num_nnc = 1000;
+  {
+    fortio_type * init_file = fortio_open_writer( "TEST.INIT" , false , ECL_ENDIAN_FLIP );
+    ecl_kw_type * trannnc_kw = ecl_kw_alloc( TRANNNC_KW , num_nnc , ECL_FLOAT );
+
+    for (int i = 0; i < num_nnc; i++) {
+      int g1 = (i * 7919) % ecl_grid_get_global_size( grid );
+      int g2 = (g1 + 1 + i % 13) % ecl_grid_get_global_size( grid );
+      ecl_grid_add_self_nnc( grid , g1 , g2 , i );
+      ecl_kw_iset_float( trannnc_kw , i , i );
+    }
+    ecl_kw_fwrite( trannnc_kw , init_file );
+    ecl_kw_free( trannnc_kw );
+    fortio_fclose( init_file );
+  }
+
+  {
+    ecl_file_type * init_file = ecl_file_open( "TEST.INIT" , 0 );
+    ecl_nnc_type * nnc_data = util_calloc( ecl_nnc_export_get_size( grid ) , sizeof * nnc_data );
+
+    test_assert_int_equal( num_nnc , ecl_nnc_export_get_size( grid ));
+    test_assert_int_equal( num_nnc , ecl_nnc_export( grid , init_file , nnc_data ));
+    for (int i=0; i < num_nnc; i++) {
+      test_assert_double_equal( nnc_data[i].input_index , nnc_data[i].trans );
+      if (i > 0)
+        test_assert_true( ecl_nnc_sort_cmp( &nnc_data[i-1] , &nnc_data[i] ) < 0 );
+    }
+
+    free( nnc_data );
+    ecl_file_close( init_file );
+  }
+  ecl_grid_free( grid );
+  test_work_area_free( test_area );
+}
+
+
+void test_get_tran_kw() {
+  test_work_area_type * test_area = test_work_area_alloc("ecl_nnc_export_get_tran");
+  {
+    fortio_type * init_file = fortio_open_writer( "TEST.INIT" , false , ECL_ENDIAN_FLIP );
+    for (int lgr_nr = 1; lgr_nr <= 2; lgr_nr++) {
+      ecl_kw_type * lgrheadi = ecl_kw_alloc( LGRHEADI_KW , 10 , ECL_INT );
+      ecl_kw_type * filler   = ecl_kw_alloc( "FILLER" , 10 , ECL_FLOAT );
+      ecl_kw_type * trannnc  = ecl_kw_alloc( TRANNNC_KW , 5 , ECL_FLOAT );
+      ecl_kw_type * trangl   = ecl_kw_alloc( TRANGL_KW , 7 , ECL_FLOAT );
+
+      ecl_kw_scalar_set_int( lgrheadi , 0 );
+      ecl_kw_iset_int( lgrheadi , LGRHEADI_LGR_NR_INDEX , lgr_nr );
+      ecl_kw_scalar_set_float( trannnc , 100 * lgr_nr );
+      ecl_kw_scalar_set_float( trangl , 1000 * lgr_nr );
+
+      ecl_kw_fwrite( lgrheadi , init_file );
+      ecl_kw_fwrite( filler , init_file );
+      ecl_kw_fwrite( filler , init_file );
+      ecl_kw_fwrite( trannnc , init_file );
+      ecl_kw_fwrite( trangl , init_file );
+
+      ecl_kw_free( trangl );
+      ecl_kw_free( trannnc );
+      ecl_kw_free( filler );
+      ecl_kw_free( lgrheadi );
+    }
+    fortio_fclose( init_file );
+  }
+
+  {
+    ecl_file_type * init_file = ecl_file_open( "TEST.INIT" , 0 );
+    test_assert_NULL( ecl_nnc_export_get_tran_kw( init_file , TRANGL_KW , 0 ));
+    test_assert_NULL( ecl_nnc_export_get_tran_kw( init_file , TRANNNC_KW , 3 ));
+    for (int lgr_nr = 1; lgr_nr <= 2; lgr_nr++) {
+      ecl_kw_type * trannnc = ecl_nnc_export_get_tran_kw( init_file , TRANNNC_KW , lgr_nr );
+      ecl_kw_type * trangl  = ecl_nnc_export_get_tran_kw( init_file , TRANGL_KW , lgr_nr );
+
+      test_assert_int_equal( 5 , ecl_kw_get_size( trannnc ));
+      test_assert_int_equal( 7 , ecl_kw_get_size( trangl ));
+      test_assert_double_equal( 100 * lgr_nr , ecl_kw_iget_float( trannnc , 0 ));
+      test_assert_double_equal( 1000 * lgr_nr , ecl_kw_iget_float( trangl , 0 ));
+    }
+    ecl_file_close( init_file );
+  }
+  test_work_area_free( test_area );
+}
+
+
+int main( int argc , char ** argv) {
+  test_sort();
+  test_export();
+  test_get_tran_kw();
+  exit(0);
+}
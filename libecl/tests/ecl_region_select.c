@@ -0,0 +1,254 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_region_select.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_region.h>
+
+#define NX 13
+#define NY 11
+#define NZ 7
+
+/*
+  The region is checked against a plain bool mask which is updated
+  with the same selections; the grid size is deliberately not a
+  multiple of the bitset word size.
+*/
+
+static void assert_region( ecl_region_type * region , const ecl_grid_type * grid , const bool * mask ) {
+  const int_vector_type * global_list = ecl_region_get_global_list( region );
+  const int_vector_type * active_list = ecl_region_get_active_list( region );
+  const int_vector_type * global_active_list = ecl_region_get_global_active_list( region );
+  int global_size = 0;
+  int active_size = 0;
+
+  for (int g = 0; g < NX*NY*NZ; g++) {
+    test_assert_bool_equal( mask[g] , ecl_region_contains_global( region , g ));
+    if (mask[g]) {
+      int active_index = ecl_grid_get_active_index1( grid , g );
+      test_assert_int_equal( g , int_vector_iget( global_list , global_size ));
+      global_size++;
+
+      if (active_index >= 0) {
+        test_assert_int_equal( active_index , int_vector_iget( active_list , active_size ));
+        test_assert_int_equal( g , int_vector_iget( global_active_list , active_size ));
+        active_size++;
+      }
+    }
+  }
+  test_assert_int_equal( global_size , int_vector_size( global_list ));
+  test_assert_int_equal( active_size , int_vector_size( active_list ));
+  test_assert_int_equal( active_size , int_vector_size( global_active_list ));
+}
+
+
+void test_chained_select( const ecl_grid_type * grid , rng_type * rng ) {
+  int nactive = ecl_grid_get_nactive( grid );
+  ecl_kw_type * global_int_kw = ecl_kw_alloc( "FIPNUM" , NX*NY*NZ , ECL_INT );
+  ecl_kw_type * active_int_kw = ecl_kw_alloc( "FIPNUM" , nactive , ECL_INT );
+  ecl_kw_type * active_float_kw1 = ecl_kw_alloc( "SWAT" , nactive , ECL_FLOAT );
+  ecl_kw_type * active_float_kw2 = ecl_kw_alloc( "SOIL" , nactive , ECL_FLOAT );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  ecl_region_type * other = ecl_region_alloc( grid , true );
+  bool mask[NX*NY*NZ] = { false };
+  bool other_mask[NX*NY*NZ];
+
+  for (int g = 0; g < NX*NY*NZ; g++) {
+    ecl_kw_iset_int( global_int_kw , g , rng_get_int( rng , 5 ));
+    other_mask[g] = true;
+  }
+
+  for (int a = 0; a < nactive; a++) {
+    ecl_kw_iset_int( active_int_kw , a , rng_get_int( rng , 5 ));
+    ecl_kw_iset_float( active_float_kw1 , a , rng_get_double( rng ));
+    ecl_kw_iset_float( active_float_kw2 , a , rng_get_double( rng ));
+  }
+
+  for (int iter = 0; iter < 500; iter++) {
+    bool select = (rng_get_int( rng , 2 ) == 0);
+    int op = rng_get_int( rng , 9 );
+
+    if (op == 0) {
+      int value = rng_get_int( rng , 5 );
+      if (select)
+        ecl_region_select_equal( region , global_int_kw , value );
+      else
+        ecl_region_deselect_equal( region , global_int_kw , value );
+
+      for (int g = 0; g < NX*NY*NZ; g++)
+        if (ecl_kw_iget_int( global_int_kw , g ) == value)
+          mask[g] = select;
+    } else if (op == 1) {
+      int value = rng_get_int( rng , 5 );
+      if (select)
+        ecl_region_select_smaller( region , active_int_kw , value );
+      else
+        ecl_region_deselect_larger( region , active_int_kw , value );
+
+      for (int a = 0; a < nactive; a++) {
+        int kw_value = ecl_kw_iget_int( active_int_kw , a );
+        if ((select && kw_value < value) || (!select && kw_value > value))
+          mask[ ecl_grid_get_global_index1A( grid , a ) ] = select;
+      }
+    } else if (op == 2) {
+      float min_value = rng_get_double( rng );
+      float max_value = min_value + 0.25;
+      if (select)
+        ecl_region_select_in_interval( region , active_float_kw1 , min_value , max_value );
+      else
+        ecl_region_deselect_in_interval( region , active_float_kw1 , min_value , max_value );
+
+      for (int a = 0; a < nactive; a++) {
+        float kw_value = ecl_kw_iget_float( active_float_kw1 , a );
+        if (kw_value >= min_value && kw_value < max_value)
+          mask[ ecl_grid_get_global_index1A( grid , a ) ] = select;
+      }
+    } else if (op == 3) {
+      if (select)
+        ecl_region_cmp_select_less( region , active_float_kw1 , active_float_kw2 );
+      else
+        ecl_region_cmp_deselect_more( region , active_float_kw1 , active_float_kw2 );
+
+      for (int a = 0; a < nactive; a++) {
+        float value1 = ecl_kw_iget_float( active_float_kw1 , a );
+        float value2 = ecl_kw_iget_float( active_float_kw2 , a );
+        if ((select && value1 < value2) || (!select && value1 >= value2))
+          mask[ ecl_grid_get_global_index1A( grid , a ) ] = select;
+      }
+    } else if (op == 4) {
+      int i1 = rng_get_int( rng , NX );
+      int i2 = i1 + rng_get_int( rng , NX - i1 );
+      int j1 = rng_get_int( rng , NY );
+      int j2 = j1 + rng_get_int( rng , NY - j1 );
+      int k1 = rng_get_int( rng , NZ );
+      int k2 = k1 + rng_get_int( rng , NZ - k1 );
+
+      if (select)
+        ecl_region_select_from_ijkbox( region , i1 , i2 , j1 , j2 , k1 , k2 );
+      else
+        ecl_region_deselect_from_ijkbox( region , i1 , i2 , j1 , j2 , k1 , k2 );
+
+      for (int k = k1; k <= k2; k++)
+        for (int j = j1; j <= j2; j++)
+          for (int i = i1; i <= i2; i++)
+            mask[ ecl_grid_get_global_index3( grid , i , j , k ) ] = select;
+    } else if (op == 5) {
+      int slice = rng_get_int( rng , 3 );
+      int n = (slice == 0) ? NX : ((slice == 1) ? NY : NZ);
+      int l1 = rng_get_int( rng , n );
+      int l2 = l1 + rng_get_int( rng , n - l1 );
+
+      if (slice == 0)
+        select ? ecl_region_select_i1i2( region , l1 , l2 ) : ecl_region_deselect_i1i2( region , l1 , l2 );
+      else if (slice == 1)
+        select ? ecl_region_select_j1j2( region , l1 , l2 ) : ecl_region_deselect_j1j2( region , l1 , l2 );
+      else
+        select ? ecl_region_select_k1k2( region , l1 , l2 ) : ecl_region_deselect_k1k2( region , l1 , l2 );
+
+      for (int k = 0; k < NZ; k++)
+        for (int j = 0; j < NY; j++)
+          for (int i = 0; i < NX; i++) {
+            int l = (slice == 0) ? i : ((slice == 1) ? j : k);
+            if (l >= l1 && l <= l2)
+              mask[ ecl_grid_get_global_index3( grid , i , j , k ) ] = select;
+          }
+    } else if (op == 6) {
+      int g = rng_get_int( rng , NX*NY*NZ );
+      if (select)
+        ecl_region_select_global_index( region , g );
+      else
+        ecl_region_deselect_global_index( region , g );
+      mask[g] = select;
+    } else if (op == 7) {
+      ecl_region_invert_selection( region );
+      for (int g = 0; g < NX*NY*NZ; g++)
+        mask[g] = !mask[g];
+    } else {
+      int set_op = rng_get_int( rng , 3 );
+      if (set_op == 0) {
+        ecl_region_union( region , other );
+        for (int g = 0; g < NX*NY*NZ; g++)
+          mask[g] = mask[g] || other_mask[g];
+      } else if (set_op == 1) {
+        ecl_region_intersection( region , other );
+        for (int g = 0; g < NX*NY*NZ; g++)
+          mask[g] = mask[g] && other_mask[g];
+      } else {
+        ecl_region_subtract( region , other );
+        for (int g = 0; g < NX*NY*NZ; g++)
+          mask[g] = mask[g] && !other_mask[g];
+      }
+
+      {
+        int i1 = rng_get_int( rng , NX );
+        ecl_region_deselect_i1i2( other , i1 , i1 );
+        for (int k = 0; k < NZ; k++)
+          for (int j = 0; j < NY; j++)
+            other_mask[ ecl_grid_get_global_index3( grid , i1 , j , k ) ] = false;
+      }
+    }
+
+    if (rng_get_int( rng , 3 ) == 0)
+      assert_region( region , grid , mask );
+  }
+  assert_region( region , grid , mask );
+
+  {
+    ecl_region_type * copy = ecl_region_alloc_copy( region );
+    test_assert_true( ecl_region_equal( region , copy ));
+    assert_region( copy , grid , mask );
+    ecl_region_free( copy );
+  }
+
+  ecl_region_select_all( region );
+  for (int g = 0; g < NX*NY*NZ; g++)
+    mask[g] = true;
+  assert_region( region , grid , mask );
+
+  ecl_region_free( other );
+  ecl_region_free( region );
+  ecl_kw_free( global_int_kw );
+  ecl_kw_free( active_int_kw );
+  ecl_kw_free( active_float_kw1 );
+  ecl_kw_free( active_float_kw2 );
+}
+
+
+int main(int argc , char ** argv) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  int * actnum = util_malloc( NX*NY*NZ * sizeof * actnum );
+  for (int g = 0; g < NX*NY*NZ; g++)
+    actnum[g] = (rng_get_int( rng , 4 ) == 0) ? 0 : 1;
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , actnum );
+    test_chained_select( grid , rng );
+    ecl_grid_free( grid );
+  }
+
+  free( actnum );
+  rng_free( rng );
+  exit(0);
+}
@@ -0,0 +1,165 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_ensemble.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/bool_vector.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec_pool.h>
+#include <ert/ecl/ecl_sum_ensemble.h>
+
+#define NUM_CASES 12
+#define STEP_LENGTH 86400
+
+
+/*
+  Case iens has num_steps = 10 + iens % 3 time steps of one day, and
+  all cases except the last one have identical SMSPEC files.
+*/
+
+static void write_case( const char * case_name , int iens , time_t start_time , bool extra_well ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( case_name , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  smspec_node_type * fopt = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0 );
+  smspec_node_type * wwct = ecl_sum_add_var( ecl_sum , "WWCT" , "OP-1" , 0 , "" , 0 );
+  int num_steps = 10 + iens % 3;
+
+  if (extra_well)
+    ecl_sum_add_var( ecl_sum , "WWCT" , "OP-2" , 0 , "" , 0 );
+
+  for (int step = 0; step < num_steps; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step + 1 , (step + 1) * STEP_LENGTH );
+    ecl_sum_tstep_set_from_node( tstep , fopt , 100 * iens + step );
+    ecl_sum_tstep_set_from_node( tstep , wwct , 0.01 * step );
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+static stringlist_type * write_cases( time_t start_time ) {
+  stringlist_type * case_list = stringlist_alloc_new();
+  for (int iens = 0; iens < NUM_CASES; iens++) {
+    char * path = util_alloc_sprintf("real%d" , iens);
+    char * case_name = util_alloc_filename( path , "CASE" , NULL );
+
+    util_make_path( path );
+    write_case( case_name , iens , start_time , iens == (NUM_CASES - 1));
+    stringlist_append_copy( case_list , case_name );
+
+    free( case_name );
+    free( path );
+  }
+  stringlist_append_copy( case_list , "does/not/exist/CASE");
+  return case_list;
+}
+
+
+static void test_pool( ) {
+  ecl_smspec_pool_type * pool = ecl_smspec_pool_alloc( ":" );
+  ecl_sum_type * sum1 = ecl_smspec_pool_fread_alloc_case( pool , "real0/CASE" );
+  ecl_sum_type * sum2 = ecl_smspec_pool_fread_alloc_case( pool , "real1/CASE" );
+  ecl_sum_type * sum3 = ecl_smspec_pool_fread_alloc_case( pool , "real11/CASE" );
+
+  test_assert_true( ecl_smspec_pool_is_instance( pool ));
+  test_assert_int_equal( ecl_smspec_pool_get_size( pool ) , 2 );
+  test_assert_ptr_equal( ecl_sum_get_smspec( sum1 ) , ecl_sum_get_smspec( sum2 ));
+  test_assert_ptr_not_equal( ecl_sum_get_smspec( sum1 ) , ecl_sum_get_smspec( sum3 ));
+
+  test_assert_true( ecl_sum_same_case( sum2 , "real1/CASE" ));
+  test_assert_false( ecl_sum_same_case( sum2 , "real0/CASE" ));
+  test_assert_int_equal( ecl_sum_get_last_report_step( sum2 ) , 11 );
+  test_assert_double_equal( ecl_sum_get_general_var( sum2 , 3 , "FOPT") , 103 );
+  test_assert_NULL( ecl_smspec_pool_fread_alloc_case( pool , "real99/CASE" ));
+
+  ecl_sum_free( sum1 );
+  ecl_sum_free( sum2 );
+  ecl_sum_free( sum3 );
+  ecl_smspec_pool_free( pool );
+}
+
+
+static void test_ensemble( const stringlist_type * case_list , time_t start_time , int num_threads ) {
+  ecl_sum_ensemble_type * ensemble = ecl_sum_ensemble_fread_alloc( case_list , ":" , num_threads );
+  double_vector_type * values = double_vector_alloc( 0 , 0 );
+  bool_vector_type * valid = bool_vector_alloc( 0 , false );
+
+  test_assert_true( ecl_sum_ensemble_is_instance( ensemble ));
+  test_assert_int_equal( ecl_sum_ensemble_get_size( ensemble ) , NUM_CASES + 1 );
+  test_assert_int_equal( ecl_sum_ensemble_get_num_loaded( ensemble ) , NUM_CASES );
+  test_assert_int_equal( ecl_sum_ensemble_get_num_layouts( ensemble ) , 2 );
+  test_assert_NULL( ecl_sum_ensemble_iget( ensemble , NUM_CASES ));
+  test_assert_time_t_equal( ecl_sum_ensemble_get_start_time( ensemble ) , start_time );
+  test_assert_time_t_equal( ecl_sum_ensemble_get_end_time( ensemble ) , start_time + 12 * STEP_LENGTH );
+  test_assert_true( ecl_sum_ensemble_has_general_var( ensemble , "FOPT" ));
+  test_assert_false( ecl_sum_ensemble_has_general_var( ensemble , "WWCT:OP-2" ));
+
+  for (int iens = 0; iens < NUM_CASES; iens++) {
+    const ecl_sum_type * ecl_sum = ecl_sum_ensemble_iget( ensemble , iens );
+    test_assert_string_equal( ecl_sum_get_case( ecl_sum ) , stringlist_iget( case_list , iens ));
+    if (iens < NUM_CASES - 1)
+      test_assert_ptr_equal( ecl_sum_get_smspec( ecl_sum ) , ecl_sum_get_smspec( ecl_sum_ensemble_iget( ensemble , 0 )));
+  }
+
+  {
+    time_t sim_time = start_time + 11 * STEP_LENGTH;
+    int num_valid = ecl_sum_ensemble_get_column( ensemble , "FOPT" , sim_time , values , valid );
+
+    test_assert_int_equal( double_vector_size( values ) , NUM_CASES + 1 );
+    test_assert_int_equal( num_valid , 8 );
+    for (int iens = 0; iens < NUM_CASES; iens++) {
+      const ecl_sum_type * ecl_sum = ecl_sum_ensemble_iget( ensemble , iens );
+      bool covered = (sim_time <= ecl_sum_get_end_time( ecl_sum ));
+
+      test_assert_bool_equal( bool_vector_iget( valid , iens ) , covered );
+      if (covered)
+        test_assert_double_equal( double_vector_iget( values , iens ) , ecl_sum_get_general_var_from_sim_time( ecl_sum , sim_time , "FOPT" ));
+    }
+    test_assert_false( bool_vector_iget( valid , NUM_CASES ));
+  }
+
+  {
+    int num_valid = ecl_sum_ensemble_get_column( ensemble , "WWCT:OP-2" , start_time + STEP_LENGTH , values , NULL );
+    test_assert_int_equal( num_valid , 1 );
+    test_assert_double_equal( double_vector_iget( values , NUM_CASES - 1 ) , 0 );
+  }
+
+  bool_vector_free( valid );
+  double_vector_free( values );
+  ecl_sum_ensemble_free( ensemble );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_sum_ensemble" );
+  time_t start_time = util_make_date_utc( 1 , 1 , 2010 );
+  stringlist_type * case_list = write_cases( start_time );
+
+  test_pool( );
+  test_ensemble( case_list , start_time , 1 );
+  test_ensemble( case_list , start_time , 4 );
+
+  stringlist_free( case_list );
+  test_work_area_free( work_area );
+  exit(0);
+}
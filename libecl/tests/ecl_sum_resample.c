@@ -0,0 +1,256 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_resample.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/time_t_vector.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_vector.h>
+
+#define NUM_STEPS 40
+
+/* Exported for the Python EclSum.dumpCSVLine(); not declared in a header. */
+void ecl_sum_fwrite_interp_csv_line(const ecl_sum_type * ecl_sum, time_t sim_time, const ecl_sum_vector_type * key_words, FILE *fp);
+
+/*
+  Values which are awkward to format: negative zero, values which
+  round to zero, values close to the rounding boundary of %f and
+  values too large for the integer formatting.
+*/
+static const float special_values[] = {-0.0 , 5e-7 , -4e-7 , 2.5e-6 , 0.4999995 , -3.0000005 , 123456.789 , 1e10 , -7.5e12 , 1e20 , 3.4e38};
+
+
+static void write_summary( const char * name , time_t start_time ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  smspec_node_type * fopr = ecl_sum_add_var( ecl_sum , "FOPR" , NULL   , 0 , "SM3/DAY" , 0.0 );
+  smspec_node_type * fopt = ecl_sum_add_var( ecl_sum , "FOPT" , NULL   , 0 , "SM3"     , 0.0 );
+  smspec_node_type * wwct = ecl_sum_add_var( ecl_sum , "WWCT" , "OP-1" , 0 , "(1)"     , 0.0 );
+  double sim_seconds = 0;
+  int num_special = sizeof special_values / sizeof special_values[0];
+
+  for (int step = 0; step < NUM_STEPS; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step / 4 + 1 , sim_seconds );
+    ecl_sum_tstep_set_from_node( tstep , fopr , (step < num_special) ? special_values[step] : 100 + step );
+    ecl_sum_tstep_set_from_node( tstep , fopt , sim_seconds / 7 );
+    ecl_sum_tstep_set_from_node( tstep , wwct , (step % 2) ? -0.25 * step : 0.125 * step );
+
+    /* Irregular ministeps from 1 hour to several days. */
+    sim_seconds += 3600 * (1 + (step * 37) % 100);
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+static time_t_vector_type * alloc_target_times( const ecl_sum_type * ecl_sum , int step_seconds ) {
+  time_t_vector_type * sim_time = time_t_vector_alloc( 0 , 0 );
+  time_t t = ecl_sum_get_start_time( ecl_sum );
+  time_t end_time = ecl_sum_get_end_time( ecl_sum );
+
+  util_inplace_forward_seconds_utc( &t , step_seconds );
+  while (t < end_time) {
+    time_t_vector_append( sim_time , t );
+    util_inplace_forward_seconds_utc( &t , step_seconds );
+  }
+  time_t_vector_append( sim_time , end_time );
+  return sim_time;
+}
+
+
+static void test_csv( const ecl_sum_type * ecl_sum , const time_t_vector_type * sim_time , const stringlist_type * keys ) {
+  ecl_sum_export_resample_csv( ecl_sum , "resample.csv" , sim_time , keys , "%Y-%m-%d %H:%M:%S" , ";" );
+  {
+    FILE * stream = util_fopen( "resample.csv" , "r" );
+    bool at_eof = false;
+    char * line = util_fscanf_alloc_line( stream , &at_eof );
+
+    test_assert_string_equal( line , "DATE;FOPR;FOPT;WWCT:OP-1" );
+    free( line );
+
+    for (int i = 0; i < time_t_vector_size( sim_time ); i++) {
+      time_t t = time_t_vector_iget( sim_time , i );
+      char * expected;
+      {
+        char date_string[64];
+        struct tm ts;
+        util_time_utc( &t , &ts );
+        strftime( date_string , sizeof date_string , "%Y-%m-%d %H:%M:%S" , &ts );
+        expected = util_alloc_sprintf( "%s;%f;%f;%f" , date_string ,
+                                       ecl_sum_get_general_var_from_sim_time( ecl_sum , t , "FOPR" ),
+                                       ecl_sum_get_general_var_from_sim_time( ecl_sum , t , "FOPT" ),
+                                       ecl_sum_get_general_var_from_sim_time( ecl_sum , t , "WWCT:OP-1" ));
+      }
+      line = util_fscanf_alloc_line( stream , &at_eof );
+      test_assert_string_equal( line , expected );
+      free( line );
+      free( expected );
+    }
+    fclose( stream );
+  }
+}
+
+
+static void test_binary( const ecl_sum_type * ecl_sum , const time_t_vector_type * sim_time , const stringlist_type * keys ) {
+  int num_keys = stringlist_get_size( keys );
+  int num_values = time_t_vector_size( sim_time ) * num_keys;
+  double * values = util_calloc( num_values , sizeof * values );
+
+  ecl_sum_export_resample_binary( ecl_sum , "resample.bin" , sim_time , keys );
+  test_assert_int_equal( util_file_size( "resample.bin" ) , num_values * sizeof * values );
+  {
+    FILE * stream = util_fopen( "resample.bin" , "r" );
+    util_fread( values , sizeof * values , num_values , stream , __func__ );
+    fclose( stream );
+  }
+
+  for (int i = 0; i < time_t_vector_size( sim_time ); i++) {
+    time_t t = time_t_vector_iget( sim_time , i );
+    for (int k = 0; k < num_keys; k++)
+      test_assert_true( values[i * num_keys + k] == ecl_sum_get_general_var_from_sim_time( ecl_sum , t , stringlist_iget( keys , k )));
+  }
+  free( values );
+}
+
+
+static void test_csv_line( const ecl_sum_type * ecl_sum , const time_t_vector_type * sim_time , const stringlist_type * keys ) {
+  ecl_sum_vector_type * keylist = ecl_sum_vector_alloc( ecl_sum );
+  for (int k = 0; k < stringlist_get_size( keys ); k++)
+    ecl_sum_vector_add_key( keylist , stringlist_iget( keys , k ));
+
+  {
+    FILE * stream = util_fopen( "lines.csv" , "w" );
+    for (int i = 0; i < time_t_vector_size( sim_time ); i++) {
+      ecl_sum_fwrite_interp_csv_line( ecl_sum , time_t_vector_iget( sim_time , i ) , keylist , stream );
+      fprintf( stream , "\n" );
+    }
+    fclose( stream );
+  }
+
+  {
+    FILE * stream = util_fopen( "lines.csv" , "r" );
+    bool at_eof = false;
+    for (int i = 0; i < time_t_vector_size( sim_time ); i++) {
+      time_t t = time_t_vector_iget( sim_time , i );
+      char * line = util_fscanf_alloc_line( stream , &at_eof );
+      char * expected = util_alloc_sprintf( "%f,%f,%f" ,
+                                            ecl_sum_get_general_var_from_sim_time( ecl_sum , t , "FOPR" ),
+                                            ecl_sum_get_general_var_from_sim_time( ecl_sum , t , "FOPT" ),
+                                            ecl_sum_get_general_var_from_sim_time( ecl_sum , t , "WWCT:OP-1" ));
+      test_assert_string_equal( line , expected );
+      free( expected );
+      free( line );
+    }
+    fclose( stream );
+  }
+  ecl_sum_vector_free( keylist );
+}
+
+
+static void export_missing_key( void * arg ) {
+  const ecl_sum_type * ecl_sum = arg;
+  time_t_vector_type * sim_time = time_t_vector_alloc( 1 , ecl_sum_get_start_time( ecl_sum ));
+  stringlist_type * keys = stringlist_alloc_new( );
+
+  stringlist_append_ref( keys , "FOPT" );
+  stringlist_append_ref( keys , "NO:SUCH:KEY" );
+  ecl_sum_export_resample_binary( ecl_sum , "missing.bin" , sim_time , keys );
+
+  stringlist_free( keys );
+  time_t_vector_free( sim_time );
+}
+
+
+/*
+  At the start time the rates are taken from the first ministep, and
+  the other variables are also evaluated at the first ministep.
+*/
+
+static void test_start( const ecl_sum_type * ecl_sum ) {
+  time_t_vector_type * sim_time = time_t_vector_alloc( 0 , 0 );
+  stringlist_type * keys = stringlist_alloc_new( );
+  double values[2];
+
+  time_t_vector_append( sim_time , ecl_sum_get_start_time( ecl_sum ));
+  time_t_vector_append( sim_time , ecl_sum_iget_sim_time( ecl_sum , 1 ));
+  stringlist_append_ref( keys , "FOPT" );
+
+  ecl_sum_export_resample_binary( ecl_sum , "start.bin" , sim_time , keys );
+  {
+    FILE * stream = util_fopen( "start.bin" , "r" );
+    util_fread( values , sizeof values[0] , 2 , stream , __func__ );
+    fclose( stream );
+  }
+  test_assert_double_equal( values[0] , ecl_sum_get_general_var( ecl_sum , 0 , "FOPT" ));
+  test_assert_double_equal( values[1] , ecl_sum_get_general_var( ecl_sum , 1 , "FOPT" ));
+
+  stringlist_free( keys );
+  time_t_vector_free( sim_time );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_sum_resample" );
+  write_summary( "CASE" , util_make_date_utc( 1 , 1 , 2010 ));
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+    stringlist_type * keys = stringlist_alloc_new( );
+
+    test_assert_true( ecl_sum_var_is_rate( ecl_sum , "FOPR" ));
+    test_assert_false( ecl_sum_var_is_rate( ecl_sum , "FOPT" ));
+
+    stringlist_append_ref( keys , "FOPR" );
+    stringlist_append_ref( keys , "FOPT" );
+    stringlist_append_ref( keys , "WWCT:OP-1" );
+
+    {
+      int step_seconds[] = {1800 , 4 * 3600 , 86400 , 3 * 86400 + 17};
+      for (int i = 0; i < 4; i++) {
+        time_t_vector_type * sim_time = alloc_target_times( ecl_sum , step_seconds[i] );
+        test_csv( ecl_sum , sim_time , keys );
+        test_binary( ecl_sum , sim_time , keys );
+        test_csv_line( ecl_sum , sim_time , keys );
+        time_t_vector_free( sim_time );
+      }
+    }
+
+    {
+      time_t_vector_type * sim_time = time_t_vector_alloc( 0 , 0 );
+      for (int i = 1; i < ecl_sum_get_data_length( ecl_sum ); i++)
+        time_t_vector_append( sim_time , ecl_sum_iget_sim_time( ecl_sum , i ));
+      test_csv( ecl_sum , sim_time , keys );
+      test_binary( ecl_sum , sim_time , keys );
+      test_csv_line( ecl_sum , sim_time , keys );
+      time_t_vector_free( sim_time );
+    }
+
+    test_start( ecl_sum );
+    test_assert_util_abort( "ecl_sum_export_resample_binary" , export_missing_key , ecl_sum );
+
+    stringlist_free( keys );
+    ecl_sum_free( ecl_sum );
+  }
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,152 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_stream.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_stream.h>
+
+#define NUM_STEPS 30
+
+
+static ecl_sum_type * alloc_writer( const char * name , bool unified ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , unified , ":" , util_make_date_utc( 1 , 1 , 2010 ) , true , 10 , 10 , 10 );
+  ecl_sum_add_var( ecl_sum , "FOPR" , NULL   , 0 , "SM3/DAY" , 0.0 );
+  ecl_sum_add_var( ecl_sum , "FOPT" , NULL   , 0 , "SM3"     , 0.0 );
+  ecl_sum_add_var( ecl_sum , "WWCT" , "OP-1" , 0 , "(1)"     , 0.0 );
+  return ecl_sum;
+}
+
+
+static int step_report( int step ) {
+  return step / 4 + 1;
+}
+
+
+static double step_seconds( int step ) {
+  return 86400.0 * step;
+}
+
+
+static void set_values( ecl_sum_tstep_type * tstep , int step ) {
+  ecl_sum_tstep_set_from_key( tstep , "FOPR" , 100 + step );
+  ecl_sum_tstep_set_from_key( tstep , "FOPT" , 1000 * step );
+  ecl_sum_tstep_set_from_key( tstep , "WWCT:OP-1" , 0.01 * step );
+}
+
+
+static void write_reference( const char * name , bool unified ) {
+  ecl_sum_type * ecl_sum = alloc_writer( name , unified );
+  for (int step = 0; step < NUM_STEPS; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , step_report( step ) , step_seconds( step ));
+    set_values( tstep , step );
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+}
+
+
+static void write_stream( const char * name , bool unified , bool append , int step1 , int step2 ) {
+  ecl_sum_type * ecl_sum = alloc_writer( name , unified );
+  ecl_sum_stream_type * stream = ecl_sum_stream_alloc( ecl_sum , append );
+
+  test_assert_true( ecl_sum_stream_is_instance( stream ));
+  if (append)
+    test_assert_int_equal( ecl_sum_stream_get_ministep( stream ) , step1 - 1 );
+
+  for (int step = step1; step < step2; step++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_stream_add_tstep( stream , step_report( step ) , step_seconds( step ));
+    set_values( tstep , step );
+  }
+  test_assert_int_equal( ecl_sum_stream_get_report_step( stream ) , step_report( step2 - 1 ));
+  ecl_sum_stream_free( stream );
+  ecl_sum_free( ecl_sum );
+}
+
+
+static void assert_equal_case( const char * ref_name , const char * name ) {
+  ecl_sum_type * ref = ecl_sum_fread_alloc_case( ref_name , ":" );
+  ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( name , ":" );
+
+  test_assert_not_NULL( ecl_sum );
+  test_assert_int_equal( ecl_sum_get_data_length( ecl_sum ) , ecl_sum_get_data_length( ref ));
+  test_assert_int_equal( ecl_sum_get_first_report_step( ecl_sum ) , ecl_sum_get_first_report_step( ref ));
+  test_assert_int_equal( ecl_sum_get_last_report_step( ecl_sum ) , ecl_sum_get_last_report_step( ref ));
+
+  for (int i = 0; i < ecl_sum_get_data_length( ref ); i++) {
+    test_assert_int_equal( ecl_sum_iget_report_step( ecl_sum , i ) , ecl_sum_iget_report_step( ref , i ));
+    test_assert_int_equal( ecl_sum_iget_mini_step( ecl_sum , i ) , ecl_sum_iget_mini_step( ref , i ));
+    test_assert_double_equal( ecl_sum_iget_sim_days( ecl_sum , i ) , ecl_sum_iget_sim_days( ref , i ));
+    test_assert_double_equal( ecl_sum_get_general_var( ecl_sum , i , "FOPR" ) , ecl_sum_get_general_var( ref , i , "FOPR" ));
+    test_assert_double_equal( ecl_sum_get_general_var( ecl_sum , i , "FOPT" ) , ecl_sum_get_general_var( ref , i , "FOPT" ));
+    test_assert_double_equal( ecl_sum_get_general_var( ecl_sum , i , "WWCT:OP-1" ) , ecl_sum_get_general_var( ref , i , "WWCT:OP-1" ));
+  }
+
+  ecl_sum_free( ecl_sum );
+  ecl_sum_free( ref );
+}
+
+
+static void test_stream( bool unified ) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_sum_stream" );
+  write_reference( "REF" , unified );
+
+  write_stream( "STREAM" , unified , false , 0 , NUM_STEPS );
+  assert_equal_case( "REF" , "STREAM" );
+
+  /* Append mode: the first append continues report step 3, the second starts on a report boundary. */
+  write_stream( "APPEND" , unified , false , 0 , 10 );
+  write_stream( "APPEND" , unified , true , 10 , 20 );
+  write_stream( "APPEND" , unified , true , 20 , NUM_STEPS );
+  assert_equal_case( "REF" , "APPEND" );
+
+  /* Without append the old data is discarded. */
+  write_stream( "APPEND" , unified , false , 0 , NUM_STEPS );
+  assert_equal_case( "REF" , "APPEND" );
+
+  /* Append mode on a case which does not exist starts a new case. */
+  write_stream( "NEW" , unified , true , 0 , NUM_STEPS );
+  assert_equal_case( "REF" , "NEW" );
+
+  test_work_area_free( work_area );
+}
+
+
+static void test_stale_files( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "ecl_sum_stream_stale" );
+  write_stream( "CASE" , false , false , 0 , NUM_STEPS );
+  write_stream( "CASE" , false , false , 0 , 10 );
+  {
+    ecl_sum_type * ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+    test_assert_int_equal( ecl_sum_get_data_length( ecl_sum ) , 10 );
+    ecl_sum_free( ecl_sum );
+  }
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv) {
+  test_stream( true );
+  test_stream( false );
+  test_stale_files( );
+  exit(0);
+}
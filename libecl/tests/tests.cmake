@@ -38,6 +38,18 @@ add_executable( ecl_sum_writer ecl_sum_writer.c )
 target_link_libraries( ecl_sum_writer ecl  )
 add_test( ecl_sum_writer ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_writer )
 
+add_executable( ecl_sum_resample ecl_sum_resample.c )
+target_link_libraries( ecl_sum_resample ecl  )
+add_test( ecl_sum_resample ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_resample )
+
+add_executable( ecl_sum_stream ecl_sum_stream.c )
+target_link_libraries( ecl_sum_stream ecl  )
+add_test( ecl_sum_stream ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_stream )
+
+add_executable( ecl_sum_ensemble ecl_sum_ensemble.c )
+target_link_libraries( ecl_sum_ensemble ecl  )
+add_test( ecl_sum_ensemble ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_ensemble )
+
 add_executable( ecl_grid_add_nnc ecl_grid_add_nnc.c )
 target_link_libraries( ecl_grid_add_nnc ecl  )
 add_test( ecl_grid_add_nnc ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_add_nnc )
@@ -58,6 +70,10 @@ add_executable( ecl_nnc_info_test ecl_nnc_info_test.c )
 target_link_libraries( ecl_nnc_info_test ecl  )
 add_test (ecl_nnc_info_test ${EXECUTABLE_OUTPUT_PATH}/ecl_nnc_info_test )
 
+add_executable( ecl_nnc_export_intrinsic ecl_nnc_export_intrinsic.c )
+target_link_libraries( ecl_nnc_export_intrinsic ecl  )
+add_test( ecl_nnc_export_intrinsic ${EXECUTABLE_OUTPUT_PATH}/ecl_nnc_export_intrinsic )
+
 add_executable( ecl_nnc_vector ecl_nnc_vector.c )
 target_link_libraries( ecl_nnc_vector ecl  )
 add_test(ecl_nnc_vector ${EXECUTABLE_OUTPUT_PATH}/ecl_nnc_vector )
@@ -96,6 +112,14 @@ add_executable( ecl_grid_copy ecl_grid_copy.c )
 target_link_libraries( ecl_grid_copy ecl  )
 add_test( ecl_grid_copy ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_copy )
 
+add_executable( ecl_grid_load_threads ecl_grid_load_threads.c )
+target_link_libraries( ecl_grid_load_threads ecl )
+add_test( ecl_grid_load_threads ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_load_threads )
+
+add_executable( ecl_region_select ecl_region_select.c )
+target_link_libraries( ecl_region_select ecl  )
+add_test( ecl_region_select ${EXECUTABLE_OUTPUT_PATH}/ecl_region_select )
+
 add_executable( ecl_get_num_cpu ecl_get_num_cpu_test.c )
 target_link_libraries( ecl_get_num_cpu ecl  )
 add_test( ecl_get_num_cpu ${EXECUTABLE_OUTPUT_PATH}/ecl_get_num_cpu 
@@ -116,4 +140,8 @@ add_executable( ecl_rst_file ecl_rst_file.c )
 target_link_libraries( ecl_rst_file ecl ert_util )
 add_test( ecl_rst_file ${EXECUTABLE_OUTPUT_PATH}/ecl_rst_file  )
 
+add_executable( ecl_file_view ecl_file_view.c )
+target_link_libraries( ecl_file_view ecl ert_util )
+add_test( ecl_file_view ${EXECUTABLE_OUTPUT_PATH}/ecl_file_view  )
+
 add_test( ecl_grid_cell_contains1 ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_cell_contains )
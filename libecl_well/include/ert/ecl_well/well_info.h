@@ -37,6 +37,7 @@ extern "C" {
   void              well_info_add_wells( well_info_type * well_info , ecl_file_type * rst_file , int report_nr , bool load_segment_information);
   void              well_info_add_wells2( well_info_type * well_info , ecl_file_view_type * rst_view , int report_nr, bool load_segment_information);
   void              well_info_load_rstfile( well_info_type * well_info , const char * filename, bool load_segment_information);
+  void              well_info_load_rstfile_mt( well_info_type * well_info , const char * filename , bool load_segment_information , int num_threads);
   void              well_info_load_rst_eclfile( well_info_type * well_info , ecl_file_type * rst_file , bool load_segment_information);
   void              well_info_free( well_info_type * well_info );
 
@@ -19,10 +19,15 @@
 #include <time.h>
 #include <stdbool.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/vector.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
 
 #include <ert/ecl/ecl_rsthead.h>
 #include <ert/ecl/ecl_file.h>
@@ -275,14 +280,14 @@ static void well_info_add_state( well_info_type * well_info , well_state_type *
  */
 
 
-void well_info_add_wells2( well_info_type * well_info , ecl_file_view_type * rst_view , int report_nr, bool load_segment_information) {
+static void well_info_load_states( const ecl_grid_type * grid , ecl_file_view_type * rst_view , int report_nr , bool load_segment_information , vector_type * state_list) {
   bool close_stream = ecl_file_view_drop_flag( rst_view , ECL_FILE_CLOSE_STREAM );
   ecl_rsthead_type * global_header = ecl_rsthead_alloc( rst_view , report_nr );
   int well_nr;
   for (well_nr = 0; well_nr < global_header->nwells; well_nr++) {
-    well_state_type * well_state = well_state_alloc_from_file2( rst_view , well_info->grid , report_nr , well_nr , load_segment_information );
+    well_state_type * well_state = well_state_alloc_from_file2( rst_view , grid , report_nr , well_nr , load_segment_information );
     if (well_state != NULL)
-      well_info_add_state( well_info , well_state );
+      vector_append_ref( state_list , well_state );
   }
   ecl_rsthead_free( global_header );
   if (close_stream)
@@ -290,6 +295,26 @@ void well_info_add_wells2( well_info_type * well_info , ecl_file_view_type * rst
 }
 
 
+/*
+  The well_state instances in @state_list are handed over to the
+  well_info structure.
+*/
+
+static void well_info_add_states( well_info_type * well_info , const vector_type * state_list) {
+  int i;
+  for (i=0; i < vector_get_size( state_list ); i++)
+    well_info_add_state( well_info , vector_iget( state_list , i ));
+}
+
+
+void well_info_add_wells2( well_info_type * well_info , ecl_file_view_type * rst_view , int report_nr, bool load_segment_information) {
+  vector_type * state_list = vector_alloc_new();
+  well_info_load_states( well_info->grid , rst_view , report_nr , load_segment_information , state_list );
+  well_info_add_states( well_info , state_list );
+  vector_free( state_list );
+}
+
+
 void well_info_add_wells( well_info_type * well_info , ecl_file_type * rst_file , int report_nr, bool load_segment_information) {
   well_info_add_wells2( well_info , ecl_file_get_active_view( rst_file ) , report_nr , load_segment_information );
 }
@@ -301,14 +326,14 @@ void well_info_add_wells( well_info_type * well_info , ecl_file_type * rst_file
 */
 
 void well_info_add_UNRST_wells2( well_info_type * well_info , ecl_file_view_type * rst_view, bool load_segment_information) {
-  int num_blocks = ecl_file_view_get_num_named_kw( rst_view , SEQNUM_KW );
-  int block_nr;
-  for (block_nr = 0; block_nr < num_blocks; block_nr++) {
-    ecl_file_view_type * step_view = ecl_file_view_add_restart_view(rst_view, block_nr , -1 , -1 , -1 );
+  ecl_file_view_block_iter_type * iter = ecl_file_view_alloc_block_iter( rst_view , SEQNUM_KW , SEQNUM_KW );
+  ecl_file_view_type * step_view;
+  while ((step_view = ecl_file_view_block_iter_next( iter ))) {
     const ecl_kw_type * seqnum_kw = ecl_file_view_iget_named_kw( step_view , SEQNUM_KW , 0);
     int report_nr = ecl_kw_iget_int( seqnum_kw , 0 );
     well_info_add_wells2( well_info , step_view , report_nr , load_segment_information );
   }
+  ecl_file_view_block_iter_free( iter );
 }
 
 
@@ -331,6 +356,118 @@ void well_info_load_rstfile( well_info_type * well_info , const char * filename,
 }
 
 
+/*
+  Parallel loading of a unified restart file. The report steps are
+  split in contiguous ranges, one range per worker, and each worker
+  decodes its range into a list of well_state instances per report
+  step. The keywords of a report step are unloaded as soon as the step
+  has been decoded, so the memory usage is bounded by one report step
+  per worker. When all the workers are complete the well_state
+  instances are added to the well_info structure in report order.
+
+  The file is only scanned once, by the calling thread; worker number
+  zero reuses that ecl_file instance, and the other workers get an
+  ecl_file instance with a copy of the keyword index and a separate
+  file handle, from ecl_file_open_index_copy().
+*/
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+typedef struct {
+  const ecl_grid_type * grid;
+  ecl_file_type       * ecl_file;
+  bool                  load_segment_information;
+  int                   step_begin;     /* The worker loads the report steps [step_begin , step_end). */
+  int                   step_end;
+  vector_type         * step_list;      /* Shared: one state list for each report step. */
+} well_info_loader_type;
+
+
+static void * well_info_load_UNRST_worker( void * arg ) {
+  well_info_loader_type * loader = arg;
+  ecl_file_view_type * global_view = ecl_file_get_global_view( loader->ecl_file );
+
+  for (int step = loader->step_begin; step < loader->step_end; step++) {
+    ecl_file_view_type * step_view = ecl_file_view_alloc_blockview( global_view , SEQNUM_KW , step );
+    const ecl_kw_type * seqnum_kw = ecl_file_view_iget_named_kw( step_view , SEQNUM_KW , 0);
+    int report_nr = ecl_kw_iget_int( seqnum_kw , 0 );
+
+    well_info_load_states( loader->grid , step_view , report_nr , loader->load_segment_information , vector_iget( loader->step_list , step ));
+    ecl_file_view_unload_all( step_view );
+    ecl_file_view_free( step_view );
+  }
+
+  return NULL;
+}
+
+
+static void well_info_load_UNRST_parallel( well_info_type * well_info , ecl_file_type * ecl_file , bool load_segment_information , int num_threads) {
+  int num_steps = ecl_file_get_num_named_kw( ecl_file , SEQNUM_KW );
+  int num_workers = util_int_min( num_threads , num_steps );
+  vector_type * step_list = vector_alloc_new();
+  well_info_loader_type * loader_list = util_calloc( num_workers , sizeof * loader_list );
+
+  for (int step = 0; step < num_steps; step++)
+    vector_append_owned_ref( step_list , vector_alloc_new() , vector_free__ );
+
+  for (int worker_nr = 0; worker_nr < num_workers; worker_nr++) {
+    well_info_loader_type * loader = &loader_list[worker_nr];
+
+    loader->grid = well_info->grid;
+    loader->ecl_file = (worker_nr == 0) ? ecl_file : ecl_file_open_index_copy( ecl_file , 0 );
+    loader->load_segment_information = load_segment_information;
+    loader->step_begin = num_steps * worker_nr / num_workers;
+    loader->step_end = num_steps * (worker_nr + 1) / num_workers;
+    loader->step_list = step_list;
+
+    if (loader->ecl_file == NULL)
+      util_abort("%s: failed to open %s \n",__func__ , ecl_file_get_src_file( ecl_file ));
+  }
+
+  {
+    thread_pool_type * tp = thread_pool_alloc( num_workers , true );
+    for (int worker_nr = 0; worker_nr < num_workers; worker_nr++)
+      thread_pool_add_job( tp , well_info_load_UNRST_worker , &loader_list[worker_nr] );
+
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  }
+
+  for (int worker_nr = 1; worker_nr < num_workers; worker_nr++)
+    ecl_file_close( loader_list[worker_nr].ecl_file );
+
+  for (int step = 0; step < num_steps; step++)
+    well_info_add_states( well_info , vector_iget_const( step_list , step ));
+
+  free( loader_list );
+  vector_free( step_list );
+}
+
+#endif
+
+
+/**
+   Will load all the wells from the restart file @filename using
+   @num_threads threads; the end result is identical to
+   well_info_load_rstfile(). Only unified restart files are loaded in
+   parallel, and only if thread support is available; otherwise the
+   function falls back to well_info_load_rstfile().
+*/
+
+void well_info_load_rstfile_mt( well_info_type * well_info , const char * filename , bool load_segment_information , int num_threads) {
+#ifdef ERT_HAVE_THREAD_POOL
+  if ((num_threads > 1) && (ecl_util_get_file_type( filename , NULL , NULL ) == ECL_UNIFIED_RESTART_FILE)) {
+    ecl_file_type * ecl_file = ecl_file_open( filename , 0);
+    if (ecl_file_get_num_named_kw( ecl_file , SEQNUM_KW ) > 0)
+      well_info_load_UNRST_parallel( well_info , ecl_file , load_segment_information , num_threads );
+    ecl_file_close( ecl_file );
+    return;
+  }
+#endif
+  well_info_load_rstfile( well_info , filename , load_segment_information );
+}
+
+
 void well_info_load_rst_eclfile( well_info_type * well_info , ecl_file_type * ecl_file, bool load_segment_information) {
   int report_nr;
   const char* filename = ecl_file_get_src_file(ecl_file);
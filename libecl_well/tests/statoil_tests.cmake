@@ -43,6 +43,8 @@ add_executable( well_info well_info.c )
 target_link_libraries( well_info ecl_well  )
 set_target_properties( well_info PROPERTIES COMPILE_FLAGS "-Werror")                                    
 add_test( well_info ${EXECUTABLE_OUTPUT_PATH}/well_info ${PROJECT_SOURCE_DIR}/test-data/Statoil/ECLIPSE/Gurbat/ECLIPSE.EGRID )
+add_test( well_info_load_mt ${EXECUTABLE_OUTPUT_PATH}/well_info ${PROJECT_SOURCE_DIR}/test-data/Statoil/ECLIPSE/Gurbat/ECLIPSE.EGRID
+                                                                ${PROJECT_SOURCE_DIR}/test-data/Statoil/ECLIPSE/Gurbat/ECLIPSE.UNRST )
 
 
 add_executable( well_conn_CF well_conn_CF.c )
@@ -33,3 +33,7 @@ target_link_libraries( well_segment_collection ecl_well  )
 set_target_properties( well_segment_collection PROPERTIES COMPILE_FLAGS "-Werror")                                    
 add_test( well_segment_collection ${EXECUTABLE_OUTPUT_PATH}/well_segment_collection )
 
+add_executable( well_info_load_rstfile_mt well_info_load_rstfile_mt.c )
+target_link_libraries( well_info_load_rstfile_mt ecl_well  )
+set_target_properties( well_info_load_rstfile_mt PROPERTIES COMPILE_FLAGS "-Werror")
+add_test( well_info_load_rstfile_mt ${EXECUTABLE_OUTPUT_PATH}/well_info_load_rstfile_mt )
@@ -27,6 +27,38 @@
 
 
 #include <ert/ecl_well/well_info.h>
+#include <ert/ecl_well/well_ts.h>
+#include <ert/ecl_well/well_state.h>
+
+
+void test_load_mt( const ecl_grid_type * grid , const char * rst_file ) {
+  well_info_type * well_info = well_info_alloc( grid );
+  well_info_type * well_info_mt = well_info_alloc( grid );
+
+  well_info_load_rstfile( well_info , rst_file , true );
+  well_info_load_rstfile_mt( well_info_mt , rst_file , true , 4 );
+
+  test_assert_int_equal( well_info_get_num_wells( well_info ) , well_info_get_num_wells( well_info_mt ));
+  for (int iwell = 0; iwell < well_info_get_num_wells( well_info ); iwell++) {
+    const char * well_name = well_info_iget_well_name( well_info , iwell );
+    well_ts_type * well_ts = well_info_get_ts( well_info , well_name );
+    well_ts_type * well_ts_mt = well_info_get_ts( well_info_mt , well_name );
+
+    test_assert_int_equal( well_ts_get_size( well_ts ) , well_ts_get_size( well_ts_mt ));
+    for (int i = 0; i < well_ts_get_size( well_ts ); i++) {
+      well_state_type * well_state = well_ts_iget_state( well_ts , i );
+      well_state_type * well_state_mt = well_ts_iget_state( well_ts_mt , i );
+
+      test_assert_int_equal( well_state_get_report_nr( well_state ) , well_state_get_report_nr( well_state_mt ));
+      test_assert_time_t_equal( well_state_get_sim_time( well_state ) , well_state_get_sim_time( well_state_mt ));
+      test_assert_int_equal( well_state_get_type( well_state ) , well_state_get_type( well_state_mt ));
+      test_assert_bool_equal( well_state_is_open( well_state ) , well_state_is_open( well_state_mt ));
+    }
+  }
+
+  well_info_free( well_info_mt );
+  well_info_free( well_info );
+}
 
 
 int main(int argc , char ** argv) {
@@ -39,6 +71,8 @@ int main(int argc , char ** argv) {
     test_assert_not_NULL( well_info );
     well_info_free( well_info );
   }
+  if (argc > 2)
+    test_load_mt( grid , argv[2] );
   ecl_grid_free( grid );
   exit(0);
 }
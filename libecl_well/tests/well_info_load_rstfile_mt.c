@@ -0,0 +1,303 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'well_info_load_rstfile_mt.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+
+#include <ert/ecl_well/well_const.h>
+#include <ert/ecl_well/well_conn.h>
+#include <ert/ecl_well/well_conn_collection.h>
+#include <ert/ecl_well/well_info.h>
+#include <ert/ecl_well/well_state.h>
+#include <ert/ecl_well/well_ts.h>
+
+/*
+  Writes a small unified restart file by hand and checks that
+  well_info_load_rstfile_mt() gives exactly the same wells, states and
+  connections as the serial well_info_load_rstfile().
+*/
+
+#define NX 10
+#define NY 10
+#define NZ 10
+
+#define NUM_STEPS 16
+#define NCWMAX     4
+#define NIWELZ    16
+#define NZWELZ     3
+#define NXWELZ     8
+#define NICONZ    20
+#define NSCONZ     4
+#define NXCONZ    52
+
+static const char * well_names[] = {"OP_1" , "WI_1" , "OP_2"};
+#define NUM_WELLS 3
+
+
+/* The wells are not all present at all report steps. */
+static bool well_active( int well , int step ) {
+  if (well == 1)
+    return (step >= 3);
+
+  if (well == 2)
+    return (step >= 5) && (step <= 10);
+
+  return true;
+}
+
+
+static int well_num_conn( int well , int step ) {
+  return 1 + (step + well) % NCWMAX;
+}
+
+
+static void write_step( fortio_type * fortio , int step ) {
+  int nwells = 0;
+  for (int well = 0; well < NUM_WELLS; well++)
+    if (well_active( well , step ))
+      nwells++;
+
+  {
+    ecl_kw_type * seqnum_kw   = ecl_kw_alloc( SEQNUM_KW   , 1 , ECL_INT );
+    ecl_kw_type * intehead_kw = ecl_kw_alloc( INTEHEAD_KW , INTEHEAD_RESTART_SIZE , ECL_INT );
+    ecl_kw_type * logihead_kw = ecl_kw_alloc( LOGIHEAD_KW , LOGIHEAD_RESTART_SIZE , ECL_BOOL );
+    ecl_kw_type * doubhead_kw = ecl_kw_alloc( DOUBHEAD_KW , DOUBHEAD_RESTART_SIZE , ECL_DOUBLE );
+    ecl_kw_type * iwel_kw     = ecl_kw_alloc( IWEL_KW , nwells * NIWELZ , ECL_INT );
+    ecl_kw_type * zwel_kw     = ecl_kw_alloc( ZWEL_KW , nwells * NZWELZ , ECL_CHAR );
+    ecl_kw_type * xwel_kw     = ecl_kw_alloc( XWEL_KW , nwells * NXWELZ , ECL_DOUBLE );
+    ecl_kw_type * icon_kw     = ecl_kw_alloc( ICON_KW , nwells * NCWMAX * NICONZ , ECL_INT );
+    ecl_kw_type * scon_kw     = ecl_kw_alloc( SCON_KW , nwells * NCWMAX * NSCONZ , ECL_FLOAT );
+    ecl_kw_type * xcon_kw     = ecl_kw_alloc( XCON_KW , nwells * NCWMAX * NXCONZ , ECL_DOUBLE );
+
+    ecl_kw_iset_int( seqnum_kw , 0 , step );
+
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_DAY_INDEX    , 1 );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_MONTH_INDEX  , 1 + step % 12 );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_YEAR_INDEX   , 2000 + step / 12 );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_IPROG_INDEX  , INTEHEAD_ECLIPSE100_VALUE );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NX_INDEX     , NX );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NY_INDEX     , NY );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NZ_INDEX     , NZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NACTIVE_INDEX, NX * NY * NZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NWELLS_INDEX , nwells );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NCWMAX_INDEX , NCWMAX );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NIWELZ_INDEX , NIWELZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NXWELZ_INDEX , NXWELZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NZWELZ_INDEX , NZWELZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NICONZ_INDEX , NICONZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NSCONZ_INDEX , NSCONZ );
+    ecl_kw_iset_int( intehead_kw , INTEHEAD_NXCONZ_INDEX , NXCONZ );
+
+    ecl_kw_iset_double( doubhead_kw , DOUBHEAD_DAYS_INDEX , 30.0 * step );
+
+    {
+      int well_nr = 0;
+      for (int well = 0; well < NUM_WELLS; well++) {
+        if (!well_active( well , step ))
+          continue;
+
+        {
+          int iwel_offset = well_nr * NIWELZ;
+          int num_conn = well_num_conn( well , step );
+
+          ecl_kw_iset_int( iwel_kw , iwel_offset + IWEL_HEADI_INDEX , 3 * well + 1 );
+          ecl_kw_iset_int( iwel_kw , iwel_offset + IWEL_HEADJ_INDEX , well + 2 );
+          ecl_kw_iset_int( iwel_kw , iwel_offset + IWEL_HEADK_INDEX , 1 );
+          ecl_kw_iset_int( iwel_kw , iwel_offset + IWEL_CONNECTIONS_INDEX , num_conn );
+          ecl_kw_iset_int( iwel_kw , iwel_offset + IWEL_TYPE_INDEX , (well == 1) ? IWEL_WATER_INJECTOR : IWEL_PRODUCER );
+          ecl_kw_iset_int( iwel_kw , iwel_offset + IWEL_STATUS_INDEX , ((step + well) % 5 == 0) ? -1 : 1 );
+
+          ecl_kw_iset_string8( zwel_kw , well_nr * NZWELZ , well_names[well] );
+
+          ecl_kw_iset_double( xwel_kw , well_nr * NXWELZ + XWEL_RES_WRAT_ITEM , 10.0 * step + well );
+          ecl_kw_iset_double( xwel_kw , well_nr * NXWELZ + XWEL_RES_GRAT_ITEM , 20.0 * step + well );
+          ecl_kw_iset_double( xwel_kw , well_nr * NXWELZ + XWEL_RES_ORAT_ITEM , 30.0 * step + well );
+          ecl_kw_iset_double( xwel_kw , well_nr * NXWELZ + XWEL_RESV_ITEM     , 40.0 * step + well );
+
+          for (int conn = 0; conn < num_conn; conn++) {
+            int index = NCWMAX * well_nr + conn;
+            int icon_offset = NICONZ * index;
+
+            ecl_kw_iset_int( icon_kw , icon_offset + ICON_IC_INDEX , conn + 1 );
+            ecl_kw_iset_int( icon_kw , icon_offset + ICON_I_INDEX  , 3 * well + 1 );
+            ecl_kw_iset_int( icon_kw , icon_offset + ICON_J_INDEX  , well + 2 );
+            ecl_kw_iset_int( icon_kw , icon_offset + ICON_K_INDEX  , conn + 1 + step % 3 );
+            ecl_kw_iset_int( icon_kw , icon_offset + ICON_STATUS_INDEX , ((conn + step) % 2) ? 1 : -1 );
+            ecl_kw_iset_int( icon_kw , icon_offset + ICON_DIRECTION_INDEX , conn % 3 );
+
+            ecl_kw_iset_float( scon_kw , NSCONZ * index + SCON_CF_INDEX , 1.0 + step + 0.25 * conn );
+
+            ecl_kw_iset_double( xcon_kw , NXCONZ * index + XCON_WRAT_INDEX , 1.0 * step + conn );
+            ecl_kw_iset_double( xcon_kw , NXCONZ * index + XCON_GRAT_INDEX , 2.0 * step + conn );
+            ecl_kw_iset_double( xcon_kw , NXCONZ * index + XCON_ORAT_INDEX , 3.0 * step + conn );
+            ecl_kw_iset_double( xcon_kw , NXCONZ * index + XCON_QR_INDEX   , 4.0 * step + conn );
+          }
+        }
+        well_nr++;
+      }
+    }
+
+    ecl_kw_fwrite( seqnum_kw , fortio );
+    ecl_kw_fwrite( intehead_kw , fortio );
+    ecl_kw_fwrite( logihead_kw , fortio );
+    ecl_kw_fwrite( doubhead_kw , fortio );
+    ecl_kw_fwrite( iwel_kw , fortio );
+    ecl_kw_fwrite( zwel_kw , fortio );
+    ecl_kw_fwrite( xwel_kw , fortio );
+    ecl_kw_fwrite( icon_kw , fortio );
+    ecl_kw_fwrite( scon_kw , fortio );
+    ecl_kw_fwrite( xcon_kw , fortio );
+
+    ecl_kw_free( seqnum_kw );
+    ecl_kw_free( intehead_kw );
+    ecl_kw_free( logihead_kw );
+    ecl_kw_free( doubhead_kw );
+    ecl_kw_free( iwel_kw );
+    ecl_kw_free( zwel_kw );
+    ecl_kw_free( xwel_kw );
+    ecl_kw_free( icon_kw );
+    ecl_kw_free( scon_kw );
+    ecl_kw_free( xcon_kw );
+  }
+}
+
+
+static void write_rstfile( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  for (int step = 0; step < NUM_STEPS; step++)
+    write_step( fortio , step );
+  fortio_fclose( fortio );
+}
+
+
+static void assert_conn_equal( const well_conn_type * conn1 , const well_conn_type * conn2 ) {
+  test_assert_true( well_conn_equal( conn1 , conn2 ));
+  test_assert_double_equal( well_conn_get_connection_factor( conn1 ) , well_conn_get_connection_factor( conn2 ));
+  test_assert_double_equal( well_conn_get_oil_rate( conn1 )    , well_conn_get_oil_rate( conn2 ));
+  test_assert_double_equal( well_conn_get_gas_rate( conn1 )    , well_conn_get_gas_rate( conn2 ));
+  test_assert_double_equal( well_conn_get_water_rate( conn1 )  , well_conn_get_water_rate( conn2 ));
+  test_assert_double_equal( well_conn_get_volume_rate( conn1 ) , well_conn_get_volume_rate( conn2 ));
+}
+
+
+static void assert_state_equal( const well_state_type * state1 , const well_state_type * state2 ) {
+  test_assert_string_equal( well_state_get_name( state1 ) , well_state_get_name( state2 ));
+  test_assert_int_equal( well_state_get_report_nr( state1 ) , well_state_get_report_nr( state2 ));
+  test_assert_true( well_state_get_sim_time( state1 ) == well_state_get_sim_time( state2 ));
+  test_assert_int_equal( well_state_get_type( state1 ) , well_state_get_type( state2 ));
+  test_assert_bool_equal( well_state_is_open( state1 ) , well_state_is_open( state2 ));
+  test_assert_int_equal( well_state_get_well_nr( state1 ) , well_state_get_well_nr( state2 ));
+  test_assert_double_equal( well_state_get_oil_rate( state1 )    , well_state_get_oil_rate( state2 ));
+  test_assert_double_equal( well_state_get_gas_rate( state1 )    , well_state_get_gas_rate( state2 ));
+  test_assert_double_equal( well_state_get_water_rate( state1 )  , well_state_get_water_rate( state2 ));
+  test_assert_double_equal( well_state_get_volume_rate( state1 ) , well_state_get_volume_rate( state2 ));
+
+  assert_conn_equal( well_state_iget_wellhead( state1 , 0 ) , well_state_iget_wellhead( state2 , 0 ));
+  {
+    const well_conn_collection_type * conns1 = well_state_get_global_connections( state1 );
+    const well_conn_collection_type * conns2 = well_state_get_global_connections( state2 );
+
+    test_assert_int_equal( well_conn_collection_get_size( conns1 ) , well_conn_collection_get_size( conns2 ));
+    for (int iconn = 0; iconn < well_conn_collection_get_size( conns1 ); iconn++)
+      assert_conn_equal( well_conn_collection_iget_const( conns1 , iconn ) , well_conn_collection_iget_const( conns2 , iconn ));
+  }
+}
+
+
+/* Check the serially loaded wells against what was written. */
+static void test_expected( const well_info_type * well_info ) {
+  test_assert_int_equal( well_info_get_num_wells( well_info ) , NUM_WELLS );
+  for (int well = 0; well < NUM_WELLS; well++) {
+    const well_ts_type * well_ts = well_info_get_ts( well_info , well_names[well] );
+    int num_states = 0;
+
+    for (int step = 0; step < NUM_STEPS; step++) {
+      if (well_active( well , step )) {
+        const well_state_type * well_state = well_ts_iget_state( well_ts , num_states );
+        const well_conn_collection_type * conns = well_state_get_global_connections( well_state );
+
+        test_assert_int_equal( well_state_get_report_nr( well_state ) , step );
+        test_assert_true( well_state_get_sim_time( well_state ) == ecl_util_make_date( 1 , 1 + step % 12 , 2000 + step / 12 ));
+        test_assert_double_equal( well_state_get_oil_rate( well_state ) , 30.0 * step + well );
+        test_assert_int_equal( well_conn_collection_get_size( conns ) , well_num_conn( well , step ));
+        test_assert_double_equal( well_conn_get_connection_factor( well_conn_collection_iget_const( conns , 0 )) , 1.0 + step );
+        num_states++;
+      }
+    }
+    test_assert_int_equal( well_ts_get_size( well_ts ) , num_states );
+  }
+}
+
+
+static void test_load( const ecl_grid_type * grid , const char * filename , int num_threads ) {
+  well_info_type * well_info1 = well_info_alloc( grid );
+  well_info_type * well_info2 = well_info_alloc( grid );
+
+  well_info_load_rstfile( well_info1 , filename , false );
+  well_info_load_rstfile_mt( well_info2 , filename , false , num_threads );
+  test_expected( well_info1 );
+
+  test_assert_int_equal( well_info_get_num_wells( well_info1 ) , well_info_get_num_wells( well_info2 ));
+  for (int iwell = 0; iwell < well_info_get_num_wells( well_info1 ); iwell++) {
+    const char * well_name = well_info_iget_well_name( well_info1 , iwell );
+    const well_ts_type * well_ts1 = well_info_get_ts( well_info1 , well_name );
+    const well_ts_type * well_ts2 = well_info_get_ts( well_info2 , well_name );
+
+    test_assert_string_equal( well_name , well_info_iget_well_name( well_info2 , iwell ));
+    test_assert_int_equal( well_ts_get_size( well_ts1 ) , well_ts_get_size( well_ts2 ));
+    for (int istate = 0; istate < well_ts_get_size( well_ts1 ); istate++)
+      assert_state_equal( well_ts_iget_state( well_ts1 , istate ) , well_ts_iget_state( well_ts2 , istate ));
+  }
+
+  well_info_free( well_info1 );
+  well_info_free( well_info2 );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "well_info_load_rstfile_mt" );
+  {
+    ecl_grid_type * grid;
+    {
+      ecl_grid_type * rect_grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+      ecl_grid_fwrite_EGRID2( rect_grid , "CASE.EGRID" , ECL_METRIC_UNITS );
+      ecl_grid_free( rect_grid );
+    }
+    grid = ecl_grid_alloc( "CASE.EGRID" );
+    write_rstfile( "CASE.UNRST" );
+
+    test_load( grid , "CASE.UNRST" , 1 );
+    test_load( grid , "CASE.UNRST" , 4 );
+    test_load( grid , "CASE.UNRST" , NUM_STEPS + 4 );
+
+    ecl_grid_free( grid );
+  }
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -31,6 +31,7 @@ extern "C" {
 
 #include <ert/ecl/ecl_grid.h>
 #include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec_pool.h>
 #include <ert/ecl/ecl_io_config.h>
 
 #include <ert/sched/sched_file.h>
@@ -71,6 +72,7 @@ extern "C" {
   const ecl_sum_type  * ecl_config_get_refcase(const ecl_config_type * ecl_config);
   bool                  ecl_config_has_refcase( const ecl_config_type * ecl_config );
   ecl_refcase_list_type * ecl_config_get_refcase_list( const ecl_config_type * ecl_config );
+  ecl_smspec_pool_type  * ecl_config_get_smspec_pool( const ecl_config_type * ecl_config );
 
   /*****************************************************************/
 
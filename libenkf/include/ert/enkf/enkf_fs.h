@@ -77,6 +77,9 @@ extern "C" {
   
 
   bool              enkf_fs_has_vector(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int iens);
+  void              enkf_fs_copy_nodes( enkf_fs_type * src_fs , enkf_fs_type * target_fs , const char * node_key , enkf_var_type var_type ,
+                                        int src_report_step , int target_report_step ,
+                                        int size , const int * src_iens , const int * target_iens);
   bool              enkf_fs_has_node(enkf_fs_type * enkf_fs , const char * node_key , enkf_var_type var_type , int report_step , int iens);
 
   void              enkf_fs_debug_fprintf( const enkf_fs_type * fs);
@@ -51,6 +51,25 @@ void enkf_matrix_deserialize(void * __node_data                 ,
                              int row_offset,
                              int column);
 
+void enkf_matrix_serialize_block(const void ** node_data              ,
+                                 int num_nodes                        ,
+                                 int node_size                        ,
+                                 ecl_data_type node_type              ,
+                                 const active_list_type * __active_list ,
+                                 matrix_type * A                      ,
+                                 int row_offset                       ,
+                                 const int * columns);
+
+
+void enkf_matrix_deserialize_block(void ** node_data                    ,
+                                   int num_nodes                        ,
+                                   int node_size                        ,
+                                   ecl_data_type node_type              ,
+                                   const active_list_type * __active_list ,
+                                   const matrix_type * A                ,
+                                   int row_offset                       ,
+                                   const int * columns);
+
 
 #ifdef __cplusplus
 }
@@ -74,6 +74,8 @@ extern "C" {
   ecl_kw_type * field_alloc_ecl_kw_wrapper(const field_type * );
   void          field_update_sum(field_type * sum , field_type * field , double lower_limit , double upper_limit);
   void          field_upgrade_103(const char * filename);
+  void          field_serialize_block(const field_type ** fields , int num_fields , const active_list_type * active_list , matrix_type * A , int row_offset , const int * columns);
+  void          field_deserialize_block(field_type ** fields , int num_fields , const active_list_type * active_list , const matrix_type * A , int row_offset , const int * columns);
   
   UTIL_IS_INSTANCE_HEADER(field);
   UTIL_SAFE_CAST_HEADER_CONST(field);
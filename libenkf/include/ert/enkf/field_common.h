@@ -30,7 +30,9 @@ typedef struct field_config_struct field_config_type;
 typedef struct field_struct        field_type;
 
 field_type * field_alloc(const field_config_type * );
+void         field_free(field_type * );
 bool         field_fload(field_type * , const char * );
+bool         field_fload_keep_inactive(field_type * , const char * );
 
 
 
@@ -33,6 +33,7 @@ extern "C" {
 #include <ert/ecl/ecl_type.h>
 
 #include <ert/rms/rms_file.h>
+#include <ert/rms/rms_file_pool.h>
 
 #include <ert/enkf/enkf_util.h>
 #include <ert/enkf/enkf_macros.h>
@@ -123,6 +124,11 @@ field_config_type * field_config_alloc_empty( const char * ecl_kw_name , ecl_gri
 
 void                    field_config_get_ijk( const field_config_type * config , int active_index , int *i , int * j , int * k);
 field_type            * field_config_get_min_std( const field_config_type * field_config );
+const field_type      * field_config_get_init_field( const field_config_type * field_config , const char * init_file);
+void                    field_config_release_init_field( const field_config_type * field_config , const field_type * init_field);
+int                     field_config_get_init_cache_size( const field_config_type * field_config );
+void                    field_config_set_rms_file_pool( field_config_type * field_config , rms_file_pool_type * rms_file_pool );
+rms_file_pool_type    * field_config_get_rms_file_pool( const field_config_type * field_config );
 const char            * field_config_default_extension(field_file_format_type , bool );
 bool                    field_config_write_compressed(const field_config_type * );
 field_file_format_type  field_config_guess_file_type(const char * );
@@ -173,6 +173,8 @@ extern "C" {
   typedef void (unlink_vector_ftype)  (void * driver, const char * , int );
   typedef bool (has_vector_ftype)     (void * driver, const char * , int );
   
+  typedef void (copy_nodes_ftype)   (void * src_driver , void * target_driver , const char * , int , int , int , const int * , const int * );
+
   typedef void (fsync_driver_ftype) (void * driver);
   typedef void (free_driver_ftype)  (void * driver);
 
@@ -207,6 +209,7 @@ load_vector_ftype         * load_vector;   \
 save_vector_ftype         * save_vector;   \
 has_vector_ftype          * has_vector;    \
 unlink_vector_ftype       * unlink_vector; \
+copy_nodes_ftype          * copy_nodes;    \
 free_driver_ftype         * free_driver;   \
 fsync_driver_ftype        * fsync_driver;  \
 int                         type_id
@@ -233,6 +236,9 @@ struct fs_driver_struct {
   void                       fs_driver_assert_magic( FILE * stream );
   void                       fs_driver_assert_version( FILE * stream , const char * mount_point);
   int                        fs_driver_fread_version( FILE * stream );
+  void                       fs_driver_copy_nodes( fs_driver_type * src_driver , fs_driver_type * target_driver , const char * node_key ,
+                                                   int src_report_step , int target_report_step ,
+                                                   int size , const int * src_iens , const int * target_iens);
 
 
 #ifdef __cplusplus
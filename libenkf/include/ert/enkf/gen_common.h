@@ -29,6 +29,7 @@ extern "C" {
 #include <ert/ecl/ecl_type.h>
 
 void    * gen_common_fscanf_alloc(const char * , ecl_data_type , int * );
+int     * gen_common_fscanf_alloc_int( const char * file , int size );
 void    * gen_common_fread_alloc(const char *  , ecl_data_type , int * );
 void    * gen_common_fload_alloc(const char *  , gen_data_file_format_type , ecl_data_type , ecl_data_type * , int * );
 
@@ -7,6 +7,9 @@ extern "C" {
 
 #include <ert/util/type_macros.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_smspec.h>
 
 #include <ert/enkf/enkf_types.h>
 
@@ -17,6 +20,7 @@ extern "C" {
   int                        summary_key_matcher_get_size(const summary_key_matcher_type * matcher);
   void                       summary_key_matcher_add_summary_key(summary_key_matcher_type * matcher, const char * summary_key);
   bool                       summary_key_matcher_match_summary_key(const summary_key_matcher_type * matcher, const char * summary_key);
+  void                       summary_key_matcher_select_smspec_nodes(const summary_key_matcher_type * matcher, const ecl_smspec_type * smspec, int_vector_type * node_index);
   bool                       summary_key_matcher_summary_key_is_required(const summary_key_matcher_type * matcher, const char * summary_key);
   stringlist_type *          summary_key_matcher_get_keys(const summary_key_matcher_type * matcher);
 
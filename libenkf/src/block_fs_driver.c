@@ -24,6 +24,7 @@
 #include <ert/util/path_fmt.h>
 #include <ert/util/block_fs.h>
 #include <ert/util/buffer.h>
+#include <ert/util/int_vector.h>
 #include <ert/util/timer.h>
 #include <ert/util/thread_pool.h>
 
@@ -282,6 +283,93 @@ static void block_fs_driver_load_vector(void * _driver , const char * node_key ,
 
 /*****************************************************************/
 
+typedef struct {
+  block_fs_driver_type * src_driver;
+  bfs_type             * target_bfs;
+  const char           * node_key;
+  int                    src_report_step;
+  int                    target_report_step;
+  int_vector_type      * src_iens;
+  int_vector_type      * target_iens;
+} bfs_copy_job_type;
+
+
+static void * block_fs_driver_copy_nodes__( void * arg ) {
+  bfs_copy_job_type * job = arg;
+  buffer_type * buffer = buffer_alloc( 1024 );
+  int index;
+
+  for (index = 0; index < int_vector_size( job->src_iens ); index++) {
+    int src_iens    = int_vector_iget( job->src_iens , index );
+    int target_iens = int_vector_iget( job->target_iens , index );
+    char * src_key    = block_fs_driver_alloc_node_key( job->src_driver , job->node_key , job->src_report_step , src_iens );
+    char * target_key = block_fs_driver_alloc_node_key( job->src_driver , job->node_key , job->target_report_step , target_iens );
+    bfs_type * src_bfs = block_fs_driver_get_fs( job->src_driver , src_iens );
+
+    block_fs_fread_realloc_buffer( src_bfs->block_fs , src_key , buffer );
+    block_fs_fwrite_buffer( job->target_bfs->block_fs , target_key , buffer );
+
+    free( src_key );
+    free( target_key );
+  }
+
+  buffer_free( buffer );
+  return NULL;
+}
+
+
+/*
+  The raw copy is batched per target block_fs file; all the nodes
+  going to one target file are copied by one job, and the jobs for the
+  different target files run in parallel.
+*/
+
+static void block_fs_driver_copy_nodes( void * _src_driver , void * _target_driver , const char * node_key ,
+                                        int src_report_step , int target_report_step ,
+                                        int size , const int * src_iens , const int * target_iens) {
+  block_fs_driver_type * src_driver = block_fs_driver_safe_cast( _src_driver );
+  block_fs_driver_type * target_driver = block_fs_driver_safe_cast( _target_driver );
+  bfs_copy_job_type * jobs = util_calloc( target_driver->num_fs , sizeof * jobs );
+  int ifs;
+
+  for (ifs = 0; ifs < target_driver->num_fs; ifs++) {
+    jobs[ifs].src_driver         = src_driver;
+    jobs[ifs].target_bfs         = target_driver->fs_list[ifs];
+    jobs[ifs].node_key           = node_key;
+    jobs[ifs].src_report_step    = src_report_step;
+    jobs[ifs].target_report_step = target_report_step;
+    jobs[ifs].src_iens           = int_vector_alloc( 0 , 0 );
+    jobs[ifs].target_iens        = int_vector_alloc( 0 , 0 );
+  }
+
+  {
+    int index;
+    for (index = 0; index < size; index++) {
+      int phase = target_iens[index] % target_driver->num_fs;
+      int_vector_append( jobs[phase].src_iens , src_iens[index] );
+      int_vector_append( jobs[phase].target_iens , target_iens[index] );
+    }
+  }
+
+  {
+    thread_pool_type * tp = thread_pool_alloc( 4 , true );
+    for (ifs = 0; ifs < target_driver->num_fs; ifs++) {
+      if (int_vector_size( jobs[ifs].src_iens ) > 0)
+        thread_pool_add_job( tp , block_fs_driver_copy_nodes__ , &jobs[ifs] );
+    }
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  }
+
+  for (ifs = 0; ifs < target_driver->num_fs; ifs++) {
+    int_vector_free( jobs[ifs].src_iens );
+    int_vector_free( jobs[ifs].target_iens );
+  }
+  free( jobs );
+}
+
+/*****************************************************************/
+
 static void block_fs_driver_save_node(void * _driver , const char * node_key , int report_step , int iens ,  buffer_type * buffer) {
   block_fs_driver_type * driver = (block_fs_driver_type *) _driver;
   block_fs_driver_assert_cast(driver);
@@ -414,6 +502,8 @@ static block_fs_driver_type * block_fs_driver_alloc(int num_fs) {
   driver->unlink_vector = block_fs_driver_unlink_vector;
   driver->has_vector    = block_fs_driver_has_vector;
 
+  driver->copy_nodes    = block_fs_driver_copy_nodes;
+
   driver->free_driver   = block_fs_driver_free;
   driver->fsync_driver  = block_fs_driver_fsync;
   driver->__id          = BLOCK_FS_DRIVER_ID;
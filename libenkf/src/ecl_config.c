@@ -70,6 +70,7 @@ struct ecl_config_struct
   time_t start_date;                    /* The start date of the ECLIPSE simulation - parsed from the data_file. */
   time_t end_date;                      /* An optional date value which can be used to check if the ECLIPSE simulation has been 'long enough'. */
   ecl_refcase_list_type * refcase_list;
+  ecl_smspec_pool_type * smspec_pool;   /* Shared smspec instances for the summary results loaded from the realizations. */
   ecl_grid_type * grid;                 /* The grid which is active for this model. */
   char * schedule_prediction_file;      /* Name of schedule prediction file - observe that this is internally handled as a gen_kw node. */
   char * schedule_target_file;          /* File name to write schedule info to */
@@ -533,6 +534,7 @@ ecl_config_type * ecl_config_alloc()
   ecl_config->schedule_prediction_file = NULL;
   ecl_config->schedule_target_file = NULL;
   ecl_config->refcase_list = ecl_refcase_list_alloc();
+  ecl_config->smspec_pool = ecl_smspec_pool_alloc( SUMMARY_KEY_JOIN_STRING );
 
   ecl_config_init_static_kw(ecl_config);
 
@@ -686,6 +688,7 @@ void ecl_config_free(ecl_config_type * ecl_config)
     ecl_grid_free(ecl_config->grid);
 
   ecl_refcase_list_free(ecl_config->refcase_list);
+  ecl_smspec_pool_free(ecl_config->smspec_pool);
 
   free(ecl_config);
 }
@@ -785,6 +788,17 @@ ecl_refcase_list_type * ecl_config_get_refcase_list(const ecl_config_type * ecl_
   return ecl_config->refcase_list;
 }
 
+/*
+  The smspec pool is used when loading the summary results of the
+  realizations; it is internally synchronized and can therefor be
+  used through a const ecl_config instance.
+*/
+
+ecl_smspec_pool_type * ecl_config_get_smspec_pool(const ecl_config_type * ecl_config)
+{
+  return ecl_config->smspec_pool;
+}
+
 const ecl_sum_type * ecl_config_get_refcase(const ecl_config_type * ecl_config)
 {
   return ecl_refcase_list_get_default(ecl_config->refcase_list);
@@ -855,6 +855,36 @@ void enkf_fs_fwrite_node(enkf_fs_type * enkf_fs , buffer_type * buffer , const c
 }
 
 
+/**
+   Copies the stored node @node_key from realizations src_iens[i] in
+   @src_fs to realizations target_iens[i] in @target_fs. The stored
+   bytes are copied without being loaded into enkf_node instances, so
+   this can only be used when the source and target configurations of
+   the node are identical, and the stored content does not depend on
+   the report step.
+*/
+
+void enkf_fs_copy_nodes( enkf_fs_type * src_fs , enkf_fs_type * target_fs , const char * node_key , enkf_var_type var_type ,
+                         int src_report_step , int target_report_step ,
+                         int size , const int * src_iens , const int * target_iens) {
+  if (target_fs->read_only)
+    util_abort("%s: attempt to write to read_only filesystem mounted at:%s - aborting. \n",__func__ , target_fs->mount_point);
+
+  if (var_type == PARAMETER) {
+    /* Parameters are *ONLY* stored at report_step == 0 */
+    src_report_step = 0;
+    if (target_report_step > 0)
+      util_abort("%s: Parameters can only be saved for report_step = 0   %s:%d\n", __func__ , node_key , target_report_step);
+  }
+
+  {
+    fs_driver_type * src_driver = fs_driver_safe_cast( enkf_fs_select_driver( src_fs , var_type , node_key ));
+    fs_driver_type * target_driver = fs_driver_safe_cast( enkf_fs_select_driver( target_fs , var_type , node_key ));
+    fs_driver_copy_nodes( src_driver , target_driver , node_key , src_report_step , target_report_step , size , src_iens , target_iens );
+  }
+}
+
+
 void enkf_fs_fwrite_vector(enkf_fs_type * enkf_fs , buffer_type * buffer , const char * node_key, enkf_var_type var_type,
                            int iens ) {
   if (enkf_fs->read_only)
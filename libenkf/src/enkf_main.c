@@ -652,9 +652,73 @@ static void serialize_node( enkf_fs_type * fs ,
 }
 
 
+/*
+  FIELD nodes are serialized FIELD_SERIALIZE_BATCH realizations at a
+  time with field_serialize_block(), which walks the active list once
+  for all the realizations in the batch.
+*/
+
+#define FIELD_SERIALIZE_BATCH 8
+
+static void serialize_field_batch( enkf_fs_type * fs ,
+                                   const enkf_config_node_type * config_node ,
+                                   const int * iens_list ,
+                                   const int * columns ,
+                                   int batch_size ,
+                                   int report_step ,
+                                   int row_offset ,
+                                   const active_list_type * active_list,
+                                   matrix_type * A) {
+  enkf_node_type * nodes[FIELD_SERIALIZE_BATCH];
+  const field_type * fields[FIELD_SERIALIZE_BATCH];
+  int i;
+
+  for (i = 0; i < batch_size; i++) {
+    node_id_type node_id = {.report_step = report_step, .iens = iens_list[i] };
+    nodes[i] = enkf_node_alloc( config_node );
+    enkf_node_load( nodes[i] , fs , node_id );
+    fields[i] = enkf_node_value_ptr( nodes[i] );
+  }
+
+  field_serialize_block( fields , batch_size , active_list , A , row_offset , columns );
+
+  for (i = 0; i < batch_size; i++)
+    enkf_node_free( nodes[i] );
+}
+
+
+static void serialize_fields_mt( serialize_info_type * info , const enkf_config_node_type * config_node ) {
+  int iens_list[FIELD_SERIALIZE_BATCH];
+  int columns[FIELD_SERIALIZE_BATCH];
+  int batch_size = 0;
+  int iens;
+
+  for (iens = info->iens1; iens < info->iens2; iens++) {
+    int column = int_vector_iget( info->iens_active_index , iens);
+    if (column >= 0) {
+      iens_list[batch_size] = iens;
+      columns[batch_size] = column;
+      batch_size++;
+    }
+
+    if ((batch_size == FIELD_SERIALIZE_BATCH) || ((iens == info->iens2 - 1) && (batch_size > 0))) {
+      serialize_field_batch( info->src_fs , config_node , iens_list , columns , batch_size , info->report_step , info->row_offset , info->active_list , info->A );
+      batch_size = 0;
+    }
+  }
+}
+
+
 static void * serialize_nodes_mt( void * arg ) {
   serialize_info_type * info = (serialize_info_type *) arg;
+  const enkf_config_node_type * config_node = ensemble_config_get_node( info->ensemble_config , info->key );
   int iens;
+
+  if (enkf_config_node_get_impl_type( config_node ) == FIELD) {
+    serialize_fields_mt( info , config_node );
+    return NULL;
+  }
+
   for (iens = info->iens1; iens < info->iens2; iens++) {
     int column = int_vector_iget( info->iens_active_index , iens);
     if (column >= 0)
@@ -766,9 +830,67 @@ static void deserialize_node( enkf_fs_type * fs,
 
 
 
+static void deserialize_field_batch( enkf_fs_type * fs ,
+                                     const enkf_config_node_type * config_node ,
+                                     const int * iens_list ,
+                                     const int * columns ,
+                                     int batch_size ,
+                                     int target_step ,
+                                     int row_offset ,
+                                     const active_list_type * active_list,
+                                     matrix_type * A) {
+  enkf_node_type * nodes[FIELD_SERIALIZE_BATCH];
+  field_type * fields[FIELD_SERIALIZE_BATCH];
+  int i;
+
+  for (i = 0; i < batch_size; i++) {
+    nodes[i] = enkf_node_alloc( config_node );
+    fields[i] = enkf_node_value_ptr( nodes[i] );
+  }
+
+  field_deserialize_block( fields , batch_size , active_list , A , row_offset , columns );
+
+  for (i = 0; i < batch_size; i++) {
+    node_id_type node_id = {.report_step = target_step, .iens = iens_list[i] };
+    enkf_node_store( nodes[i] , fs , true , node_id );
+    state_map_update_undefined(enkf_fs_get_state_map(fs) , iens_list[i] , STATE_INITIALIZED);
+    enkf_node_free( nodes[i] );
+  }
+}
+
+
+static void deserialize_fields_mt( serialize_info_type * info , const enkf_config_node_type * config_node ) {
+  int iens_list[FIELD_SERIALIZE_BATCH];
+  int columns[FIELD_SERIALIZE_BATCH];
+  int batch_size = 0;
+  int iens;
+
+  for (iens = info->iens1; iens < info->iens2; iens++) {
+    int column = int_vector_iget( info->iens_active_index , iens);
+    if (column >= 0) {
+      iens_list[batch_size] = iens;
+      columns[batch_size] = column;
+      batch_size++;
+    }
+
+    if ((batch_size == FIELD_SERIALIZE_BATCH) || ((iens == info->iens2 - 1) && (batch_size > 0))) {
+      deserialize_field_batch( info->target_fs , config_node , iens_list , columns , batch_size , info->target_step , info->row_offset , info->active_list , info->A );
+      batch_size = 0;
+    }
+  }
+}
+
+
 static void * deserialize_nodes_mt( void * arg ) {
   serialize_info_type * info = (serialize_info_type *) arg;
+  const enkf_config_node_type * config_node = ensemble_config_get_node( info->ensemble_config , info->key );
   int iens;
+
+  if (enkf_config_node_get_impl_type( config_node ) == FIELD) {
+    deserialize_fields_mt( info , config_node );
+    return NULL;
+  }
+
   for (iens = info->iens1; iens < info->iens2; iens++) {
     int column = int_vector_iget( info->iens_active_index , iens );
     if (column >= 0)
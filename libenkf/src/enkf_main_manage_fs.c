@@ -151,6 +151,29 @@ void enkf_main_initialize_from_scratch(enkf_main_type * enkf_main , enkf_fs_type
 
 
 
+/*
+  For these node types the stored content is completely determined by
+  the node configuration, which is shared by the source and target
+  case, and independent of the report step; they can therefore be
+  copied as raw stored bytes with enkf_fs_copy_nodes() instead of
+  being loaded and stored with enkf_node_copy().
+*/
+
+static bool enkf_main_raw_copy_node( const enkf_config_node_type * config_node ) {
+  if (enkf_config_node_vector_storage( config_node ))
+    return false;
+
+  switch (enkf_config_node_get_impl_type( config_node )) {
+  case(FIELD):
+  case(GEN_KW):
+  case(SURFACE):
+    return true;
+  default:
+    return false;
+  }
+}
+
+
 static void enkf_main_copy_ensemble( const enkf_main_type * enkf_main,
                                      enkf_fs_type * source_case_fs,
                                      int source_report_step,
@@ -178,6 +201,10 @@ static void enkf_main_copy_ensemble( const enkf_main_type * enkf_main,
 
     for (inode =0; inode < stringlist_get_size( node_list ); inode++) {
       enkf_config_node_type * config_node = ensemble_config_get_node( enkf_main_get_ensemble_config(enkf_main) , stringlist_iget( node_list , inode ));
+      bool raw_copy = enkf_main_raw_copy_node( config_node );
+      int_vector_type * raw_src_iens = int_vector_alloc( 0 , 0 );
+      int_vector_type * raw_target_iens = int_vector_alloc( 0 , 0 );
+
       for (src_iens = 0; src_iens < enkf_main_get_ensemble_size( enkf_main ); src_iens++) {
         if (bool_vector_safe_iget(iens_mask , src_iens)) {
           int target_iens = ranking_permutation[src_iens];
@@ -185,18 +212,35 @@ static void enkf_main_copy_ensemble( const enkf_main_type * enkf_main,
           node_id_type target_id = {.report_step = target_report_step , .iens = target_iens };
 
           /* The copy is careful ... */
-          if (enkf_config_node_has_node( config_node , source_case_fs , src_id))
-            enkf_node_copy( config_node ,
-                            source_case_fs , target_case_fs ,
-                            src_id , target_id );
+          if (enkf_config_node_has_node( config_node , source_case_fs , src_id)) {
+            if (raw_copy) {
+              int_vector_append( raw_src_iens , src_iens );
+              int_vector_append( raw_target_iens , target_iens );
+            } else
+              enkf_node_copy( config_node ,
+                              source_case_fs , target_case_fs ,
+                              src_id , target_id );
+          }
 
           if (0 == target_report_step)
             state_map_iset(target_state_map, target_iens, STATE_INITIALIZED);
         }
       }
+
+      if (int_vector_size( raw_src_iens ) > 0)
+        enkf_fs_copy_nodes( source_case_fs , target_case_fs ,
+                            enkf_config_node_get_key( config_node ) ,
+                            enkf_config_node_get_var_type( config_node ) ,
+                            source_report_step , target_report_step ,
+                            int_vector_size( raw_src_iens ) ,
+                            int_vector_get_const_ptr( raw_src_iens ) ,
+                            int_vector_get_const_ptr( raw_target_iens ));
+
+      int_vector_free( raw_src_iens );
+      int_vector_free( raw_target_iens );
     }
 
-    if (ranking_permutation == NULL)
+    if (ranking_key == NULL)
       free( ranking_permutation );
   }
 }
@@ -18,6 +18,7 @@
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <ert/util/util.h>
 
@@ -184,91 +185,203 @@ vector (marked with X2 above)). Now - that was clear ehhh?
 */
    
 
-void enkf_matrix_serialize(const void * __node_data               , 
-                           int node_size                          ,      
-                           ecl_data_type node_type                ,
-                           const active_list_type * __active_list , 
-                           matrix_type * A                        ,
-                           int row_offset,
-                           int column) {
-  int active_size;
-  const int   * active_list    = active_list_get_active( __active_list ); 
-  active_size = active_list_get_active_size( __active_list , node_size);
-
-  if (ecl_type_is_double(node_type)) {
-    const double * node_data = (const double *) __node_data;
-    if (active_size == node_size) /** All elements active */
-      matrix_set_many_on_column( A , row_offset , node_size , node_data , column);
-    else {
-      int row_index;
-      int node_index;
-      for (row_index = 0; row_index < active_size; row_index++) {
-        node_index = active_list[ row_index ];
-        matrix_iset( A , row_index + row_offset , column , node_data[node_index] );
+/*
+  The serialize / deserialize kernels work directly on the column
+  storage of A when the matrix has row_stride == 1, which is the case
+  for all matrices allocated by matrix_alloc(). The gather/scatter
+  loops are written with restrict qualified pointers and without
+  function calls in the loop body, so that the float <-> double
+  conversion can be vectorized by the compiler.
+
+  The _block() versions handle several realizations of the same node
+  in one call; the active list is processed in slices of
+  SERIALIZE_ROW_BLOCK indices, and each slice is applied to all the
+  realizations while it is still in cache.
+*/
+
+#define SERIALIZE_ROW_BLOCK 4096
+
+
+static void serialize_gather_float( double * restrict target , const float * restrict src , const int * restrict index , int size) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[i] = src[ index[i] ];
+}
+
+
+static void serialize_copy_float( double * restrict target , const float * restrict src , int size) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[i] = src[i];
+}
+
+
+static void serialize_gather_double( double * restrict target , const double * restrict src , const int * restrict index , int size) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[i] = src[ index[i] ];
+}
+
+
+static void deserialize_scatter_float( float * restrict target , const double * restrict src , const int * restrict index , int size) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[ index[i] ] = src[i];
+}
+
+
+static void deserialize_copy_float( float * restrict target , const double * restrict src , int size) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[i] = src[i];
+}
+
+
+static void deserialize_scatter_double( double * restrict target , const double * restrict src , const int * restrict index , int size) {
+  int i;
+  for (i = 0; i < size; i++)
+    target[ index[i] ] = src[i];
+}
+
+
+static void enkf_matrix_assert_type( ecl_data_type node_type , const char * caller) {
+  if (!(ecl_type_is_double(node_type) || ecl_type_is_float(node_type)))
+    util_abort("%s: internal error: trying to serialize unserializable type:%s \n",caller , ecl_type_get_name( node_type ));
+}
+
+
+void enkf_matrix_serialize_block(const void ** node_data              ,
+                                 int num_nodes                        ,
+                                 int node_size                        ,
+                                 ecl_data_type node_type              ,
+                                 const active_list_type * __active_list ,
+                                 matrix_type * A                      ,
+                                 int row_offset                       ,
+                                 const int * columns) {
+
+  const int * active_list = active_list_get_active( __active_list );
+  int active_size = active_list_get_active_size( __active_list , node_size);
+  bool all_active = (active_size == node_size);
+  enkf_matrix_assert_type( node_type , __func__ );
+
+  if (matrix_get_row_stride( A ) == 1) {
+    double * A_data = matrix_get_data( A );
+    int column_stride = matrix_get_column_stride( A );
+    int row1;
+
+    for (row1 = 0; row1 < active_size; row1 += SERIALIZE_ROW_BLOCK) {
+      int rows = util_int_min( SERIALIZE_ROW_BLOCK , active_size - row1 );
+      int inode;
+      for (inode = 0; inode < num_nodes; inode++) {
+        double * target = &A_data[ row_offset + row1 + columns[inode] * column_stride ];
+
+        if (ecl_type_is_double( node_type )) {
+          const double * src = node_data[inode];
+          if (all_active)
+            memcpy( target , &src[row1] , rows * sizeof * target );
+          else
+            serialize_gather_double( target , src , &active_list[row1] , rows );
+        } else {
+          const float * src = node_data[inode];
+          if (all_active)
+            serialize_copy_float( target , &src[row1] , rows );
+          else
+            serialize_gather_float( target , src , &active_list[row1] , rows );
+        }
       }
     }
-  } else if (ecl_type_is_float(node_type)) {
-    const float * node_data = (const float *) __node_data;
-    int row_index;
-    if (active_size == node_size) {/** All elements active */
-      for (row_index = 0; row_index < node_size; row_index++)
-        matrix_iset( A , row_index + row_offset , column , node_data[ row_index ]);  /* Must have float -> double conversion; can not use memcpy() based approach */
-    } else {
+  } else {
+    int inode;
+    for (inode = 0; inode < num_nodes; inode++) {
       int row_index;
-      int node_index;
       for (row_index = 0; row_index < active_size; row_index++) {
-        node_index = active_list[ row_index ];
-        matrix_iset( A , row_index + row_offset , column , node_data[node_index] );
+        int node_index = all_active ? row_index : active_list[ row_index ];
+        double value;
+        if (ecl_type_is_double( node_type ))
+          value = ((const double *) node_data[inode])[node_index];
+        else
+          value = ((const float *) node_data[inode])[node_index];
+        matrix_iset( A , row_index + row_offset , columns[inode] , value );
       }
-    }      
-  } else 
-      util_abort("%s: internal error: trying to serialize unserializable type:%s \n",__func__ , ecl_type_get_name( node_type ));
+    }
+  }
 }
 
 
-void enkf_matrix_deserialize(void * __node_data                 , 
-                             int node_size                      ,      
-                             ecl_data_type node_type            ,
-                             const active_list_type * __active_list , 
-                             const matrix_type * A,
-                             int row_offset,
-                             int column) {
-  int active_size;
-  const int   * active_list    = active_list_get_active( __active_list ); 
-  active_size = active_list_get_active_size( __active_list , node_size );
-    
-  if (ecl_type_is_double(node_type)) {
-    double * node_data = (double *) __node_data;
-
-    if (active_size == node_size) { /** All elements active */
-      int row_index;
-      for (row_index = 0; row_index < active_size; row_index++) 
-        node_data[row_index] = matrix_iget( A , row_index + row_offset , column);
-    } else {
-      int row_index;
-      int node_index;
-      for (row_index = 0; row_index < active_size; row_index++) {
-        node_index = active_list[ row_index ];
-        node_data[node_index] = matrix_iget( A , row_index + row_offset , column);
+void enkf_matrix_deserialize_block(void ** node_data                    ,
+                                   int num_nodes                        ,
+                                   int node_size                        ,
+                                   ecl_data_type node_type              ,
+                                   const active_list_type * __active_list ,
+                                   const matrix_type * A                ,
+                                   int row_offset                       ,
+                                   const int * columns) {
+
+  const int * active_list = active_list_get_active( __active_list );
+  int active_size = active_list_get_active_size( __active_list , node_size);
+  bool all_active = (active_size == node_size);
+  enkf_matrix_assert_type( node_type , __func__ );
+
+  if (matrix_get_row_stride( A ) == 1) {
+    const double * A_data = matrix_get_data( A );
+    int column_stride = matrix_get_column_stride( A );
+    int row1;
+
+    for (row1 = 0; row1 < active_size; row1 += SERIALIZE_ROW_BLOCK) {
+      int rows = util_int_min( SERIALIZE_ROW_BLOCK , active_size - row1 );
+      int inode;
+      for (inode = 0; inode < num_nodes; inode++) {
+        const double * src = &A_data[ row_offset + row1 + columns[inode] * column_stride ];
+
+        if (ecl_type_is_double( node_type )) {
+          double * target = node_data[inode];
+          if (all_active)
+            memcpy( &target[row1] , src , rows * sizeof * src );
+          else
+            deserialize_scatter_double( target , src , &active_list[row1] , rows );
+        } else {
+          float * target = node_data[inode];
+          if (all_active)
+            deserialize_copy_float( &target[row1] , src , rows );
+          else
+            deserialize_scatter_float( target , src , &active_list[row1] , rows );
+        }
       }
     }
-    
-  } else if (ecl_type_is_float(node_type)) {
-    float * node_data = (float *) __node_data;
-    
-    if (active_size == node_size) { /** All elements active */
-      int row_index;
-      for (row_index = 0; row_index < active_size; row_index++) 
-        node_data[row_index] = matrix_iget( A , row_index + row_offset , column);
-    } else {
+  } else {
+    int inode;
+    for (inode = 0; inode < num_nodes; inode++) {
       int row_index;
-      int node_index;
       for (row_index = 0; row_index < active_size; row_index++) {
-        node_index = active_list[ row_index ];
-        node_data[node_index] = matrix_iget( A , row_index + row_offset , column);
+        int node_index = all_active ? row_index : active_list[ row_index ];
+        double value = matrix_iget( A , row_index + row_offset , columns[inode] );
+        if (ecl_type_is_double( node_type ))
+          ((double *) node_data[inode])[node_index] = value;
+        else
+          ((float *) node_data[inode])[node_index] = value;
       }
     }
-  } else 
-    util_abort("%s: internal error: trying to serialize unserializable type:%s \n",__func__ , ecl_type_get_name( node_type ));
+  }
+}
+
+
+void enkf_matrix_serialize(const void * __node_data               ,
+                           int node_size                          ,
+                           ecl_data_type node_type                ,
+                           const active_list_type * __active_list ,
+                           matrix_type * A                        ,
+                           int row_offset,
+                           int column) {
+  enkf_matrix_serialize_block( &__node_data , 1 , node_size , node_type , __active_list , A , row_offset , &column );
+}
+
+
+void enkf_matrix_deserialize(void * __node_data                 ,
+                             int node_size                      ,
+                             ecl_data_type node_type            ,
+                             const active_list_type * __active_list ,
+                             const matrix_type * A,
+                             int row_offset,
+                             int column) {
+  enkf_matrix_deserialize_block( &__node_data , 1 , node_size , node_type , __active_list , A , row_offset , &column );
 }
-                           
@@ -560,25 +560,26 @@ static bool enkf_state_internalize_dynamic_eclipse_results(enkf_state_type * enk
         int_vector_resize( time_index , step2 + 1);
 
         const ecl_smspec_type * smspec = ecl_sum_get_smspec(summary);
+        int_vector_type * node_index = int_vector_alloc( 0 , 0 );
 
-        for(int i = 0; i < ecl_smspec_num_nodes(smspec); i++) {
-            const smspec_node_type * smspec_node = ecl_smspec_iget_node(smspec, i);
+        summary_key_matcher_select_smspec_nodes(matcher, smspec, node_index);
+        for(int i = 0; i < int_vector_size(node_index); i++) {
+            const smspec_node_type * smspec_node = ecl_smspec_iget_node(smspec, int_vector_iget(node_index, i));
             const char * key = smspec_node_get_gen_key1(smspec_node);
 
-            if(summary_key_matcher_match_summary_key(matcher, key)) {
-                summary_key_set_type * key_set = enkf_fs_get_summary_key_set(result_fs);
-                summary_key_set_add_summary_key(key_set, key);
+            summary_key_set_type * key_set = enkf_fs_get_summary_key_set(result_fs);
+            summary_key_set_add_summary_key(key_set, key);
 
-                enkf_config_node_type * config_node = ensemble_config_get_or_create_summary_node(enkf_state->ensemble_config, key);
-                enkf_node_type * node = enkf_state_get_or_create_node(enkf_state, config_node);
+            enkf_config_node_type * config_node = ensemble_config_get_or_create_summary_node(enkf_state->ensemble_config, key);
+            enkf_node_type * node = enkf_state_get_or_create_node(enkf_state, config_node);
 
-                enkf_node_try_load_vector( node , result_fs , iens );  // Ensure that what is currently on file is loaded before we update.
+            enkf_node_try_load_vector( node , result_fs , iens );  // Ensure that what is currently on file is loaded before we update.
 
-                enkf_node_forward_load_vector( node , load_context , time_index);
-                enkf_node_store_vector( node , result_fs , iens );
-            }
+            enkf_node_forward_load_vector( node , load_context , time_index);
+            enkf_node_store_vector( node , result_fs , iens );
         }
 
+        int_vector_free( node_index );
         int_vector_free( time_index );
 
         /*
@@ -36,6 +36,8 @@
 
 #include <ert/ecl/ecl_grid.h>
 
+#include <ert/rms/rms_file_pool.h>
+
 #include <ert/job_queue/job_queue.h>
 #include <ert/job_queue/lsf_driver.h>
 #include <ert/job_queue/local_driver.h>
@@ -72,6 +74,7 @@
 
 
 #define ENSEMBLE_CONFIG_TYPE_ID 8825306
+#define ENSEMBLE_CONFIG_RMS_FILE_POOL_SIZE 16   /* Opened ROFF files which are kept when not in use. */
 
 struct ensemble_config_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -79,6 +82,7 @@ struct ensemble_config_struct {
   char                     * gen_kw_format_string;   /* format string used when creating gen_kw search/replace strings. */
   hash_type                * config_nodes;           /* a hash of enkf_config_node instances - which again conatin pointers to e.g. field_config objects.  */
   field_trans_table_type   * field_trans_table;      /* a table of the transformations which are available to apply on fields. */
+  rms_file_pool_type       * rms_file_pool;          /* the opened ROFF files shared by the fields. */
   const ecl_sum_type       * refcase;                /* a ecl_sum reference instance - can be null (not owned by the ensemble
                                                       config). is only used to check that summary keys are valid when adding. */
   bool                       have_forward_init;
@@ -152,6 +156,7 @@ ensemble_config_type * ensemble_config_alloc( ) {
   UTIL_TYPE_ID_INIT( ensemble_config , ENSEMBLE_CONFIG_TYPE_ID );
   ensemble_config->config_nodes          = hash_alloc();
   ensemble_config->field_trans_table     = field_trans_table_alloc();
+  ensemble_config->rms_file_pool         = rms_file_pool_alloc( ENSEMBLE_CONFIG_RMS_FILE_POOL_SIZE );
   ensemble_config->refcase               = NULL;
   ensemble_config->gen_kw_format_string  = util_alloc_string_copy( DEFAULT_GEN_KW_TAG_FORMAT );
   ensemble_config->have_forward_init     = false;
@@ -166,6 +171,7 @@ ensemble_config_type * ensemble_config_alloc( ) {
 void ensemble_config_free(ensemble_config_type * ensemble_config) {
   hash_free( ensemble_config->config_nodes );
   field_trans_table_free( ensemble_config->field_trans_table );
+  rms_file_pool_free( ensemble_config->rms_file_pool );
   summary_key_matcher_free(ensemble_config->summary_key_matcher);
   free( ensemble_config->gen_kw_format_string );
   free( ensemble_config );
@@ -808,6 +814,7 @@ int ensemble_config_get_observations( const ensemble_config_type * config , enkf
 
 enkf_config_node_type * ensemble_config_add_field( ensemble_config_type * config , const char * key , ecl_grid_type * ecl_grid , bool forward_init) {
   enkf_config_node_type * config_node = enkf_config_node_alloc_field( key , ecl_grid , config->field_trans_table , forward_init);
+  field_config_set_rms_file_pool( enkf_config_node_get_ref( config_node ) , config->rms_file_pool );
   ensemble_config_add_node( config , config_node );
   return config_node;
 }
@@ -32,6 +32,7 @@
 #include <ert/ecl/ecl_type.h>
 
 #include <ert/rms/rms_file.h>
+#include <ert/rms/rms_file_pool.h>
 #include <ert/rms/rms_tagkey.h>
 #include <ert/rms/rms_type.h>
 #include <ert/rms/rms_util.h>
@@ -123,16 +124,10 @@ void field_export3D(const field_type * field ,
   ecl_data_type data_type = field_config_get_ecl_data_type( config );
   int   sizeof_ctype_target = ecl_type_get_sizeof_ctype(target_data_type);
 
-  field_type * initial_field               = NULL;
-  field_config_type * initial_field_config = NULL;
-  if (init_file) {
-    ecl_grid_type * grid        = field_config_get_grid(config);
-    bool global_size            = true;
-    initial_field_config        = field_config_alloc_empty(field_config_get_key(config), grid, NULL, global_size);
-    initial_field               = field_alloc(initial_field_config);
+  const field_type * initial_field = NULL;
+  if (init_file)
+    initial_field = field_config_get_init_field( config , init_file );
 
-    field_fload_keep_inactive(initial_field, init_file);
-  }
   switch(ecl_type_get_type(data_type)) {
   case(ECL_DOUBLE_TYPE):
     {
@@ -191,10 +186,8 @@ void field_export3D(const field_type * field ,
     break;
   }
 
-  if (initial_field) {
-    field_config_free(initial_field_config);
-    field_free(initial_field);
-  }
+  if (initial_field)
+    field_config_release_init_field( config , initial_field );
 }
 #undef EXPORT_MACRO
 
@@ -839,6 +832,44 @@ void field_deserialize(field_type * field , node_id_type node_id , const active_
   enkf_matrix_deserialize( field->data , data_size , data_type , active_list , A , row_offset , column);
 }
 
+/*
+  Block versions of field_serialize() / field_deserialize() for
+  several realizations of the same field; all the fields must share
+  the same field_config instance.
+*/
+
+void field_serialize_block(const field_type ** fields , int num_fields , const active_list_type * active_list , matrix_type * A , int row_offset , const int * columns) {
+  if (num_fields > 0) {
+    const field_config_type *config      = fields[0]->config;
+    const int                data_size   = field_config_get_data_size(config );
+    ecl_data_type data_type              = field_config_get_ecl_data_type(config);
+    const void ** data = util_calloc( num_fields , sizeof * data );
+
+    for (int i = 0; i < num_fields; i++)
+      data[i] = fields[i]->data;
+
+    enkf_matrix_serialize_block( data , num_fields , data_size , data_type , active_list , A , row_offset , columns);
+    free( data );
+  }
+}
+
+
+void field_deserialize_block(field_type ** fields , int num_fields , const active_list_type * active_list , const matrix_type * A , int row_offset , const int * columns) {
+  if (num_fields > 0) {
+    const field_config_type *config      = fields[0]->config;
+    const int                data_size   = field_config_get_data_size(config );
+    ecl_data_type data_type              = field_config_get_ecl_data_type(config);
+    void ** data = util_calloc( num_fields , sizeof * data );
+
+    for (int i = 0; i < num_fields; i++)
+      data[i] = fields[i]->data;
+
+    enkf_matrix_deserialize_block( data , num_fields , data_size , data_type , active_list , A , row_offset , columns);
+    free( data );
+  }
+}
+
+
 static int __get_index(const field_type * field, int i, int j, int k) {
   return field_config_keep_inactive_cells(field->config) ? field_config_global_index(field->config , i , j , k) : field_config_active_index(field->config , i , j , k);
 }
@@ -1077,19 +1108,31 @@ bool field_fload_rms(field_type * field , const char * filename, bool keep_inact
   }
 
   {
-    const char * key           = field_config_get_ecl_kw_name(field->config);
-    rms_file_type * rms_file   = rms_file_alloc(filename , false);
+    const char * key                   = field_config_get_ecl_kw_name(field->config);
+    rms_file_pool_type * rms_file_pool = field_config_get_rms_file_pool(field->config);
+    rms_file_type * rms_file           = NULL;
     rms_tagkey_type * data_tag;
-    if (field_config_enkf_mode(field->config))
-      data_tag = rms_file_fread_alloc_data_tagkey(rms_file , "parameter" , "name" , key);
-    else {
+
+    if (rms_file_pool == NULL)
+      rms_file = rms_file_alloc(filename , false);
+
+    if (field_config_enkf_mode(field->config)) {
+      if (rms_file_pool)
+        data_tag = rms_file_pool_fread_alloc_data_tagkey(rms_file_pool , filename , "parameter" , "name" , key);
+      else
+        data_tag = rms_file_fread_alloc_data_tagkey(rms_file , "parameter" , "name" , key);
+    } else {
       /**
           Setting the key - purely to support converting between
           different types of files, without knowing the key. A usable
           feature - but not really well defined.
       */
 
-      rms_tag_type * rms_tag = rms_file_fread_alloc_tag(rms_file , "parameter" , NULL , NULL);
+      rms_tag_type * rms_tag;
+      if (rms_file_pool)
+        rms_tag = rms_file_pool_fread_alloc_tag(rms_file_pool , filename , "parameter" , NULL , NULL);
+      else
+        rms_tag = rms_file_fread_alloc_tag(rms_file , "parameter" , NULL , NULL);
       const char * parameter_name = rms_tag_get_namekey_name(rms_tag);
       field_config_set_key( (field_config_type *) field->config , parameter_name );
       data_tag = rms_tagkey_copyc( rms_tag_get_key(rms_tag , "data") );
@@ -1102,7 +1145,8 @@ bool field_fload_rms(field_type * field , const char * filename, bool keep_inact
 
     field_import3D(field , rms_tagkey_get_data_ref(data_tag) , true , keep_inactive, data_type);
     rms_tagkey_free(data_tag);
-    rms_file_free(rms_file);
+    if (rms_file)
+      rms_file_free(rms_file);
   }
   return true;
 }
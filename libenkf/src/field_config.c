@@ -19,9 +19,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <time.h>
+
+#include <ert/util/ert_api_config.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#endif
 
 #include <ert/util/util.h>
 #include <ert/util/string_util.h>
+#include <ert/util/vector.h>
 
 #include <ert/ecl/ecl_grid.h>
 #include <ert/ecl/ecl_kw.h>
@@ -30,6 +37,7 @@
 #include <ert/ecl/ecl_type.h>
 
 #include <ert/rms/rms_file.h>
+#include <ert/rms/rms_file_pool.h>
 #include <ert/rms/rms_util.h>
 
 #include <ert/enkf/enkf_types.h>
@@ -154,9 +162,181 @@ struct field_config_struct {
   char * output_transform_name;
   char * init_transform_name;
   char * input_transform_name;
+
+  struct field_init_cache_struct * init_cache;     /* Cache of init_file fields used to fill the inactive cells on export - see field_config_get_init_field(). */
+  rms_file_pool_type             * rms_file_pool;  /* Shared pool of opened ROFF files; not owned, can be NULL. */
 };
 
 
+/*
+  When a field is exported with an init_file the inactive cells are
+  filled with the values from the init_file. The init_file is the
+  same for all the realizations, so the parsed init file is cached in
+  the field_config instance. The cache holds at most
+  FIELD_INIT_CACHE_SIZE fields, and evicts the least recently used
+  field first. Fields which are in use are never evicted, so the limit
+  is exceeded while more fields are in use.
+
+  A cached field is valid as long as the mtime and size of the file
+  are unchanged. The mtime has a resolution of one second, so a field
+  which was loaded in the same second as the file was modified can
+  not be trusted, and is loaded again on the next request.
+
+  The cached fields are shared between threads. The file is parsed
+  outside the cache lock, so exports with different init files do not
+  wait for each other, and the exports waiting for the same file share
+  one parse. A node which is replaced because the file has been
+  modified is marked stale, and freed when the last user has released
+  it.
+*/
+
+#define FIELD_INIT_CACHE_SIZE 2
+
+typedef struct {
+  char              * filename;
+  time_t              mtime;
+  size_t              size;
+  time_t              load_time;
+  field_config_type * config;
+  field_type        * field;
+  int                 refcount;
+  int                 last_used;
+  bool                stale;
+  bool                loaded;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t     load_lock;
+#endif
+} field_init_cache_node_type;
+
+
+typedef struct field_init_cache_struct {
+  vector_type       * nodes;
+  int                 use_count;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t     lock;
+#endif
+} field_init_cache_type;
+
+
+static field_init_cache_node_type * field_init_cache_node_alloc( const char * filename , time_t mtime , size_t size) {
+  field_init_cache_node_type * node = util_malloc( sizeof * node );
+
+  node->filename = util_alloc_string_copy( filename );
+  node->mtime = mtime;
+  node->size = size;
+  node->load_time = time( NULL );
+  node->config = NULL;
+  node->field = NULL;
+  node->refcount = 0;
+  node->last_used = 0;
+  node->stale = false;
+  node->loaded = false;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &node->load_lock , NULL );
+#endif
+  return node;
+}
+
+
+static void field_init_cache_node_load( field_init_cache_node_type * node , const field_config_type * field_config ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &node->load_lock );
+#endif
+  if (!node->loaded) {
+    bool global_size = true;
+    node->config = field_config_alloc_empty( field_config_get_key( field_config ) , field_config->grid , NULL , global_size );
+    node->field = field_alloc( node->config );
+    field_fload_keep_inactive( node->field , node->filename );
+    node->loaded = true;
+  }
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &node->load_lock );
+#endif
+}
+
+
+static void field_init_cache_node_free( field_init_cache_node_type * node ) {
+  if (node->field)
+    field_free( node->field );
+
+  if (node->config)
+    field_config_free( node->config );
+
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &node->load_lock );
+#endif
+  free( node->filename );
+  free( node );
+}
+
+
+static void field_init_cache_node_free__( void * arg ) {
+  field_init_cache_node_free( arg );
+}
+
+
+static field_init_cache_type * field_init_cache_alloc( ) {
+  field_init_cache_type * cache = util_malloc( sizeof * cache );
+  cache->nodes = vector_alloc_new();
+  cache->use_count = 0;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &cache->lock , NULL );
+#endif
+  return cache;
+}
+
+
+static void field_init_cache_free( field_init_cache_type * cache ) {
+  vector_free( cache->nodes );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &cache->lock );
+#endif
+  free( cache );
+}
+
+
+static void field_init_cache_lock( field_init_cache_type * cache ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &cache->lock );
+#endif
+}
+
+
+static void field_init_cache_unlock( field_init_cache_type * cache ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &cache->lock );
+#endif
+}
+
+
+/*
+  Frees the least recently used nodes which are not in use, until the
+  cache holds at most FIELD_INIT_CACHE_SIZE nodes. Must be called with
+  the cache lock held.
+*/
+
+static void field_init_cache_evict( field_init_cache_type * cache ) {
+  while (vector_get_size( cache->nodes ) > FIELD_INIT_CACHE_SIZE) {
+    const field_init_cache_node_type * lru_node = NULL;
+    int lru_index = -1;
+    int index;
+
+    for (index = 0; index < vector_get_size( cache->nodes ); index++) {
+      const field_init_cache_node_type * node = vector_iget_const( cache->nodes , index );
+      if ((node->refcount == 0) && ((lru_node == NULL) || (node->last_used < lru_node->last_used))) {
+        lru_node = node;
+        lru_index = index;
+      }
+    }
+
+    if (lru_node == NULL)
+      break;
+
+    vector_idel( cache->nodes , lru_index );
+  }
+}
+
+
 UTIL_IS_INSTANCE_FUNCTION(field_config , FIELD_CONFIG_ID)
 
 /*****************************************************************/
@@ -355,6 +535,89 @@ field_type * field_config_get_min_std( const field_config_type * field_config )
 }
 
 
+/*
+  Will return a field with global size which has been loaded from
+  @init_file; the returned field must be handed back with
+  field_config_release_init_field() when the caller is done with
+  it. The file is only parsed again when it has been modified, or when
+  the field has been evicted from the cache.
+*/
+
+const field_type * field_config_get_init_field( const field_config_type * field_config , const char * init_file) {
+  field_init_cache_type * cache = field_config->init_cache;
+  field_init_cache_node_type * cache_node = NULL;
+  time_t mtime = util_file_mtime( init_file );
+  size_t size = util_file_size( init_file );
+
+  field_init_cache_lock( cache );
+  {
+    int index = 0;
+    while (index < vector_get_size( cache->nodes )) {
+      field_init_cache_node_type * node = vector_iget( cache->nodes , index );
+      if (!node->stale && util_string_equal( node->filename , init_file )) {
+        if ((node->mtime == mtime) && (node->size == size) && (node->mtime < node->load_time)) {
+          cache_node = node;
+          break;
+        }
+
+        node->stale = true;
+        if (node->refcount == 0) {
+          vector_idel( cache->nodes , index );
+          continue;
+        }
+      }
+      index++;
+    }
+
+    if (cache_node == NULL) {
+      cache_node = field_init_cache_node_alloc( init_file , mtime , size );
+      vector_append_owned_ref( cache->nodes , cache_node , field_init_cache_node_free__ );
+    }
+    cache_node->refcount++;
+    cache_node->last_used = ++cache->use_count;
+    field_init_cache_evict( cache );
+  }
+  field_init_cache_unlock( cache );
+
+  field_init_cache_node_load( cache_node , field_config );
+  return cache_node->field;
+}
+
+
+void field_config_release_init_field( const field_config_type * field_config , const field_type * init_field) {
+  field_init_cache_type * cache = field_config->init_cache;
+
+  field_init_cache_lock( cache );
+  {
+    int index;
+    for (index = 0; index < vector_get_size( cache->nodes ); index++) {
+      field_init_cache_node_type * node = vector_iget( cache->nodes , index );
+      if (node->field == init_field) {
+        node->refcount--;
+        if (node->stale && (node->refcount == 0))
+          vector_idel( cache->nodes , index );
+        break;
+      }
+    }
+    field_init_cache_evict( cache );
+  }
+  field_init_cache_unlock( cache );
+}
+
+
+/*
+  The number of init_file fields currently held by the cache.
+*/
+
+int field_config_get_init_cache_size( const field_config_type * field_config ) {
+  int size;
+  field_init_cache_lock( field_config->init_cache );
+  size = vector_get_size( field_config->init_cache->nodes );
+  field_init_cache_unlock( field_config->init_cache );
+  return size;
+}
+
+
 field_file_format_type field_config_get_export_format(const field_config_type * field_config) {
   return field_config->export_format;
 }
@@ -440,6 +703,8 @@ field_config_type * field_config_alloc_empty( const char * ecl_kw_name , ecl_gri
   config->truncation       = TRUNCATE_NONE;
   config->min_std          = NULL;
   config->trans_table      = trans_table;
+  config->init_cache       = field_init_cache_alloc();
+  config->rms_file_pool    = NULL;
 
   field_config_set_grid(config , ecl_grid , false);       /* The grid is (currently) set on allocation and can NOT be updated afterwards. */
   field_config_set_ecl_data_type( config , ECL_FLOAT );   /* This is the internal type - currently not exported any API to change it. */
@@ -682,6 +947,7 @@ void field_config_free(field_config_type * config) {
   util_safe_free(config->output_transform_name);
   util_safe_free(config->init_transform_name);
   if ((config->private_grid) && (config->grid != NULL)) ecl_grid_free( config->grid );
+  field_init_cache_free( config->init_cache );
   free(config);
 }
 
@@ -989,6 +1255,23 @@ int field_config_parse_user_key(const field_config_type * config, const char * i
 ecl_grid_type * field_config_get_grid(const field_config_type * config) { return config->grid; }
 
 
+/*
+  The ROFF files of the field are loaded through the rms_file_pool,
+  which is typically shared by all the fields of an ensemble_config;
+  several parameters in the same file will then use the same indexed
+  rms_file. With no pool every load opens and indexes the file again.
+*/
+
+void field_config_set_rms_file_pool( field_config_type * config , rms_file_pool_type * rms_file_pool ) {
+  config->rms_file_pool = rms_file_pool;
+}
+
+
+rms_file_pool_type * field_config_get_rms_file_pool( const field_config_type * config ) {
+  return config->rms_file_pool;
+}
+
+
 void field_config_fprintf_config( const field_config_type * config ,
                                   enkf_var_type var_type ,
                                   const char * outfile ,
@@ -91,8 +91,8 @@ static void forward_load_context_load_ecl_sum(forward_load_context_type * load_c
     }
 
     if ((header_file != NULL) && (stringlist_get_size(data_files) > 0)) {
-      summary = ecl_sum_fread_alloc(header_file , data_files , SUMMARY_KEY_JOIN_STRING );
-      {
+      summary = ecl_smspec_pool_fread_alloc_sum( ecl_config_get_smspec_pool( load_context->ecl_config ) , header_file , data_files );
+      if (summary) {
         time_t end_time = ecl_config_get_end_date( load_context->ecl_config );
         if (end_time > 0) {
           if (ecl_sum_get_end_time( summary ) < end_time) {
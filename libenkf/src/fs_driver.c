@@ -46,6 +46,7 @@ void fs_driver_init(fs_driver_type * driver) {
   driver->save_vector   = NULL;
   driver->has_vector    = NULL;
   driver->unlink_vector = NULL;
+  driver->copy_nodes    = NULL;
   
   driver->free_driver   = NULL;
   driver->fsync_driver  = NULL;
@@ -160,3 +161,34 @@ int fs_driver_fread_version( FILE * stream ) {
 /*****************************************************************/
 
 
+
+
+/*****************************************************************/
+
+/**
+   Will copy the stored node @node_key for realizations src_iens[i] at
+   @src_report_step in @src_driver to realizations target_iens[i] at
+   @target_report_step in @target_driver, for i in [0,size). The stored
+   bytes are copied as they are, without going through the enkf_node
+   layer. When both drivers are of the same type and the driver
+   implements copy_nodes() that is used, otherwise the nodes are
+   copied one by one with load_node() / save_node().
+*/
+
+void fs_driver_copy_nodes( fs_driver_type * src_driver , fs_driver_type * target_driver , const char * node_key ,
+                           int src_report_step , int target_report_step ,
+                           int size , const int * src_iens , const int * target_iens) {
+
+  if ((src_driver->copy_nodes != NULL) && (src_driver->copy_nodes == target_driver->copy_nodes))
+    src_driver->copy_nodes( src_driver , target_driver , node_key , src_report_step , target_report_step , size , src_iens , target_iens );
+  else {
+    buffer_type * buffer = buffer_alloc( 1024 );
+    int index;
+    for (index = 0; index < size; index++) {
+      buffer_clear( buffer );
+      src_driver->load_node( src_driver , node_key , src_report_step , src_iens[index] , buffer );
+      target_driver->save_node( target_driver , node_key , target_report_step , target_iens[index] , buffer );
+    }
+    buffer_free( buffer );
+  }
+}
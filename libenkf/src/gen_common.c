@@ -18,7 +18,10 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <limits.h>
 #include <string.h>
+#include <ctype.h>
 
 #include <ert/util/util.h>
 
@@ -34,46 +37,384 @@
 */
 
 
-void * gen_common_fscanf_alloc(const char * file , ecl_data_type load_data_type , int * size) {
+/*
+  The ASCII files are parsed with a small buffered scanner instead of
+  one fscanf() call per value. The file is read in blocks of
+  GEN_COMMON_READ_SIZE bytes, and the numbers are converted with hand
+  written conversion functions; the conversion falls back to
+  strtod()/strtof()/strtol() when the fast path can not guarantee a
+  correctly rounded result, so the values are bit-identical to what
+  fscanf() would produce.
+
+  The scanner only hands out the part of the buffer [pos, parse_end)
+  which is terminated by whitespace (or end of file), i.e. a number is
+  never split between two blocks.
+*/
+
+#define GEN_COMMON_READ_SIZE  65536
+#define GEN_COMMON_SAMPLE_SIZE   64
+
+typedef struct {
+  FILE * stream;
+  char * buffer;
+  int    buffer_size;     /* Allocated size; one byte is reserved for a terminating \0. */
+  int    data_end;        /* Number of valid bytes in the buffer. */
+  int    parse_end;       /* The bytes [pos, parse_end) only contain complete tokens. */
+  int    pos;
+  long   consumed;        /* Number of bytes consumed before the current buffer. */
+  bool   eof;
+} gen_common_scanner_type;
+
+
+static void gen_common_scanner_init( gen_common_scanner_type * scanner , FILE * stream ) {
+  scanner->stream = stream;
+  scanner->buffer_size = GEN_COMMON_READ_SIZE + 1;
+  scanner->buffer = util_malloc( scanner->buffer_size );
+  scanner->buffer[0] = '\0';
+  scanner->data_end = 0;
+  scanner->parse_end = 0;
+  scanner->pos = 0;
+  scanner->consumed = 0;
+  scanner->eof = false;
+}
+
+
+static void gen_common_scanner_fill( gen_common_scanner_type * scanner ) {
+  int remaining = scanner->data_end - scanner->pos;
+
+  memmove( scanner->buffer , &scanner->buffer[ scanner->pos ] , remaining );
+  scanner->consumed += scanner->pos;
+  scanner->pos = 0;
+  scanner->data_end = remaining;
+
+  if (scanner->data_end + 1 == scanner->buffer_size) {
+    /* One token fills the whole buffer. */
+    scanner->buffer_size = 2 * scanner->buffer_size - 1;
+    scanner->buffer = util_realloc( scanner->buffer , scanner->buffer_size );
+  }
+
+  {
+    size_t read_size = fread( &scanner->buffer[ scanner->data_end ] , 1 , scanner->buffer_size - 1 - scanner->data_end , scanner->stream );
+    scanner->data_end += read_size;
+    if (read_size == 0)
+      scanner->eof = true;
+  }
+  scanner->buffer[ scanner->data_end ] = '\0';
+
+  if (scanner->eof)
+    scanner->parse_end = scanner->data_end;
+  else {
+    int index = scanner->data_end - 1;
+    while ((index >= 0) && !isspace( (unsigned char) scanner->buffer[index] ))
+      index--;
+    scanner->parse_end = index + 1;
+  }
+}
+
+
+/*
+  Returns a pointer to the start of the next token, or NULL when the
+  end of file has been reached.
+*/
+
+static const char * gen_common_scanner_next( gen_common_scanner_type * scanner ) {
+  while (true) {
+    while ((scanner->pos < scanner->parse_end) && isspace( (unsigned char) scanner->buffer[ scanner->pos ] ))
+      scanner->pos++;
+
+    if (scanner->pos < scanner->parse_end)
+      return &scanner->buffer[ scanner->pos ];
+
+    if (scanner->eof)
+      return NULL;
+
+    gen_common_scanner_fill( scanner );
+  }
+}
+
+
+static void gen_common_scanner_advance( gen_common_scanner_type * scanner , const char * end ) {
+  scanner->pos = end - scanner->buffer;
+}
+
+
+static long gen_common_scanner_get_offset( const gen_common_scanner_type * scanner ) {
+  return scanner->consumed + scanner->pos;
+}
+
+
+static void gen_common_scanner_free( gen_common_scanner_type * scanner ) {
+  free( scanner->buffer );
+}
+
+
+/*
+  Scans a decimal number [+-]digits[.digits][(e|E)[+-]digits] starting
+  at @s, and returns a pointer to the first character after the
+  number. The number is returned as @mantissa * 10^@exp10; if the
+  number has more significant digits than fit in the mantissa the
+  @exact flag is set to false. If there is no number at @s the return
+  value is @s.
+*/
+
+static const char * gen_common_scan_decimal( const char * s , bool * negative , uint64_t * mantissa , int * exp10 , bool * exact) {
+  const char * p = s;
+  int digits = 0;
+  int sig_digits = 0;
+
+  *negative = false;
+  *mantissa = 0;
+  *exp10 = 0;
+  *exact = true;
+
+  if ((*p == '+') || (*p == '-')) {
+    *negative = (*p == '-');
+    p++;
+  }
+
+  while (isdigit( (unsigned char) *p )) {
+    if (*mantissa || (*p != '0')) {
+      if (sig_digits < 19) {
+        *mantissa = *mantissa * 10 + (*p - '0');
+        sig_digits++;
+      } else {
+        (*exp10)++;
+        *exact = false;
+      }
+    }
+    digits++;
+    p++;
+  }
+
+  if (*p == '.') {
+    p++;
+    while (isdigit( (unsigned char) *p )) {
+      if (*mantissa || (*p != '0')) {
+        if (sig_digits < 19) {
+          *mantissa = *mantissa * 10 + (*p - '0');
+          sig_digits++;
+          (*exp10)--;
+        } else
+          *exact = false;
+      } else
+        (*exp10)--;
+      digits++;
+      p++;
+    }
+  }
+
+  if (digits == 0)
+    return s;
+
+  if ((*p == 'e') || (*p == 'E')) {
+    const char * e = p + 1;
+    bool exp_negative = false;
+    int exp_value = 0;
+
+    if ((*e == '+') || (*e == '-')) {
+      exp_negative = (*e == '-');
+      e++;
+    }
+
+    if (isdigit( (unsigned char) *e )) {
+      while (isdigit( (unsigned char) *e )) {
+        if (exp_value < 100000)
+          exp_value = exp_value * 10 + (*e - '0');
+        e++;
+      }
+      *exp10 += exp_negative ? -exp_value : exp_value;
+      p = e;
+    }
+  }
+  return p;
+}
+
+
+/*
+  The fast path requires that both the mantissa and the power of ten
+  are exactly representable, then the result of one multiplication or
+  division is correctly rounded. Hexadecimal numbers, inf and nan are
+  left to the C library.
+*/
+
+static const char * gen_common_parse_double( const char * s , double * value) {
+  static const double pow10[] = {1e0 , 1e1 , 1e2 , 1e3 , 1e4 , 1e5 , 1e6 , 1e7 , 1e8 , 1e9 , 1e10 , 1e11,
+                                 1e12 , 1e13 , 1e14 , 1e15 , 1e16 , 1e17 , 1e18 , 1e19 , 1e20 , 1e21 , 1e22};
+  bool negative , exact;
+  uint64_t mantissa;
+  int exp10;
+  const char * end = gen_common_scan_decimal( s , &negative , &mantissa , &exp10 , &exact );
+
+  if ((end != s) && exact && (*end != 'x') && (*end != 'X') && (mantissa <= (UINT64_C(1) << 53)) && (exp10 >= -22) && (exp10 <= 22)) {
+    double v = (double) mantissa;
+    if (exp10 >= 0)
+      v *= pow10[ exp10 ];
+    else
+      v /= pow10[ -exp10 ];
+    *value = negative ? -v : v;
+    return end;
+  } else {
+    char * strtod_end;
+    *value = strtod( s , &strtod_end );
+    return strtod_end;
+  }
+}
+
+
+static const char * gen_common_parse_float( const char * s , float * value) {
+  static const float pow10[] = {1e0f , 1e1f , 1e2f , 1e3f , 1e4f , 1e5f , 1e6f , 1e7f , 1e8f , 1e9f , 1e10f};
+  bool negative , exact;
+  uint64_t mantissa;
+  int exp10;
+  const char * end = gen_common_scan_decimal( s , &negative , &mantissa , &exp10 , &exact );
+
+  if ((end != s) && exact && (*end != 'x') && (*end != 'X') && (mantissa <= (UINT64_C(1) << 24)) && (exp10 >= -10) && (exp10 <= 10)) {
+    float v = (float) mantissa;
+    if (exp10 >= 0)
+      v *= pow10[ exp10 ];
+    else
+      v /= pow10[ -exp10 ];
+    *value = negative ? -v : v;
+    return end;
+  } else {
+    char * strtof_end;
+    *value = strtof( s , &strtof_end );
+    return strtof_end;
+  }
+}
+
+
+static const char * gen_common_parse_int( const char * s , int * value) {
+  const char * p = s;
+  bool negative = false;
+  int digits = 0;
+  int v = 0;
+
+  if ((*p == '+') || (*p == '-')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  while (isdigit( (unsigned char) *p ) && (digits < 9)) {
+    v = v * 10 + (*p - '0');
+    digits++;
+    p++;
+  }
+
+  if (digits == 0)
+    return s;
+
+  if (isdigit( (unsigned char) *p )) {
+    char * strtol_end;
+    *value = strtol( s , &strtol_end , 10 );
+    return strtol_end;
+  }
+
+  *value = negative ? -v : v;
+  return p;
+}
+
+
+/*
+  Will parse at most @max_size values from @file; if @max_size is
+  negative all the values in the file are parsed. The return value is
+  true if parsing stopped because the end of file (or @max_size) was
+  reached, and false if it stopped on something which could not be
+  parsed as a number.
+*/
+
+static bool gen_common_fscanf_alloc__(const char * file , ecl_data_type load_data_type , int max_size , void ** data , int * size) {
   FILE * stream           = util_fopen(file , "r");
   int sizeof_ctype        = ecl_type_get_sizeof_ctype(load_data_type);
+  long file_size          = util_file_size( file );
   int buffer_elements     = *size;
   int current_size        = 0;
-  int fscanf_return       = 1; /* To keep the compiler happy .*/
-  void * buffer;
-  
-  if (buffer_elements == 0)
-    buffer_elements = 100;
-  
-  buffer = util_calloc( buffer_elements , sizeof_ctype );
-  {
-    do {
-      if (ecl_type_is_float(load_data_type)) {
-        float  * float_buffer = (float *) buffer;
-        fscanf_return = fscanf(stream , "%g" , &float_buffer[current_size]);
-      } else if (ecl_type_is_double(load_data_type)) {
-        double  * double_buffer = (double *) buffer;
-        fscanf_return = fscanf(stream , "%lg" , &double_buffer[current_size]);
-      } else if (ecl_type_is_int(load_data_type)) {
-        int * int_buffer = (int *) buffer;
-        fscanf_return = fscanf(stream , "%d" , &int_buffer[current_size]);
-      }  else 
-        util_abort("%s: god dammit - internal error \n",__func__);
-      
-      if (fscanf_return == 1)
-        current_size += 1;
-      
-      if (current_size == buffer_elements) {
+  bool complete           = true;
+  char * buffer;
+  gen_common_scanner_type scanner;
+
+  if (!(ecl_type_is_float(load_data_type) || ecl_type_is_double(load_data_type) || ecl_type_is_int(load_data_type)))
+    util_abort("%s: god dammit - internal error \n",__func__);
+
+  if (buffer_elements <= 0)
+    buffer_elements = GEN_COMMON_SAMPLE_SIZE;
+
+  buffer = util_malloc( buffer_elements * sizeof_ctype );
+  gen_common_scanner_init( &scanner , stream );
+  while (current_size != max_size) {
+    const char * token = gen_common_scanner_next( &scanner );
+    const char * end;
+
+    if (token == NULL)
+      break;
+
+    if (current_size == buffer_elements) {
+      if (current_size == GEN_COMMON_SAMPLE_SIZE) {
+        /*
+          Estimate the number of elements from the average number of
+          bytes used by the first elements; with 10% slack.
+        */
+        double bytes_per_element = 1.0 * gen_common_scanner_get_offset( &scanner ) / current_size;
+        double estimate = util_double_min( 1.10 * file_size / bytes_per_element , INT_MAX / 16 );
+        buffer_elements = util_int_max( 2 * current_size , estimate );
+      } else
         buffer_elements *= 2;
-        buffer = util_realloc( buffer , buffer_elements * sizeof_ctype );
-      }
-    } while (fscanf_return == 1);
+
+      if (max_size > 0)
+        buffer_elements = util_int_min( buffer_elements , max_size );
+      buffer = util_realloc( buffer , buffer_elements * sizeof_ctype );
+    }
+
+    if (ecl_type_is_float(load_data_type))
+      end = gen_common_parse_float( token , (float *) &buffer[ current_size * sizeof_ctype ]);
+    else if (ecl_type_is_double(load_data_type))
+      end = gen_common_parse_double( token , (double *) &buffer[ current_size * sizeof_ctype ]);
+    else
+      end = gen_common_parse_int( token , (int *) &buffer[ current_size * sizeof_ctype ]);
+
+    if (end == token) {
+      complete = false;
+      break;
+    }
+
+    gen_common_scanner_advance( &scanner , end );
+    current_size++;
   }
-  if (fscanf_return != EOF) 
-    util_abort("%s: scanning of %s terminated before EOF was reached -- fix your file.\n" , __func__ , file);
-  
+  gen_common_scanner_free( &scanner );
   fclose(stream);
+
+  if (current_size > 0)
+    buffer = util_realloc( buffer , current_size * sizeof_ctype );
+
+  *data = buffer;
   *size = current_size;
+  return complete;
+}
+
+
+void * gen_common_fscanf_alloc(const char * file , ecl_data_type load_data_type , int * size) {
+  void * buffer;
+  if (!gen_common_fscanf_alloc__( file , load_data_type , -1 , &buffer , size ))
+    util_abort("%s: scanning of %s terminated before EOF was reached -- fix your file.\n" , __func__ , file);
+
+  return buffer;
+}
+
+
+/*
+  Will load the first @size integers from @file, any content after the
+  first @size integers is ignored. Will fail hard if the file contains
+  less than @size integers.
+*/
+
+int * gen_common_fscanf_alloc_int( const char * file , int size ) {
+  void * buffer;
+  int load_size = size;
+
+  gen_common_fscanf_alloc__( file , ECL_INT , size , &buffer , &load_size );
+  if (load_size < size)
+    util_abort("%s: error when loading %s - file not long enough.\n",__func__ , file );
+
   return buffer;
 }
 
@@ -256,21 +256,17 @@ static bool gen_data_fload_active__(gen_data_type * gen_data, const char * filen
     {
       char * active_file = util_alloc_sprintf("%s_active" , filename );
       if (util_file_exists( active_file )) {
+        int * active_int = gen_common_fscanf_alloc_int( active_file , size );
         file_exists = true;
-        FILE * stream = util_fopen( active_file , "r");
-        int active_int;
         for (int index=0; index < size; index++) {
-          if (fscanf( stream ,  "%d" , &active_int) == 1) {
-            if (active_int == 1)
-              bool_vector_iset( gen_data->active_mask , index , true);
-            else if (active_int == 0)
-              bool_vector_iset( gen_data->active_mask , index , false);
-            else
-              util_abort("%s: error when loading active mask from:%s only 0 and 1 allowed \n",__func__ , active_file);
-          } else
-            util_abort("%s: error when loading active mask from:%s - file not long enough.\n",__func__ , active_file );
+          if (active_int[index] == 1)
+            bool_vector_iset( gen_data->active_mask , index , true);
+          else if (active_int[index] == 0)
+            bool_vector_iset( gen_data->active_mask , index , false);
+          else
+            util_abort("%s: error when loading active mask from:%s only 0 and 1 allowed \n",__func__ , active_file);
         }
-        fclose( stream );
+        free( active_int );
       }
       free( active_file );
     }
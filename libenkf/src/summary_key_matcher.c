@@ -2,36 +2,149 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
 
 #include <ert/util/util.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/int_vector.h>
 #include <ert/util/type_macros.h>
 
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/smspec_node.h>
+
 #include <ert/enkf/enkf_types.h>
 
 
 
 #define SUMMARY_KEY_MATCHER_TYPE_ID 700672137
+#define SMSPEC_CACHE_SIZE           16
+
+/*
+  The matcher is compiled incrementally as keys are added:
+
+    plain_keys: the patterns without any glob special characters; these
+       can only match a summary key which is identical to the pattern,
+       and are checked with one hash lookup.
+
+    prefix_index: the remaining patterns indexed by their literal
+       prefix, i.e. the characters in front of the first special
+       character. A summary key can only match the patterns whose
+       prefix is a prefix of the key, so util_fnmatch() is only called
+       for those; patterns of the form "PREFIX*" are accepted without
+       calling util_fnmatch() at all.
+
+  In addition the list of matching smspec nodes is cached for the most
+  recently used smspec layouts, so that realizations with identical
+  SMSPEC files reuse the result of the first realization.
+*/
+
+typedef struct {
+  int               num_nodes;
+  char           ** keys;
+  int_vector_type * match_index;
+} smspec_match_type;
+
 
 struct summary_key_matcher_struct {
   UTIL_TYPE_ID_DECLARATION;
   hash_type        * key_set;
+  hash_type        * plain_keys;
+  hash_type        * prefix_index;       /* prefix -> stringlist of patterns. */
+  int_vector_type  * prefix_length;      /* The distinct prefix lengths in prefix_index, sorted. */
+  hash_type        * smspec_cache;       /* signature -> smspec_match instance. */
+  pthread_mutex_t    cache_lock;
 };
 
 
 UTIL_IS_INSTANCE_FUNCTION( summary_key_matcher , SUMMARY_KEY_MATCHER_TYPE_ID )
 
 
+static smspec_match_type * smspec_match_alloc( const ecl_smspec_type * smspec , int_vector_type * match_index ) {
+  smspec_match_type * match = util_malloc( sizeof * match );
+  match->num_nodes = ecl_smspec_num_nodes( smspec );
+  match->keys = util_calloc( util_int_max( 1 , match->num_nodes ) , sizeof * match->keys );
+  match->match_index = match_index;
+  for (int i = 0; i < match->num_nodes; i++)
+    match->keys[i] = util_alloc_string_copy( smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i )));
+  return match;
+}
+
+
+static void smspec_match_free( smspec_match_type * match ) {
+  util_free_stringlist( match->keys , match->num_nodes );
+  int_vector_free( match->match_index );
+  free( match );
+}
+
+
+static void smspec_match_free__( void * arg ) {
+  smspec_match_free( arg );
+}
+
+
+static bool smspec_match_equal( const smspec_match_type * match , const ecl_smspec_type * smspec ) {
+  if (match->num_nodes != ecl_smspec_num_nodes( smspec ))
+    return false;
+
+  for (int i = 0; i < match->num_nodes; i++) {
+    if (!util_string_equal( match->keys[i] , smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i ))))
+      return false;
+  }
+  return true;
+}
+
+
+/*
+  FNV-1a hash of all the gen_key1 values of the smspec; combined with the
+  number of nodes this is used as the cache key for the smspec layout.
+*/
+
+static char * summary_key_matcher_alloc_signature( const ecl_smspec_type * smspec ) {
+  uint64_t hash = 14695981039346656037ULL;
+  int num_nodes = ecl_smspec_num_nodes( smspec );
+
+  for (int i = 0; i < num_nodes; i++) {
+    const char * key = smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i ));
+    if (key) {
+      for (const char * c = key; *c; c++) {
+        hash ^= (unsigned char) *c;
+        hash *= 1099511628211ULL;
+      }
+    }
+    hash ^= 0xff;
+    hash *= 1099511628211ULL;
+  }
+  return util_alloc_sprintf("%d:%016llx" , num_nodes , (unsigned long long) hash);
+}
+
+
+static int summary_key_matcher_prefix_length( const char * pattern ) {
+  return strcspn( pattern , "*?[\\" );
+}
+
+
 summary_key_matcher_type * summary_key_matcher_alloc() {
   summary_key_matcher_type * matcher = util_malloc(sizeof * matcher);
   UTIL_TYPE_ID_INIT( matcher , SUMMARY_KEY_MATCHER_TYPE_ID);
   matcher->key_set = hash_alloc();
+  matcher->plain_keys = hash_alloc();
+  matcher->prefix_index = hash_alloc();
+  matcher->prefix_length = int_vector_alloc( 0 , 0 );
+  matcher->smspec_cache = hash_alloc();
+  pthread_mutex_init( &matcher->cache_lock , NULL );
   return matcher;
 }
 
 void summary_key_matcher_free(summary_key_matcher_type * matcher) {
     hash_free(matcher->key_set);
+    hash_free(matcher->plain_keys);
+    hash_free(matcher->prefix_index);
+    int_vector_free(matcher->prefix_length);
+    hash_free(matcher->smspec_cache);
+    pthread_mutex_destroy( &matcher->cache_lock );
     free(matcher);
 }
 
@@ -39,27 +152,117 @@ int summary_key_matcher_get_size(const summary_key_matcher_type * matcher) {
   return hash_get_size( matcher->key_set );
 }
 
+
+static void summary_key_matcher_compile_key(summary_key_matcher_type * matcher, const char * summary_key) {
+  int prefix_length = summary_key_matcher_prefix_length( summary_key );
+
+  if (summary_key[prefix_length] == '\0')
+    hash_insert_int( matcher->plain_keys , summary_key , 1 );
+  else {
+    char * prefix = util_alloc_substring_copy( summary_key , 0 , prefix_length );
+    if (!hash_has_key( matcher->prefix_index , prefix ))
+      hash_insert_hash_owned_ref( matcher->prefix_index , prefix , stringlist_alloc_new() , stringlist_free__ );
+
+    stringlist_append_copy( hash_get( matcher->prefix_index , prefix ) , summary_key );
+    if (!int_vector_contains( matcher->prefix_length , prefix_length )) {
+      int_vector_append( matcher->prefix_length , prefix_length );
+      int_vector_sort( matcher->prefix_length );
+    }
+    free( prefix );
+  }
+}
+
+
 void summary_key_matcher_add_summary_key(summary_key_matcher_type * matcher, const char * summary_key) {
     if(!hash_has_key(matcher->key_set, summary_key)) {
         hash_insert_int(matcher->key_set, summary_key, !util_string_has_wildcard(summary_key));
+        summary_key_matcher_compile_key( matcher , summary_key );
+
+        pthread_mutex_lock( &matcher->cache_lock );
+        hash_clear( matcher->smspec_cache );
+        pthread_mutex_unlock( &matcher->cache_lock );
     }
 }
 
+
 bool summary_key_matcher_match_summary_key(const summary_key_matcher_type * matcher, const char * summary_key) {
-    stringlist_type * keys = hash_alloc_stringlist(matcher->key_set);
+  if (summary_key == NULL)
+    return false;
+
+  if (hash_has_key( matcher->plain_keys , summary_key ))
+    return true;
+
+  {
+    int key_length = strlen( summary_key );
+    char * prefix = util_malloc( key_length + 1 );
     bool has_key = false;
 
-    for (int i = 0; i < stringlist_get_size(keys); i++) {
-        const char * pattern = stringlist_iget(keys, i);
-        if(util_fnmatch(pattern, summary_key) == 0) {
+    for (int i = 0; i < int_vector_size( matcher->prefix_length ) && !has_key; i++) {
+      int prefix_length = int_vector_iget( matcher->prefix_length , i );
+      if (prefix_length > key_length)
+        break;
+
+      memcpy( prefix , summary_key , prefix_length );
+      prefix[prefix_length] = '\0';
+      if (hash_has_key( matcher->prefix_index , prefix )) {
+        const stringlist_type * patterns = hash_get( matcher->prefix_index , prefix );
+        for (int j = 0; j < stringlist_get_size( patterns ); j++) {
+          const char * pattern = stringlist_iget( patterns , j );
+
+          if (util_string_equal( &pattern[prefix_length] , "*") || (util_fnmatch( pattern , summary_key ) == 0)) {
             has_key = true;
             break;
+          }
         }
+      }
     }
 
-    stringlist_free(keys);
-
+    free( prefix );
     return has_key;
+  }
+}
+
+
+/*
+  Will fill the node_index vector with the index of all the smspec
+  nodes whose gen_key1 is matched by the matcher. The result is cached
+  on the smspec layout, i.e. the list of gen_key1 values, and
+  subsequent calls with an identical smspec will not do any pattern
+  matching.
+*/
+
+void summary_key_matcher_select_smspec_nodes(const summary_key_matcher_type * matcher, const ecl_smspec_type * smspec, int_vector_type * node_index) {
+  summary_key_matcher_type * cache_matcher = (summary_key_matcher_type *) matcher;
+  char * signature = summary_key_matcher_alloc_signature( smspec );
+  bool cache_hit = false;
+
+  pthread_mutex_lock( &cache_matcher->cache_lock );
+  if (hash_has_key( cache_matcher->smspec_cache , signature )) {
+    const smspec_match_type * match = hash_get( cache_matcher->smspec_cache , signature );
+    if (smspec_match_equal( match , smspec )) {
+      int_vector_memcpy( node_index , match->match_index );
+      cache_hit = true;
+    }
+  }
+  pthread_mutex_unlock( &cache_matcher->cache_lock );
+
+  if (!cache_hit) {
+    int_vector_type * match_index = int_vector_alloc( 0 , 0 );
+    for (int i = 0; i < ecl_smspec_num_nodes( smspec ); i++) {
+      const char * key = smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i ));
+      if (summary_key_matcher_match_summary_key( matcher , key ))
+        int_vector_append( match_index , i );
+    }
+    int_vector_memcpy( node_index , match_index );
+
+    pthread_mutex_lock( &cache_matcher->cache_lock );
+    if (hash_get_size( cache_matcher->smspec_cache ) >= SMSPEC_CACHE_SIZE)
+      hash_clear( cache_matcher->smspec_cache );
+    hash_insert_hash_owned_ref( cache_matcher->smspec_cache , signature , smspec_match_alloc( smspec , match_index ) , smspec_match_free__ );
+    pthread_mutex_unlock( &cache_matcher->cache_lock );
+  }
+
+  free( signature );
 }
 
 stringlist_type * summary_key_matcher_get_keys(const summary_key_matcher_type * matcher) {
@@ -74,4 +277,4 @@ bool summary_key_matcher_summary_key_is_required(const summary_key_matcher_type
     }
 
     return is_required;
-}
\ No newline at end of file
+}
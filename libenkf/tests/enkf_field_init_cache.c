@@ -0,0 +1,204 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'enkf_field_init_cache.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <utime.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/thread_pool.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_grdecl.h>
+
+#include <ert/enkf/field_config.h>
+#include <ert/enkf/field.h>
+
+#define NX 6
+#define NY 5
+#define NZ 4
+#define INIT_FILE "PORO.grdecl"
+
+
+static void write_init_file__( const char * filename , float offset , time_t mtime ) {
+  ecl_kw_type * poro_kw = ecl_kw_alloc( "PORO" , NX * NY * NZ , ECL_FLOAT );
+  for (int g = 0; g < NX * NY * NZ; g++)
+    ecl_kw_iset_float( poro_kw , g , offset + g );
+
+  {
+    FILE * stream = util_fopen( filename , "w");
+    ecl_kw_fprintf_grdecl( poro_kw , stream );
+    fclose( stream );
+  }
+  ecl_kw_free( poro_kw );
+
+  {
+    struct utimbuf times = { .actime = mtime , .modtime = mtime };
+    utime( filename , &times );
+  }
+}
+
+
+static void write_init_file( float offset , time_t mtime ) {
+  write_init_file__( INIT_FILE , offset , mtime );
+}
+
+
+static void assert_export( const ecl_grid_type * grid , const field_type * field , float offset ) {
+  float data[ NX * NY * NZ ];
+  float fill = -1;
+
+  field_export3D( field , data , false , ECL_FLOAT , &fill , INIT_FILE );
+  for (int g = 0; g < NX * NY * NZ; g++) {
+    if (ecl_grid_cell_active1( grid , g ))
+      test_assert_float_equal( data[g] , 1 );
+    else
+      test_assert_float_equal( data[g] , offset + g );
+  }
+}
+
+
+typedef struct {
+  const ecl_grid_type * grid;
+  const field_type    * field;
+  float                 offset;
+} export_arg_type;
+
+
+static void export_mt( int index , void * arg ) {
+  export_arg_type * export_arg = arg;
+  assert_export( export_arg->grid , export_arg->field , export_arg->offset );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "enkf_field_init_cache" );
+  int * actnum = util_malloc( NX * NY * NZ * sizeof * actnum );
+  for (int g = 0; g < NX * NY * NZ; g++)
+    actnum[g] = (g % 3) ? 1 : 0;
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , actnum );
+    field_config_type * field_config = field_config_alloc_empty( "PORO" , grid , NULL , false );
+    field_type * field = field_alloc( field_config );
+    time_t mtime = time( NULL ) - 100;
+
+    for (int i = 0; i < NX; i++)
+      for (int j = 0; j < NY; j++)
+        for (int k = 0; k < NZ; k++) {
+          float value = 1;
+          if (ecl_grid_cell_active3( grid , i , j , k ))
+            field_ijk_set( field , i , j , k , &value );
+        }
+
+    write_init_file( 100 , mtime );
+    assert_export( grid , field , 100 );
+    {
+      const field_type * init_field1 = field_config_get_init_field( field_config , INIT_FILE );
+      const field_type * init_field2 = field_config_get_init_field( field_config , INIT_FILE );
+      test_assert_ptr_equal( init_field1 , init_field2 );
+      field_config_release_init_field( field_config , init_field1 );
+      field_config_release_init_field( field_config , init_field2 );
+    }
+
+    {
+      const field_type * old_field = field_config_get_init_field( field_config , INIT_FILE );
+
+      /* Updating the file while a cached field is still in use. */
+      write_init_file( 200 , mtime + 10 );
+      assert_export( grid , field , 200 );
+      {
+        const field_type * new_field = field_config_get_init_field( field_config , INIT_FILE );
+        test_assert_ptr_not_equal( old_field , new_field );
+        test_assert_float_equal( field_iget_double( old_field , 0 ) , 100 );
+        test_assert_float_equal( field_iget_double( new_field , 0 ) , 200 );
+        field_config_release_init_field( field_config , new_field );
+      }
+      field_config_release_init_field( field_config , old_field );
+    }
+
+    {
+      thread_pool_type * tp = thread_pool_alloc( 4 , true );
+      export_arg_type export_arg = { .grid = grid , .field = field , .offset = 300 };
+
+      write_init_file( 300 , mtime + 20 );
+      thread_pool_parallel_for( tp , 0 , 64 , export_mt , &export_arg );
+      thread_pool_free( tp );
+    }
+
+    /* Fields in use are never evicted; otherwise at most two fields are kept. */
+    {
+      const char * files[3] = {"PORO1.grdecl" , "PORO2.grdecl" , "PORO3.grdecl"};
+      const field_type * init_fields[3];
+
+      for (int i = 0; i < 3; i++) {
+        write_init_file__( files[i] , 1000 * (i + 1) , mtime );
+        init_fields[i] = field_config_get_init_field( field_config , files[i] );
+        test_assert_float_equal( field_iget_double( init_fields[i] , 0 ) , 1000 * (i + 1));
+      }
+      test_assert_int_equal( field_config_get_init_cache_size( field_config ) , 3 );
+
+      for (int i = 0; i < 3; i++)
+        field_config_release_init_field( field_config , init_fields[i] );
+      test_assert_int_equal( field_config_get_init_cache_size( field_config ) , 2 );
+
+      {
+        const field_type * init_field = field_config_get_init_field( field_config , files[2] );
+        test_assert_ptr_equal( init_field , init_fields[2] );
+        field_config_release_init_field( field_config , init_field );
+      }
+      test_assert_int_equal( field_config_get_init_cache_size( field_config ) , 2 );
+    }
+
+    /*
+      A field loaded in the same second as the file was modified can
+      not be trusted, and is loaded again.
+    */
+    {
+      const field_type * init_field1;
+      const field_type * init_field2;
+
+      write_init_file( 400 , time( NULL ) + 10 );
+      init_field1 = field_config_get_init_field( field_config , INIT_FILE );
+      init_field2 = field_config_get_init_field( field_config , INIT_FILE );
+      test_assert_ptr_not_equal( init_field1 , init_field2 );
+      test_assert_float_equal( field_iget_double( init_field2 , 0 ) , 400 );
+      field_config_release_init_field( field_config , init_field1 );
+      field_config_release_init_field( field_config , init_field2 );
+
+      write_init_file( 500 , mtime + 30 );
+      init_field1 = field_config_get_init_field( field_config , INIT_FILE );
+      init_field2 = field_config_get_init_field( field_config , INIT_FILE );
+      test_assert_ptr_equal( init_field1 , init_field2 );
+      test_assert_float_equal( field_iget_double( init_field1 , 0 ) , 500 );
+      field_config_release_init_field( field_config , init_field1 );
+      field_config_release_init_field( field_config , init_field2 );
+    }
+    test_assert_int_equal( field_config_get_init_cache_size( field_config ) , 1 );
+
+    field_free( field );
+    field_config_free( field_config );
+    ecl_grid_free( grid );
+  }
+  free( actnum );
+  test_work_area_free( work_area );
+  exit(0);
+}
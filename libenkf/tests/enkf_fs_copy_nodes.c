@@ -0,0 +1,114 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'enkf_fs_copy_nodes.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/buffer.h>
+
+#include <ert/enkf/enkf_fs.h>
+
+#define ENS_SIZE 100
+
+
+/*
+  The content of node @key for realization @iens is (iens + 1) * 100
+  integers with value iens.
+*/
+
+static void fwrite_node( enkf_fs_type * fs , const char * key , enkf_var_type var_type , int report_step , int iens ) {
+  buffer_type * buffer = buffer_alloc( 100 );
+  for (int i = 0; i < (iens + 1) * 100; i++)
+    buffer_fwrite_int( buffer , iens );
+
+  enkf_fs_fwrite_node( fs , buffer , key , var_type , report_step , iens );
+  buffer_free( buffer );
+}
+
+
+static void assert_node( enkf_fs_type * fs , const char * key , enkf_var_type var_type , int report_step , int iens , int src_iens ) {
+  buffer_type * buffer = buffer_alloc( 100 );
+
+  test_assert_true( enkf_fs_has_node( fs , key , var_type , report_step , iens ));
+  enkf_fs_fread_node( fs , buffer , key , var_type , report_step , iens );
+  test_assert_int_equal( buffer_get_size( buffer ) , (src_iens + 1) * 100 * sizeof(int) );
+  for (int i = 0; i < (src_iens + 1) * 100; i++)
+    test_assert_int_equal( buffer_fread_int( buffer ) , src_iens );
+
+  buffer_free( buffer );
+}
+
+
+void test_copy_case( ) {
+  enkf_fs_type * src_fs = enkf_fs_create_fs( "src" , BLOCK_FS_DRIVER_ID , NULL , true );
+  enkf_fs_type * target_fs = enkf_fs_create_fs( "target" , BLOCK_FS_DRIVER_ID , NULL , true );
+  int src_iens[ENS_SIZE];
+  int target_iens[ENS_SIZE];
+
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    fwrite_node( src_fs , "PORO" , PARAMETER , 0 , iens );
+    src_iens[iens] = iens;
+    target_iens[iens] = ENS_SIZE - 1 - iens;
+  }
+
+  /* Parameters are always read from report_step 0 in the source. */
+  enkf_fs_copy_nodes( src_fs , target_fs , "PORO" , PARAMETER , 5 , 0 , ENS_SIZE , src_iens , target_iens );
+  for (int iens = 0; iens < ENS_SIZE; iens++)
+    assert_node( target_fs , "PORO" , PARAMETER , 0 , target_iens[iens] , iens );
+
+  /* Copy within one case, between report steps. */
+  for (int iens = 0; iens < ENS_SIZE; iens += 3)
+    fwrite_node( src_fs , "PRESSURE" , DYNAMIC_STATE , 1 , iens );
+
+  {
+    int size = 0;
+    for (int iens = 0; iens < ENS_SIZE; iens += 3) {
+      src_iens[size] = iens;
+      target_iens[size] = iens;
+      size++;
+    }
+    enkf_fs_copy_nodes( src_fs , src_fs , "PRESSURE" , DYNAMIC_STATE , 1 , 2 , size , src_iens , target_iens );
+  }
+
+  for (int iens = 0; iens < ENS_SIZE; iens++) {
+    if ((iens % 3) == 0)
+      assert_node( src_fs , "PRESSURE" , DYNAMIC_STATE , 2 , iens , iens );
+    else
+      test_assert_false( enkf_fs_has_node( src_fs , "PRESSURE" , DYNAMIC_STATE , 2 , iens ));
+  }
+
+  enkf_fs_decref( src_fs );
+  enkf_fs_decref( target_fs );
+
+  {
+    enkf_fs_type * fs = enkf_fs_mount( "target" );
+    for (int iens = 0; iens < ENS_SIZE; iens++)
+      assert_node( fs , "PORO" , PARAMETER , 0 , ENS_SIZE - 1 - iens , iens );
+    enkf_fs_decref( fs );
+  }
+}
+
+
+int main(int argc, char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("enkf_fs_copy_nodes");
+  test_copy_case( );
+  test_work_area_free( work_area );
+  exit(0);
+}
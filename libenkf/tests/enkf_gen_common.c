@@ -0,0 +1,167 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'enkf_gen_common.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+
+#include <ert/ecl/ecl_type.h>
+
+#include <ert/enkf/gen_data_config.h>
+#include <ert/enkf/gen_common.h>
+
+
+/*
+  The reference values are loaded with one fscanf() call per value,
+  which is what the gen_common parser should reproduce bit for bit.
+*/
+
+static void * fscanf_alloc_reference( const char * file , ecl_data_type data_type , int size ) {
+  FILE * stream = util_fopen( file , "r");
+  void * data = util_malloc( size * ecl_type_get_sizeof_ctype( data_type ));
+
+  for (int i = 0; i < size; i++) {
+    int fscanf_return;
+    if (ecl_type_is_float( data_type ))
+      fscanf_return = fscanf( stream , "%g" , &((float *) data)[i] );
+    else if (ecl_type_is_double( data_type ))
+      fscanf_return = fscanf( stream , "%lg" , &((double *) data)[i] );
+    else
+      fscanf_return = fscanf( stream , "%d" , &((int *) data)[i] );
+    test_assert_int_equal( fscanf_return , 1 );
+  }
+  fclose( stream );
+  return data;
+}
+
+
+static void write_random_file( const char * file , int size , rng_type * rng ) {
+  const char * formats[] = {"%g" , "%.3f" , "%.12e" , "%.17g" , "%14.8E" , "%.0f"};
+  FILE * stream = util_fopen( file , "w");
+
+  for (int i = 0; i < size; i++) {
+    double value = (rng_get_double( rng ) - 0.5) * pow( 10 , rng_get_int( rng , 40 ) - 20 );
+    fprintf( stream , formats[ i % 6 ] , value );
+    fprintf( stream , (i % 7) == 0 ? "\n" : "  " );
+  }
+  fprintf( stream , "1 -0 +2.5 .5 5. 1e3 1E-3 0x1p4 inf -nan 12345678901234567890123 1e400 1e-400");
+  fclose( stream );
+}
+
+
+void test_float_double( ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  int size = 100000;
+
+  write_random_file( "data.txt" , size , rng );
+  size += 13;
+  {
+    int load_size = 0;
+    double * data = gen_common_fscanf_alloc( "data.txt" , ECL_DOUBLE , &load_size );
+    double * ref = fscanf_alloc_reference( "data.txt" , ECL_DOUBLE , size );
+
+    test_assert_int_equal( load_size , size );
+    test_assert_int_equal( memcmp( data , ref , size * sizeof * data ) , 0 );
+    free( data );
+    free( ref );
+  }
+
+  {
+    int load_size = 0;
+    float * data = gen_common_fscanf_alloc( "data.txt" , ECL_FLOAT , &load_size );
+    float * ref = fscanf_alloc_reference( "data.txt" , ECL_FLOAT , size );
+
+    test_assert_int_equal( load_size , size );
+    test_assert_int_equal( memcmp( data , ref , size * sizeof * data ) , 0 );
+    free( data );
+    free( ref );
+  }
+  rng_free( rng );
+}
+
+
+void test_int( ) {
+  FILE * stream = util_fopen( "int.txt" , "w");
+  fprintf( stream , "0 1 -1 +7 123456789 -2147483648 2147483647\n");
+  for (int i = 0; i < 200000; i++)
+    fprintf( stream , "%d\n" , i % 2);
+  fclose( stream );
+
+  {
+    int load_size = 0;
+    int * data = gen_common_fscanf_alloc( "int.txt" , ECL_INT , &load_size );
+    int * ref = fscanf_alloc_reference( "int.txt" , ECL_INT , 200007 );
+
+    test_assert_int_equal( load_size , 200007 );
+    test_assert_int_equal( memcmp( data , ref , load_size * sizeof * data ) , 0 );
+    free( data );
+    free( ref );
+  }
+}
+
+
+/*
+  The active mask loader only considers the first @size values; the
+  remaining content of the file is not inspected.
+*/
+
+void test_alloc_int( ) {
+  FILE * stream = util_fopen( "data_active" , "w");
+  fprintf( stream , "1 0 1\n1 garbage");
+  fclose( stream );
+
+  {
+    int * data = gen_common_fscanf_alloc_int( "data_active" , 4 );
+    test_assert_int_equal( data[0] , 1 );
+    test_assert_int_equal( data[1] , 0 );
+    test_assert_int_equal( data[2] , 1 );
+    test_assert_int_equal( data[3] , 1 );
+    free( data );
+  }
+}
+
+
+void test_empty( ) {
+  FILE * stream = util_fopen( "empty.txt" , "w");
+  fprintf( stream , "  \n\n ");
+  fclose( stream );
+  {
+    int load_size = 0;
+    double * data = gen_common_fscanf_alloc( "empty.txt" , ECL_DOUBLE , &load_size );
+    test_assert_int_equal( load_size , 0 );
+    free( data );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "enkf_gen_common" );
+
+  test_float_double( );
+  test_int( );
+  test_alloc_int( );
+  test_empty( );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,229 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'enkf_serialize_block.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/util/matrix.h>
+
+#include <ert/ecl/ecl_type.h>
+
+#include <ert/enkf/active_list.h>
+#include <ert/enkf/enkf_serialize.h>
+
+/*
+  The block serializer is compared with the reference of one
+  matrix_iset() / matrix_iget() per element. When called with
+  arguments: enkf_serialize_block <size> <ens_size> the test also
+  prints the serialize / deserialize timings for a field of the given
+  size, i.e. enkf_serialize_block 5000000 100 will time a field with
+  5M active cells.
+*/
+
+#define ROW_OFFSET 3
+
+
+static void ** alloc_nodes( rng_type * rng , ecl_data_type data_type , int size , int ens_size ) {
+  void ** nodes = util_calloc( ens_size , sizeof * nodes );
+  for (int iens = 0; iens < ens_size; iens++) {
+    nodes[iens] = util_malloc( size * ecl_type_get_sizeof_ctype( data_type ));
+    for (int i = 0; i < size; i++) {
+      double value = rng_get_double( rng );
+      if (ecl_type_is_float( data_type ))
+        ((float *) nodes[iens])[i] = value;
+      else
+        ((double *) nodes[iens])[i] = value;
+    }
+  }
+  return nodes;
+}
+
+
+static void free_nodes( void ** nodes , int ens_size ) {
+  for (int iens = 0; iens < ens_size; iens++)
+    free( nodes[iens] );
+  free( nodes );
+}
+
+
+static double node_iget( const void * node , ecl_data_type data_type , int index ) {
+  if (ecl_type_is_float( data_type ))
+    return ((const float *) node)[index];
+  else
+    return ((const double *) node)[index];
+}
+
+
+static active_list_type * alloc_active_list( int size , int stride ) {
+  active_list_type * active_list = active_list_alloc( );
+  if (stride > 1) {
+    for (int i = 0; i < size; i += stride)
+      active_list_add_index( active_list , i );
+  }
+  return active_list;
+}
+
+
+static void test_serialize( ecl_data_type data_type , int size , int ens_size , int stride ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  active_list_type * active_list = alloc_active_list( size , stride );
+  const int * active = active_list_get_active( active_list );
+  int active_size = active_list_get_active_size( active_list , size );
+  void ** nodes = alloc_nodes( rng , data_type , size , ens_size );
+  int * columns = util_calloc( ens_size , sizeof * columns );
+  matrix_type * A = matrix_alloc( active_size + 2 * ROW_OFFSET , ens_size + 1 );
+
+  /* The realizations are placed in reverse order in the matrix. */
+  for (int iens = 0; iens < ens_size; iens++)
+    columns[iens] = ens_size - iens;
+
+  enkf_matrix_serialize_block( (const void **) nodes , ens_size , size , data_type , active_list , A , ROW_OFFSET , columns );
+  for (int iens = 0; iens < ens_size; iens++) {
+    for (int row = 0; row < active_size; row++) {
+      int index = (active_size == size) ? row : active[row];
+      test_assert_double_equal( matrix_iget( A , row + ROW_OFFSET , columns[iens] ) , node_iget( nodes[iens] , data_type , index ));
+    }
+  }
+
+  {
+    void ** target = alloc_nodes( rng , data_type , size , ens_size );
+    void ** initial = alloc_nodes( rng , data_type , size , ens_size );
+
+    for (int iens = 0; iens < ens_size; iens++)
+      memcpy( initial[iens] , target[iens] , size * ecl_type_get_sizeof_ctype( data_type ));
+
+    matrix_scale( A , 2 );
+    enkf_matrix_deserialize_block( target , ens_size , size , data_type , active_list , A , ROW_OFFSET , columns );
+    for (int iens = 0; iens < ens_size; iens++) {
+      for (int row = 0; row < active_size; row++) {
+        int index = (active_size == size) ? row : active[row];
+        test_assert_double_equal( node_iget( target[iens] , data_type , index ) , 2 * node_iget( nodes[iens] , data_type , index ));
+      }
+
+      /* The single column version must give identical results. */
+      {
+        void * node = util_malloc( size * ecl_type_get_sizeof_ctype( data_type ));
+        memcpy( node , initial[iens] , size * ecl_type_get_sizeof_ctype( data_type ));
+        enkf_matrix_deserialize( node , size , data_type , active_list , A , ROW_OFFSET , columns[iens] );
+        test_assert_int_equal( memcmp( node , target[iens] , size * ecl_type_get_sizeof_ctype( data_type )) , 0 );
+        free( node );
+      }
+    }
+    free_nodes( initial , ens_size );
+    free_nodes( target , ens_size );
+  }
+
+  matrix_free( A );
+  free( columns );
+  free_nodes( nodes , ens_size );
+  active_list_free( active_list );
+  rng_free( rng );
+}
+
+
+/*
+  Serializing into a view of a larger matrix; the column stride of the
+  view is different from the number of rows.
+*/
+
+static void test_shared_matrix( ) {
+  const int size = 1000;
+  const int ens_size = 5;
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  active_list_type * active_list = alloc_active_list( size , 3 );
+  int active_size = active_list_get_active_size( active_list , size );
+  void ** nodes = alloc_nodes( rng , ECL_DOUBLE , size , ens_size );
+  matrix_type * full = matrix_alloc( active_size + 10 , ens_size + 2 );
+  matrix_type * A = matrix_alloc_shared( full , 5 , 1 , active_size , ens_size );
+  matrix_type * ref = matrix_alloc( active_size , ens_size );
+  int columns[] = {0,1,2,3,4};
+
+  matrix_set( full , -1 );
+  enkf_matrix_serialize_block( (const void **) nodes , ens_size , size , ECL_DOUBLE , active_list , A , 0 , columns );
+  for (int iens = 0; iens < ens_size; iens++)
+    enkf_matrix_serialize( nodes[iens] , size , ECL_DOUBLE , active_list , ref , 0 , iens );
+
+  test_assert_true( matrix_equal( A , ref ));
+  test_assert_double_equal( matrix_iget( full , 4 , 1 ) , -1 );
+  test_assert_double_equal( matrix_iget( full , 5 + active_size , 1 ) , -1 );
+  test_assert_double_equal( matrix_iget( full , 5 , 0 ) , -1 );
+
+  matrix_free( ref );
+  matrix_free( A );
+  matrix_free( full );
+  free_nodes( nodes , ens_size );
+  active_list_free( active_list );
+  rng_free( rng );
+}
+
+
+static void time_serialize( ecl_data_type data_type , int size , int ens_size ) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  active_list_type * active_list = alloc_active_list( size , 1 );
+  int active_size = active_list_get_active_size( active_list , size );
+  void ** nodes = alloc_nodes( rng , data_type , size , ens_size );
+  int * columns = util_calloc( ens_size , sizeof * columns );
+  matrix_type * A = matrix_alloc( active_size , ens_size );
+
+  for (int iens = 0; iens < ens_size; iens++)
+    columns[iens] = iens;
+
+  {
+    clock_t start = clock();
+    for (int iens = 0; iens < ens_size; iens++)
+      enkf_matrix_serialize( nodes[iens] , size , data_type , active_list , A , 0 , iens );
+    printf("%-6s %-18s %8.3f s\n" , ecl_type_get_name( data_type ) , "serialize:" , (double) (clock() - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    enkf_matrix_serialize_block( (const void **) nodes , ens_size , size , data_type , active_list , A , 0 , columns );
+    printf("%-6s %-18s %8.3f s\n" , ecl_type_get_name( data_type ) , "serialize_block:" , (double) (clock() - start) / CLOCKS_PER_SEC);
+
+    start = clock();
+    enkf_matrix_deserialize_block( nodes , ens_size , size , data_type , active_list , A , 0 , columns );
+    printf("%-6s %-18s %8.3f s\n" , ecl_type_get_name( data_type ) , "deserialize_block:" , (double) (clock() - start) / CLOCKS_PER_SEC);
+  }
+
+  matrix_free( A );
+  free( columns );
+  free_nodes( nodes , ens_size );
+  active_list_free( active_list );
+  rng_free( rng );
+}
+
+
+int main(int argc , char ** argv) {
+  test_serialize( ECL_FLOAT  , 10000 , 11 , 1 );
+  test_serialize( ECL_FLOAT  , 10000 , 11 , 3 );
+  test_serialize( ECL_DOUBLE , 10000 , 11 , 1 );
+  test_serialize( ECL_DOUBLE , 10000 , 11 , 7 );
+  test_serialize( ECL_FLOAT  , 1 , 1 , 1 );
+  test_shared_matrix( );
+
+  if (argc == 3) {
+    int size , ens_size;
+    if (util_sscanf_int( argv[1] , &size ) && util_sscanf_int( argv[2] , &ens_size )) {
+      time_serialize( ECL_FLOAT  , size , ens_size );
+      time_serialize( ECL_DOUBLE , size , ens_size );
+    }
+  }
+  exit(0);
+}
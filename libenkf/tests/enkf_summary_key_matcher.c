@@ -0,0 +1,138 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'enkf_summary_key_matcher.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec.h>
+#include <ert/ecl/smspec_node.h>
+
+#include <ert/enkf/summary_key_matcher.h>
+
+
+static const char * patterns[] = {"FOPT" , "WOPR:OP_1" , "WWCT:*" , "*:INJ_?" , "GOPR:[AB]*" , "BPR:1,*" , "RPR:\\*" , "W*T:OP_*"};
+static const char * keys[] = {"FOPT" , "FOPR" , "WOPR:OP_1" , "WOPR:OP_2" , "WWCT:OP_1" , "WWCT:INJ_1" , "WWIR:INJ_1" , "WWIR:INJ_12" ,
+                              "GOPR:A1" , "GOPR:C1" , "BPR:1,1,1" , "BPR:2,1,1" , "RPR:*" , "RPR:1" , "WGPT:OP_2" , "WOPT:INJ_1" , "WWCT" , ""};
+
+
+static void test_match( ) {
+  summary_key_matcher_type * matcher = summary_key_matcher_alloc( );
+  int num_patterns = sizeof patterns / sizeof patterns[0];
+  int num_keys = sizeof keys / sizeof keys[0];
+
+  for (int i = 0; i < num_patterns; i++)
+    summary_key_matcher_add_summary_key( matcher , patterns[i] );
+  summary_key_matcher_add_summary_key( matcher , "FOPT" );
+  test_assert_int_equal( summary_key_matcher_get_size( matcher ) , num_patterns );
+
+  for (int j = 0; j < num_keys; j++) {
+    bool fnmatch = false;
+    for (int i = 0; i < num_patterns; i++) {
+      if (util_fnmatch( patterns[i] , keys[j] ) == 0)
+        fnmatch = true;
+    }
+    test_assert_bool_equal( summary_key_matcher_match_summary_key( matcher , keys[j] ) , fnmatch );
+  }
+  test_assert_false( summary_key_matcher_match_summary_key( matcher , NULL ));
+
+  test_assert_true( summary_key_matcher_summary_key_is_required( matcher , "FOPT" ));
+  test_assert_false( summary_key_matcher_summary_key_is_required( matcher , "WWCT:*" ));
+  test_assert_false( summary_key_matcher_summary_key_is_required( matcher , "WWCT:OP_1" ));
+  summary_key_matcher_free( matcher );
+}
+
+
+static ecl_sum_type * alloc_ecl_sum( const char * case_name , int num_wells ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( case_name , false , true , ":" , 0 , true , 10 , 10 , 10 );
+  ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0 );
+  ecl_sum_add_var( ecl_sum , "FOPR" , NULL , 0 , "SM3/DAY" , 0 );
+  for (int i = 0; i < num_wells; i++) {
+    char * well = util_alloc_sprintf("OP_%d" , i);
+    ecl_sum_add_var( ecl_sum , "WOPR" , well , 0 , "SM3/DAY" , 0 );
+    ecl_sum_add_var( ecl_sum , "WWCT" , well , 0 , "" , 0 );
+    free( well );
+  }
+  return ecl_sum;
+}
+
+
+static void assert_smspec_nodes( const summary_key_matcher_type * matcher , const ecl_smspec_type * smspec , const int_vector_type * node_index ) {
+  int index = 0;
+  for (int i = 0; i < ecl_smspec_num_nodes( smspec ); i++) {
+    const char * key = smspec_node_get_gen_key1( ecl_smspec_iget_node( smspec , i ));
+    if (summary_key_matcher_match_summary_key( matcher , key )) {
+      test_assert_true( index < int_vector_size( node_index ));
+      test_assert_int_equal( int_vector_iget( node_index , index ) , i );
+      index++;
+    }
+  }
+  test_assert_int_equal( index , int_vector_size( node_index ));
+}
+
+
+static void test_smspec_nodes( ) {
+  summary_key_matcher_type * matcher = summary_key_matcher_alloc( );
+  ecl_sum_type * ecl_sum1 = alloc_ecl_sum( "CASE1" , 10 );
+  ecl_sum_type * ecl_sum2 = alloc_ecl_sum( "CASE2" , 10 );
+  ecl_sum_type * ecl_sum3 = alloc_ecl_sum( "CASE3" , 5 );
+  int_vector_type * node_index = int_vector_alloc( 0 , 0 );
+
+  summary_key_matcher_add_summary_key( matcher , "FOPT" );
+  summary_key_matcher_add_summary_key( matcher , "WWCT:*" );
+
+  summary_key_matcher_select_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum1 ) , node_index );
+  test_assert_int_equal( int_vector_size( node_index ) , 11 );
+  assert_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum1 ) , node_index );
+
+  /* Identical layout - served from the cache. */
+  summary_key_matcher_select_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum2 ) , node_index );
+  assert_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum2 ) , node_index );
+
+  summary_key_matcher_select_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum3 ) , node_index );
+  test_assert_int_equal( int_vector_size( node_index ) , 6 );
+  assert_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum3 ) , node_index );
+
+  /* Adding a key must invalidate the cached result. */
+  summary_key_matcher_add_summary_key( matcher , "WOPR:OP_1" );
+  summary_key_matcher_select_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum2 ) , node_index );
+  test_assert_int_equal( int_vector_size( node_index ) , 12 );
+  assert_smspec_nodes( matcher , ecl_sum_get_smspec( ecl_sum2 ) , node_index );
+
+  int_vector_free( node_index );
+  ecl_sum_free( ecl_sum1 );
+  ecl_sum_free( ecl_sum2 );
+  ecl_sum_free( ecl_sum3 );
+  summary_key_matcher_free( matcher );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "enkf_summary_key_matcher" );
+
+  test_match( );
+  test_smspec_nodes( );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
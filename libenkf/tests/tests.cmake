@@ -26,6 +26,18 @@ add_executable( enkf_gen_data_config_parse enkf_gen_data_config_parse.c )
 target_link_libraries( enkf_gen_data_config_parse enkf  )
 add_test( enkf_gen_data_config_parse ${EXECUTABLE_OUTPUT_PATH}/enkf_gen_data_config_parse)
 
+add_executable( enkf_gen_common enkf_gen_common.c )
+target_link_libraries( enkf_gen_common enkf  )
+add_test( enkf_gen_common ${EXECUTABLE_OUTPUT_PATH}/enkf_gen_common)
+
+add_executable( enkf_field_init_cache enkf_field_init_cache.c )
+target_link_libraries( enkf_field_init_cache enkf  )
+add_test( enkf_field_init_cache ${EXECUTABLE_OUTPUT_PATH}/enkf_field_init_cache)
+
+add_executable( enkf_serialize_block enkf_serialize_block.c )
+target_link_libraries( enkf_serialize_block enkf  )
+add_test( enkf_serialize_block ${EXECUTABLE_OUTPUT_PATH}/enkf_serialize_block)
+
 add_executable( enkf_enkf_config_node_gen_data enkf_enkf_config_node_gen_data.c )
 target_link_libraries( enkf_enkf_config_node_gen_data enkf  )
 add_test( enkf_enkf_config_node_gen_data ${EXECUTABLE_OUTPUT_PATH}/enkf_enkf_config_node_gen_data)
@@ -47,6 +59,10 @@ add_executable( enkf_ensemble_config enkf_ensemble_config.c )
 target_link_libraries( enkf_ensemble_config enkf  )
 add_test( enkf_ensemble_config ${EXECUTABLE_OUTPUT_PATH}/enkf_ensemble_config)
 
+add_executable( enkf_summary_key_matcher enkf_summary_key_matcher.c )
+target_link_libraries( enkf_summary_key_matcher enkf  )
+add_test( enkf_summary_key_matcher ${EXECUTABLE_OUTPUT_PATH}/enkf_summary_key_matcher)
+
 add_executable( enkf_pca_plot enkf_pca_plot.c )
 target_link_libraries( enkf_pca_plot enkf )
 add_test( enkf_pca_plot ${EXECUTABLE_OUTPUT_PATH}/enkf_pca_plot)
@@ -91,6 +107,10 @@ add_executable( enkf_fs enkf_fs.c )
 target_link_libraries( enkf_fs enkf  )
 add_test( enkf_fs  ${EXECUTABLE_OUTPUT_PATH}/enkf_fs )
 
+add_executable( enkf_fs_copy_nodes enkf_fs_copy_nodes.c )
+target_link_libraries( enkf_fs_copy_nodes enkf  )
+add_test( enkf_fs_copy_nodes  ${EXECUTABLE_OUTPUT_PATH}/enkf_fs_copy_nodes )
+
 add_executable( enkf_workflow_job_test_version enkf_workflow_job_test_version.c )
 target_link_libraries( enkf_workflow_job_test_version enkf  )
 add_test( enkf_workflow_job_test_version  ${EXECUTABLE_OUTPUT_PATH}/enkf_workflow_job_test_version 
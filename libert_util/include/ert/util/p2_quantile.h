@@ -0,0 +1,42 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'p2_quantile.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_P2_QUANTILE_H
+#define ERT_P2_QUANTILE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ert/util/type_macros.h>
+
+  typedef struct p2_quantile_struct p2_quantile_type;
+
+  p2_quantile_type * p2_quantile_alloc( double quantile );
+  void               p2_quantile_free( p2_quantile_type * p2 );
+  void               p2_quantile_reset( p2_quantile_type * p2 );
+  void               p2_quantile_add( p2_quantile_type * p2 , double value );
+  double             p2_quantile_get( const p2_quantile_type * p2 );
+  double             p2_quantile_get_quantile( const p2_quantile_type * p2 );
+  int                p2_quantile_get_count( const p2_quantile_type * p2 );
+
+  UTIL_IS_INSTANCE_HEADER( p2_quantile );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
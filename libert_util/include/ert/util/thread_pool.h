@@ -25,6 +25,7 @@ extern "C" {
 #include <stdbool.h>
 
   typedef struct     thread_pool_struct thread_pool_type;
+  typedef void      (thread_pool_index_ftype) (int index , void * arg);
 
   void               thread_pool_join(thread_pool_type * );
   thread_pool_type * thread_pool_alloc(int , bool start_queue);
@@ -34,6 +35,7 @@ extern "C" {
   void             * thread_pool_iget_return_value( const thread_pool_type * pool , int queue_index );
   int                thread_pool_get_max_running( const thread_pool_type * pool );
   bool               thread_pool_try_join(thread_pool_type * pool, int timeout_seconds);
+  void               thread_pool_parallel_for( thread_pool_type * pool , int begin , int end , thread_pool_index_ftype * func , void * arg);
 
 #ifdef __cplusplus
 }
@@ -519,7 +519,9 @@ void    util_abort_set_executable( const char * argv0 );
 
 #ifdef ERT_HAVE_SPAWN
   pid_t      util_spawn(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file);
+  pid_t      util_spawn_process_group(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file);
   int        util_spawn_blocking(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file);
+  int        util_spawn_capture(const char *executable, int argc, const char **argv, char ** stdout_buffer, char ** stderr_buffer, int timeout_ms);
 #ifdef ERT_HAVE_PING
   bool       util_ping( const char * hostname);
 #endif
@@ -49,6 +49,7 @@ typedef @TYPE@ (@TYPE@_ftype) (@TYPE@);
   @TYPE@_vector_type * @TYPE@_vector_alloc( int init_size , @TYPE@ );
   @TYPE@_vector_type * @TYPE@_vector_alloc_private_wrapper(int init_size, @TYPE@ default_value , @TYPE@ * data , int alloc_size);
   @TYPE@_vector_type * @TYPE@_vector_alloc_shared_wrapper(int init_size, @TYPE@ default_value , @TYPE@ * data , int alloc_size);
+  @TYPE@_vector_type * @TYPE@_vector_alloc_view( @TYPE@ * data , int size );
   @TYPE@_vector_type * @TYPE@_vector_alloc_strided_copy( const @TYPE@_vector_type * src , int start , int stop , int stride );
   @TYPE@_vector_type * @TYPE@_vector_alloc_copy( const @TYPE@_vector_type * src);
   void                 @TYPE@_vector_imul(@TYPE@_vector_type * vector, int index, @TYPE@ factor);
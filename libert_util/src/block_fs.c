@@ -1093,6 +1093,9 @@ block_fs_type * block_fs_mount( const char * mount_file ,
       long_vector_free( fix_nodes );
     }
   }
+  /* Without data ownership the index will not change; lookups can go lock free. */
+  if (!block_fs->data_owner)
+    hash_freeze( block_fs->index );
   if (preload) block_fs_preload( block_fs );
   return block_fs;
 }
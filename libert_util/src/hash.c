@@ -73,6 +73,10 @@ struct hash_struct {
   hashf_type       *hashf;
 
   lock_type         rwlock;
+
+  uint32_t          frozen_size;     /* Size of the open addressing lookup table of a frozen hash; 0 when the hash is not frozen. */
+  uint32_t         *frozen_index;    /* The precomputed global index (i.e. hash value) of the node in each slot. */
+  hash_node_type  **frozen_nodes;    /* The nodes; NULL for empty slots. */
 };
 
 
@@ -86,27 +90,49 @@ typedef struct hash_sort_node {
 /*****************************************************************/
 /*                          locking                              */
 /*****************************************************************/
+
+static bool __hash_frozen( const hash_type * hash ) {
+  return (hash->frozen_size > 0);
+}
+
+static void hash_unfreeze__( hash_type * hash );
+
 #ifdef HAVE_PTHREAD
 static void __hash_deadlock_abort(hash_type * hash) {
   util_abort("%s: A deadlock condition has been detected in the hash routine - and the program will abort.\n", __func__);
 }
 
 
+/*
+  A frozen hash is read without any locking at all; all modifying
+  operations start by unfreezing the hash in __hash_wrlock(), so
+  __hash_unlock() will only find a frozen hash on the read path.
+*/
+
 static void __hash_rdlock(hash_type * hash) {
-  int lock_error = pthread_rwlock_tryrdlock( &hash->rwlock );
-  if (lock_error != 0)
-    util_abort("%s: did not get hash->read_lock - fix locking in calling scope\n",__func__);
+  if (__hash_frozen( hash ))
+    return;
+  {
+    int lock_error = pthread_rwlock_tryrdlock( &hash->rwlock );
+    if (lock_error != 0)
+      util_abort("%s: did not get hash->read_lock - fix locking in calling scope\n",__func__);
+  }
 }
 
 
 static void __hash_wrlock(hash_type * hash) {
-  int lock_error = pthread_rwlock_trywrlock( &hash->rwlock );
-  if (lock_error != 0)
-    util_abort("%s: did not get hash->write_lock - fix locking in calling scope\n",__func__);
+  hash_unfreeze__( hash );
+  {
+    int lock_error = pthread_rwlock_trywrlock( &hash->rwlock );
+    if (lock_error != 0)
+      util_abort("%s: did not get hash->write_lock - fix locking in calling scope\n",__func__);
+  }
 }
 
 
 static void __hash_unlock( hash_type * hash) {
+  if (__hash_frozen( hash ))
+    return;
   pthread_rwlock_unlock( &hash->rwlock );
 }
 
@@ -122,7 +148,7 @@ static void LOCK_INIT( lock_type * rwlock ) {
 #else
 
 static void __hash_rdlock(hash_type * hash) {}
-static void __hash_wrlock(hash_type * hash) {}
+static void __hash_wrlock(hash_type * hash) { hash_unfreeze__( hash ); }
 static void __hash_unlock(hash_type * hash) {}
 static void LOCK_DESTROY(lock_type * rwlock) {}
 static void LOCK_INIT(lock_type * rwlock) {}
@@ -150,10 +176,37 @@ static void * __hash_get_node_unlocked(const hash_type *__hash , const char *key
 }
 
 
+/*
+  Lookup in a frozen hash: linear probing in the open addressing table,
+  comparing the precomputed global index before the key itself. No
+  locks are taken.
+*/
+
+static hash_node_type * __hash_get_node_frozen(const hash_type *hash , const char *key, bool abort_on_error) {
+  const uint32_t global_index = hash->hashf(key , strlen(key));
+  const uint32_t mask = hash->frozen_size - 1;
+  uint32_t slot = global_index & mask;
+
+  while (hash->frozen_nodes[slot] != NULL) {
+    if (hash->frozen_index[slot] == global_index) {
+      if (strcmp( hash_node_get_key( hash->frozen_nodes[slot] ) , key) == 0)
+        return hash->frozen_nodes[slot];
+    }
+    slot = (slot + 1) & mask;
+  }
+
+  if (abort_on_error)
+    util_abort("%s: tried to get from key:%s which does not exist - aborting \n",__func__ , key);
+
+  return NULL;
+}
+
+
 /*
   This function looks up a hash_node from the hash. This is the common
   low-level function to get content from the hash. The function takes
-  read-lock which is held during execution.
+  read-lock which is held during execution - unless the hash is
+  frozen, in which case no locking is needed.
 
   Would strongly preferred that the hash_type * was const - but that is
   difficult due to locking requirements.
@@ -162,6 +215,9 @@ static void * __hash_get_node_unlocked(const hash_type *__hash , const char *key
 static void * __hash_get_node(const hash_type *hash_in , const char *key, bool abort_on_error) {
   hash_node_type * node;
   hash_type * hash = (hash_type *)hash_in;
+  if (__hash_frozen( hash ))
+    return __hash_get_node_frozen( hash , key , abort_on_error );
+
   __hash_rdlock( hash );
   node = __hash_get_node_unlocked(hash , key , abort_on_error);
   __hash_unlock( hash );
@@ -421,6 +477,81 @@ double hash_get_double(const hash_type * hash , const char * key) {
 }
 
 
+/*****************************************************************/
+
+/*****************************************************************/
+/*                         Frozen hash                           */
+/*****************************************************************/
+
+/**
+   Freezing a hash will build an additional open addressing lookup
+   table, and subsequent lookups in the hash will then be done without
+   any locking - i.e. concurrent lookups from many threads will not
+   contend on the rwlock. This is intended for hash tables which are
+   built once and then used read-only, typically on the innermost
+   lookup paths.
+
+   The hash can still be modified after it has been frozen, but any
+   modification will unfreeze the hash, i.e. it will return to the
+   normal locking mode and must be frozen again explicitly. Observe
+   that modifying the hash while other threads are reading from it is
+   not supported, frozen or not.
+*/
+
+void hash_freeze( hash_type * hash ) {
+  __hash_wrlock( hash );
+  {
+    uint32_t frozen_size = 1;
+    uint32_t * frozen_index;
+    hash_node_type ** frozen_nodes;
+    uint32_t i;
+
+    while (frozen_size < 2 * hash->elements)
+      frozen_size *= 2;
+
+    frozen_index = util_calloc( frozen_size , sizeof * frozen_index );
+    frozen_nodes = util_calloc( frozen_size , sizeof * frozen_nodes );
+    for (i=0; i < frozen_size; i++)
+      frozen_nodes[i] = NULL;
+
+    for (i=0; i < hash->size; i++) {
+      hash_node_type * node = hash_sll_get_head( hash->table[i] );
+      while (node != NULL) {
+        uint32_t global_index = hash_node_get_global_index( node );
+        uint32_t slot = global_index & (frozen_size - 1);
+
+        while (frozen_nodes[slot] != NULL)
+          slot = (slot + 1) & (frozen_size - 1);
+
+        frozen_index[slot] = global_index;
+        frozen_nodes[slot] = node;
+        node = hash_node_get_next( node );
+      }
+    }
+    __hash_unlock( hash );
+
+    hash->frozen_index = frozen_index;
+    hash->frozen_nodes = frozen_nodes;
+    hash->frozen_size  = frozen_size;
+  }
+}
+
+
+static void hash_unfreeze__( hash_type * hash ) {
+  if (__hash_frozen( hash )) {
+    hash->frozen_size = 0;
+    free( hash->frozen_index );
+    free( hash->frozen_nodes );
+    hash->frozen_index = NULL;
+    hash->frozen_nodes = NULL;
+  }
+}
+
+
+bool hash_is_frozen( const hash_type * hash ) {
+  return __hash_frozen( hash );
+}
+
 /*****************************************************************/
 
 void hash_del(hash_type *hash , const char *key) {
@@ -516,6 +647,9 @@ static hash_type * __hash_alloc(int size, double resize_fill , hashf_type *hashf
   hash->table     = hash_sll_alloc_table(hash->size);
   hash->elements  = 0;
   hash->resize_fill  = resize_fill;
+  hash->frozen_size  = 0;
+  hash->frozen_index = NULL;
+  hash->frozen_nodes = NULL;
   LOCK_INIT( &hash->rwlock );
 
   return hash;
@@ -542,6 +676,7 @@ void hash_free(hash_type *hash) {
   for (i=0; i < hash->size; i++)
     hash_sll_free(hash->table[i]);
   free(hash->table);
+  hash_unfreeze__( hash );
   LOCK_DESTROY( &hash->rwlock );
   free(hash);
 }
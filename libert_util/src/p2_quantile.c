@@ -0,0 +1,198 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'p2_quantile.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+
+#include <ert/util/util.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/statistics.h>
+#include <ert/util/p2_quantile.h>
+
+/*
+  Streaming quantile estimator based on the P^2 algorithm of Jain and
+  Chlamtac: "The P^2 algorithm for dynamic calculation of quantiles
+  and histograms without storing observations", Comm. ACM 28 (1985).
+
+  The estimator keeps five markers; the minimum, the maximum, the
+  requested quantile and the two quantiles halfway between these. The
+  marker heights are adjusted with piecewise parabolic interpolation
+  as observations are added, i.e. the memory usage is constant and
+  independent of the number of observations. Until five values have
+  been added the estimate is the exact empirical quantile.
+*/
+
+#define P2_QUANTILE_TYPE_ID 771350
+#define P2_MARKERS          5
+
+struct p2_quantile_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  double quantile;
+  int    count;
+  double height[P2_MARKERS];
+  int    pos[P2_MARKERS];
+  double desired_pos[P2_MARKERS];
+  double delta_pos[P2_MARKERS];
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( p2_quantile , P2_QUANTILE_TYPE_ID )
+
+
+void p2_quantile_reset( p2_quantile_type * p2 ) {
+  const double p = p2->quantile;
+
+  p2->count = 0;
+  for (int i=0; i < P2_MARKERS; i++) {
+    p2->height[i] = 0;
+    p2->pos[i] = i + 1;
+  }
+
+  p2->desired_pos[0] = 1;
+  p2->desired_pos[1] = 1 + 2*p;
+  p2->desired_pos[2] = 1 + 4*p;
+  p2->desired_pos[3] = 3 + 2*p;
+  p2->desired_pos[4] = 5;
+
+  p2->delta_pos[0] = 0;
+  p2->delta_pos[1] = p/2;
+  p2->delta_pos[2] = p;
+  p2->delta_pos[3] = (1 + p)/2;
+  p2->delta_pos[4] = 1;
+}
+
+
+p2_quantile_type * p2_quantile_alloc( double quantile ) {
+  if ((quantile < 0) || (quantile > 1.0))
+    util_abort("%s: quantile must be in [0,1] \n",__func__);
+  {
+    p2_quantile_type * p2 = util_malloc( sizeof * p2 );
+    UTIL_TYPE_ID_INIT( p2 , P2_QUANTILE_TYPE_ID );
+    p2->quantile = quantile;
+    p2_quantile_reset( p2 );
+    return p2;
+  }
+}
+
+
+void p2_quantile_free( p2_quantile_type * p2 ) {
+  free( p2 );
+}
+
+
+static double p2_quantile_parabolic( const p2_quantile_type * p2 , int i , int d) {
+  const double * q = p2->height;
+  const int    * n = p2->pos;
+
+  return q[i] + d * 1.0 / (n[i+1] - n[i-1]) * ((n[i] - n[i-1] + d) * (q[i+1] - q[i]) / (n[i+1] - n[i]) +
+                                                (n[i+1] - n[i] - d) * (q[i] - q[i-1]) / (n[i] - n[i-1]));
+}
+
+
+static double p2_quantile_linear( const p2_quantile_type * p2 , int i , int d) {
+  const double * q = p2->height;
+  const int    * n = p2->pos;
+
+  return q[i] + d * (q[i+d] - q[i]) / (n[i+d] - n[i]);
+}
+
+
+void p2_quantile_add( p2_quantile_type * p2 , double value ) {
+  if (p2->count < P2_MARKERS) {
+    /* Insertion sort of the first observations. */
+    int i = p2->count;
+    while ((i > 0) && (p2->height[i-1] > value)) {
+      p2->height[i] = p2->height[i-1];
+      i--;
+    }
+    p2->height[i] = value;
+    p2->count++;
+    return;
+  }
+
+  {
+    double * q = p2->height;
+    int k;
+
+    /* 1: Find the cell containing the new value, and update the extreme markers. */
+    if (value < q[0]) {
+      q[0] = value;
+      k = 0;
+    } else if (value >= q[4]) {
+      q[4] = value;
+      k = 3;
+    } else {
+      k = 0;
+      while (value >= q[k+1])
+        k++;
+    }
+
+    /* 2: Increment the marker positions. */
+    for (int i = k + 1; i < P2_MARKERS; i++)
+      p2->pos[i]++;
+
+    for (int i = 0; i < P2_MARKERS; i++)
+      p2->desired_pos[i] += p2->delta_pos[i];
+
+    /* 3: Adjust the heights of the three middle markers if necessary. */
+    for (int i = 1; i < (P2_MARKERS - 1); i++) {
+      double d = p2->desired_pos[i] - p2->pos[i];
+
+      if (((d >= 1) && ((p2->pos[i+1] - p2->pos[i]) > 1)) ||
+          ((d <= -1) && ((p2->pos[i-1] - p2->pos[i]) < -1))) {
+        int ds = (d > 0) ? 1 : -1;
+        double new_height = p2_quantile_parabolic( p2 , i , ds );
+
+        if ((q[i-1] < new_height) && (new_height < q[i+1]))
+          q[i] = new_height;
+        else
+          q[i] = p2_quantile_linear( p2 , i , ds );
+
+        p2->pos[i] += ds;
+      }
+    }
+    p2->count++;
+  }
+}
+
+
+double p2_quantile_get( const p2_quantile_type * p2 ) {
+  if (p2->count == 0)
+    util_abort("%s: no observations added\n",__func__);
+
+  if (p2->count <= P2_MARKERS) {
+    double_vector_type * data = double_vector_alloc( 0 , 0 );
+    double value;
+
+    double_vector_append_many( data , p2->height , p2->count );
+    value = statistics_empirical_quantile__( data , p2->quantile );
+    double_vector_free( data );
+
+    return value;
+  } else
+    return p2->height[2];
+}
+
+
+double p2_quantile_get_quantile( const p2_quantile_type * p2 ) {
+  return p2->quantile;
+}
+
+
+int p2_quantile_get_count( const p2_quantile_type * p2 ) {
+  return p2->count;
+}
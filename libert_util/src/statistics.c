@@ -21,6 +21,7 @@
 
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
+#include <ert/util/perm_vector.h>
 #include <ert/util/statistics.h>
 
 
@@ -141,3 +142,231 @@ double statistics_empirical_quantile__( const double_vector_type * data , double
     }
   }
 }
+
+
+
+/*
+  Selection based quantiles
+  -------------------------
+
+  The functions below calculate several quantiles from an unsorted
+  data vector without sorting it fully. The k'th order statistic is
+  found with a quickselect variant (three-way partitioning, which is
+  robust against the many equal values typical of e.g. summary rate
+  vectors), falling back to sorting the remaining range if the
+  partitioning degenerates; i.e. the introselect algorithm used by
+  std::nth_element().
+
+  After a call to statistics_select__() with index k, all elements
+  before position k are <= data[k] and all elements after k are >=
+  data[k]; this is exploited when several quantiles are evaluated
+  in ascending order.
+*/
+
+static int statistics_double_cmp( const void * arg1 , const void * arg2 ) {
+  double d1 = *((const double *) arg1);
+  double d2 = *((const double *) arg2);
+
+  if (d1 < d2)
+    return -1;
+  else if (d1 > d2)
+    return 1;
+  else
+    return 0;
+}
+
+
+static double statistics_select__( double * data , int left , int right , int k ) {
+  int depth_limit = 0;
+  {
+    int length = right - left + 1;
+    while (length > 0) {
+      depth_limit += 2;
+      length /= 2;
+    }
+  }
+
+  while (right > left) {
+    if (depth_limit == 0) {
+      qsort( &data[left] , right - left + 1 , sizeof * data , statistics_double_cmp );
+      return data[k];
+    }
+    depth_limit--;
+
+    {
+      double pivot;
+      {
+        /* Median of three pivot. */
+        double a = data[left];
+        double b = data[ left + (right - left) / 2 ];
+        double c = data[right];
+
+        if (a < b) {
+          if (b < c)
+            pivot = b;
+          else if (a < c)
+            pivot = c;
+          else
+            pivot = a;
+        } else {
+          if (a < c)
+            pivot = a;
+          else if (b < c)
+            pivot = c;
+          else
+            pivot = b;
+        }
+      }
+
+      {
+        /*
+          Three way partitioning:
+
+            [left , lt)   < pivot
+            [lt , gt]    == pivot
+            (gt , right]  > pivot
+        */
+        int lt = left;
+        int gt = right;
+        int i  = left;
+
+        while (i <= gt) {
+          double value = data[i];
+          if (value < pivot) {
+            data[i] = data[lt];
+            data[lt] = value;
+            lt++;
+            i++;
+          } else if (value > pivot) {
+            data[i] = data[gt];
+            data[gt] = value;
+            gt--;
+          } else
+            i++;
+        }
+
+        if (k < lt)
+          right = lt - 1;
+        else if (k > gt)
+          left = gt + 1;
+        else
+          return pivot;
+      }
+    }
+  }
+  return data[k];
+}
+
+
+/**
+   Will calculate all the quantiles in the @quantiles vector and store
+   the result in the corresponding elements of the @result vector. The
+   result is identical to calling statistics_empirical_quantile() for
+   each quantile in turn, but the total cost is O(n) for a small set of
+   quantiles instead of the O(n log n) required for a full sort.
+
+   Observe that the data vector is reordered in place; but in contrast
+   to statistics_empirical_quantile() it is in general *not* sorted on
+   return.
+*/
+
+void statistics_empirical_quantiles( double_vector_type * data_vector , const double_vector_type * quantiles , double_vector_type * result) {
+  const int num_quantiles = double_vector_size( quantiles );
+  const int size = double_vector_size( data_vector ) - 1;
+  double * data = double_vector_get_ptr( data_vector );
+
+  if (size < 0)
+    util_abort("%s: can not calculate quantiles of empty vector\n",__func__);
+
+  double_vector_resize( result , num_quantiles );
+  for (int iq = 0; iq < num_quantiles; iq++) {
+    double quantile = double_vector_iget( quantiles , iq );
+    if ((quantile < 0) || (quantile > 1.0))
+      util_abort("%s: quantile must be in [0,1] \n",__func__);
+  }
+
+  {
+    double min_value = data[0];
+    double max_value = data[0];
+    for (int i=1; i <= size; i++) {
+      if (data[i] < min_value)
+        min_value = data[i];
+      if (data[i] > max_value)
+        max_value = data[i];
+    }
+
+    if (min_value == max_value) {
+      /* All elements are equal - see statistics_empirical_quantile__(). */
+      double_vector_set_all( result , min_value );
+      return;
+    }
+  }
+
+  {
+    perm_vector_type * sort_perm = double_vector_alloc_sort_perm( quantiles );
+    int left = 0;
+
+    for (int iq = 0; iq < num_quantiles; iq++) {
+      const int result_index = perm_vector_iget( sort_perm , iq );
+      const double quantile = double_vector_iget( quantiles , result_index );
+      const double real_index = quantile * size;
+      int lower_index = floor( real_index );
+      int upper_index = ceil( real_index );
+      double lower_value = statistics_select__( data , left , size , lower_index );
+      double upper_value;
+
+      left = lower_index;
+      if (upper_index == lower_index)
+        upper_value = lower_value;
+      else {
+        /* data[lower_index + 1 , size] >= lower_value: the next order statistic is the minimum. */
+        upper_value = data[upper_index];
+        for (int i = upper_index + 1; i <= size; i++)
+          if (data[i] < upper_value)
+            upper_value = data[i];
+      }
+
+      if (upper_value == lower_value) {
+        /*
+          Reproduce the index shifting of
+          statistics_empirical_quantile__() by counting the extent
+          [run_start , run_end] of the run of equal values in the sorted
+          order, and then select the values at the final indices.
+        */
+        const double value = lower_value;
+        int run_start = 0;
+        int run_end = -1;
+
+        for (int i=0; i <= size; i++) {
+          if (data[i] < value)
+            run_start++;
+          if (data[i] <= value)
+            run_end++;
+        }
+
+        while (true) {
+          upper_index = util_int_min( size , upper_index + 1);
+          if (upper_index > run_end)
+            break;
+
+          lower_index = util_int_max( 0 , lower_index - 1);
+          if (lower_index < run_start)
+            break;
+        }
+
+        upper_value = (upper_index > run_end)   ? statistics_select__( data , 0 , size , upper_index ) : value;
+        lower_value = (lower_index < run_start) ? statistics_select__( data , 0 , size , lower_index ) : value;
+        left = 0;
+      }
+
+      {
+        double upper_quantile = upper_index * 1.0 / size;
+        double lower_quantile = lower_index * 1.0 / size;
+        double a = (upper_value - lower_value) / (upper_quantile - lower_quantile);
+
+        double_vector_iset( result , result_index , lower_value + a*(quantile - lower_quantile));
+      }
+    }
+    perm_vector_free( sort_perm );
+  }
+}
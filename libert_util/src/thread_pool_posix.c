@@ -16,13 +16,13 @@
    for more details.
 */
 
-#define  _GNU_SOURCE   /* Must define this to get access to pthread_rwlock_t */
+#define  _GNU_SOURCE
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
-#include <signal.h>
+#include <errno.h>
 #include <pthread.h>
-#include <unistd.h>
+#include <sys/time.h>
 
 #include "ert/util/build_config.h"
 
@@ -32,15 +32,22 @@
 
 
 /**
-   This file implements a small thread_pool object based on
-   pthread_create() function calls. The characetristics of this
+   This file implements a small thread_pool object based on a fixed
+   set of long lived worker threads. The characetristics of this
    implementation is as follows:
 
-    1. The jobs are mangaged by a separate thread - dispatch_thread.
-    2. The new jobs are just appended to the queue, the
-       dispatch_thread sees them in the queue and dispatches them.
-    3. The dispatch thread manages a list of thread_pool_job_slot_type
-       instances - one slot for each actually running job.
+    1. The worker threads are created the first time the pool is
+       started, and live until the pool is freed; i.e. they are reused
+       across thread_pool_join() / thread_pool_restart() cycles.
+    2. The new jobs are appended to the queue, and an idle worker is
+       woken up with a condition variable. The workers pick jobs from
+       the queue in FIFO order.
+    3. When a job completes the worker immediately picks the next job
+       from the queue; thread_pool_join() waits on a condition variable
+       until all the jobs in the queue have completed.
+
+   I.e. there is no dispatch thread, no pthread_create() per job and no
+   polling with sleep - this matters when the individual jobs are small.
 
    Example
    -------
@@ -90,6 +97,13 @@
 
   6. When you are really finished: thread_pool_free( tp );
 
+
+   For loops over an index range there is a convenience function
+   thread_pool_parallel_for(), which will call a function for all
+   indices in [begin,end) and return when all have completed:
+
+         thread_pool_parallel_for( tp , 0 , ens_size , some_index_function , arg );
+
 */
 
 
@@ -100,9 +114,6 @@ typedef void * (start_func_ftype) (void *) ;
    Internal struct which is used as queue node.
 */
 typedef struct {
-  thread_pool_type * pool;                /* A back-reference to the thread_pool holding the queue. */
-  int                slot_index;          /* The index in the space [0,max_running) of the job slot where this job is running. */
-  int                queue_index;         /* The index of the current tp_arg in the queue. */
   void             * func_arg;            /* The arguments to this job - supplied by the calling scope. */
   start_func_ftype * func;                /* The function to call - supplied by the calling scope. */
   void             * return_value;
@@ -110,33 +121,24 @@ typedef struct {
 
 
 
-/**
-   Internal struct used to keep track of the job slots.
-*/
-typedef struct {
-  pthread_t  thread;                /* The thread variable currently (or more correct:last) running. */
-  int        run_count;             /* The number of times this slot has been used - just to check whether the slot has been used AT ALL when/if joining. */
-  bool       running;               /* Is the job_slot running now?? */
-} thread_pool_job_slot_type;
-
-
-
-
 #define THREAD_POOL_TYPE_ID 71443207
 struct thread_pool_struct {
   UTIL_TYPE_ID_DECLARATION;
   thread_pool_arg_type      * queue;              /* The jobs to be executed are appended in this vector. */
   int                         queue_index;        /* The index of the next job to run. */
-  int                         queue_size;         /* The number of jobs in the queue - including those which are complete. [Should be protected / atomic / ... ] */
+  int                         queue_size;         /* The number of jobs in the queue - including those which are complete. */
   int                         queue_alloc_size;   /* The allocated size of the queue. */
+  int                         complete_count;     /* The number of jobs which have completed. */
 
-  int                         max_running;        /* The max number of concurrently running jobs. */
-  bool                        join;               /* Flag set by the main thread to inform the dispatch thread that joining should start. */
-  bool                        accepting_jobs;     /* True|False whether the dispatch thread is running. */
+  int                         max_running;        /* The number of worker threads. */
+  int                         idle_workers;       /* The number of workers currently waiting for a job. */
+  bool                        accepting_jobs;     /* True|False whether the pool has been started and not yet joined. */
+  bool                        shutdown;           /* Set by thread_pool_free() to make the workers exit. */
 
-  thread_pool_job_slot_type * job_slots;          /* A vector to @max_running job slots, each slot can be reused several times.*/
-  pthread_t                   dispatch_thread;
-  pthread_rwlock_t            queue_lock;
+  pthread_t                 * workers;            /* The @max_running worker threads - NULL until the pool is first started. */
+  pthread_mutex_t             queue_mutex;        /* Protects all the fields above, except the workers. */
+  pthread_cond_t              job_available;      /* Signalled when a job is added or when shutdown is requested. */
+  pthread_cond_t              job_complete;       /* Broadcast when a job completes. */
 };
 
 
@@ -144,37 +146,13 @@ static UTIL_SAFE_CAST_FUNCTION( thread_pool , THREAD_POOL_TYPE_ID )
 
 
 /**
-   This function will grow the queue. It is called by the main thread
-   (i.e. the context of the calling scope), and the queue is read by
-   the dispatch_thread - i.e. access to the queue must be protected by
-   rwlock.
+   The queue is grown by the thread adding jobs, while the workers read
+   from it; i.e. this must be called with the queue_mutex held.
 */
 
 static void thread_pool_resize_queue( thread_pool_type * pool, int queue_length ) {
-  pthread_rwlock_wrlock( &pool->queue_lock );
-  {
-    pool->queue            = util_realloc( pool->queue , queue_length * sizeof * pool->queue );
-    pool->queue_alloc_size = queue_length;
-  }
-  pthread_rwlock_unlock( &pool->queue_lock );
-}
-
-
-/**
-   This function updates an element in the queue, the function is
-   called by the executing threads, on the same time the main thread
-   might be resizing the thread, we therefor take a read lock during
-   execution of this function. (Write lock is not necessary because we
-   will not change the queue pointer itself, only something it points
-   to.)
-*/
-
-static void thread_pool_iset_return_value( thread_pool_type * pool , int index , void * return_value) {
-  pthread_rwlock_rdlock( &pool->queue_lock );
-  {
-    pool->queue[ index ].return_value = return_value;
-  }
-  pthread_rwlock_unlock( &pool->queue_lock );
+  pool->queue            = util_realloc( pool->queue , queue_length * sizeof * pool->queue );
+  pool->queue_alloc_size = queue_length;
 }
 
 
@@ -184,131 +162,77 @@ void * thread_pool_iget_return_value( const thread_pool_type * pool , int queue_
 
 
 /**
-   The pthread_create() call which this is all about, does not start
-   the user supplied function. Instead it will start an instance of
-   this function, which will do some housekeeping before calling the
-   user supplied function.
+   This function is run by all the worker threads. The worker will
+   pick the next job from the queue, run it with the lock released and
+   then go back for more; when the queue is empty it will wait for the
+   job_available condition.
 */
 
-static void * thread_pool_start_job( void * arg ) {
-  thread_pool_arg_type * tp_arg = (thread_pool_arg_type * ) arg;
-  thread_pool_type * tp         =  tp_arg->pool;
-  int slot_index                =  tp_arg->slot_index;
-  void * func_arg               =  tp_arg->func_arg;
-  start_func_ftype * func       =  tp_arg->func;
-  void * return_value;
+static void * thread_pool_worker( void * arg ) {
+  thread_pool_type * tp = thread_pool_safe_cast( arg );
+
+  pthread_mutex_lock( &tp->queue_mutex );
+  while (true) {
+    if (tp->queue_index < tp->queue_size) {
+      int queue_index          = tp->queue_index;
+      start_func_ftype * func  = tp->queue[ queue_index ].func;
+      void * func_arg          = tp->queue[ queue_index ].func_arg;
+      void * return_value;
 
+      tp->queue_index++;
+      pthread_mutex_unlock( &tp->queue_mutex );
+      {
+        return_value = func( func_arg );            /* Starting the real external function */
+      }
+      pthread_mutex_lock( &tp->queue_mutex );
 
-  return_value = func( func_arg );                  /* Starting the real external function */
-  tp->job_slots[ slot_index ].running = false;      /* We mark the job as completed. */
-  free( arg );
+      tp->queue[ queue_index ].return_value = return_value;
+      tp->complete_count++;
+      pthread_cond_broadcast( &tp->job_complete );
+    } else {
+      if (tp->shutdown)
+        break;
 
-  if (return_value != NULL)
-    thread_pool_iset_return_value( tp , tp_arg->queue_index , return_value);
+      tp->idle_workers++;
+      pthread_cond_wait( &tp->job_available , &tp->queue_mutex );
+      tp->idle_workers--;
+    }
+  }
+  pthread_mutex_unlock( &tp->queue_mutex );
 
   return NULL;
 }
 
 
+static void thread_pool_start_workers( thread_pool_type * tp ) {
+  tp->workers = util_calloc( tp->max_running , sizeof * tp->workers );
+  for (int i=0; i < tp->max_running; i++) {
+    if (pthread_create( &tp->workers[i] , NULL , thread_pool_worker , tp ) != 0)
+      util_abort("%s: failed to create worker thread: %s \n",__func__ , strerror( errno ));
+  }
+}
 
-/**
-   This function is run by the dispatch_thread. The thread will keep
-   an eye on the queue, and dispatch new jobs when there are free
-   slots available.
-*/
 
-static void * thread_pool_main_loop( void * arg ) {
-  thread_pool_type * tp = thread_pool_safe_cast( arg );
-  {
-    const int usleep_init = 1000;  /* The sleep time when there are free slots available - but no jobs wanting to run. */
-    int internal_offset   = 0;     /* Keep track of the (index of) the last job slot fired off - minor time saving. */
-    while (true) {
-      if (tp->queue_size > tp->queue_index) {
-        /*
-           There are jobs in the queue which would like to run -
-           let us see if we can find a slot for them.
-        */
-        int counter     = 0;
-        bool slot_found = false;
-        do {
-          int slot_index = (counter + internal_offset) % tp->max_running;
-          thread_pool_job_slot_type * job_slot = &tp->job_slots[ slot_index ];
-          if (!job_slot->running) {
-            /* OK thread[slot_index] is ready to take this job.*/
-            thread_pool_arg_type * tp_arg;
-
-            /*
-               The queue might be updated by the main thread - we must
-               take a copy of the node we are interested in.
-            */
-            pthread_rwlock_rdlock( &tp->queue_lock );
-            tp_arg = util_alloc_copy( &tp->queue[ tp->queue_index ] , sizeof * tp_arg );
-            pthread_rwlock_unlock( &tp->queue_lock );
-
-            tp_arg->slot_index = slot_index;
-            job_slot->running = true;
-            /*
-               Here is the actual pthread_create() call creating an
-               additional running thread.
-            */
-
-            /*Cleanup of previous run threads. Needed to avoid memory leak*/
-            if (job_slot->run_count > 0)
-              pthread_join(job_slot->thread, NULL);
-
-            pthread_create( &job_slot->thread , NULL , thread_pool_start_job , tp_arg );
-            job_slot->run_count += 1;
-            tp->queue_index++;
-            internal_offset += (counter + 1);
-            slot_found = true;
-          } else
-            counter++;
-        } while (!slot_found && (counter < tp->max_running));
-
-        if (!slot_found) {
-            util_yield();
-        }
-      } else
-        util_usleep(usleep_init);    /* There are no jobs wanting to run. */
-
-      /*****************************************************************/
-      /*
-        We exit explicitly from this loop when both conditions apply:
-
-         1. tp->join       == true              :  The calling scope has signaled that it will not submit more jobs.
-         2. tp->queue_size == tp->queue_index   :  This function has submitted all the jobs in the queue.
-      */
-      if ((tp->join) && (tp->queue_size == tp->queue_index))
-        break;
-    } /* End of while() loop */
-  }
+static void thread_pool_stop_workers( thread_pool_type * tp ) {
+  pthread_mutex_lock( &tp->queue_mutex );
+  tp->shutdown = true;
+  pthread_cond_broadcast( &tp->job_available );
+  pthread_mutex_unlock( &tp->queue_mutex );
 
-  /*
-     There are no more jobs in the queue, and the main scope has
-     signaled that join should start. Observe that we join only the
-     jobs corresponding to explicitly running job_slots; when a job
-     slot is used multiple times the first jobs run in the job_slot
-     will not be explicitly joined.
-  */
-  {
-    int i;
-    for (i=0; i < tp->max_running; i++) {
-      thread_pool_job_slot_type job_slot = tp->job_slots[i];
-      if (job_slot.run_count > 0)
-        pthread_join( job_slot.thread , NULL );
-    }
-  }
-  /* When we are here all the jobs have completed. */
-  return NULL;
-}
+  for (int i=0; i < tp->max_running; i++)
+    pthread_join( tp->workers[i] , NULL );
 
+  free( tp->workers );
+  tp->workers = NULL;
+}
 
 
 
 /**
-   This function initializes a couple of counters, and starts up the
-   dispatch thread. If the thread_pool should be reused after a join,
-   this function must be called before adding new jobs.
+   This function initializes a couple of counters, and starts the
+   worker threads the first time it is called. If the thread_pool
+   should be reused after a join, this function must be called before
+   adding new jobs.
 
    The functions thread_pool_restart() and thread_pool_join() should
    be joined up like open/close and malloc/free combinations.
@@ -317,98 +241,69 @@ static void * thread_pool_main_loop( void * arg ) {
 void thread_pool_restart( thread_pool_type * tp ) {
   if (tp->accepting_jobs)
     util_abort("%s: fatal error - tried restart already running thread pool\n",__func__);
+
+  pthread_mutex_lock( &tp->queue_mutex );
   {
-    tp->join           = false;
     tp->queue_index    = 0;
     tp->queue_size     = 0;
-    {
-      int i;
-      for (i=0; i < tp->max_running; i++) {
-        tp->job_slots[i].run_count = 0;
-        tp->job_slots[i].running   = false;
-      }
-    }
-
-    /* Starting the dispatch thread. */
-    pthread_create( &tp->dispatch_thread , NULL , thread_pool_main_loop , tp );
+    tp->complete_count = 0;
     tp->accepting_jobs = true;
   }
+  pthread_mutex_unlock( &tp->queue_mutex );
+
+  if ((tp->max_running > 0) && (tp->workers == NULL))
+    thread_pool_start_workers( tp );
 }
 
 
 
 /**
    This function is called by the calling scope when all the jobs have
-   been submitted, and we just wait for them to complete.
-
-   This function just sets the join switch to true - this again tells
-   the dispatch_thread to start the join process on the worker
-   threads.
+   been submitted, and we just wait for them to complete. The worker
+   threads are not stopped; they will wait for new jobs after a
+   thread_pool_restart().
 */
 
 void thread_pool_join(thread_pool_type * pool) {
-  pool->join = true;                               /* Signals to the main thread that joining can start. */
-  if (pool->max_running > 0) {
-    pthread_join( pool->dispatch_thread , NULL );  /* Wait for the main thread to complete. */
+  pthread_mutex_lock( &pool->queue_mutex );
+  {
+    while (pool->complete_count < pool->queue_size)
+      pthread_cond_wait( &pool->job_complete , &pool->queue_mutex );
     pool->accepting_jobs = false;
   }
+  pthread_mutex_unlock( &pool->queue_mutex );
 }
 
 /*
-  This will try to join the thread; if the manager thread has not
-  completed within @timeout_seconds the function will return false. If
-  the join fails the queue will be reset in a non-joining state and it
-  will be open for more jobs. Probably not in a 100% sane state.
+  This will try to join the pool; if the jobs have not completed
+  within @timeout_seconds the function will return false. If the join
+  fails the pool is left in a non-joined state and it will be open for
+  more jobs.
 */
 
 bool thread_pool_try_join(thread_pool_type * pool, int timeout_seconds) {
   bool join_ok = true;
+  struct timespec ts;
+  {
+    struct timeval now;
+    gettimeofday( &now , NULL );
+    ts.tv_sec  = now.tv_sec + timeout_seconds;
+    ts.tv_nsec = now.tv_usec * 1000;
+  }
 
-  pool->join = true;                               /* Signals to the main thread that joining can start. */
-  if (pool->max_running > 0) {
-    struct timespec ts;
-    time_t timeout_time = time( NULL );
-
-    util_inplace_forward_seconds_utc(&timeout_time , timeout_seconds );
-    ts.tv_sec = timeout_time;
-    ts.tv_nsec = 0;
-
-#ifdef HAVE_TIMEDJOIN
-
-    {
-      int join_return = pthread_timedjoin_np( pool->dispatch_thread , NULL , &ts);  /* Wait for the main thread to complete. */
-      if (join_return == 0)
-        pool->accepting_jobs = false;
-      else {
-        pool->join = false;
-        join_ok = false;
+  pthread_mutex_lock( &pool->queue_mutex );
+  {
+    while (pool->complete_count < pool->queue_size) {
+      if (pthread_cond_timedwait( &pool->job_complete , &pool->queue_mutex , &ts ) == ETIMEDOUT) {
+        join_ok = (pool->complete_count == pool->queue_size);
+        break;
       }
     }
-
-#else
-
-    while(true) {
-        if (pthread_kill(pool->dispatch_thread, 0) == 0){
-            util_yield();
-        } else {
-            pthread_join(pool->dispatch_thread, NULL);
-            pool->accepting_jobs = false;
-            break;
-        }
-
-        time_t now = time(NULL);
-
-        if(util_difftime_seconds(now, timeout_time) <= 0) {
-            join_ok = false;
-            break;
-        }
-    }
-
-#endif
-
-
-
+    if (join_ok)
+      pool->accepting_jobs = false;
   }
+  pthread_mutex_unlock( &pool->queue_mutex );
+
   return join_ok;
 }
 
@@ -417,7 +312,7 @@ bool thread_pool_try_join(thread_pool_type * pool, int timeout_seconds) {
 
 /**
    max_running is the maximum number of concurrent threads. If
-   @start_queue is true the dispatch thread will start immediately. If
+   @start_queue is true the worker threads will start immediately. If
    the function is called with @start_queue == false you must first
    call thread_pool_restart() BEFORE you can start adding jobs.
 */
@@ -425,11 +320,18 @@ bool thread_pool_try_join(thread_pool_type * pool, int timeout_seconds) {
 thread_pool_type * thread_pool_alloc(int max_running , bool start_queue) {
   thread_pool_type * pool = util_malloc( sizeof *pool );
   UTIL_TYPE_ID_INIT( pool , THREAD_POOL_TYPE_ID );
-  pool->job_slots         = util_calloc( max_running , sizeof * pool->job_slots );
   pool->max_running       = max_running;
   pool->queue             = NULL;
+  pool->queue_index       = 0;
+  pool->queue_size        = 0;
+  pool->complete_count    = 0;
+  pool->idle_workers      = 0;
   pool->accepting_jobs    = false;
-  pthread_rwlock_init( &pool->queue_lock , NULL);
+  pool->shutdown          = false;
+  pool->workers           = NULL;
+  pthread_mutex_init( &pool->queue_mutex , NULL );
+  pthread_cond_init( &pool->job_available , NULL );
+  pthread_cond_init( &pool->job_complete , NULL );
   thread_pool_resize_queue( pool  , 32 );
   if (start_queue)
     thread_pool_restart( pool );
@@ -443,39 +345,126 @@ void thread_pool_add_job(thread_pool_type * pool , start_func_ftype * start_func
     start_func( func_arg );
   else {
     if (pool->accepting_jobs) {
-      if (pool->queue_size == pool->queue_alloc_size)
-        thread_pool_resize_queue( pool , pool->queue_alloc_size * 2);
-
-      /*
-         The new job is added to the queue - the main thread is watching
-         the queue and will pick up the new job.
-      */
+      pthread_mutex_lock( &pool->queue_mutex );
       {
         int queue_index = pool->queue_size;
 
-        pool->queue[ queue_index ].pool         = pool;
+        if (pool->queue_size == pool->queue_alloc_size)
+          thread_pool_resize_queue( pool , pool->queue_alloc_size * 2);
+
         pool->queue[ queue_index ].func_arg     = func_arg;
         pool->queue[ queue_index ].func         = start_func;
         pool->queue[ queue_index ].return_value = NULL;
-        pool->queue[ queue_index ].queue_index = queue_index;
+        pool->queue_size++;
+
+        /* Only wake a worker if one is actually waiting. */
+        if (pool->idle_workers > 0)
+          pthread_cond_signal( &pool->job_available );
       }
-      pool->queue_size++;  /* <- This is shared between this thread and the dispatch thread */
+      pthread_mutex_unlock( &pool->queue_mutex );
     } else
       util_abort("%s: thread_pool is not running - restart with thread_pool_restart()?? \n",__func__);
   }
 }
 
 
+/*****************************************************************/
+
+/**
+   Shared state for one thread_pool_parallel_for() call. The index
+   range is handed out to the jobs in chunks from the @next counter,
+   i.e. the load is balanced dynamically between the workers.
+*/
+
+typedef struct {
+  thread_pool_type          * pool;
+  thread_pool_index_ftype   * func;
+  void                      * arg;
+  int                         next;
+  int                         end;
+  int                         chunk_size;
+  int                         running_jobs;
+} thread_pool_range_type;
+
+
+static void * thread_pool_range_job( void * arg ) {
+  thread_pool_range_type * range = (thread_pool_range_type *) arg;
+  thread_pool_type * pool = range->pool;
+
+  pthread_mutex_lock( &pool->queue_mutex );
+  while (range->next < range->end) {
+    int chunk_start = range->next;
+    int chunk_end   = util_int_min( range->end , chunk_start + range->chunk_size );
+
+    range->next = chunk_end;
+    pthread_mutex_unlock( &pool->queue_mutex );
+    {
+      for (int index = chunk_start; index < chunk_end; index++)
+        range->func( index , range->arg );
+    }
+    pthread_mutex_lock( &pool->queue_mutex );
+  }
+  range->running_jobs--;
+  pthread_mutex_unlock( &pool->queue_mutex );
+
+  return NULL;
+}
+
+
+/**
+   Will call @func( index , @arg ) for all index values in the range
+   [begin,end), using the worker threads of the pool, and return when
+   all the calls have completed. The pool must be running,
+   i.e. started and not joined; the function only waits for its own
+   calls, other jobs in the pool are not affected.
+
+   Observe that this function must not be called from a job running in
+   the same pool.
+*/
+
+void thread_pool_parallel_for( thread_pool_type * pool , int begin , int end , thread_pool_index_ftype * func , void * arg) {
+  if (pool->max_running == 0) {
+    for (int index = begin; index < end; index++)
+      func( index , arg );
+  } else if (end > begin) {
+    thread_pool_range_type range;
+    int num_jobs = util_int_min( pool->max_running , end - begin );
+
+    range.pool         = pool;
+    range.func         = func;
+    range.arg          = arg;
+    range.next         = begin;
+    range.end          = end;
+    range.chunk_size   = util_int_max( 1 , (end - begin) / (4 * pool->max_running));
+    range.running_jobs = num_jobs;
+
+    for (int i=0; i < num_jobs; i++)
+      thread_pool_add_job( pool , thread_pool_range_job , &range );
+
+    pthread_mutex_lock( &pool->queue_mutex );
+    while (range.running_jobs > 0)
+      pthread_cond_wait( &pool->job_complete , &pool->queue_mutex );
+    pthread_mutex_unlock( &pool->queue_mutex );
+  }
+}
+
 
 /*
-  Observe that this function does not join the worker threads,
-  i.e. you should call thread_pool_join() first (otherwise the thing
-  will go up in flames).
+  If the pool has not been joined, this function will first wait for
+  all the queued jobs to complete; then the worker threads are stopped.
 */
 
 
 void thread_pool_free(thread_pool_type * pool) {
-  util_safe_free( pool->job_slots );
+  if (pool->accepting_jobs)
+    thread_pool_join( pool );
+
+  if (pool->workers)
+    thread_pool_stop_workers( pool );
+
+  pthread_cond_destroy( &pool->job_available );
+  pthread_cond_destroy( &pool->job_complete );
+  pthread_mutex_destroy( &pool->queue_mutex );
   util_safe_free( pool->queue );
   free(pool);
 }
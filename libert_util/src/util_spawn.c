@@ -1,5 +1,6 @@
 #include <spawn.h>
 #include <pthread.h>
+#include <poll.h>
 extern char **environ;
 
 
@@ -42,13 +43,7 @@ static void __init_redirection(posix_spawn_file_actions_t * file_actions, const
 */
 static pthread_mutex_t spawn_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-/*
-  The util_spawn function will start a new process running
-  @executable. The pid of the new process will be
-  returned. Alternatively the util_spawn_blocking() function will
-  block until the newlye created process has completed.
-*/
-pid_t util_spawn(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file) {
+static pid_t util_spawn_file_actions__(const char *executable, int argc, const char **argv, const posix_spawn_file_actions_t * file_actions, bool process_group) {
   pid_t pid;
   char **__argv = util_malloc((argc + 2) * sizeof *__argv);
 
@@ -61,29 +56,84 @@ pid_t util_spawn(const char *executable, int argc, const char **argv, const char
   }
 
   {
-      posix_spawn_file_actions_t file_actions;
-      __init_redirection(&file_actions , stdout_file , stderr_file);
-
-      pthread_mutex_lock( &spawn_mutex );
-      {
-        int spawn_status;
-        if (util_is_executable(executable)) { // the executable is in current directory or an absolute path
-          spawn_status = posix_spawn(&pid, executable, &file_actions, NULL, __argv, environ);
-        } else { // Try to find executable in path
-          spawn_status = posix_spawnp(&pid, executable, &file_actions, NULL, __argv, environ);
+      posix_spawnattr_t spawn_attr;
+
+      posix_spawnattr_init(&spawn_attr);
+      if (process_group) {
+        posix_spawnattr_setflags(&spawn_attr, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&spawn_attr, 0);
+      }
+
+      int spawn_status;
+      int attempt = 0;
+
+      while (true) {
+        pthread_mutex_lock( &spawn_mutex );
+        {
+          if (util_is_executable(executable)) { // the executable is in current directory or an absolute path
+            spawn_status = posix_spawn(&pid, executable, file_actions, &spawn_attr, __argv, environ);
+          } else { // Try to find executable in path
+            spawn_status = posix_spawnp(&pid, executable, file_actions, &spawn_attr, __argv, environ);
+          }
         }
+        pthread_mutex_unlock( &spawn_mutex );
 
-        if (spawn_status != 0)
-          util_abort("%s: failed to spawn external command: \'%s\': %s \n", __func__, executable, strerror(spawn_status));
+        /*
+          If the executable has just been written by another thread, a
+          child spawned concurrently might still hold an open file
+          descriptor to it, and the exec fails with ETXTBSY. That is
+          transient, so we retry a few times.
+        */
+        if ((spawn_status == ETXTBSY) && (attempt < 10)) {
+          attempt++;
+          util_usleep( 10000 );
+        } else
+          break;
       }
-      pthread_mutex_unlock( &spawn_mutex );
-      posix_spawn_file_actions_destroy(&file_actions);
+      posix_spawnattr_destroy(&spawn_attr);
+
+      /* Must not abort while holding the spawn_mutex; util_abort() uses util_spawn() to create the backtrace. */
+      if (spawn_status != 0)
+        util_abort("%s: failed to spawn external command: \'%s\': %s \n", __func__, executable, strerror(spawn_status));
   }
 
   free(__argv);
   return pid;
 }
 
+
+static pid_t util_spawn__(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file, bool process_group) {
+  pid_t pid;
+  posix_spawn_file_actions_t file_actions;
+
+  __init_redirection(&file_actions , stdout_file , stderr_file);
+  pid = util_spawn_file_actions__(executable, argc, argv, &file_actions, process_group);
+  posix_spawn_file_actions_destroy(&file_actions);
+
+  return pid;
+}
+
+
+/*
+  The util_spawn function will start a new process running
+  @executable. The pid of the new process will be
+  returned. Alternatively the util_spawn_blocking() function will
+  block until the newlye created process has completed.
+*/
+pid_t util_spawn(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file) {
+  return util_spawn__(executable, argc, argv, stdout_file, stderr_file, false);
+}
+
+
+/*
+  As util_spawn(), but the new process is made leader of a new
+  process group; i.e. the process and all its descendants can be
+  signalled with kill(-pid , signal).
+*/
+pid_t util_spawn_process_group(const char *executable, int argc, const char **argv, const char *stdout_file, const char *stderr_file) {
+  return util_spawn__(executable, argc, argv, stdout_file, stderr_file, true);
+}
+
 /*
   Will spawn a new process and wait for its completion. The exit
   status of the new process is returned, observe that exit status 127
@@ -98,6 +148,223 @@ int util_spawn_blocking(const char *executable, int argc, const char **argv, con
 }
 
 
+/*****************************************************************/
+
+typedef struct {
+  int    fd;
+  char * data;
+  size_t size;
+  size_t alloc_size;
+} spawn_capture_type;
+
+
+/*
+  The pipes are marked close-on-exec, so that processes spawned
+  concurrently by other threads do not inherit the write end; that
+  would keep the pipe open until the other process had exited. With
+  pipe2() the flag is set atomically when the pipe is created;
+  otherwise the pipe is created with the spawn_mutex held, which only
+  protects against the util_spawn functions in other threads.
+*/
+
+static void util_spawn_capture_pipe__(int * pipe_fd) {
+  int status;
+#ifdef HAVE_PIPE2
+  status = pipe2( pipe_fd , O_CLOEXEC );
+#else
+  pthread_mutex_lock( &spawn_mutex );
+  status = pipe( pipe_fd );
+  if (status == 0) {
+    fcntl( pipe_fd[0] , F_SETFD , FD_CLOEXEC );
+    fcntl( pipe_fd[1] , F_SETFD , FD_CLOEXEC );
+  }
+  pthread_mutex_unlock( &spawn_mutex );
+#endif
+
+  if (status != 0)
+    util_abort("%s: failed to create pipe: %s \n",__func__ , strerror( errno ));
+}
+
+
+/*
+  Reads what is available from the pipe; returns false when the write
+  end of the pipe has been closed.
+*/
+
+static bool util_spawn_capture_read__(spawn_capture_type * capture) {
+  if (capture->size + 4096 >= capture->alloc_size) {
+    capture->alloc_size = 2 * capture->alloc_size + 4096;
+    capture->data = util_realloc( capture->data , capture->alloc_size );
+  }
+
+  {
+    ssize_t bytes_read = read( capture->fd , &capture->data[capture->size] , capture->alloc_size - capture->size - 1);
+    if (bytes_read > 0) {
+      capture->size += bytes_read;
+      return true;
+    } else if ((bytes_read < 0) && (errno == EINTR || errno == EAGAIN))
+      return true;
+    else
+      return false;
+  }
+}
+
+
+static double util_spawn_capture_elapsed_ms(const struct timespec * start) {
+  struct timespec now;
+  clock_gettime( CLOCK_MONOTONIC , &now );
+  return 1000.0 * (now.tv_sec - start->tv_sec) + 1e-6 * (now.tv_nsec - start->tv_nsec);
+}
+
+
+/*
+  Will spawn a new process and wait for its completion like
+  util_spawn_blocking(), but the stdout and stderr of the process are
+  captured through pipes and returned as newly allocated \0 terminated
+  strings in *stdout_buffer and *stderr_buffer; the caller must free
+  them. No temporary files are involved.
+
+   o If stdout_buffer or stderr_buffer is NULL, the corresponding
+     stream is not captured, but goes to wherever the parent process
+     is sending it.
+
+   o If stdout_buffer == stderr_buffer both streams are captured,
+     interleaved, in *stdout_buffer.
+
+   o If timeout_ms > 0 the process is killed with SIGKILL if it has
+     not completed within timeout_ms milliseconds; the returned wait
+     status will then satisfy WIFSIGNALED(). The output captured
+     before the timeout is returned.
+
+  The return value is the wait status of the process, as for
+  util_spawn_blocking().
+*/
+
+int util_spawn_capture(const char *executable, int argc, const char **argv, char ** stdout_buffer, char ** stderr_buffer, int timeout_ms) {
+  bool merge_output = (stdout_buffer != NULL) && (stdout_buffer == stderr_buffer);
+  spawn_capture_type capture[2];
+  int num_capture = 0;
+  int stdout_pipe[2] = {-1 , -1};
+  int stderr_pipe[2] = {-1 , -1};
+  int status;
+  pid_t pid;
+
+  {
+    posix_spawn_file_actions_t file_actions;
+    int action_status = posix_spawn_file_actions_init(&file_actions);
+
+    action_status += posix_spawn_file_actions_addclose(&file_actions, 0);
+    if (stdout_buffer) {
+      util_spawn_capture_pipe__( stdout_pipe );
+      action_status += posix_spawn_file_actions_adddup2(&file_actions, stdout_pipe[1], 1);
+      if (merge_output)
+        action_status += posix_spawn_file_actions_adddup2(&file_actions, stdout_pipe[1], 2);
+    }
+
+    if (stderr_buffer && !merge_output) {
+      util_spawn_capture_pipe__( stderr_pipe );
+      action_status += posix_spawn_file_actions_adddup2(&file_actions, stderr_pipe[1], 2);
+    }
+
+    if (action_status != 0)
+      util_abort("%s: something failed while setting up the output pipes \n",__func__);
+
+    pid = util_spawn_file_actions__(executable, argc, argv, &file_actions, false);
+    posix_spawn_file_actions_destroy(&file_actions);
+  }
+
+  if (stdout_pipe[1] >= 0) {
+    close( stdout_pipe[1] );
+    capture[num_capture] = (spawn_capture_type) {.fd = stdout_pipe[0] , .data = NULL , .size = 0 , .alloc_size = 0};
+    num_capture++;
+  }
+
+  if (stderr_pipe[1] >= 0) {
+    close( stderr_pipe[1] );
+    capture[num_capture] = (spawn_capture_type) {.fd = stderr_pipe[0] , .data = NULL , .size = 0 , .alloc_size = 0};
+    num_capture++;
+  }
+
+  {
+    struct timespec start;
+    bool capture_open[2] = {true , true};
+    int num_open = num_capture;
+    bool timed_out = false;
+
+    clock_gettime( CLOCK_MONOTONIC , &start );
+    while (num_open > 0) {
+      struct pollfd poll_fd[2];
+      int poll_index[2];
+      int num_poll = 0;
+      int poll_timeout = -1;
+      int i;
+
+      for (i = 0; i < num_capture; i++) {
+        if (capture_open[i]) {
+          poll_fd[num_poll].fd = capture[i].fd;
+          poll_fd[num_poll].events = POLLIN;
+          poll_fd[num_poll].revents = 0;
+          poll_index[num_poll] = i;
+          num_poll++;
+        }
+      }
+
+      if (timeout_ms > 0) {
+        double remaining = timeout_ms - util_spawn_capture_elapsed_ms( &start );
+        if (remaining <= 0) {
+          timed_out = true;
+          break;
+        }
+        poll_timeout = (int) remaining + 1;
+      }
+
+      if (poll( poll_fd , num_poll , poll_timeout ) < 0) {
+        if (errno == EINTR)
+          continue;
+        util_abort("%s: poll() failed: %s \n",__func__ , strerror( errno ));
+      }
+
+      for (i = 0; i < num_poll; i++) {
+        if (poll_fd[i].revents != 0) {
+          int index = poll_index[i];
+          if (!util_spawn_capture_read__( &capture[index] )) {
+            capture_open[index] = false;
+            num_open--;
+          }
+        }
+      }
+    }
+
+    if (timed_out)
+      kill( pid , SIGKILL );
+  }
+
+  while (waitpid(pid , &status , 0) < 0) {
+    if (errno != EINTR)
+      util_abort("%s: waitpid() failed: %s \n",__func__ , strerror( errno ));
+  }
+
+  {
+    int i;
+    for (i = 0; i < num_capture; i++) {
+      close( capture[i].fd );
+      if (capture[i].data == NULL)
+        capture[i].data = util_malloc( 1 );
+      capture[i].data[capture[i].size] = '\0';
+    }
+
+    i = 0;
+    if (stdout_buffer)
+      *stdout_buffer = capture[i++].data;
+
+    if (stderr_buffer && !merge_output)
+      *stderr_buffer = capture[i++].data;
+  }
+
+  return status;
+}
+
+
 
 /**
    The ping program must(?) be setuid root, so implementing a simple
@@ -293,6 +293,21 @@ static void @TYPE@_vector_assert_writable( const @TYPE@_vector_type * vector ) {
 }
 
 
+/**
+   This function will allocate a read-only vector instance which is a
+   view of the @size elements starting at @data. Observe that the
+   vector does not take ownership of the data, i.e. the data must be
+   kept alive, and not be modified, as long as the view is in use.
+*/
+
+@TYPE@_vector_type * @TYPE@_vector_alloc_view( @TYPE@ * data , int size ) {
+  @TYPE@_vector_type * vector = @TYPE@_vector_alloc__( 0 , 0 , data , size , false );
+  vector->size = size;
+  @TYPE@_vector_set_read_only( vector , true );
+  return vector;
+}
+
+
 /**
    This function will allocate a vector wrapper around the input
    pointer data. The input data will be hijacked by the vector
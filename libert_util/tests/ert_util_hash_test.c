@@ -19,7 +19,60 @@
 #include <stdbool.h>
 
 #include <ert/util/test_util.h>
+#include <ert/util/util.h>
 #include <ert/util/hash.h>
+#include <ert/util/thread_pool.h>
+
+#define NUM_KEYS 10000
+
+
+static void lookup_key( int index , void * arg ) {
+  const hash_type * h = arg;
+  char * key = util_alloc_sprintf("KEY:%d" , index );
+  test_assert_int_equal( index , hash_get_int( h , key ));
+  free( key );
+}
+
+
+void test_freeze() {
+  hash_type * h = hash_alloc();
+  int i;
+
+  hash_freeze( h );
+  test_assert_true( hash_is_frozen( h ));
+  test_assert_false( hash_has_key( h , "KEY" ));
+
+  for (i=0; i < NUM_KEYS; i++) {
+    char * key = util_alloc_sprintf("KEY:%d" , i );
+    hash_insert_int( h , key , i );
+    free( key );
+  }
+  test_assert_false( hash_is_frozen( h ));
+
+  hash_freeze( h );
+  test_assert_true( hash_is_frozen( h ));
+  test_assert_int_equal( NUM_KEYS , hash_get_size( h ));
+  test_assert_false( hash_has_key( h , "KEY" ));
+  test_assert_NULL( hash_safe_get( h , "KEY:-1" ));
+  {
+    thread_pool_type * tp = thread_pool_alloc( 4 , true );
+    thread_pool_parallel_for( tp , 0 , NUM_KEYS , lookup_key , h );
+    thread_pool_free( tp );
+  }
+  {
+    stringlist_type * keys = hash_alloc_stringlist( h );
+    test_assert_int_equal( NUM_KEYS , stringlist_get_size( keys ));
+    stringlist_free( keys );
+  }
+
+  hash_del( h , "KEY:0" );
+  test_assert_false( hash_is_frozen( h ));
+  test_assert_false( hash_has_key( h , "KEY:0" ));
+  test_assert_int_equal( 1 , hash_get_int( h , "KEY:1" ));
+
+  hash_free( h );
+}
+
 
 int main(int argc , char ** argv) {
   
@@ -39,5 +92,6 @@ int main(int argc , char ** argv) {
   test_assert_false( hash_has_key( h , "Key" ));
 
   hash_free( h );
+  test_freeze();
   exit(0);
 }
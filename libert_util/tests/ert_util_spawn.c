@@ -20,6 +20,10 @@
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <pthread.h>
 
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
@@ -149,10 +153,110 @@ void test_spawn_redirect() {
 
 
 
+void test_spawn_capture() {
+  test_work_area_type * test_area = test_work_area_alloc("spawn_capture");
+  {
+    char * stdout_buffer;
+    char * stderr_buffer;
+    int status;
+
+    make_script("script" , "stdout" , "stderr");
+    status = util_spawn_capture("script" , 0 , NULL , &stdout_buffer , &stderr_buffer , 0);
+    test_assert_int_equal( status , 0 );
+    test_assert_string_equal( stdout_buffer , "stdout" );
+    test_assert_string_equal( stderr_buffer , "stderr" );
+    free( stdout_buffer );
+    free( stderr_buffer );
+
+    status = util_spawn_capture("script" , 0 , NULL , &stdout_buffer , &stdout_buffer , 0);
+    test_assert_int_equal( status , 0 );
+    test_assert_string_equal( stdout_buffer , "stdoutstderr" );
+    free( stdout_buffer );
+
+    status = util_spawn_capture("/bin/sh" , 2 , (const char *[2]) {"-c" , "exit 3"} , &stdout_buffer , NULL , 0);
+    test_assert_true( WIFEXITED( status ));
+    test_assert_int_equal( WEXITSTATUS( status ) , 3 );
+    test_assert_string_equal( stdout_buffer , "" );
+    free( stdout_buffer );
+
+    /* Large output - more than the pipe buffer. */
+    status = util_spawn_capture("/bin/sh" , 2 , (const char *[2]) {"-c" , "yes 0123456789 | head -n 20000"} , &stdout_buffer , NULL , 0);
+    test_assert_int_equal( status , 0 );
+    test_assert_int_equal( strlen( stdout_buffer ) , 20000 * 11 );
+    free( stdout_buffer );
+
+    status = util_spawn_capture("/bin/sh" , 2 , (const char *[2]) {"-c" , "echo start; exec sleep 10"} , &stdout_buffer , NULL , 250);
+    test_assert_true( WIFSIGNALED( status ));
+    test_assert_int_equal( WTERMSIG( status ) , SIGKILL );
+    test_assert_string_equal( stdout_buffer , "start\n" );
+    free( stdout_buffer );
+  }
+  test_work_area_free( test_area );
+}
+
+
+static void * close_fd_delayed( void * arg ) {
+  int * fd = arg;
+  usleep( 50000 );
+  close( *fd );
+  return NULL;
+}
+
+
+/*
+  A child which is forked while another thread is writing a script
+  inherits the open descriptor, and exec of the script fails with
+  ETXTBSY until the child has exec'ed and the descriptor is closed.
+  Here the descriptor is held open by the test for 50 ms; util_spawn()
+  must retry instead of aborting.
+*/
+
+void test_spawn_text_busy() {
+  test_work_area_type * test_area = test_work_area_alloc("spawn_text_busy");
+  make_script("script" , "stdout" , "stderr");
+  {
+    int fd = open( "script" , O_WRONLY );
+    pthread_t thread;
+
+    test_assert_true( fd >= 0 );
+    pthread_create( &thread , NULL , close_fd_delayed , &fd );
+    test_assert_int_equal( util_spawn_blocking( "script" , 0 , NULL , "stdout.txt" , "stderr.txt") , 0 );
+    pthread_join( thread , NULL );
+  }
+  test_assert_file_content( "stdout.txt" , "stdout" );
+  test_work_area_free( test_area );
+}
+
+
+static void spawn_missing( void * arg ) {
+  util_spawn_blocking( "/does/not/exist" , 0 , NULL , NULL , NULL );
+}
+
+
+/*
+  util_spawn() must not call util_abort() while holding spawn_mutex;
+  util_abort() spawns addr2line for the backtrace. When the abort is
+  intercepted by the test the mutex would be left locked, and the next
+  spawn would hang.
+*/
+
+void test_spawn_abort() {
+  test_work_area_type * test_area = test_work_area_alloc("spawn_abort");
+  test_assert_util_abort( "util_spawn_file_actions__" , spawn_missing , NULL );
+
+  make_script("script" , "stdout" , "stderr");
+  test_assert_int_equal( util_spawn_blocking( "script" , 0 , NULL , "stdout.txt" , "stderr.txt") , 0 );
+  test_work_area_free( test_area );
+}
+
+
 int main(int argc , char ** argv) {
   util_install_signals();
   test_spawn_no_redirect( );
   test_spawn_redirect( );
   test_spawn_redirect_threaded( );
+  test_spawn_capture( );
+  test_spawn_text_busy( );
+  test_spawn_abort( );
   exit(0);
 }
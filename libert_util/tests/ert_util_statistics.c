@@ -19,9 +19,12 @@
 
 
 #include <stdlib.h>
+#include <math.h>
 
 #include <ert/util/test_util.h>
 #include <ert/util/statistics.h>
+#include <ert/util/p2_quantile.h>
+#include <ert/util/rng.h>
 
 
 void test_mean_std() {
@@ -35,6 +38,106 @@ void test_mean_std() {
 }
 
 
+
+void test_quantiles_equal( const double_vector_type * data ) {
+  double_vector_type * quantiles = double_vector_alloc(0,0);
+  double_vector_type * result    = double_vector_alloc(0,0);
+  double_vector_type * sorted    = double_vector_alloc_copy( data );
+  double_vector_type * work      = double_vector_alloc_copy( data );
+
+  double_vector_append( quantiles , 0.90 );
+  double_vector_append( quantiles , 0.10 );
+  double_vector_append( quantiles , 0.50 );
+  double_vector_append( quantiles , 0.00 );
+  double_vector_append( quantiles , 1.00 );
+  double_vector_append( quantiles , 0.33 );
+  double_vector_append( quantiles , 0.33 );
+
+  double_vector_sort( sorted );
+  statistics_empirical_quantiles( work , quantiles , result );
+  test_assert_int_equal( double_vector_size( quantiles ) , double_vector_size( result ));
+  for (int iq = 0; iq < double_vector_size( quantiles ); iq++)
+    test_assert_double_equal( statistics_empirical_quantile__( sorted , double_vector_iget( quantiles , iq )) ,
+                              double_vector_iget( result , iq ));
+
+  double_vector_sort( work );
+  test_assert_true( double_vector_equal( work , sorted ));
+
+  double_vector_free( work );
+  double_vector_free( sorted );
+  double_vector_free( result );
+  double_vector_free( quantiles );
+}
+
+
+void test_quantiles() {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  double_vector_type * d = double_vector_alloc(0,0);
+
+  for (int i=0; i < 1001; i++)
+    double_vector_append( d , rng_get_double( rng ));
+  test_quantiles_equal( d );
+
+  /* Many repeated values; exercises the index shifting for ties. */
+  double_vector_reset( d );
+  for (int i=0; i < 1000; i++)
+    double_vector_append( d , rng_get_int( rng , 4 ));
+  test_quantiles_equal( d );
+
+  double_vector_reset( d );
+  for (int i=0; i < 100; i++)
+    double_vector_append( d , (i < 95) ? 0 : i );
+  test_quantiles_equal( d );
+
+  double_vector_reset( d );
+  for (int i=0; i < 10; i++)
+    double_vector_append( d , 7 );
+  test_quantiles_equal( d );
+
+  double_vector_reset( d );
+  double_vector_append( d , 3 );
+  double_vector_append( d , 1 );
+  test_quantiles_equal( d );
+
+  double_vector_free( d );
+  rng_free( rng );
+}
+
+
+void test_p2_quantile() {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  p2_quantile_type * p10 = p2_quantile_alloc( 0.10 );
+  p2_quantile_type * p50 = p2_quantile_alloc( 0.50 );
+  p2_quantile_type * p90 = p2_quantile_alloc( 0.90 );
+
+  test_assert_true( p2_quantile_is_instance( p50 ));
+  p2_quantile_add( p50 , 3 );
+  p2_quantile_add( p50 , 1 );
+  p2_quantile_add( p50 , 2 );
+  test_assert_double_equal( 2 , p2_quantile_get( p50 ));
+  p2_quantile_reset( p50 );
+  test_assert_int_equal( 0 , p2_quantile_get_count( p50 ));
+
+  for (int i=0; i < 100000; i++) {
+    double value = rng_get_double( rng );
+    p2_quantile_add( p10 , value );
+    p2_quantile_add( p50 , value );
+    p2_quantile_add( p90 , value );
+  }
+  test_assert_int_equal( 100000 , p2_quantile_get_count( p50 ));
+  test_assert_true( fabs( p2_quantile_get( p10 ) - 0.10 ) < 0.01 );
+  test_assert_true( fabs( p2_quantile_get( p50 ) - 0.50 ) < 0.01 );
+  test_assert_true( fabs( p2_quantile_get( p90 ) - 0.90 ) < 0.01 );
+
+  p2_quantile_free( p10 );
+  p2_quantile_free( p50 );
+  p2_quantile_free( p90 );
+  rng_free( rng );
+}
+
+
 int main( int argc , char ** argv ) {
   test_mean_std();
+  test_quantiles();
+  test_p2_quantile();
 }
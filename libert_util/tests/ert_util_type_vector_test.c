@@ -344,6 +344,21 @@ void test_empty() {
   int_vector_free( vec );
 }
 
+void test_view() {
+  int data[5] = {1,2,3,4,5};
+  int_vector_type * view = int_vector_alloc_view( &data[1] , 3 );
+
+  test_assert_int_equal( 3 , int_vector_size( view ));
+  test_assert_int_equal( 2 , int_vector_iget( view , 0 ));
+  test_assert_int_equal( 4 , int_vector_iget( view , 2 ));
+  test_assert_true( int_vector_get_read_only( view ));
+  test_assert_false( int_vector_growable( view ));
+
+  int_vector_free( view );
+  test_assert_int_equal( 5 , data[4] );
+}
+
+
 int main(int argc , char ** argv) {
 
   int_vector_type * int_vector = int_vector_alloc( 0 , 99);
@@ -434,5 +449,6 @@ int main(int argc , char ** argv) {
   test_resize();
   test_empty();
   test_insert_double();
+  test_view();
   exit(0);
 }
@@ -19,6 +19,7 @@
 #include <pthread.h>
 
 #include <ert/util/test_util.h>
+#include <ert/util/util.h>
 #include <ert/util/thread_pool.h>
 
 
@@ -64,7 +65,77 @@ void run() {
 
 
 
+void * return_arg(void * arg) {
+  return arg;
+}
+
+
+void run_restart() {
+  int run_size = 4;
+  int values[100];
+  thread_pool_type * tp = thread_pool_alloc( run_size , false );
+
+  for (int iter = 0; iter < 10; iter++) {
+    thread_pool_restart( tp );
+    for (int i=0; i < 100; i++)
+      thread_pool_add_job( tp , return_arg , &values[i] );
+    thread_pool_join( tp );
+
+    for (int i=0; i < 100; i++)
+      test_assert_ptr_equal( thread_pool_iget_return_value( tp , i ) , &values[i] );
+  }
+  thread_pool_free( tp );
+}
+
+
+void try_join() {
+  int value = 0;
+  thread_pool_type * tp = thread_pool_alloc( 2 , true );
+
+  pthread_mutex_init(&lock , NULL);
+  for (int i=0; i < 10; i++)
+    thread_pool_add_job( tp , inc , &value );
+
+  test_assert_true( thread_pool_try_join( tp , 10 ));
+  test_assert_int_equal( 10 , value );
+  thread_pool_free( tp );
+  pthread_mutex_destroy( &lock );
+}
+
+
+void square( int index , void * arg ) {
+  int * data = (int *) arg;
+  data[index] = index * index;
+}
+
+
+void parallel_for() {
+  const int size = 10007;
+  int * data = util_calloc( size , sizeof * data );
+
+  for (int run_size = 0; run_size < 4; run_size++) {
+    thread_pool_type * tp = thread_pool_alloc( run_size , true );
+
+    for (int i=0; i < size; i++)
+      data[i] = -1;
+
+    thread_pool_parallel_for( tp , 1 , size , square , data );
+    test_assert_int_equal( -1 , data[0] );
+    for (int i=1; i < size; i++)
+      test_assert_int_equal( i*i , data[i] );
+
+    thread_pool_parallel_for( tp , 10 , 10 , square , data );
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+  }
+  free( data );
+}
+
+
 int main( int argc , char ** argv) {
   create_and_destroy();
   run();
+  run_restart();
+  try_join();
+  parallel_for();
 }
@@ -29,11 +29,13 @@ typedef struct geo_pointset_struct geo_pointset_type;
 
 
   geo_pointset_type * geo_pointset_alloc( bool external_z );
+  geo_pointset_type * geo_pointset_alloc_shared( const geo_pointset_type * base );
   void                geo_pointset_free( geo_pointset_type * pointset );
   void                geo_pointset_add_xyz( geo_pointset_type * pointset , double x , double y, double z);
   int                 geo_pointset_get_size( const geo_pointset_type * pointset );
   void                geo_pointset_iget_xy( const geo_pointset_type * pointset , int index , double * x , double * y);
   const double      * geo_pointset_get_zcoord( const geo_pointset_type * pointset );
+  double            * geo_pointset_get_zcoord_ref( geo_pointset_type * pointset );
   bool                geo_pointset_equal( const geo_pointset_type * pointset1 , const geo_pointset_type * pointset2);
   double              geo_pointset_iget_z( const geo_pointset_type * pointset , int index );
   void                geo_pointset_iset_z( geo_pointset_type * pointset , int index , double value);
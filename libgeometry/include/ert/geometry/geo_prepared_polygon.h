@@ -0,0 +1,53 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'geo_prepared_polygon.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_GEO_PREPARED_POLYGON_H
+#define ERT_GEO_PREPARED_POLYGON_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/type_macros.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
+
+#include <ert/geometry/geo_polygon.h>
+
+  typedef struct geo_prepared_polygon_struct geo_prepared_polygon_type;
+
+  geo_prepared_polygon_type * geo_prepared_polygon_alloc( const geo_polygon_type * polygon );
+  void                        geo_prepared_polygon_free( geo_prepared_polygon_type * prepared );
+  bool                        geo_prepared_polygon_contains_point( const geo_prepared_polygon_type * prepared , double x , double y);
+  void                        geo_prepared_polygon_contains_points( const geo_prepared_polygon_type * prepared , int num_points , const double * x , const double * y , bool * inside);
+  void                        geo_prepared_polygon_set_num_threads( int num_threads );
+  int                         geo_prepared_polygon_get_num_threads( void );
+#ifdef ERT_HAVE_THREAD_POOL
+  void                        geo_prepared_polygon_contains_points_mt( const geo_prepared_polygon_type * prepared , int num_points , const double * x , const double * y , bool * inside , thread_pool_type * tp);
+#endif
+
+  UTIL_IS_INSTANCE_HEADER( geo_prepared_polygon );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
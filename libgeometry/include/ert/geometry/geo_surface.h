@@ -36,12 +36,18 @@ extern "C" {
   void                geo_surface_free__( void * arg);
   geo_pointset_type * geo_surface_get_pointset( const geo_surface_type * surface );
   geo_surface_type  * geo_surface_fload_alloc_irap( const char * filename , bool loadz);
+  geo_surface_type  * geo_surface_fload_alloc_irap_shared( const geo_surface_type * base , const char * filename );
   geo_surface_type  * geo_surface_alloc_new( int nx, int ny, double xinc, double yinc, double xstart, double ystart, double angle );
   bool                geo_surface_fload_irap_zcoord( const geo_surface_type * surface, const char * filename, double *zlist);
   double              geo_surface_iget_zvalue(const geo_surface_type * surface, int index);
+  void                geo_surface_iset_zvalue(geo_surface_type * surface, int index , double value);
+  void                geo_surface_iadd( geo_surface_type * self , const geo_surface_type * other);
+  void                geo_surface_isub( geo_surface_type * self , const geo_surface_type * other);
   int                 geo_surface_get_size( const geo_surface_type * surface );
   void                geo_surface_fprintf_irap( const geo_surface_type * surface, const char * filename );
   void                geo_surface_fprintf_irap_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord);
+  void                geo_surface_fwrite_irap_binary( const geo_surface_type * surface, const char * filename );
+  void                geo_surface_fwrite_irap_binary_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord);
   int                 geo_surface_get_nx( const geo_surface_type * surface );
   int                 geo_surface_get_ny( const geo_surface_type * surface );
   void                geo_surface_iget_xy( const geo_surface_type* surface, int index, double* x, double* y);
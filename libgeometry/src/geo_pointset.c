@@ -33,6 +33,7 @@ struct geo_pointset_struct {
   int         size;
   int         alloc_size;
   bool        internal_z;
+  bool        shared_xy;  // The x and y coordinates are owned by another pointset.
 
   double    * xcoord;
   double    * ycoord;
@@ -57,16 +58,40 @@ geo_pointset_type *  geo_pointset_alloc( bool internal_z) {
   pointset->ycoord = NULL;
   pointset->zcoord = NULL;
   pointset->internal_z = internal_z;
+  pointset->shared_xy = false;
   pointset->size = 0;
   geo_pointset_resize( pointset , INIT_SIZE );
   return pointset;
 }
 
 
+/**
+   Allocates a pointset which shares the x and y coordinates with
+   @base, and has internal z coordinates initialized to zero. The
+   @base pointset must be kept alive, and can not be modified, as long
+   as the shared pointset is in use.
+*/
+
+geo_pointset_type *  geo_pointset_alloc_shared( const geo_pointset_type * base ) {
+  geo_pointset_type * pointset = util_malloc( sizeof * pointset );
+  pointset->xcoord = base->xcoord;
+  pointset->ycoord = base->ycoord;
+  pointset->zcoord = util_calloc( base->size , sizeof * pointset->zcoord );
+  pointset->internal_z = true;
+  pointset->shared_xy = true;
+  pointset->size = base->size;
+  pointset->alloc_size = base->size;
+  return pointset;
+}
+
+
 void geo_pointset_memcpy( const geo_pointset_type * src, geo_pointset_type * target , bool copy_zdata) {
   if (src->internal_z != target->internal_z)
     util_abort("%s: when copying geo_poitset they must have equal value for internal_z\n", __func__);
 
+  if (target->shared_xy)
+    util_abort("%s: can not copy into a pointset with shared x and y coordinates\n", __func__);
+
   geo_pointset_resize( target , src->size );
   target->size = src->size;
   memcpy( target->xcoord , src->xcoord , src->size * sizeof * src->xcoord);
@@ -84,6 +109,9 @@ void geo_pointset_memcpy( const geo_pointset_type * src, geo_pointset_type * tar
 }
 
 void geo_pointset_add_xyz( geo_pointset_type * pointset , double x , double y, double z) {
+  if (pointset->shared_xy)
+    util_abort("%s: can not add points to a pointset with shared x and y coordinates\n", __func__);
+
   if (pointset->size == pointset->alloc_size)
     geo_pointset_resize( pointset , 1 + pointset->alloc_size * 2);
 
@@ -96,8 +124,10 @@ void geo_pointset_add_xyz( geo_pointset_type * pointset , double x , double y, d
 }
 
 void geo_pointset_free( geo_pointset_type * pointset ) {
-  free( pointset->xcoord );
-  free( pointset->ycoord );
+  if (!pointset->shared_xy) {
+    free( pointset->xcoord );
+    free( pointset->ycoord );
+  }
   util_safe_free( pointset->zcoord );
   free( pointset );
 }
@@ -113,6 +143,11 @@ const double * geo_pointset_get_zcoord( const geo_pointset_type * pointset ) {
 }
 
 
+double * geo_pointset_get_zcoord_ref( geo_pointset_type * pointset ) {
+  return pointset->zcoord;
+}
+
+
 static void geo_pointset_assert_index( const geo_pointset_type * pointset , int index) {
   if ((index < 0) || (index >= pointset->size))
     util_abort("%s: invalid pointset index. Size:%d \n",__func__ , index );
@@ -0,0 +1,304 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'geo_prepared_polygon.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
+
+#include <ert/geometry/geo_polygon.h>
+#include <ert/geometry/geo_prepared_polygon.h>
+
+/*
+  The prepared polygon is an acceleration structure for repeated point
+  in polygon tests against the same polygon. The y range of the
+  polygon is divided in num_bins horizontal slabs, and every edge is
+  registered in all the slabs its y range overlaps. The ray crossing
+  test of geo_util_inside_polygon() only toggles on edges with
+  ymin < y0 <= ymax, so for a point it is sufficient to test the edges
+  registered in the slab of the point; the edge test is identical to
+  the one in geo_util_inside_polygon() and the result is exactly the
+  same as geo_polygon_contains_point().
+
+  Observe that the prepared polygon is a snapshot of the polygon; later
+  updates to the polygon are not reflected.
+*/
+
+#define GEO_PREPARED_POLYGON_TYPE_ID 7712109
+
+#define MAX_BINS              65536
+#define MT_MIN_POINTS         16384
+#define MT_CHUNK_SIZE         4096
+
+struct geo_prepared_polygon_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int      num_edges;
+  double * x1;               /* The edges with degenerate edges removed; (x1,y1) -> (x2,y2). */
+  double * y1;
+  double * x2;
+  double * y2;
+
+  double   xmax;             /* Bounding box; the points outside [ymin,ymax] and right of xmax are never inside. */
+  double   ymin;
+  double   ymax;
+
+  int      num_bins;
+  double   bin_scale;
+  int    * bin_offset;       /* The edges of bin b are bin_edges[ bin_offset[b] ... bin_offset[b+1] ). */
+  int    * bin_edges;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( geo_prepared_polygon , GEO_PREPARED_POLYGON_TYPE_ID);
+
+
+static int geo_prepared_polygon_get_bin( const geo_prepared_polygon_type * prepared , double y ) {
+  int bin = (int) floor( (y - prepared->ymin) * prepared->bin_scale );
+  if (bin < 0)
+    bin = 0;
+
+  if (bin >= prepared->num_bins)
+    bin = prepared->num_bins - 1;
+
+  return bin;
+}
+
+
+static void geo_prepared_polygon_build_bins( geo_prepared_polygon_type * prepared ) {
+  int * bin_count;
+  int edge;
+
+  prepared->num_bins = util_int_max( 1 , util_int_min( prepared->num_edges , MAX_BINS ));
+  if (prepared->ymax > prepared->ymin)
+    prepared->bin_scale = prepared->num_bins / (prepared->ymax - prepared->ymin);
+  else
+    prepared->bin_scale = 0;
+
+  prepared->bin_offset = util_malloc( (prepared->num_bins + 1) * sizeof * prepared->bin_offset );
+  bin_count = util_malloc( prepared->num_bins * sizeof * bin_count );
+  for (int bin = 0; bin < prepared->num_bins; bin++)
+    bin_count[bin] = 0;
+
+  for (edge = 0; edge < prepared->num_edges; edge++) {
+    int bin1 = geo_prepared_polygon_get_bin( prepared , util_double_min( prepared->y1[edge] , prepared->y2[edge] ));
+    int bin2 = geo_prepared_polygon_get_bin( prepared , util_double_max( prepared->y1[edge] , prepared->y2[edge] ));
+    for (int bin = bin1; bin <= bin2; bin++)
+      bin_count[bin]++;
+  }
+
+  prepared->bin_offset[0] = 0;
+  for (int bin = 0; bin < prepared->num_bins; bin++)
+    prepared->bin_offset[bin + 1] = prepared->bin_offset[bin] + bin_count[bin];
+
+  prepared->bin_edges = util_malloc( util_int_max( 1 , prepared->bin_offset[ prepared->num_bins ] ) * sizeof * prepared->bin_edges );
+  for (int bin = 0; bin < prepared->num_bins; bin++)
+    bin_count[bin] = prepared->bin_offset[bin];
+
+  for (edge = 0; edge < prepared->num_edges; edge++) {
+    int bin1 = geo_prepared_polygon_get_bin( prepared , util_double_min( prepared->y1[edge] , prepared->y2[edge] ));
+    int bin2 = geo_prepared_polygon_get_bin( prepared , util_double_max( prepared->y1[edge] , prepared->y2[edge] ));
+    for (int bin = bin1; bin <= bin2; bin++) {
+      prepared->bin_edges[ bin_count[bin] ] = edge;
+      bin_count[bin]++;
+    }
+  }
+
+  free( bin_count );
+}
+
+
+geo_prepared_polygon_type * geo_prepared_polygon_alloc( const geo_polygon_type * polygon ) {
+  geo_prepared_polygon_type * prepared = util_malloc( sizeof * prepared );
+  int num_points = geo_polygon_get_size( polygon );
+  int alloc_size = util_int_max( 1 , num_points );
+
+  UTIL_TYPE_ID_INIT( prepared , GEO_PREPARED_POLYGON_TYPE_ID );
+  prepared->x1 = util_malloc( alloc_size * sizeof * prepared->x1 );
+  prepared->y1 = util_malloc( alloc_size * sizeof * prepared->y1 );
+  prepared->x2 = util_malloc( alloc_size * sizeof * prepared->x2 );
+  prepared->y2 = util_malloc( alloc_size * sizeof * prepared->y2 );
+  prepared->num_edges = 0;
+  prepared->xmax = 0;
+  prepared->ymin = 0;
+  prepared->ymax = 0;
+
+  {
+    int point_num;
+    for (point_num = 0; point_num < num_points; point_num++) {
+      int edge = prepared->num_edges;
+      double x1,y1,x2,y2;
+
+      geo_polygon_iget_xy( polygon , point_num , &x1 , &y1 );
+      geo_polygon_iget_xy( polygon , (point_num + 1) % num_points , &x2 , &y2 );
+
+      if ((x1 == x2) && (y1 == y2))
+        continue;
+
+      prepared->x1[edge] = x1;
+      prepared->y1[edge] = y1;
+      prepared->x2[edge] = x2;
+      prepared->y2[edge] = y2;
+
+      if (edge == 0) {
+        prepared->xmax = util_double_max( x1 , x2 );
+        prepared->ymin = util_double_min( y1 , y2 );
+        prepared->ymax = util_double_max( y1 , y2 );
+      } else {
+        prepared->xmax = util_double_max( prepared->xmax , util_double_max( x1 , x2 ));
+        prepared->ymin = util_double_min( prepared->ymin , util_double_min( y1 , y2 ));
+        prepared->ymax = util_double_max( prepared->ymax , util_double_max( y1 , y2 ));
+      }
+      prepared->num_edges++;
+    }
+  }
+
+  geo_prepared_polygon_build_bins( prepared );
+  return prepared;
+}
+
+
+void geo_prepared_polygon_free( geo_prepared_polygon_type * prepared ) {
+  free( prepared->x1 );
+  free( prepared->y1 );
+  free( prepared->x2 );
+  free( prepared->y2 );
+  free( prepared->bin_offset );
+  free( prepared->bin_edges );
+  free( prepared );
+}
+
+
+bool geo_prepared_polygon_contains_point( const geo_prepared_polygon_type * prepared , double x0 , double y0) {
+  bool inside = false;
+
+  if ((prepared->num_edges == 0) || (y0 <= prepared->ymin) || (y0 > prepared->ymax) || (x0 > prepared->xmax))
+    return false;
+
+  {
+    int bin = geo_prepared_polygon_get_bin( prepared , y0 );
+    int index;
+
+    for (index = prepared->bin_offset[bin]; index < prepared->bin_offset[bin + 1]; index++) {
+      int edge = prepared->bin_edges[index];
+      double x1 = prepared->x1[edge];  double y1 = prepared->y1[edge];
+      double x2 = prepared->x2[edge];  double y2 = prepared->y2[edge];
+      double ymin = util_double_min(y1,y2);
+      double ymax = util_double_max(y1,y2);
+      double xmax = util_double_max(x1,x2);
+
+      if ((y0 > ymin) && (y0 <= ymax)) {
+        if (x0 <= xmax) {
+          double xc = (y0 - y1) * (x2 - x1) / (y2 - y1) + x1;
+
+          if ((x1 == x2) || (x0 <= xc))
+            inside = !inside;
+        }
+      }
+    }
+  }
+  return inside;
+}
+
+
+static void geo_prepared_polygon_contains_points__( const geo_prepared_polygon_type * prepared , int offset , int num_points , const double * x , const double * y , bool * inside) {
+  int index;
+  for (index = offset; index < offset + num_points; index++)
+    inside[index] = geo_prepared_polygon_contains_point( prepared , x[index] , y[index] );
+}
+
+
+static int geo_prepared_polygon_num_threads = 1;
+
+
+void geo_prepared_polygon_set_num_threads( int num_threads ) {
+  if (num_threads < 1)
+    util_abort("%s: invalid number of threads:%d \n",__func__ , num_threads);
+
+  geo_prepared_polygon_num_threads = num_threads;
+}
+
+
+int geo_prepared_polygon_get_num_threads( void ) {
+  return geo_prepared_polygon_num_threads;
+}
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+
+typedef struct {
+  const geo_prepared_polygon_type * prepared;
+  int                               num_points;
+  int                               chunk_size;
+  const double                    * x;
+  const double                    * y;
+  bool                            * inside;
+} geo_prepared_polygon_batch_type;
+
+
+static void geo_prepared_polygon_contains_chunk( int chunk , void * arg ) {
+  geo_prepared_polygon_batch_type * batch = arg;
+  int offset = chunk * batch->chunk_size;
+  int size = util_int_min( batch->chunk_size , batch->num_points - offset );
+
+  geo_prepared_polygon_contains_points__( batch->prepared , offset , size , batch->x , batch->y , batch->inside );
+}
+
+
+/*
+  As geo_prepared_polygon_contains_points(), but the chunks are
+  evaluated by the caller's thread pool, which must be running;
+  i.e. callers doing many selections can reuse one pool. The pool
+  must not be the pool of the calling job.
+*/
+
+void geo_prepared_polygon_contains_points_mt( const geo_prepared_polygon_type * prepared , int num_points , const double * x , const double * y , bool * inside , thread_pool_type * tp) {
+  geo_prepared_polygon_batch_type batch = { .prepared   = prepared,
+                                            .num_points = num_points,
+                                            .chunk_size = MT_CHUNK_SIZE,
+                                            .x          = x,
+                                            .y          = y,
+                                            .inside     = inside };
+  int num_chunks = (num_points + batch.chunk_size - 1) / batch.chunk_size;
+
+  thread_pool_parallel_for( tp , 0 , num_chunks , geo_prepared_polygon_contains_chunk , &batch );
+}
+
+#endif
+
+
+/*
+  Batched version of geo_prepared_polygon_contains_point(); large
+  batches are split in chunks which are evaluated by a temporary
+  thread pool with geo_prepared_polygon_get_num_threads() threads.
+*/
+
+void geo_prepared_polygon_contains_points( const geo_prepared_polygon_type * prepared , int num_points , const double * x , const double * y , bool * inside) {
+#ifdef ERT_HAVE_THREAD_POOL
+  if ((geo_prepared_polygon_num_threads > 1) && (num_points >= MT_MIN_POINTS)) {
+    thread_pool_type * tp = thread_pool_alloc( geo_prepared_polygon_num_threads , true );
+    geo_prepared_polygon_contains_points_mt( prepared , num_points , x , y , inside , tp );
+    thread_pool_free( tp );
+    return;
+  }
+#endif
+  geo_prepared_polygon_contains_points__( prepared , 0 , num_points , x , y , inside );
+}
@@ -29,6 +29,7 @@
 #include <ert/geometry/geo_pointset.h>
 #include <ert/geometry/geo_region.h>
 #include <ert/geometry/geo_polygon.h>
+#include <ert/geometry/geo_prepared_polygon.h>
 
 #define GEO_REGION_TYPE_ID 4431973
 
@@ -104,18 +105,26 @@ static void geo_region_polygon_select__( geo_region_type * region ,
                                          const geo_polygon_type * polygon , 
                                          bool select_inside , bool select) {
   
+  geo_prepared_polygon_type * prepared = geo_prepared_polygon_alloc( polygon );
+  int alloc_size = util_int_max( 1 , region->pointset_size );
+  double * x = util_malloc( alloc_size * sizeof * x );
+  double * y = util_malloc( alloc_size * sizeof * y );
+  bool * inside = util_malloc( alloc_size * sizeof * inside );
   int index;
-  for (index = 0; index < region->pointset_size; index++) {
 
-    double x , y;
-    bool is_inside;
-    geo_pointset_iget_xy( region->pointset , index , &x , &y);
-    
-    is_inside = geo_polygon_contains_point( polygon  , x , y );
-    if (is_inside == select_inside) 
-      region->active_mask[index] = select;
+  for (index = 0; index < region->pointset_size; index++) 
+    geo_pointset_iget_xy( region->pointset , index , &x[index] , &y[index]);
 
+  geo_prepared_polygon_contains_points( prepared , region->pointset_size , x , y , inside );
+  for (index = 0; index < region->pointset_size; index++) {
+    if (inside[index] == select_inside) 
+      region->active_mask[index] = select;
   }
+
+  free( inside );
+  free( y );
+  free( x );
+  geo_prepared_polygon_free( prepared );
   geo_region_invalidate_index_list( region );
 }
 
@@ -19,6 +19,8 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
 
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
@@ -29,6 +31,26 @@
 #define __PI                3.14159265
 #define GEO_SURFACE_TYPE_ID 111743
 
+#define IRAP_MAGIC             -996
+#define IRAP_BUFFER_SIZE       (1 << 20)
+#define IRAP_MAX_NUMBER_LENGTH 64        // Upper limit on the length of one formatted number.
+
+
+/*
+  The IRAP binary format is a sequence of big endian Fortran records:
+
+    1: -996 ny xmin xmax ymin ymax xinc yinc   (int int float x 6)
+    2: nx angle xrot yrot                      (int float x 3)
+    3: 0 0 0 0 0 0 0                           (int x 7)
+    4...: The z values as float, with ix running fastest; the
+          values can be split over an arbitrary number of records.
+*/
+
+typedef union {
+  int   i;
+  float f;
+} irap_word_type;
+
 
 struct geo_surface_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -90,21 +112,65 @@ static void geo_surface_init_regular( geo_surface_type * surface , const double
 }
 
 
+/**
+   Reads the formatted z values from the current position of @stream.
+   The file is read in large blocks, and the values are converted
+   with strtod() directly from the buffer. Returns false if the file
+   is too short, or if there is more data dangling at the end of the
+   file.
+*/
+
 static bool geo_surface_fscanf_zcoord( const geo_surface_type * surface , FILE * stream , double * zcoord) {
-  int index = 0;
+  const int size = surface->nx * surface->ny;
+  char * buffer  = util_malloc( IRAP_BUFFER_SIZE + 1 );
+  int length     = 0;
+  int pos        = 0;
+  int index      = 0;
+  bool eof       = false;
+  bool read_ok   = true;
 
   while (true) {
-    if (fscanf(stream , "%lg" , &zcoord[index]) == 1)
-      index++;
-    else
-      return false; // File is too short
+    while ((pos < length) && isspace( (unsigned char) buffer[pos] ))
+      pos++;
+
+    if (!eof && (length - pos < IRAP_MAX_NUMBER_LENGTH)) {
+      int remaining = length - pos;
+      int bytes_read;
+
+      memmove( buffer , &buffer[pos] , remaining );
+      bytes_read = fread( &buffer[remaining] , 1 , IRAP_BUFFER_SIZE - remaining , stream );
+      if (bytes_read < IRAP_BUFFER_SIZE - remaining)
+        eof = true;
+
+      length = remaining + bytes_read;
+      buffer[length] = '\0';
+      pos = 0;
+      continue;
+    }
 
-    if (index == surface->nx * surface->ny) {
-      double extra_value;
-      int fscanf_return = fscanf( stream , "%lg" , &extra_value);
-      return (fscanf_return == EOF); // no more data dangling at the end of the file.
+    if (pos == length)
+      break;
+
+    if (index == size) {
+      read_ok = false;   // More data dangling at the end of the file.
+      break;
+    }
+
+    {
+      char * start = &buffer[pos];
+      char * end;
+      zcoord[index] = strtod( start , &end );
+      if (end == start) {
+        read_ok = false;
+        break;
+      }
+      pos += end - start;
+      index++;
     }
   }
+
+  free( buffer );
+  return read_ok && (index == size);
 }
 
 
@@ -131,16 +197,41 @@ static void geo_surface_fprintf_irap_header( const geo_surface_type * surface ,
 
 
 
+/**
+   The values are formatted into a large buffer which is written in
+   one operation when it is full.
+*/
+
 static void geo_surface_fprintf_zcoord( const geo_surface_type * surface , FILE * stream , const double * zcoord ) {
   int num_columns = 6;
   const char * fmt = "%12.4f  ";
+  char * buffer = util_malloc( IRAP_BUFFER_SIZE );
+  int length = 0;
   int i;
   for (i=0; i < geo_surface_get_size( surface ); i++) {
-    fprintf(stream , fmt , zcoord[i]);
+    if (length > IRAP_BUFFER_SIZE - IRAP_MAX_NUMBER_LENGTH) {
+      util_fwrite( buffer , 1 , length , stream , __func__ );
+      length = 0;
+    }
+
+    {
+      int avail = IRAP_BUFFER_SIZE - length - 1;
+      int bytes = snprintf( &buffer[length] , avail , fmt , zcoord[i] );
+      if (bytes < avail)
+        length += bytes;
+      else {
+        // Extremely large value which does not fit in the buffer.
+        util_fwrite( buffer , 1 , length , stream , __func__ );
+        length = 0;
+        fprintf(stream , fmt , zcoord[i]);
+      }
+    }
 
     if (((i + 1) % num_columns) == 0)
-      fprintf(stream , "\n");
+      buffer[length++] = '\n';
   }
+  util_fwrite( buffer , 1 , length , stream , __func__ );
+  free( buffer );
 }
 
 
@@ -163,32 +254,41 @@ void geo_surface_fprintf_irap_external_zcoord( const geo_surface_type * surface,
   geo_surface_fprintf_irap__( surface , filename , zcoord );
 }
 
+
+static void geo_surface_init_header( geo_surface_type * surface ,
+                                     int nx,        int ny,
+                                     double xinc,   double yinc,
+                                     double xstart, double ystart,
+                                     double angle ) {
+  surface->origo[0]  = xstart;
+  surface->origo[1]  = ystart;
+  surface->rot_angle = angle * __PI / 180.0;
+  surface->nx = nx;
+  surface->ny = ny;
+
+  surface->vec1[0] = xinc * cos( surface->rot_angle ) ;
+  surface->vec1[1] = xinc * sin( surface->rot_angle ) ;
+
+  surface->vec2[0] = -yinc * sin( surface->rot_angle ) ;
+  surface->vec2[1] =  yinc * cos( surface->rot_angle );
+
+  surface->cell_size[0] = xinc;
+  surface->cell_size[1] = yinc;
+}
+
+
 geo_surface_type  * geo_surface_alloc_new( int nx,        int ny,
                                            double xinc,   double yinc,
                                            double xstart, double ystart,
                                            double angle ) {
     geo_surface_type * surface = geo_surface_alloc_empty( true );
-
-    surface->origo[0]  = xstart;
-    surface->origo[1]  = ystart;
-    surface->rot_angle = angle * __PI / 180.0;
-    surface->nx = nx;
-    surface->ny = ny;
-
-    surface->vec1[0] = xinc * cos( surface->rot_angle ) ;
-    surface->vec1[1] = xinc * sin( surface->rot_angle ) ;
-
-    surface->vec2[0] = -yinc * sin( surface->rot_angle ) ;
-    surface->vec2[1] =  yinc * cos( surface->rot_angle );
-
-    surface->cell_size[0] = xinc;
-    surface->cell_size[1] = yinc;
+    geo_surface_init_header( surface , nx , ny , xinc , yinc , xstart , ystart , angle );
     geo_surface_init_regular( surface, NULL );
     return surface;
 }
 
 
-static void geo_surface_fload_irap_header( geo_surface_type * surface, FILE * stream ) {
+static void geo_surface_fload_irap_ascii_header( geo_surface_type * surface, FILE * stream ) {
   int const996;
   int ny,nx;
   double xinc, yinc,xstart, xend,ystart,yend,angle;
@@ -212,23 +312,212 @@ static void geo_surface_fload_irap_header( geo_surface_type * surface, FILE * st
         if (fscanf(stream , "%lg %lg %d %d %d %d %d %d %d " , &d , &d , &i, &i, &i, &i, &i, &i, &i) != 9)
           util_abort("%s: reading irap header failed \n",__func__ );
       }
+      geo_surface_init_header( surface , nx , ny , xinc , yinc , xstart , ystart , angle );
+    }  else
+    util_abort("%s: reading irap header failed\n",__func__ );
+}
 
-      surface->origo[0]  = xstart;
-      surface->origo[1]  = ystart;
-      surface->rot_angle = angle * __PI / 180.0;
-      surface->nx = nx;
-      surface->ny = ny;
 
-      surface->vec1[0] = xinc * cos( surface->rot_angle ) ;
-      surface->vec1[1] = xinc * sin( surface->rot_angle ) ;
+static bool geo_surface_host_little_endian( ) {
+  int one = 1;
+  return (*((char *) &one) == 1);
+}
 
-      surface->vec2[0] = -yinc * sin( surface->rot_angle ) ;
-      surface->vec2[1] =  yinc * cos( surface->rot_angle );
 
-      surface->cell_size[0] = xinc;
-      surface->cell_size[1] = yinc;
-    }  else
-    util_abort("%s: reading irap header failed\n",__func__ );
+static void geo_surface_irap_endian_flip( void * data , int num_words ) {
+  if (geo_surface_host_little_endian( ))
+    util_endian_flip_vector( data , sizeof( irap_word_type ) , num_words );
+}
+
+
+/**
+   Reads one Fortran record of at most @max_words four byte words into
+   @data; the data are in file byte order. Returns false if the record
+   is malformed, or larger than @max_words.
+*/
+
+static bool geo_surface_fread_irap_record( FILE * stream , void * data , int max_words , int * num_words) {
+  int head_marker , tail_marker;
+
+  if (fread( &head_marker , sizeof head_marker , 1 , stream ) != 1)
+    return false;
+  geo_surface_irap_endian_flip( &head_marker , 1 );
+
+  if ((head_marker < 0) || (head_marker % sizeof( irap_word_type )) || (head_marker > max_words * (int) sizeof( irap_word_type )))
+    return false;
+
+  *num_words = head_marker / sizeof( irap_word_type );
+  if (fread( data , sizeof( irap_word_type ) , *num_words , stream ) != *num_words)
+    return false;
+
+  if (fread( &tail_marker , sizeof tail_marker , 1 , stream ) != 1)
+    return false;
+  geo_surface_irap_endian_flip( &tail_marker , 1 );
+
+  return (head_marker == tail_marker);
+}
+
+
+/**
+   Writes @num_words four byte words from @data as one Fortran record;
+   the data are flipped to big endian in place.
+*/
+
+static void geo_surface_fwrite_irap_record( FILE * stream , void * data , int num_words) {
+  int marker = num_words * sizeof( irap_word_type );
+  geo_surface_irap_endian_flip( &marker , 1 );
+  geo_surface_irap_endian_flip( data , num_words );
+
+  util_fwrite( &marker , sizeof marker , 1 , stream , __func__ );
+  util_fwrite( data , sizeof( irap_word_type ) , num_words , stream , __func__ );
+  util_fwrite( &marker , sizeof marker , 1 , stream , __func__ );
+}
+
+
+/**
+   A binary IRAP file starts with the record marker of the 32 byte
+   first header record, whereas a formatted file starts with the text
+   "-996". The stream is repositioned at the start of the file.
+*/
+
+static bool geo_surface_fread_is_binary( FILE * stream ) {
+  bool binary = false;
+  int marker;
+
+  if (fread( &marker , sizeof marker , 1 , stream ) == 1) {
+    geo_surface_irap_endian_flip( &marker , 1 );
+    binary = (marker == 8 * sizeof( irap_word_type ));
+  }
+  util_fseek( stream , 0 , SEEK_SET );
+  return binary;
+}
+
+
+static void geo_surface_fload_irap_binary_header( geo_surface_type * surface, FILE * stream ) {
+  irap_word_type record1[8];
+  irap_word_type record2[4];
+  irap_word_type record3[7];
+  int num_words1 , num_words2 , num_words3;
+
+  if (geo_surface_fread_irap_record( stream , record1 , 8 , &num_words1 ) &&
+      geo_surface_fread_irap_record( stream , record2 , 4 , &num_words2 ) &&
+      geo_surface_fread_irap_record( stream , record3 , 7 , &num_words3 ) &&
+      (num_words1 == 8) && (num_words2 == 4) && (num_words3 == 7)) {
+
+    geo_surface_irap_endian_flip( record1 , 8 );
+    geo_surface_irap_endian_flip( record2 , 4 );
+    if (record1[0].i != IRAP_MAGIC)
+      util_abort("%s: reading binary irap header failed - invalid magic number:%d \n",__func__ , record1[0].i);
+
+    geo_surface_init_header( surface ,
+                             record2[0].i , record1[1].i ,   // nx , ny
+                             record1[6].f , record1[7].f ,   // xinc , yinc
+                             record1[2].f , record1[4].f ,   // xstart , ystart
+                             record2[1].f );                 // angle
+  } else
+    util_abort("%s: reading binary irap header failed\n",__func__ );
+}
+
+
+/*
+  Reads the header of an IRAP surface file, in either the formatted
+  or the binary variant, and returns true if the file is binary.
+*/
+
+static bool geo_surface_fload_irap_header( geo_surface_type * surface, FILE * stream ) {
+  bool binary = geo_surface_fread_is_binary( stream );
+  if (binary)
+    geo_surface_fload_irap_binary_header( surface , stream );
+  else
+    geo_surface_fload_irap_ascii_header( surface , stream );
+  return binary;
+}
+
+
+static bool geo_surface_fread_binary_zcoord( const geo_surface_type * surface , FILE * stream , double * zcoord) {
+  const int size = surface->nx * surface->ny;
+  float * data = util_calloc( size , sizeof * data );
+  int index = 0;
+  bool read_ok = true;
+
+  while (read_ok && (index < size)) {
+    int num_words;
+    read_ok = geo_surface_fread_irap_record( stream , &data[index] , size - index , &num_words );
+    index += num_words;
+  }
+
+  if (read_ok)
+    read_ok = (fgetc( stream ) == EOF); // no more data dangling at the end of the file.
+
+  if (read_ok) {
+    geo_surface_irap_endian_flip( data , size );
+    for (index = 0; index < size; index++)
+      zcoord[index] = data[index];
+  }
+
+  free( data );
+  return read_ok;
+}
+
+
+static bool geo_surface_fread_zcoord( const geo_surface_type * surface , FILE * stream , bool binary , double * zcoord) {
+  if (binary)
+    return geo_surface_fread_binary_zcoord( surface , stream , zcoord );
+  else
+    return geo_surface_fscanf_zcoord( surface , stream , zcoord );
+}
+
+
+
+static void geo_surface_fwrite_irap_binary__( const geo_surface_type * surface, const char * filename , const double * zcoord) {
+  FILE * stream = util_mkdir_fopen( filename , "w");
+  {
+    irap_word_type record1[8];
+    irap_word_type record2[4];
+    irap_word_type record3[7];
+
+    record1[0].i = IRAP_MAGIC;
+    record1[1].i = surface->ny;
+    record1[2].f = surface->origo[0];
+    record1[3].f = surface->origo[0] + surface->cell_size[0] * (surface->nx - 1);
+    record1[4].f = surface->origo[1];
+    record1[5].f = surface->origo[1] + surface->cell_size[1] * (surface->ny - 1);
+    record1[6].f = surface->cell_size[0];
+    record1[7].f = surface->cell_size[1];
+
+    record2[0].i = surface->nx;
+    record2[1].f = surface->rot_angle * 180 / __PI;
+    record2[2].f = surface->origo[0];
+    record2[3].f = surface->origo[1];
+
+    memset( record3 , 0 , sizeof record3 );
+
+    geo_surface_fwrite_irap_record( stream , record1 , 8 );
+    geo_surface_fwrite_irap_record( stream , record2 , 4 );
+    geo_surface_fwrite_irap_record( stream , record3 , 7 );
+  }
+
+  {
+    float * data = util_calloc( surface->nx , sizeof * data );
+    int ix,iy;
+    for (iy = 0; iy < surface->ny; iy++) {
+      for (ix = 0; ix < surface->nx; ix++)
+        data[ix] = zcoord[ix + iy * surface->nx];
+      geo_surface_fwrite_irap_record( stream , data , surface->nx );
+    }
+    free( data );
+  }
+  fclose( stream );
+}
+
+
+void geo_surface_fwrite_irap_binary( const geo_surface_type * surface, const char * filename ) {
+  const double * zcoord = geo_pointset_get_zcoord( surface->pointset );
+  geo_surface_fwrite_irap_binary__( surface , filename , zcoord );
+}
+
+void geo_surface_fwrite_irap_binary_external_zcoord( const geo_surface_type * surface, const char * filename , const double * zcoord) {
+  geo_surface_fwrite_irap_binary__( surface , filename , zcoord );
 }
 
 
@@ -237,13 +526,13 @@ static bool geo_surface_fload_irap( geo_surface_type * surface , const char * fi
   bool read_ok  = true;
   {
     FILE * stream = util_fopen( filename , "r");
-    geo_surface_fload_irap_header( surface , stream );
+    bool binary = geo_surface_fload_irap_header( surface , stream );
     {
       double * zcoord = NULL;
 
       if (loadz) {
         zcoord = util_calloc( surface->nx * surface->ny , sizeof * zcoord  );
-        read_ok = geo_surface_fscanf_zcoord( surface , stream , zcoord );
+        read_ok = geo_surface_fread_zcoord( surface , stream , binary , zcoord );
       }
 
       if (read_ok)
@@ -286,15 +575,16 @@ bool geo_surface_fload_irap_zcoord( const geo_surface_type * surface, const char
   FILE * stream = util_fopen__( filename , "r");
   if (stream) {
     bool loadOK = true;
+    bool binary;
     {
       geo_surface_type * tmp_surface = geo_surface_alloc_empty( false );
 
-      geo_surface_fload_irap_header( tmp_surface , stream );
+      binary = geo_surface_fload_irap_header( tmp_surface , stream );
       loadOK = geo_surface_equal_header( surface , tmp_surface );
       geo_surface_free( tmp_surface );
     }
     if (loadOK)
-      loadOK = geo_surface_fscanf_zcoord( surface , stream , zcoord);
+      loadOK = geo_surface_fread_zcoord( surface , stream , binary , zcoord);
 
     fclose( stream );
     return loadOK;
@@ -314,6 +604,29 @@ geo_surface_type * geo_surface_fload_alloc_irap( const char * filename , bool lo
 }
 
 
+/**
+   Will load the z values from @filename into a new surface which
+   shares the geometry with @base; i.e. when loading many surfaces with
+   the same header, e.g. one for each realization of an ensemble, the
+   x and y coordinates are only stored once. The @base surface must be
+   kept alive as long as the new surface is in use. Returns NULL if the
+   file can not be loaded, or the header does not agree with @base.
+*/
+
+geo_surface_type * geo_surface_fload_alloc_irap_shared( const geo_surface_type * base , const char * filename ) {
+  geo_surface_type * surface = util_malloc( sizeof * surface );
+  UTIL_TYPE_ID_INIT( surface , GEO_SURFACE_TYPE_ID )
+  geo_surface_copy_header( base , surface );
+  surface->pointset = geo_pointset_alloc_shared( base->pointset );
+
+  if (!geo_surface_fload_irap_zcoord( base , filename , geo_pointset_get_zcoord_ref( surface->pointset ))) {
+    geo_surface_free( surface );
+    surface = NULL;
+  }
+  return surface;
+}
+
+
 geo_surface_type * geo_surface_alloc_copy( const geo_surface_type * src , bool copy_zdata) {
   geo_surface_type * target = geo_surface_alloc_empty( true );
 
@@ -0,0 +1,145 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'geo_prepared_polygon.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
+
+#include <ert/geometry/geo_polygon.h>
+#include <ert/geometry/geo_prepared_polygon.h>
+
+
+/*
+  The prepared polygon should give exactly the same result as
+  geo_polygon_contains_point(), also for points on the vertices and
+  edges of the polygon.
+*/
+
+static void assert_equal_points( const geo_polygon_type * polygon , int num_points , const double * x , const double * y) {
+  geo_prepared_polygon_type * prepared = geo_prepared_polygon_alloc( polygon );
+  bool * inside = util_malloc( num_points * sizeof * inside );
+
+  test_assert_true( geo_prepared_polygon_is_instance( prepared ));
+  geo_prepared_polygon_contains_points( prepared , num_points , x , y , inside );
+  for (int i = 0; i < num_points; i++) {
+    bool expected = geo_polygon_contains_point( polygon , x[i] , y[i] );
+    test_assert_bool_equal( expected , inside[i] );
+    test_assert_bool_equal( expected , geo_prepared_polygon_contains_point( prepared , x[i] , y[i] ));
+  }
+
+
+#ifdef ERT_HAVE_THREAD_POOL
+  {
+    thread_pool_type * tp = thread_pool_alloc( 3 , true );
+    for (int iter = 0; iter < 2; iter++) {
+      bool * inside_mt = util_malloc( num_points * sizeof * inside_mt );
+      geo_prepared_polygon_contains_points_mt( prepared , num_points , x , y , inside_mt , tp );
+      for (int i = 0; i < num_points; i++)
+        test_assert_bool_equal( inside[i] , inside_mt[i] );
+      free( inside_mt );
+    }
+    thread_pool_free( tp );
+  }
+#endif
+
+  free( inside );
+  geo_prepared_polygon_free( prepared );
+}
+
+
+static void assert_equal( const geo_polygon_type * polygon , rng_type * rng , int num_points ) {
+  double * x = util_malloc( num_points * sizeof * x );
+  double * y = util_malloc( num_points * sizeof * y );
+  int size = geo_polygon_get_size( polygon );
+
+  for (int i = 0; i < num_points; i++) {
+    if (size > 0 && (i % 10) == 0)
+      geo_polygon_iget_xy( polygon , rng_get_int( rng , size ) , &x[i] , &y[i] );
+    else {
+      x[i] = 2.4 * rng_get_double( rng ) - 1.2;
+      y[i] = 2.4 * rng_get_double( rng ) - 1.2;
+    }
+  }
+
+  assert_equal_points( polygon , num_points , x , y );
+  free( x );
+  free( y );
+}
+
+
+void test_star( rng_type * rng , int num_corners , int num_points ) {
+  geo_polygon_type * polygon = geo_polygon_alloc( NULL );
+  for (int i = 0; i < num_corners; i++) {
+    double r = 0.2 + 0.8 * rng_get_double( rng );
+    double phi = 2 * M_PI * i / num_corners;
+    geo_polygon_add_point( polygon , r * cos( phi ) , r * sin( phi ));
+  }
+
+  assert_equal( polygon , rng , num_points );
+  geo_polygon_free( polygon );
+}
+
+
+void test_grid_aligned( rng_type * rng ) {
+  geo_polygon_type * polygon = geo_polygon_alloc( NULL );
+  double x[] = {0 , 0 , 1 , 1 , 0.5 , 0.5 , 0.5 , 0 };
+  double y[] = {0 , 1 , 1 , 0 , 0   , 0.5 , 0.5 , 0 };
+
+  for (int i = 0; i < 8; i++)
+    geo_polygon_add_point( polygon , x[i] , y[i] );
+
+  assert_equal_points( polygon , 8 , x , y );
+  assert_equal( polygon , rng , 5000 );
+  geo_polygon_free( polygon );
+}
+
+
+void test_empty( rng_type * rng ) {
+  geo_polygon_type * polygon = geo_polygon_alloc( NULL );
+  assert_equal( polygon , rng , 100 );
+
+  geo_polygon_add_point( polygon , 0.5 , 0.5 );
+  assert_equal( polygon , rng , 100 );
+  geo_polygon_free( polygon );
+}
+
+
+int main(int argc , char ** argv) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+
+  test_empty( rng );
+  test_grid_aligned( rng );
+  test_star( rng , 3 , 1000 );
+  test_star( rng , 50 , 20000 );
+  test_star( rng , 5000 , 20000 );
+
+  test_assert_int_equal( geo_prepared_polygon_get_num_threads( ) , 1 );
+  geo_prepared_polygon_set_num_threads( 4 );
+  test_assert_int_equal( geo_prepared_polygon_get_num_threads( ) , 4 );
+  test_star( rng , 50 , 20000 );
+
+  rng_free( rng );
+  exit(0);
+}
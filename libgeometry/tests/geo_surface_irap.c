@@ -0,0 +1,151 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'geo_surface_irap.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/geometry/geo_surface.h>
+
+#define NX 17
+#define NY 11
+
+
+static geo_surface_type * alloc_surface( double shift ) {
+  geo_surface_type * surface = geo_surface_alloc_new( NX , NY , 50.0 , 25.0 , 444230.0 , 6809537.0 , -30.0 );
+  for (int i = 0; i < NX * NY; i++)
+    geo_surface_iset_zvalue( surface , i , 1000 + shift + i * 0.25 );
+  return surface;
+}
+
+
+static void truncate_file( const char * src_file , const char * target_file , int bytes ) {
+  int size;
+  char * content = util_fread_alloc_file_content( src_file , &size );
+  FILE * stream = util_fopen( target_file , "w" );
+  util_fwrite( content , 1 , size - bytes , stream , __func__ );
+  fclose( stream );
+  free( content );
+}
+
+
+static void append_file( const char * src_file , const char * target_file , const char * extra ) {
+  int size;
+  char * content = util_fread_alloc_file_content( src_file , &size );
+  FILE * stream = util_fopen( target_file , "w" );
+  util_fwrite( content , 1 , size , stream , __func__ );
+  fprintf( stream , "%s" , extra );
+  fclose( stream );
+  free( content );
+}
+
+
+static void test_roundtrip( ) {
+  geo_surface_type * surface = alloc_surface( 0 );
+
+  geo_surface_fprintf_irap( surface , "surface.irap" );
+  geo_surface_fwrite_irap_binary( surface , "surface.irapbin" );
+  {
+    geo_surface_type * ascii_surface = geo_surface_fload_alloc_irap( "surface.irap" , true );
+    geo_surface_type * binary_surface = geo_surface_fload_alloc_irap( "surface.irapbin" , true );
+
+    test_assert_true( geo_surface_equal( surface , ascii_surface ));
+    test_assert_true( geo_surface_equal( surface , binary_surface ));
+
+    geo_surface_free( binary_surface );
+    geo_surface_free( ascii_surface );
+  }
+  geo_surface_free( surface );
+}
+
+
+static void test_zcoord( ) {
+  geo_surface_type * base = geo_surface_fload_alloc_irap( "surface.irap" , false );
+  double * zcoord = util_calloc( NX * NY , sizeof * zcoord );
+
+  test_assert_true( geo_surface_fload_irap_zcoord( base , "surface.irapbin" , zcoord ));
+  test_assert_double_equal( zcoord[NX * NY - 1] , 1000 + (NX * NY - 1) * 0.25 );
+
+  truncate_file( "surface.irap" , "short.irap" , 20 );
+  truncate_file( "surface.irapbin" , "short.irapbin" , 8 );
+  append_file( "surface.irap" , "long.irap" , " 1.0\n" );
+  append_file( "surface.irap" , "space.irap" , "\n\n   \n" );
+
+  test_assert_false( geo_surface_fload_irap_zcoord( base , "short.irap" , zcoord ));
+  test_assert_false( geo_surface_fload_irap_zcoord( base , "short.irapbin" , zcoord ));
+  test_assert_false( geo_surface_fload_irap_zcoord( base , "long.irap" , zcoord ));
+  test_assert_true( geo_surface_fload_irap_zcoord( base , "space.irap" , zcoord ));
+
+  geo_surface_fwrite_irap_binary_external_zcoord( base , "external.irapbin" , zcoord );
+  test_assert_true( geo_surface_fload_irap_zcoord( base , "external.irapbin" , zcoord ));
+  test_assert_double_equal( zcoord[1] , 1000.25 );
+
+  free( zcoord );
+  geo_surface_free( base );
+}
+
+
+static void test_shared( ) {
+  geo_surface_type * base = geo_surface_fload_alloc_irap( "surface.irap" , false );
+  geo_surface_type * surface = alloc_surface( 100 );
+
+  geo_surface_fwrite_irap_binary( surface , "shifted.irapbin" );
+  {
+    geo_surface_type * shared1 = geo_surface_fload_alloc_irap_shared( base , "surface.irap" );
+    geo_surface_type * shared2 = geo_surface_fload_alloc_irap_shared( base , "shifted.irapbin" );
+
+    test_assert_not_NULL( shared1 );
+    test_assert_not_NULL( shared2 );
+    test_assert_true( geo_surface_equal( surface , shared2 ));
+    test_assert_int_equal( geo_surface_get_size( shared1 ) , NX * NY );
+    test_assert_double_equal( geo_surface_iget_zvalue( shared1 , 10 ) , 1002.5 );
+    test_assert_double_equal( geo_surface_iget_zvalue( shared2 , 10 ) , 1102.5 );
+
+    geo_surface_isub( shared2 , shared1 );
+    test_assert_double_equal( geo_surface_iget_zvalue( shared2 , NX * NY - 1 ) , 100 );
+
+    test_assert_NULL( geo_surface_fload_alloc_irap_shared( base , "short.irapbin" ));
+    geo_surface_free( shared2 );
+    geo_surface_free( shared1 );
+  }
+
+  {
+    geo_surface_type * other = geo_surface_alloc_new( NX , NY , 50.0 , 25.0 , 0.0 , 0.0 , 0.0 );
+    geo_surface_fprintf_irap( other , "other.irap" );
+    test_assert_NULL( geo_surface_fload_alloc_irap_shared( base , "other.irap" ));
+    geo_surface_free( other );
+  }
+
+  geo_surface_free( surface );
+  geo_surface_free( base );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "geo_surface_irap" );
+
+  test_roundtrip( );
+  test_zcoord( );
+  test_shared( );
+
+  test_work_area_free( work_area );
+  exit( 0 );
+}
@@ -17,26 +17,58 @@
 */
 
 #include <sys/wait.h>
+#include <sys/syscall.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
 #include <pthread.h>
 #include <errno.h>
+#include <time.h>
 
 #include <ert/util/util.h>
-#include <ert/util/arg_pack.h>
+#include <ert/util/vector.h>
 
 #include <ert/job_queue/queue_driver.h>
 #include <ert/job_queue/local_driver.h>
 
 
+/*
+  The local driver starts the jobs directly with posix_spawn(), and
+  one reaper thread per driver waits for all the running jobs and
+  updates the status field of the jobs when they complete. The jobs
+  are started as leaders of a new process group, so that a kill will
+  also reach all the processes started by the job.
+
+  The reaper waits for the individual pids with waitpid(pid , WNOHANG)
+  instead of waitpid(-1) or SIGCHLD; the driver is running in a
+  process where other code (e.g. util_spawn_blocking() and Python)
+  also starts and waits for child processes, and a general wait would
+  steal their exit status.
+
+  Where the kernel supports pidfd_open() the reaper sleeps in poll()
+  on one pidfd per job, and on a pipe which is written to when a job
+  is submitted or the driver is freed; a pidfd becomes readable when
+  the process exits, without reaping it. Jobs without a pidfd (old
+  kernel, or the process had already been reaped) are checked with
+  waitpid() every LOCAL_DRIVER_REAP_USLEEP microseconds.
+*/
+
+#define LOCAL_DRIVER_REAP_USLEEP   20000
+#define LOCAL_DRIVER_KILL_TIMEOUT  5       /* Seconds from SIGTERM to SIGKILL when the driver is freed. */
+
+
 struct local_job_struct {
   UTIL_TYPE_ID_DECLARATION;
-  bool            active;
-  job_status_type status;
-  pthread_t       run_thread;
-  pid_t           child_process;
+  bool                 active;       /* The process has been started and not yet reaped. */
+  bool                 released;     /* The queue layer has called free_job(). */
+  job_status_type      status;
+  pid_t                child_process;
+  int                  pidfd;        /* -1 if pidfd_open() is not available. */
+  local_driver_type  * driver;
 };
 
 
@@ -45,8 +77,12 @@ struct local_job_struct {
 
 struct local_driver_struct {
   UTIL_TYPE_ID_DECLARATION;
-  pthread_attr_t     thread_attr;
-  pthread_mutex_t    submit_lock;
+  pthread_mutex_t    submit_lock;    /* Protects the active_jobs table and the job status fields. */
+  pthread_cond_t     job_cond;
+  pthread_t          reaper_thread;
+  bool               shutdown;
+  int                wakeup_pipe[2]; /* Written to wake the reaper from poll(). */
+  vector_type      * active_jobs;    /* Jobs with a process which has not been reaped; not owned. Only the reaper removes jobs. */
 };
 
 /*****************************************************************/
@@ -61,72 +97,213 @@ local_job_type * local_job_alloc() {
   job = util_malloc(sizeof * job );
   UTIL_TYPE_ID_INIT( job , LOCAL_JOB_TYPE_ID );
   job->active = false;
+  job->released = false;
   job->status = JOB_QUEUE_WAITING;
+  job->child_process = 0;
+  job->pidfd = -1;
+  job->driver = NULL;
   return job;
 }
 
 void local_job_free(local_job_type * job) {
-  if (job->active) {
-    /* Thread clean up */
-  }
+  if (job->pidfd >= 0)
+    close( job->pidfd );
   free(job);
 }
 
 
+static int local_job_pidfd_open( pid_t pid ) {
+#ifdef SYS_pidfd_open
+  int pidfd = syscall( SYS_pidfd_open , pid , 0 );
+  if (pidfd >= 0)
+    return pidfd;
+#endif
+  return -1;
+}
+
+
 
 job_status_type local_driver_get_job_status(void * __driver, void * __job) {
   if (__job == NULL) 
     /* The job has not been registered at all ... */
     return JOB_QUEUE_NOT_ACTIVE;
   else {
+    local_driver_type * driver = local_driver_safe_cast( __driver );
     local_job_type * job = local_job_safe_cast( __job );
-    return job->status;
+    job_status_type status;
+
+    pthread_mutex_lock( &driver->submit_lock );
+    status = job->status;
+    pthread_mutex_unlock( &driver->submit_lock );
+    return status;
   }
 }
 
 
+/**
+   The job is freed immediately if the process has been reaped;
+   otherwise it is marked as released and freed by the reaper thread
+   when the process completes.
+*/
 
 void local_driver_free_job( void * __job ) {
   local_job_type    * job    = local_job_safe_cast( __job );
-  local_job_free(job);
+  local_driver_type * driver = job->driver;
+
+  if (driver != NULL) {
+    bool free_job;
+    pthread_mutex_lock( &driver->submit_lock );
+    free_job = !job->active;
+    job->released = true;
+    pthread_mutex_unlock( &driver->submit_lock );
+
+    if (free_job)
+      local_job_free( job );
+  } else
+    local_job_free( job );
 }
 
 
+/**
+   Sends SIGTERM to the process group of the job, i.e. to the job and
+   all the processes it has started. The process is reaped by the
+   reaper thread as usual.
+*/
+
 void local_driver_kill_job( void * __driver , void * __job) {
-  local_job_type    * job  = local_job_safe_cast( __job );
+  local_driver_type * driver = local_driver_safe_cast( __driver );
+  local_job_type    * job    = local_job_safe_cast( __job );
   
+  pthread_mutex_lock( &driver->submit_lock );
   if (job->active) {
-    pthread_cancel( job->run_thread ); 
+    if (kill( -job->child_process , SIGTERM ) != 0)
+      kill( job->child_process , SIGTERM );
   }
-  
-  kill( job->child_process , SIGTERM );
+  pthread_mutex_unlock( &driver->submit_lock );
 }
 
 
-void * submit_job_thread__(void * __arg) {
-  arg_pack_type *arg_pack = arg_pack_safe_cast(__arg);
-  const char *executable = arg_pack_iget_const_ptr(arg_pack, 0);
-  /*
-    The arg_pack contains a run_path field as the second argument,
-    it has therefor been left here as a comment:
+/**
+   Reaps the job at position @index in the active_jobs table if the
+   process has completed; returns true if the job was removed from the
+   table. Must be called with the submit_lock held.
+*/
+
+static bool local_driver_try_reap( local_driver_type * driver , int index , int options ) {
+  local_job_type * job = vector_iget( driver->active_jobs , index );
+  int wait_status;
+  pid_t pid = waitpid( job->child_process , &wait_status , options );
 
-    const char * run_path    = arg_pack_iget_const_ptr(arg_pack , 1);
+  /*
+    ECHILD means that the process has already been reaped by
+    someone else, e.g. when SIGCHLD is ignored by the application.
   */
-  int argc = arg_pack_iget_int(arg_pack, 2);
-  char **argv = arg_pack_iget_ptr(arg_pack, 3);
-  local_job_type *job = arg_pack_iget_ptr(arg_pack, 4);
+  if ((pid == job->child_process) || ((pid < 0) && (errno == ECHILD))) {
+    job->status = JOB_QUEUE_DONE;
+    job->active = false;
+    if (job->pidfd >= 0) {
+      close( job->pidfd );
+      job->pidfd = -1;
+    }
+    vector_idel( driver->active_jobs , index );
+
+    if (job->released)
+      local_job_free( job );
+    return true;
+  } else
+    return false;
+}
 
-  {
-    int wait_status;
-    job->child_process = util_spawn(executable, argc, (const char**) argv, NULL, NULL);
-    util_free_stringlist(argv, argc);
-    arg_pack_free(arg_pack);
-    waitpid(job->child_process, &wait_status, 0);
+
+/**
+   Checks all the active jobs, and removes the jobs with a completed
+   process from the active_jobs table. Must be called with the
+   submit_lock held.
+*/
+
+static void local_driver_reap_jobs( local_driver_type * driver ) {
+  int index = 0;
+  while (index < vector_get_size( driver->active_jobs )) {
+    if (!local_driver_try_reap( driver , index , WNOHANG ))
+      index++;
   }
+}
 
-  job->status = JOB_QUEUE_DONE;
-  job->active = false;
-  pthread_exit(NULL);
+
+static void local_driver_drain_wakeup( local_driver_type * driver ) {
+  char buffer[64];
+  while (read( driver->wakeup_pipe[0] , buffer , sizeof buffer ) > 0)
+    ;
+}
+
+
+static void local_driver_wakeup( local_driver_type * driver ) {
+  char c = 0;
+  if (write( driver->wakeup_pipe[1] , &c , 1 ) < 0) {
+    /* EAGAIN: the pipe is full, and the reaper will wake up anyway. */
+  }
+}
+
+
+/*
+  The poll() is done without the submit_lock; while the lock is
+  released new jobs can be appended to active_jobs, but only the
+  reaper removes jobs, so the first num_jobs elements are still the
+  jobs in the pollfd table when the lock is retaken. They are checked
+  from the back, so that removing a job does not move the jobs which
+  have not yet been checked.
+*/
+
+static void * local_driver_reaper_thread__( void * arg ) {
+  local_driver_type * driver = local_driver_safe_cast( arg );
+  struct pollfd * fds = NULL;
+  int fds_size = 0;
+
+  pthread_mutex_lock( &driver->submit_lock );
+  while (true) {
+    while ((vector_get_size( driver->active_jobs ) == 0) && !driver->shutdown)
+      pthread_cond_wait( &driver->job_cond , &driver->submit_lock );
+
+    if (driver->shutdown)
+      break;
+
+    {
+      int num_jobs = vector_get_size( driver->active_jobs );
+      int timeout = -1;
+      int index;
+
+      if (num_jobs + 1 > fds_size) {
+        fds_size = 2 * (num_jobs + 1);
+        fds = util_realloc( fds , fds_size * sizeof * fds );
+      }
+
+      fds[0].fd = driver->wakeup_pipe[0];
+      fds[0].events = POLLIN;
+      for (index = 0; index < num_jobs; index++) {
+        const local_job_type * job = vector_iget_const( driver->active_jobs , index );
+        fds[index + 1].fd = job->pidfd;     /* A negative fd is ignored by poll(). */
+        fds[index + 1].events = POLLIN;
+        fds[index + 1].revents = 0;
+        if (job->pidfd < 0)
+          timeout = LOCAL_DRIVER_REAP_USLEEP / 1000;
+      }
+
+      pthread_mutex_unlock( &driver->submit_lock );
+      if (poll( fds , num_jobs + 1 , timeout ) < 0) {
+        for (index = 0; index < num_jobs; index++)
+          fds[index + 1].revents = POLLIN;   /* EINTR: check them all. */
+      }
+      local_driver_drain_wakeup( driver );
+      pthread_mutex_lock( &driver->submit_lock );
+
+      for (index = num_jobs - 1; index >= 0; index--) {
+        if ((fds[index + 1].fd < 0) || (fds[index + 1].revents != 0))
+          local_driver_try_reap( driver , index , WNOHANG );
+      }
+    }
+  }
+  pthread_mutex_unlock( &driver->submit_lock );
+  free( fds );
   return NULL;
 }
 
@@ -141,30 +318,81 @@ void * local_driver_submit_job(void * __driver           ,
                                const char ** argv ) {
   local_driver_type * driver = local_driver_safe_cast( __driver );
   {
-    local_job_type * job    = local_job_alloc();
-    arg_pack_type  * arg_pack = arg_pack_alloc();
-    arg_pack_append_const_ptr( arg_pack , submit_cmd);
-    arg_pack_append_const_ptr( arg_pack , run_path );
-    arg_pack_append_int( arg_pack , argc );
-    arg_pack_append_ptr( arg_pack , util_alloc_stringlist_copy( argv , argc ));   /* Due to conflict with threads and python GC we take a local copy. */
-    arg_pack_append_ptr( arg_pack , job );
+    local_job_type * job = local_job_alloc();
+    job->driver        = driver;
+    job->child_process = util_spawn_process_group( submit_cmd , argc , argv , NULL , NULL );
+    job->pidfd         = local_job_pidfd_open( job->child_process );
     
     pthread_mutex_lock( &driver->submit_lock );
     job->active = true;
     job->status = JOB_QUEUE_RUNNING;
-    
-    if (pthread_create( &job->run_thread , &driver->thread_attr , submit_job_thread__ , arg_pack) != 0) 
-      util_abort("%s: failed to create run thread - aborting \n",__func__);
-    
+    vector_append_ref( driver->active_jobs , job );
+    pthread_cond_signal( &driver->job_cond );
+    local_driver_wakeup( driver );
     pthread_mutex_unlock( &driver->submit_lock );
+
     return job;
   }
 }
 
 
+/**
+   Sends @sig to the process groups of all the jobs which are still
+   running. Must be called with the submit_lock held.
+*/
+
+static void local_driver_signal_jobs( local_driver_type * driver , int sig ) {
+  int index;
+  for (index = 0; index < vector_get_size( driver->active_jobs ); index++) {
+    const local_job_type * job = vector_iget_const( driver->active_jobs , index );
+    if (kill( -job->child_process , sig ) != 0)
+      kill( job->child_process , sig );
+  }
+}
+
+
+/**
+   Jobs which are still running when the driver is freed are killed
+   and reaped, so that they do not remain as zombies for the rest of
+   the process lifetime. They get SIGTERM first, and SIGKILL if they
+   are still running after LOCAL_DRIVER_KILL_TIMEOUT seconds. Jobs
+   which have been released with local_driver_free_job() are freed
+   when they are reaped; the job handles which have not been released
+   must be freed before the driver.
+*/
 
 void local_driver_free(local_driver_type * driver) {
-  pthread_attr_destroy ( &driver->thread_attr );
+  pthread_mutex_lock( &driver->submit_lock );
+  driver->shutdown = true;
+  pthread_cond_signal( &driver->job_cond );
+  local_driver_wakeup( driver );
+  pthread_mutex_unlock( &driver->submit_lock );
+  pthread_join( driver->reaper_thread , NULL );
+
+  local_driver_reap_jobs( driver );
+  if (vector_get_size( driver->active_jobs ) > 0) {
+    time_t kill_time = time( NULL );
+    local_driver_signal_jobs( driver , SIGTERM );
+    while (true) {
+      local_driver_reap_jobs( driver );
+      if (vector_get_size( driver->active_jobs ) == 0)
+        break;
+
+      if ((time( NULL ) - kill_time) >= LOCAL_DRIVER_KILL_TIMEOUT) {
+        local_driver_signal_jobs( driver , SIGKILL );
+        while (vector_get_size( driver->active_jobs ) > 0)
+          local_driver_try_reap( driver , 0 , 0 );
+        break;
+      }
+      util_usleep( LOCAL_DRIVER_REAP_USLEEP );
+    }
+  }
+
+  vector_free( driver->active_jobs );
+  close( driver->wakeup_pipe[0] );
+  close( driver->wakeup_pipe[1] );
+  pthread_cond_destroy( &driver->job_cond );
+  pthread_mutex_destroy( &driver->submit_lock );
   free(driver);
   driver = NULL;
 }
@@ -180,8 +408,22 @@ void * local_driver_alloc() {
   local_driver_type * local_driver = util_malloc(sizeof * local_driver );
   UTIL_TYPE_ID_INIT( local_driver , LOCAL_DRIVER_TYPE_ID);
   pthread_mutex_init( &local_driver->submit_lock , NULL );
-  pthread_attr_init( &local_driver->thread_attr );
-  pthread_attr_setdetachstate( &local_driver->thread_attr , PTHREAD_CREATE_DETACHED );
+  pthread_cond_init( &local_driver->job_cond , NULL );
+  local_driver->shutdown = false;
+  local_driver->active_jobs = vector_alloc_new();
+
+  if (pipe( local_driver->wakeup_pipe ) != 0)
+    util_abort("%s: failed to create pipe: %s \n",__func__ , strerror( errno ));
+  {
+    int i;
+    for (i = 0; i < 2; i++) {
+      fcntl( local_driver->wakeup_pipe[i] , F_SETFL , O_NONBLOCK );
+      fcntl( local_driver->wakeup_pipe[i] , F_SETFD , FD_CLOEXEC );
+    }
+  }
+
+  if (pthread_create( &local_driver->reaper_thread , NULL , local_driver_reaper_thread__ , local_driver ) != 0)
+    util_abort("%s: failed to create reaper thread - aborting \n",__func__);
   
   return local_driver;
 }
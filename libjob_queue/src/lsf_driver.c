@@ -205,27 +205,64 @@ long lsf_job_get_jobnr( const lsf_job_type * job ) {
   return job->lsf_jobnr;
 }
 
+/*
+  The output from bsub is of the form:
+
+     Job <12345> is submitted to default queue <normal>.
+
+  Returns 0 if a job id can not be found.
+*/
+
+static int lsf_job_scan_bsub_output(const char * output) {
+  int jobid = 0;
+  const char * start = strchr(output , '<');
+  if (start != NULL) {
+    const char * end = strchr(start , '>');
+    if (end != NULL) {
+      char * jobid_string = util_alloc_substring_copy( start , 1 , end - start - 1);
+      util_sscanf_int( jobid_string , &jobid);
+      free( jobid_string );
+    }
+  }
+  return jobid;
+}
+
+
 int lsf_job_parse_bsub_stdout(const char * bsub_cmd, const char * stdout_file) {
   int     jobid = 0;
   if ((util_file_exists(stdout_file)) && (util_file_size(stdout_file) > 0)) {
-    FILE * stream = util_fopen(stdout_file , "r");
-    if (util_fseek_string(stream , "<" , true , true)) {
-      char * jobid_string = util_fscanf_alloc_upto(stream , ">" , false);
-      if (jobid_string != NULL) {
-        util_sscanf_int( jobid_string , &jobid);
-        free( jobid_string );
-      }
-    }
-    fclose( stream );
+    char * file_content = util_fread_alloc_file_content( stdout_file , NULL );
+    jobid = lsf_job_scan_bsub_output( file_content );
 
     if (jobid == 0) {
-      char * file_content = util_fread_alloc_file_content( stdout_file , NULL );
       fprintf(stderr,"Failed to get lsf job id from file: %s \n",stdout_file );
       fprintf(stderr,"bsub command                      : %s \n",bsub_cmd );
       fprintf(stderr,"%s\n", file_content);
       free( file_content );
       util_abort("%s: \n",__func__);
     }
+    free( file_content );
+  }
+  return jobid;
+}
+
+
+/*
+  As lsf_job_parse_bsub_stdout(), but parses the bsub output directly
+  from a buffer.
+*/
+
+int lsf_job_parse_bsub_output(const char * bsub_cmd, const char * output) {
+  int jobid = 0;
+  if (strlen( output ) > 0) {
+    jobid = lsf_job_scan_bsub_output( output );
+
+    if (jobid == 0) {
+      fprintf(stderr,"Failed to get lsf job id from bsub output \n");
+      fprintf(stderr,"bsub command                      : %s \n",bsub_cmd );
+      fprintf(stderr,"%s\n", output);
+      util_abort("%s: \n",__func__);
+    }
   }
   return jobid;
 }
@@ -501,7 +538,7 @@ static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
                                        int           job_argc,
                                        const char ** job_argv) {
   int job_id;
-  char * tmp_file = util_alloc_tmp_file("/tmp" , "enkf-submit" , true);
+  char * output = NULL;
 
   {
     stringlist_type * remote_argv = lsf_driver_alloc_cmd( driver , lsf_stdout , job_name , submit_cmd , num_cpu , job_argc , job_argv);
@@ -514,7 +551,7 @@ static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
       if (driver->debug_output)
         printf("Submitting: %s %s %s \n",driver->rsh_cmd , argv[0] , argv[1]);
 
-      util_spawn_blocking(driver->rsh_cmd, 2, (const char **) argv, tmp_file, NULL);
+      util_spawn_capture(driver->rsh_cmd, 2, (const char **) argv, &output, NULL, 0);
 
       free( argv[1] );
       free( argv );
@@ -526,16 +563,19 @@ static int lsf_driver_submit_shell_job(lsf_driver_type * driver ,
         stringlist_fprintf(remote_argv , " " , stdout);
         printf("\n");
       }
-      util_spawn_blocking(driver->bsub_cmd, stringlist_get_size( remote_argv), (const char **) argv, tmp_file, tmp_file);
+      util_spawn_capture(driver->bsub_cmd, stringlist_get_size( remote_argv), (const char **) argv, &output, &output, 0);
       free( argv );
     }
 
     stringlist_free( remote_argv );
   }
 
-  job_id = lsf_job_parse_bsub_stdout(driver->bsub_cmd , tmp_file);
-  util_unlink_existing( tmp_file );
-  free(tmp_file);
+  if (output != NULL) {
+    job_id = lsf_job_parse_bsub_output(driver->bsub_cmd , output);
+    free( output );
+  } else
+    job_id = 0;
+
   return job_id;
 }
 
@@ -553,49 +593,48 @@ static int lsf_driver_get_status__(lsf_driver_type * driver , const char * statu
 
 
 static void lsf_driver_update_bjobs_table(lsf_driver_type * driver) {
-  char * tmp_file   = util_alloc_tmp_file("/tmp" , "enkf-bjobs" , true);
+  char * output = NULL;
 
   if (driver->submit_method == LSF_SUBMIT_REMOTE_SHELL) {
     char ** argv = util_calloc( 2 , sizeof * argv);
     argv[0] = driver->remote_lsf_server;
     argv[1] = util_alloc_sprintf("%s -a" , driver->bjobs_cmd);
-    util_spawn_blocking(driver->rsh_cmd, 2, (const char **) argv, tmp_file, NULL);
+    util_spawn_capture(driver->rsh_cmd, 2, (const char **) argv, &output, NULL, 0);
     free( argv[1] );
     free( argv );
   } else if (driver->submit_method == LSF_SUBMIT_LOCAL_SHELL) {
     char ** argv = util_calloc( 1 , sizeof * argv);
     argv[0] = "-a";
-    util_spawn_blocking(driver->bjobs_cmd, 1, (const char **) argv, tmp_file, NULL);
+    util_spawn_capture(driver->bjobs_cmd, 1, (const char **) argv, &output, NULL, 0);
     free( argv );
   }
 
-  {
+  hash_clear(driver->bjobs_cache);
+  if (output != NULL) {
     char user[32];
     char status[16];
-    FILE *stream = util_fopen(tmp_file , "r");;
-    bool at_eof = false;
-    hash_clear(driver->bjobs_cache);
-    util_fskip_lines(stream , 1);
-    while (!at_eof) {
-      char * line = util_fscanf_alloc_line(stream , &at_eof);
-      if (line != NULL) {
-        int  job_id_int;
-
-        if (sscanf(line , "%d %s %s", &job_id_int , user , status) == 3) {
-          char * job_id = util_alloc_sprintf("%d" , job_id_int);
-
-          if (hash_has_key( driver->my_jobs , job_id ))   /* Consider only jobs submitted by this ERT instance - not old jobs lying around from the same user. */
-            hash_insert_int(driver->bjobs_cache , job_id , lsf_driver_get_status__( driver , status , job_id));
-
-          free(job_id);
-        }
-        free(line);
+    /* The first line is the header line. */
+    char * line = strchr( output , '\n' );
+
+    while (line != NULL) {
+      char * next_line = strchr( ++line , '\n' );
+      int  job_id_int;
+
+      if (next_line != NULL)
+        *next_line = '\0';
+
+      if (sscanf(line , "%d %31s %15s", &job_id_int , user , status) == 3) {
+        char * job_id = util_alloc_sprintf("%d" , job_id_int);
+
+        if (hash_has_key( driver->my_jobs , job_id ))   /* Consider only jobs submitted by this ERT instance - not old jobs lying around from the same user. */
+          hash_insert_int(driver->bjobs_cache , job_id , lsf_driver_get_status__( driver , status , job_id));
+
+        free(job_id);
       }
+      line = next_line;
     }
-    fclose(stream);
+    free( output );
   }
-  util_unlink_existing(tmp_file);
-  free(tmp_file);
 }
 
 
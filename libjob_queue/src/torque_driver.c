@@ -15,12 +15,17 @@
    See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
    for more details.
  */
+#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <time.h>
+#include <pthread.h>
 
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
+#include <ert/util/hash.h>
+#include <ert/util/stringlist.h>
 
 #include <ert/job_queue/torque_driver.h>
 
@@ -44,12 +49,21 @@ struct torque_driver_struct {
   char * cluster_label;
   int    submit_sleep;
   FILE * debug_stream;
+
+  int               qstat_refresh_interval;
+  char            * qstat_refresh_interval_char;
+  time_t            last_qstat_update;
+  bool              qstat_stale;        /* Set when a job is submitted or killed; forces a refresh on the next status query. */
+  hash_type       * qstat_jobs;         /* The jobs which are still polled with qstat; i.e. not completed, killed or freed. */
+  hash_type       * qstat_cache;        /* The status of the jobs from the last qstat call. */
+  pthread_mutex_t   qstat_mutex;
 };
 
 struct torque_job_struct {
   UTIL_TYPE_ID_DECLARATION;
   long int torque_jobnr;
   char * torque_jobnr_char;
+  torque_driver_type * driver;          /* The driver whose qstat tables hold the job; NULL if the submit failed. Must outlive the job. */
 };
 
 UTIL_SAFE_CAST_FUNCTION(torque_driver, TORQUE_DRIVER_TYPE_ID);
@@ -73,6 +87,12 @@ void * torque_driver_alloc() {
   torque_driver->cluster_label = NULL;
   torque_driver->job_prefix = NULL;
   torque_driver->debug_stream = NULL;
+  torque_driver->qstat_refresh_interval_char = NULL;
+  torque_driver->last_qstat_update = 0;
+  torque_driver->qstat_stale = true;
+  torque_driver->qstat_jobs = hash_alloc();
+  torque_driver->qstat_cache = hash_alloc();
+  pthread_mutex_init( &torque_driver->qstat_mutex , NULL );
 
   torque_driver_set_option(torque_driver, TORQUE_QSUB_CMD, TORQUE_DEFAULT_QSUB_CMD);
   torque_driver_set_option(torque_driver, TORQUE_QSTAT_CMD, TORQUE_DEFAULT_QSTAT_CMD);
@@ -80,6 +100,7 @@ void * torque_driver_alloc() {
   torque_driver_set_option(torque_driver, TORQUE_NUM_CPUS_PER_NODE, "1");
   torque_driver_set_option(torque_driver, TORQUE_NUM_NODES, "1");
   torque_driver_set_option(torque_driver, TORQUE_SUBMIT_SLEEP, TORQUE_DEFAULT_SUBMIT_SLEEP);
+  torque_driver_set_option(torque_driver, TORQUE_QSTAT_REFRESH_INTERVAL, TORQUE_DEFAULT_QSTAT_REFRESH_INTERVAL);
 
   return torque_driver;
 }
@@ -101,6 +122,7 @@ static void torque_driver_set_qsub_cmd(torque_driver_type * driver, const char *
 
 static void torque_driver_set_qstat_cmd(torque_driver_type * driver, const char * qstat_cmd) {
   driver->qstat_cmd = util_realloc_string_copy(driver->qstat_cmd, qstat_cmd);
+  driver->qstat_stale = true;
 }
 
 static void torque_driver_set_qdel_cmd(torque_driver_type * driver, const char * qdel_cmd) {
@@ -121,6 +143,22 @@ static bool torque_driver_set_submit_sleep(torque_driver_type * driver, const ch
 }
 
 
+void torque_driver_set_qstat_refresh_interval(torque_driver_type * driver, int refresh_interval) {
+  driver->qstat_refresh_interval = refresh_interval;
+  util_safe_free(driver->qstat_refresh_interval_char);
+  driver->qstat_refresh_interval_char = util_alloc_sprintf("%d", refresh_interval);
+}
+
+static bool torque_driver_set_qstat_refresh_interval_option(torque_driver_type * driver, const char* refresh_interval_char) {
+  int refresh_interval;
+  if (util_sscanf_int(refresh_interval_char, &refresh_interval) && (refresh_interval >= 0)) {
+    torque_driver_set_qstat_refresh_interval(driver, refresh_interval);
+    return true;
+  } else
+    return false;
+}
+
+
 static bool torque_driver_set_num_nodes(torque_driver_type * driver, const char* num_nodes_char) {
   int num_nodes = 0;
   if (util_sscanf_int(num_nodes_char, &num_nodes)) {
@@ -188,6 +226,8 @@ bool torque_driver_set_option(void * __driver, const char * option_key, const vo
       torque_driver_set_debug_output(driver, value);
     else if (strcmp(TORQUE_SUBMIT_SLEEP, option_key) == 0)
       option_set = torque_driver_set_submit_sleep(driver, value);
+    else if (strcmp(TORQUE_QSTAT_REFRESH_INTERVAL, option_key) == 0)
+      option_set = torque_driver_set_qstat_refresh_interval_option(driver, value);
     else
       option_set = false;
   }
@@ -215,6 +255,8 @@ const void * torque_driver_get_option(const void * __driver, const char * option
       return driver->cluster_label;
     else if(strcmp(TORQUE_JOB_PREFIX_KEY, option_key) == 0)
       return driver->job_prefix;
+    else if(strcmp(TORQUE_QSTAT_REFRESH_INTERVAL, option_key) == 0)
+      return driver->qstat_refresh_interval_char;
     else {
       util_abort("%s: option_id:%s not recognized for TORQUE driver \n", __func__, option_key);
       return NULL;
@@ -232,6 +274,7 @@ void torque_driver_init_option_list(stringlist_type * option_list) {
   stringlist_append_ref(option_list, TORQUE_KEEP_QSUB_OUTPUT);
   stringlist_append_ref(option_list, TORQUE_CLUSTER_LABEL);
   stringlist_append_ref(option_list, TORQUE_JOB_PREFIX_KEY);
+  stringlist_append_ref(option_list, TORQUE_QSTAT_REFRESH_INTERVAL);
 }
 
 torque_job_type * torque_job_alloc() {
@@ -239,6 +282,7 @@ torque_job_type * torque_job_alloc() {
   job = util_malloc(sizeof * job);
   job->torque_jobnr_char = NULL;
   job->torque_jobnr = 0;
+  job->driver = NULL;
   UTIL_TYPE_ID_INIT(job, TORQUE_JOB_TYPE_ID);
 
   return job;
@@ -297,25 +341,29 @@ static void torque_debug(const torque_driver_type * driver , const char * fmt ,
 }
 
 
-static int torque_job_parse_qsub_stdout(const torque_driver_type * driver, const char * stdout_file) {
+/**
+   The output from qsub is the job id, e.g. "1612427.server"; the
+   numeric part before the first '.' is returned.
+*/
+
+static int torque_job_parse_qsub_output(const torque_driver_type * driver, const char * output) {
   int jobid;
   {
-    FILE * stream = util_fopen(stdout_file, "r");
-    char * jobid_string = util_fscanf_alloc_upto(stream, ".", false);
+    const char * dot_ptr = strchr(output, '.');
+    char * jobid_string = NULL;
+
+    if (dot_ptr != NULL)
+      jobid_string = util_alloc_substring_copy(output, 0, dot_ptr - output);
 
     torque_debug(driver, "Torque job ID string: '%s'", jobid_string);
 
     if (jobid_string == NULL || !util_sscanf_int(jobid_string, &jobid)) {
-
-      char * file_content = util_fread_alloc_file_content(stdout_file, NULL);
-      fprintf(stderr, "Failed to get torque job id from file: %s \n", stdout_file);
+      fprintf(stderr, "Failed to get torque job id from qsub output\n");
       fprintf(stderr, "qsub command                      : %s \n", driver->qsub_cmd);
-      fprintf(stderr, "File content: [%s]\n", file_content);
-      free(file_content);
+      fprintf(stderr, "Output: [%s]\n", output);
       util_exit("%s: \n", __func__);
     }
     free(jobid_string);
-    fclose(stream);
   }
   return jobid;
 }
@@ -361,12 +409,10 @@ static int torque_driver_submit_shell_job(torque_driver_type * driver,
   usleep( driver->submit_sleep );
   {
     int job_id;
-    char * tmp_std_file = util_alloc_tmp_file("/tmp", "enkf-submit-std", true);
-    char * tmp_err_file = util_alloc_tmp_file("/tmp", "enkf-submit-err", true);
+    char * qsub_stdout = NULL;
+    char * qsub_stderr = NULL;
     char * script_filename = util_alloc_filename(run_path, "qsub_script", "sh");
 
-    torque_debug(driver, "Setting up submit stdout target '%s' for '%s'", tmp_std_file, script_filename);
-    torque_debug(driver, "Setting up submit stderr target '%s' for '%s'", tmp_err_file, script_filename);
     torque_job_create_submit_script(script_filename, submit_cmd, job_argc, job_argv);
     {
       int p_units_from_driver = driver->num_cpus_per_node * driver->num_nodes;
@@ -378,21 +424,21 @@ static int torque_driver_submit_shell_job(torque_driver_type * driver,
         stringlist_type * remote_argv = torque_driver_alloc_cmd(driver, job_name, script_filename);
         torque_debug(driver, "Submit arguments: %s", stringlist_alloc_joined_string(remote_argv, " "));
         char ** argv = stringlist_alloc_char_ref(remote_argv);
-        int status = util_spawn_blocking(driver->qsub_cmd, stringlist_get_size(remote_argv), (const char **) argv, tmp_std_file, tmp_err_file);
+        int status = util_spawn_capture(driver->qsub_cmd, stringlist_get_size(remote_argv), (const char **) argv, &qsub_stdout, &qsub_stderr, 0);
         if (status != 0) {
           torque_debug_spawn_status_info(driver, status);
+          torque_debug(driver, "qsub stderr: %s", qsub_stderr);
         }
         free(argv);
         stringlist_free(remote_argv);
       }
     }
 
-    job_id = torque_job_parse_qsub_stdout(driver, tmp_std_file);
+    job_id = torque_job_parse_qsub_output(driver, qsub_stdout);
 
-    util_unlink_existing(tmp_std_file);
-    util_unlink_existing(tmp_err_file);
-    free(tmp_std_file);
-    free(tmp_err_file);
+    free(qsub_stdout);
+    free(qsub_stderr);
+    free(script_filename);
 
     return job_id;
   }
@@ -404,9 +450,29 @@ void torque_job_free(torque_job_type * job) {
   free(job);
 }
 
+/*
+  Removes the job from the qstat tables of the driver; must be called
+  with the qstat_mutex held.
+*/
+
+static void torque_driver_forget_job__(torque_driver_type * driver, const char * jobnr) {
+  if (hash_has_key( driver->qstat_jobs , jobnr ))
+    hash_del( driver->qstat_jobs , jobnr );
+
+  if (hash_has_key( driver->qstat_cache , jobnr ))
+    hash_del( driver->qstat_cache , jobnr );
+}
+
+
 void torque_driver_free_job(void * __job) {
 
   torque_job_type * job = torque_job_safe_cast(__job);
+  if (job->driver != NULL) {
+    torque_driver_type * driver = job->driver;
+    pthread_mutex_lock( &driver->qstat_mutex );
+    torque_driver_forget_job__( driver , job->torque_jobnr_char );
+    pthread_mutex_unlock( &driver->qstat_mutex );
+  }
   torque_job_free(job);
 }
 
@@ -431,6 +497,14 @@ void * torque_driver_submit_job(void * __driver,
     job->torque_jobnr = torque_driver_submit_shell_job(driver, run_path, local_job_name, submit_cmd, num_cpu, argc, argv);
     job->torque_jobnr_char = util_alloc_sprintf("%ld", job->torque_jobnr);
 
+    if (job->torque_jobnr > 0) {
+      pthread_mutex_lock( &driver->qstat_mutex );
+      hash_insert_ref( driver->qstat_jobs , job->torque_jobnr_char , NULL );
+      driver->qstat_stale = true;
+      job->driver = driver;
+      pthread_mutex_unlock( &driver->qstat_mutex );
+    }
+
     torque_debug( driver , "Job:%s Id:%d" , run_path , job->torque_jobnr);
     free(local_job_name);
   }
@@ -448,38 +522,54 @@ void * torque_driver_submit_job(void * __driver,
 }
 
 /**
-   Will return NULL if "something" fails; that again will be
-   translated to JOB_QUEUE_STATUS_FAILURE - which the queue layer will
-   just interpret as "No change in status". Possible failures are:
+   Parses one job line from the output of qstat:
 
-    1. The file capturing stdout is not created.
-    2. Can not extract the correct status string from the stdout file.
+     Job id                    Name             User            Time Use S Queue
+     ------------------------- ---------------- --------------- -------- - -----
+     1612427.st-lcmm           ...130getupdates fama            00:00:01 R normal
 
+   The job number, without the server part, is copied to @jobnr
+   (which must hold at least 32 characters). Returns
+   JOB_QUEUE_STATUS_FAILURE if the line can not be parsed, or the
+   status is not recognized.
 */
 
-static job_status_type torque_driver_get_qstat_status(torque_driver_type * driver, const char * jobnr_char) {
-  char * tmp_file = util_alloc_tmp_file("/tmp", "enkf-qstat", true);
+static job_status_type torque_driver_parse_status_line(const char * line, char * jobnr) {
   job_status_type status = JOB_QUEUE_STATUS_FAILURE;
-
-  {
-    const char ** argv = util_calloc(1, sizeof * argv);
-    argv[0] = jobnr_char;
-
-    util_spawn_blocking(driver->qstat_cmd, 1, (const char **) argv, tmp_file, NULL);
-    free(argv);
+  char job_id_full_string[32];
+  char string_status[16];
+
+  jobnr[0] = '\0';
+  if (sscanf(line, "%31s %*s %*s %*s %15s %*s", job_id_full_string, string_status) == 2) {
+    const char *dotPtr = strchr(job_id_full_string, '.');
+    if (dotPtr != NULL) {
+      int dotPosition = dotPtr - job_id_full_string;
+      memcpy(jobnr, job_id_full_string, dotPosition);
+      jobnr[dotPosition] = '\0';
+
+      switch( string_status[0] ) {
+      case 'R':
+        status = JOB_QUEUE_RUNNING;
+        break;
+
+      case 'E':
+        status = JOB_QUEUE_DONE;
+        break;
+
+      case 'C':
+        status = JOB_QUEUE_DONE;
+        break;
+
+      case 'Q':
+        status = JOB_QUEUE_PENDING;
+        break;
+      }
+    }
   }
-
-  if (util_file_exists( tmp_file )) {
-    status = torque_driver_parse_status( tmp_file , jobnr_char);
-    unlink(tmp_file);
-  } else
-    fprintf(stderr, "No such file: %s - reading qstat status failed \n", tmp_file );
-
-  free(tmp_file);
-
   return status;
 }
 
+
 job_status_type torque_driver_parse_status(const char * qstat_file, const char * jobnr_char) {
   int status = JOB_QUEUE_STATUS_FAILURE;
 
@@ -494,54 +584,190 @@ job_status_type torque_driver_parse_status(const char * qstat_file, const char *
     }
 
     if (line) {
-      char job_id_full_string[32];
-      char   string_status[2];
+      char jobnr[32];
+      job_status_type line_status = torque_driver_parse_status_line(line, jobnr);
+      if (util_string_equal(jobnr, jobnr_char))
+        status = line_status;
+      free(line);
+    }
+  }
+  if (status == JOB_QUEUE_STATUS_FAILURE)
+    fprintf(stderr,"** Warning: failed to get job status for job:%s from file:%s\n",jobnr_char , qstat_file );
+
+  return status;
+}
+
+
+/*
+  Collects the job numbers from the "qstat: Unknown Job Id 1612427.st-lcmm"
+  messages on stderr; newer Torque versions write "Unknown Job Id Error".
+*/
+
+static void torque_driver_parse_unknown_jobs(const char * stderr_output, hash_type * unknown_jobs) {
+  const char * tag = "Unknown Job Id";
+  const char * ptr = stderr_output;
 
-      if (sscanf(line, "%s %*s %*s %*s %s %*s", job_id_full_string, string_status) == 2) {
-        const char *dotPtr = strchr(job_id_full_string, '.');
-        int dotPosition = dotPtr - job_id_full_string;
+  while ((ptr != NULL) && ((ptr = strstr( ptr , tag )) != NULL)) {
+    const char * line_end = strchr( ptr , '\n' );
+    const char * job_id = (line_end != NULL) ? line_end : ptr + strlen( ptr );
 
-        {
-          char* job_id_as_char_ptr = util_alloc_substring_copy(job_id_full_string, 0, dotPosition);
-          if (util_string_equal(job_id_as_char_ptr, jobnr_char)) {
+    /* The job id is the last word on the line. */
+    while ((job_id > ptr) && isspace( job_id[-1] ))
+      job_id--;
+    {
+      const char * id_end = job_id;
+      while ((job_id > ptr) && !isspace( job_id[-1] ))
+        job_id--;
+
+      {
+        char * jobnr = util_alloc_substring_copy( job_id , 0 , id_end - job_id );
+        char * dot = strchr( jobnr , '.' );
+        if (dot != NULL)
+          *dot = '\0';
+        hash_insert_ref( unknown_jobs , jobnr , NULL );
+        free( jobnr );
+      }
+    }
+    ptr = line_end;
+  }
+}
 
-            switch( string_status[0] ) {
-            case 'R':
-              status = JOB_QUEUE_RUNNING;
-              break;
 
-            case 'E':
-              status = JOB_QUEUE_DONE;
-              break;
+/**
+   Calls qstat once with all the jobs which are still polled, and
+   updates the status cache from the output. Jobs which have completed
+   are not polled any longer, but their status is retained in the cache
+   until the job is freed.
+
+   Torque purges completed jobs immediately unless keep_completed is set
+   on the server, so a job which qstat no longer knows is assumed to
+   have finished - as the LSF driver does. It is reported as
+   JOB_QUEUE_DONE, and the queue layer decides between success and
+   failure. A job is considered unknown when qstat listed the jobs
+   without it, or explicitly reported an unknown job id for it. If qstat
+   failed altogether the job is polled again, and the status query
+   returns JOB_QUEUE_STATUS_FAILURE, which the queue layer interprets as
+   "No change in status".
+
+   Must be called with the qstat_mutex held.
+*/
 
-            case 'C':
-              status = JOB_QUEUE_DONE;
-              break;
+static void torque_driver_update_qstat_cache(torque_driver_type * driver) {
+  stringlist_type * polled_jobs;
+  hash_type * listed_jobs;
+  hash_type * unknown_jobs;
+  bool job_list_valid = false;
+  char * output = NULL;
+  char * error_output = NULL;
 
-            case 'Q':
-              status = JOB_QUEUE_PENDING;
-              break;
-            }
+  /* Without any job ids qstat would list all the jobs on the server. */
+  if (hash_get_size( driver->qstat_jobs ) == 0)
+    return;
 
-            free(job_id_as_char_ptr);
-          }
+  polled_jobs = hash_alloc_stringlist( driver->qstat_jobs );
+  listed_jobs = hash_alloc( );
+  unknown_jobs = hash_alloc( );
+
+  {
+    char ** argv = stringlist_alloc_char_ref( polled_jobs );
+    util_spawn_capture(driver->qstat_cmd, stringlist_get_size( polled_jobs ), (const char **) argv, &output, &error_output, 0);
+    free(argv);
+  }
+
+  {
+    int i;
+    for (i = 0; i < stringlist_get_size( polled_jobs ); i++) {
+      const char * jobnr = stringlist_iget( polled_jobs , i );
+      if (hash_has_key( driver->qstat_cache , jobnr ))
+        hash_del( driver->qstat_cache , jobnr );
+    }
+  }
+
+  {
+    /* The first two lines are header lines. */
+    char * line = strchr( output , '\n' );
+    if (line != NULL)
+      line = strchr( line + 1 , '\n' );
+
+    if (line != NULL)
+      job_list_valid = true;
+
+    while (line != NULL) {
+      char * next_line = strchr( ++line , '\n' );
+      char jobnr[32];
+      job_status_type status;
+
+      if (next_line != NULL)
+        *next_line = '\0';
+
+      status = torque_driver_parse_status_line(line, jobnr);
+      if (jobnr[0] != '\0')
+        hash_insert_ref( listed_jobs , jobnr , NULL );
+
+      if ((status != JOB_QUEUE_STATUS_FAILURE) && hash_has_key( driver->qstat_jobs , jobnr )) {
+        hash_insert_int( driver->qstat_cache , jobnr , status );
+        if (status == JOB_QUEUE_DONE)
+          hash_del( driver->qstat_jobs , jobnr );
+      }
+      line = next_line;
+    }
+  }
+
+  if (error_output != NULL)
+    torque_driver_parse_unknown_jobs( error_output , unknown_jobs );
+
+  {
+    int i;
+    for (i = 0; i < stringlist_get_size( polled_jobs ); i++) {
+      const char * jobnr = stringlist_iget( polled_jobs , i );
+      if (!hash_has_key( listed_jobs , jobnr )) {
+        if (job_list_valid || hash_has_key( unknown_jobs , jobnr )) {
+          fprintf(stderr,"** Warning: job:%s is not known by qstat - assuming it is finished.\n", jobnr);
+          hash_insert_int( driver->qstat_cache , jobnr , JOB_QUEUE_DONE );
+          hash_del( driver->qstat_jobs , jobnr );
         }
       }
-      free(line);
     }
   }
-  if (status == JOB_QUEUE_STATUS_FAILURE)
-    fprintf(stderr,"** Warning: failed to get job status for job:%s from file:%s\n",jobnr_char , qstat_file );
 
-  return status;
+  torque_debug( driver , "qstat status updated for %d jobs" , stringlist_get_size( polled_jobs ));
+  free(output);
+  util_safe_free(error_output);
+  hash_free( unknown_jobs );
+  hash_free( listed_jobs );
+  stringlist_free( polled_jobs );
 }
 
 
+/**
+   The status of all the jobs is fetched with one qstat call, and
+   cached for qstat_refresh_interval seconds. Submitting or killing a
+   job, or changing the qstat command, invalidates the cache.
+*/
 
 job_status_type torque_driver_get_job_status(void * __driver, void * __job) {
   torque_driver_type * driver = torque_driver_safe_cast(__driver);
   torque_job_type * job = torque_job_safe_cast(__job);
-  return torque_driver_get_qstat_status(driver, job->torque_jobnr_char);
+  job_status_type status = JOB_QUEUE_STATUS_FAILURE;
+
+  pthread_mutex_lock( &driver->qstat_mutex );
+  {
+    bool update_cache = (driver->qstat_stale ||
+                         (difftime(time(NULL) , driver->last_qstat_update) > driver->qstat_refresh_interval));
+    if (update_cache) {
+      torque_driver_update_qstat_cache( driver );
+      driver->last_qstat_update = time(NULL);
+      driver->qstat_stale = false;
+    }
+
+    if (hash_has_key( driver->qstat_cache , job->torque_jobnr_char ))
+      status = hash_get_int( driver->qstat_cache , job->torque_jobnr_char );
+    else
+      fprintf(stderr,"** Warning: failed to get job status for job:%s from %s\n",job->torque_jobnr_char , driver->qstat_cmd );
+  }
+  pthread_mutex_unlock( &driver->qstat_mutex );
+
+  return status;
 }
 
 
@@ -550,6 +776,15 @@ void torque_driver_kill_job(void * __driver, void * __job) {
   torque_driver_type * driver = torque_driver_safe_cast(__driver);
   torque_job_type * job = torque_job_safe_cast(__job);
   util_spawn_blocking(driver->qdel_cmd, 1, (const char **) &job->torque_jobnr_char, NULL, NULL);
+
+  /* A killed job is not polled any more; it has exited without completing. */
+  pthread_mutex_lock( &driver->qstat_mutex );
+  if (hash_has_key( driver->qstat_jobs , job->torque_jobnr_char )) {
+    hash_del( driver->qstat_jobs , job->torque_jobnr_char );
+    hash_insert_int( driver->qstat_cache , job->torque_jobnr_char , JOB_QUEUE_EXIT );
+  }
+  driver->qstat_stale = true;
+  pthread_mutex_unlock( &driver->qstat_mutex );
 }
 
 void torque_driver_free(torque_driver_type * driver) {
@@ -560,9 +795,13 @@ void torque_driver_free(torque_driver_type * driver) {
   free(driver->qsub_cmd);
   free(driver->num_cpus_per_node_char);
   free(driver->num_nodes_char);
+  free(driver->qstat_refresh_interval_char);
   if (driver->job_prefix)
     free(driver->job_prefix);
 
+  hash_free(driver->qstat_jobs);
+  hash_free(driver->qstat_cache);
+  pthread_mutex_destroy(&driver->qstat_mutex);
   free(driver);
 }
 
@@ -0,0 +1,173 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'job_local_driver_test.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/util.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/job_queue/queue_driver.h>
+#include <ert/job_queue/local_driver.h>
+
+#define NUM_JOBS 200
+
+
+static void * submit_shell( void * driver , const char * cmd ) {
+  const char * argv[2] = {"-c" , cmd};
+  return local_driver_submit_job( driver , "/bin/sh" , 1 , NULL , "JOB" , 2 , argv );
+}
+
+
+static bool wait_done( void * driver , void * job ) {
+  for (int i = 0; i < 1000; i++) {
+    if (local_driver_get_job_status( driver , job ) == JOB_QUEUE_DONE)
+      return true;
+    util_usleep( 10000 );
+  }
+  return false;
+}
+
+
+/*
+  A process which has been killed is either gone, or a zombie waiting
+  to be reaped by init.
+*/
+
+static bool process_alive( int pid ) {
+  char * stat_file = util_alloc_sprintf("/proc/%d/stat" , pid);
+  bool alive = false;
+  FILE * stream = fopen( stat_file , "r" );
+  if (stream) {
+    int stat_pid;
+    char state;
+    if (fscanf( stream , "%d %*s %c" , &stat_pid , &state ) == 2)
+      alive = (state != 'Z');
+    fclose( stream );
+  }
+  free( stat_file );
+  return alive;
+}
+
+
+static void test_run_many( ) {
+  void * driver = local_driver_alloc( );
+  void * jobs[NUM_JOBS];
+
+  for (int i = 0; i < NUM_JOBS; i++)
+    jobs[i] = submit_shell( driver , "exit 0" );
+
+  for (int i = 0; i < NUM_JOBS; i++) {
+    test_assert_true( wait_done( driver , jobs[i] ));
+    local_driver_free_job( jobs[i] );
+  }
+  local_driver_free__( driver );
+}
+
+
+static void test_kill( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "local_driver_kill" );
+  void * driver = local_driver_alloc( );
+  void * job = submit_shell( driver , "sleep 60 & echo $! > child.pid; wait" );
+  int child_pid;
+
+  while (!util_file_exists( "child.pid" ) || util_file_size( "child.pid" ) == 0)
+    util_usleep( 10000 );
+  {
+    FILE * stream = util_fopen( "child.pid" , "r" );
+    test_assert_int_equal( fscanf( stream , "%d" , &child_pid ) , 1 );
+    fclose( stream );
+  }
+
+  test_assert_true( process_alive( child_pid ));
+  test_assert_int_equal( local_driver_get_job_status( driver , job ) , JOB_QUEUE_RUNNING );
+
+  local_driver_kill_job( driver , job );
+  test_assert_true( wait_done( driver , job ));
+  local_driver_free_job( job );
+
+  {
+    int i;
+    for (i = 0; i < 500 && process_alive( child_pid ); i++)
+      util_usleep( 10000 );
+    test_assert_false( process_alive( child_pid ));
+  }
+
+  local_driver_free__( driver );
+  test_work_area_free( work_area );
+}
+
+
+/*
+  Jobs which are freed by the queue layer while they are still running
+  are freed by the reaper when they complete.
+*/
+
+static void test_free_running( ) {
+  void * driver = local_driver_alloc( );
+  void * job1 = submit_shell( driver , "sleep 0.2" );
+  void * job2 = submit_shell( driver , "sleep 0.2" );
+
+  local_driver_free_job( job1 );
+  local_driver_free_job( job2 );
+  util_usleep( 500000 );
+
+  local_driver_free__( driver );
+}
+
+
+/*
+  Jobs which are still running when the driver is freed are killed and
+  reaped by local_driver_free(); the /proc entry of a zombie would still
+  exist.
+*/
+
+static void test_free_driver_reaps( ) {
+  test_work_area_type * work_area = test_work_area_alloc( "local_driver_free_reaps" );
+  void * driver = local_driver_alloc( );
+  void * job = submit_shell( driver , "echo $$ > job.pid; exec sleep 60" );
+  int job_pid;
+
+  while (!util_file_exists( "job.pid" ) || util_file_size( "job.pid" ) == 0)
+    util_usleep( 10000 );
+  {
+    FILE * stream = util_fopen( "job.pid" , "r" );
+    test_assert_int_equal( fscanf( stream , "%d" , &job_pid ) , 1 );
+    fclose( stream );
+  }
+  test_assert_true( process_alive( job_pid ));
+
+  local_driver_free_job( job );
+  local_driver_free__( driver );
+  {
+    char * proc_dir = util_alloc_sprintf( "/proc/%d" , job_pid );
+    test_assert_false( util_entry_exists( proc_dir ));
+    free( proc_dir );
+  }
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv) {
+  test_run_many( );
+  test_kill( );
+  test_free_running( );
+  test_free_driver_reaps( );
+  exit(0);
+}
@@ -70,6 +70,19 @@ void test_parse_fail_abort() {
 }
 
 
+void parse_invalid_output( void * arg ) {
+  const char * output = (const char*) arg;
+  lsf_job_parse_bsub_output("bsub" , output);
+}
+
+
+void test_parse_output() {
+  test_assert_int_equal( lsf_job_parse_bsub_output("bsub" , "") , 0);
+  test_assert_int_equal( lsf_job_parse_bsub_output("bsub" , "Job <12345> is submitted to default queue <normal>.\n") , 12345);
+  test_assert_util_abort( "lsf_job_parse_bsub_output" , parse_invalid_output , "Job 12345 is submitted to default queue <normal>.\n" );
+}
+
+
 int main(int argc, char ** argv) {
   test_work_area_type * work_area = test_work_area_alloc( "bsub_parse_stdout");
   {
@@ -77,6 +90,7 @@ int main(int argc, char ** argv) {
     test_file_does_not_exist( );
     test_OK();
     test_parse_fail_abort();
+    test_parse_output();
   }
   test_work_area_free( work_area );
 }
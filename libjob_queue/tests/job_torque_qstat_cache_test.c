@@ -0,0 +1,284 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'job_torque_qstat_cache_test.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/job_queue/torque_driver.h>
+
+#define NUM_JOBS 10
+
+/*
+  The qsub emulator hands out the job ids 1001, 1002, ...; the qstat
+  emulator logs the arguments of every call to qstat.log, prints the
+  content of qstat.table, and the content of qstat.stderr on stderr.
+*/
+
+static void write_script( const char * filename , const char * content ) {
+  FILE * stream = util_fopen( filename , "w" );
+  fprintf( stream , "#!/bin/sh\n%s" , content );
+  fclose( stream );
+  util_addmode_if_owner( filename , S_IXUSR );
+}
+
+
+static void write_emulators( torque_driver_type * driver ) {
+  char * cwd = util_alloc_cwd( );
+  char * qsub_content  = util_alloc_sprintf("n=`cat %s/counter 2>/dev/null || echo 1000`\nn=`expr $n + 1`\necho $n > %s/counter\necho $n.mock-server\n" , cwd , cwd);
+  char * qstat_content = util_alloc_sprintf("echo \"$@\" >> %s/qstat.log\ncat %s/qstat.table\ncat %s/qstat.stderr 1>&2 2>/dev/null\nexit 0\n" , cwd , cwd , cwd);
+
+  write_script( "qsub" , qsub_content );
+  write_script( "qstat" , qstat_content );
+  write_script( "qdel" , "exit 0\n" );
+
+  {
+    char * qsub_cmd  = util_alloc_abs_path( "qsub" );
+    char * qstat_cmd = util_alloc_abs_path( "qstat" );
+    char * qdel_cmd  = util_alloc_abs_path( "qdel" );
+
+    torque_driver_set_option( driver , TORQUE_QSUB_CMD , qsub_cmd );
+    torque_driver_set_option( driver , TORQUE_QSTAT_CMD , qstat_cmd );
+    torque_driver_set_option( driver , TORQUE_QDEL_CMD , qdel_cmd );
+
+    free( qdel_cmd );
+    free( qstat_cmd );
+    free( qsub_cmd );
+  }
+
+  free( qstat_content );
+  free( qsub_content );
+  free( cwd );
+}
+
+
+static void write_table( const char ** status ) {
+  FILE * stream = util_fopen( "qstat.table" , "w" );
+  fprintf( stream , "Job id                    Name             User            Time Use S Queue\n");
+  fprintf( stream , "------------------------- ---------------- --------------- -------- - -----\n");
+  for (int i = 0; i < NUM_JOBS; i++) {
+    if (status[i] != NULL)
+      fprintf( stream , "%d.mock-server          JOB-%d            user            00:00:01 %s normal\n" , 1001 + i , i , status[i]);
+  }
+  fclose( stream );
+}
+
+
+static void write_file( const char * filename , const char * content ) {
+  FILE * stream = util_fopen( filename , "w" );
+  fprintf( stream , "%s" , content );
+  fclose( stream );
+}
+
+
+static stringlist_type * load_qstat_calls( ) {
+  stringlist_type * calls = stringlist_alloc_new( );
+  if (util_file_exists( "qstat.log" )) {
+    FILE * stream = util_fopen( "qstat.log" , "r" );
+    bool at_eof = false;
+    while (!at_eof) {
+      char * line = util_fscanf_alloc_line( stream , &at_eof );
+      if (line != NULL) {
+        if (strlen( line ) > 0)
+          stringlist_append_owned_ref( calls , line );
+        else
+          free( line );
+      }
+    }
+    fclose( stream );
+  }
+  return calls;
+}
+
+
+static void assert_qstat_calls( int expected_calls ) {
+  stringlist_type * calls = load_qstat_calls( );
+  test_assert_int_equal( stringlist_get_size( calls ) , expected_calls );
+  stringlist_free( calls );
+}
+
+
+static stringlist_type * alloc_qstat_args( int call_nr ) {
+  stringlist_type * calls = load_qstat_calls( );
+  stringlist_type * args = stringlist_alloc_from_split( stringlist_iget( calls , call_nr ) , " " );
+  stringlist_free( calls );
+  return args;
+}
+
+
+static void assert_status( torque_driver_type * driver , torque_job_type ** jobs , const job_status_type * expected ) {
+  for (int i = 0; i < NUM_JOBS; i++)
+    test_assert_int_equal( torque_driver_get_job_status( driver , jobs[i] ) , expected[i] );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "torque_qstat_cache" );
+  torque_driver_type * driver = torque_driver_alloc( );
+  char * run_path = util_alloc_cwd( );
+  torque_job_type * jobs[NUM_JOBS];
+
+  test_assert_string_equal( torque_driver_get_option( driver , TORQUE_QSTAT_REFRESH_INTERVAL ) , TORQUE_DEFAULT_QSTAT_REFRESH_INTERVAL );
+  test_assert_false( torque_driver_set_option( driver , TORQUE_QSTAT_REFRESH_INTERVAL , "-1" ));
+  test_assert_true( torque_driver_set_option( driver , TORQUE_QSTAT_REFRESH_INTERVAL , "1000" ));
+  write_emulators( driver );
+
+  for (int i = 0; i < NUM_JOBS; i++) {
+    jobs[i] = torque_driver_submit_job( driver , "/bin/true" , 1 , run_path , "JOB" , 0 , NULL );
+    test_assert_not_NULL( jobs[i] );
+  }
+
+  /*
+    Job 1009 is not listed by qstat, i.e. it has been purged by the
+    server, and is assumed to be finished; the job with the unknown
+    status 'H' is still polled.
+  */
+  {
+    const char * status[NUM_JOBS] = {"R" , "R" , "Q" , "Q" , "R" , "E" , "C" , "H" , NULL , "R"};
+    const job_status_type expected[NUM_JOBS] = {JOB_QUEUE_RUNNING , JOB_QUEUE_RUNNING , JOB_QUEUE_PENDING , JOB_QUEUE_PENDING , JOB_QUEUE_RUNNING ,
+                                                JOB_QUEUE_DONE , JOB_QUEUE_DONE , JOB_QUEUE_STATUS_FAILURE , JOB_QUEUE_DONE , JOB_QUEUE_RUNNING};
+    write_table( status );
+    assert_status( driver , jobs , expected );
+    assert_qstat_calls( 1 );
+
+    assert_status( driver , jobs , expected );
+    assert_qstat_calls( 1 );
+  }
+
+  {
+    stringlist_type * args = alloc_qstat_args( 0 );
+    test_assert_int_equal( stringlist_get_size( args ) , NUM_JOBS );
+    test_assert_true( stringlist_contains( args , "1001" ));
+    test_assert_true( stringlist_contains( args , "1010" ));
+    stringlist_free( args );
+  }
+
+  /*
+    Killing a job invalidates the cache; the killed job is reported as
+    exited, and is not polled any more - neither are the completed and
+    purged jobs.
+  */
+  torque_driver_kill_job( driver , jobs[0] );
+  {
+    const char * status[NUM_JOBS] = {"E" , "R" , "R" , "Q" , "R" , "E" , "C" , "R" , NULL , "R"};
+    const job_status_type expected[NUM_JOBS] = {JOB_QUEUE_EXIT , JOB_QUEUE_RUNNING , JOB_QUEUE_RUNNING , JOB_QUEUE_PENDING , JOB_QUEUE_RUNNING ,
+                                                JOB_QUEUE_DONE , JOB_QUEUE_DONE , JOB_QUEUE_RUNNING , JOB_QUEUE_DONE , JOB_QUEUE_RUNNING};
+    write_table( status );
+    assert_status( driver , jobs , expected );
+    assert_qstat_calls( 2 );
+  }
+
+  {
+    stringlist_type * args = alloc_qstat_args( 1 );
+    test_assert_int_equal( stringlist_get_size( args ) , NUM_JOBS - 4 );
+    test_assert_false( stringlist_contains( args , "1001" ));
+    test_assert_true( stringlist_contains( args , "1002" ));
+    test_assert_false( stringlist_contains( args , "1006" ));
+    test_assert_false( stringlist_contains( args , "1007" ));
+    test_assert_true( stringlist_contains( args , "1008" ));
+    test_assert_false( stringlist_contains( args , "1009" ));
+    stringlist_free( args );
+  }
+
+  /* When the refresh interval has expired the cache is updated. */
+  torque_driver_set_qstat_refresh_interval( driver , 0 );
+  {
+    const char * status[NUM_JOBS] = {NULL , "E" , "R" , "Q" , "R" , NULL , NULL , "R" , NULL , "R"};
+    write_table( status );
+  }
+  sleep( 2 );
+  torque_driver_get_job_status( driver , jobs[1] );
+  assert_qstat_calls( 3 );
+  {
+    stringlist_type * args = alloc_qstat_args( 2 );
+    test_assert_int_equal( stringlist_get_size( args ) , NUM_JOBS - 4 );
+    test_assert_true( stringlist_contains( args , "1002" ));
+    stringlist_free( args );
+  }
+
+  /* When all the jobs have completed qstat is not called any more. */
+  {
+    const char * status[NUM_JOBS] = {"C" , "C" , "C" , "C" , "C" , "C" , "C" , "C" , "C" , "C"};
+    write_table( status );
+    sleep( 2 );
+    torque_driver_get_job_status( driver , jobs[1] );
+    assert_qstat_calls( 4 );
+    {
+      stringlist_type * args = alloc_qstat_args( 3 );
+      test_assert_int_equal( stringlist_get_size( args ) , NUM_JOBS - 5 );
+      test_assert_false( stringlist_contains( args , "1002" ));
+      stringlist_free( args );
+    }
+
+    torque_driver_kill_job( driver , jobs[1] );
+    for (int i = 0; i < NUM_JOBS; i++)
+      torque_driver_get_job_status( driver , jobs[i] );
+    assert_qstat_calls( 4 );
+  }
+
+  for (int i = 0; i < NUM_JOBS; i++)
+    torque_driver_free_job( jobs[i] );
+
+  /*
+    When all the polled jobs are unknown qstat lists nothing, and only
+    reports the unknown job ids on stderr. Without any message about a
+    job the qstat call is assumed to have failed, and the job is polled
+    again.
+  */
+  {
+    torque_job_type * job1 = torque_driver_submit_job( driver , "/bin/true" , 1 , run_path , "JOB" , 0 , NULL );
+    torque_job_type * job2 = torque_driver_submit_job( driver , "/bin/true" , 1 , run_path , "JOB" , 0 , NULL );
+
+    write_file( "qstat.table" , "" );
+    write_file( "qstat.stderr" , "qstat: Unknown Job Id Error 1011.mock-server\n" );
+    test_assert_int_equal( torque_driver_get_job_status( driver , job1 ) , JOB_QUEUE_DONE );
+    test_assert_int_equal( torque_driver_get_job_status( driver , job2 ) , JOB_QUEUE_STATUS_FAILURE );
+    assert_qstat_calls( 5 );
+
+    write_file( "qstat.stderr" , "" );
+    sleep( 2 );
+    test_assert_int_equal( torque_driver_get_job_status( driver , job2 ) , JOB_QUEUE_STATUS_FAILURE );
+    assert_qstat_calls( 6 );
+    {
+      stringlist_type * args = alloc_qstat_args( 5 );
+      test_assert_int_equal( stringlist_get_size( args ) , 1 );
+      test_assert_string_equal( stringlist_iget( args , 0 ) , "1012" );
+      stringlist_free( args );
+    }
+
+    /* A freed job is not polled any more. */
+    torque_driver_free_job( job2 );
+    sleep( 2 );
+    test_assert_int_equal( torque_driver_get_job_status( driver , job1 ) , JOB_QUEUE_DONE );
+    assert_qstat_calls( 6 );
+
+    torque_driver_free_job( job1 );
+  }
+
+  free( run_path );
+  torque_driver_free( driver );
+  test_work_area_free( work_area );
+  exit(0);
+}
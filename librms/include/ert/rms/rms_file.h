@@ -48,6 +48,8 @@ rms_tag_type       * rms_file_fread_alloc_tag(rms_file_type * , const char *, co
 rms_tagkey_type    * rms_file_fread_alloc_data_tagkey(rms_file_type * , const char *, const char *, const char *);
 void                 rms_file_complete_fwrite(const rms_file_type *);
 void                 rms_file_init_fwrite(const rms_file_type * , const char *);
+void                 rms_file_fwrite_tag(const rms_file_type * , const rms_tag_type * );
+bool                 rms_file_get_fmt_file(const rms_file_type * );
 void                 rms_file_get_dims(const rms_file_type * , int * );
 FILE               * rms_file_get_FILE(const rms_file_type * );
 void                 rms_file_add_dimensions(rms_file_type * , int , int , int , bool);
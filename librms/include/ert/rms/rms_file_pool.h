@@ -0,0 +1,44 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_file_pool.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_RMS_FILE_POOL_H
+#define ERT_RMS_FILE_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ert/util/type_macros.h>
+
+#include <ert/rms/rms_tag.h>
+#include <ert/rms/rms_tagkey.h>
+
+  typedef struct rms_file_pool_struct rms_file_pool_type;
+
+  rms_file_pool_type * rms_file_pool_alloc( int max_size );
+  void                 rms_file_pool_free( rms_file_pool_type * pool );
+  int                  rms_file_pool_get_size( const rms_file_pool_type * pool );
+  rms_tag_type       * rms_file_pool_fread_alloc_tag( rms_file_pool_type * pool , const char * filename , const char * tagname , const char * keyname , const char * keyvalue );
+  rms_tagkey_type    * rms_file_pool_fread_alloc_data_tagkey( rms_file_pool_type * pool , const char * filename , const char * tagname , const char * keyname , const char * keyvalue );
+
+  UTIL_IS_INSTANCE_HEADER( rms_file_pool );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
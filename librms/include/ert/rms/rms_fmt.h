@@ -0,0 +1,46 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_fmt.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_RMS_FMT_H
+#define ERT_RMS_FMT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+
+#include <ert/rms/rms_type.h>
+
+typedef struct rms_fmt_reader_struct rms_fmt_reader_type;
+
+rms_fmt_reader_type * rms_fmt_reader_alloc(FILE * stream);
+void                  rms_fmt_reader_free(rms_fmt_reader_type * reader);
+long int              rms_fmt_reader_tell(rms_fmt_reader_type * reader);
+const char          * rms_fmt_reader_next_token(rms_fmt_reader_type * reader);
+const char          * rms_fmt_reader_peek_token(rms_fmt_reader_type * reader);
+int                   rms_fmt_reader_skip_token(rms_fmt_reader_type * reader);
+void                  rms_fmt_reader_fread_numeric(rms_fmt_reader_type * reader , rms_type_enum rms_type , int size , void * data);
+
+void                  rms_fmt_fwrite_numeric(FILE * stream , rms_type_enum rms_type , int size , const void * data);
+void                  rms_fmt_fwrite_string(const char * string , FILE * stream);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
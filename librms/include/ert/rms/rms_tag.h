@@ -28,6 +28,7 @@ extern "C" {
 #include <ert/util/hash.h>
 
 #include <ert/rms/rms_tagkey.h>
+#include <ert/rms/rms_fmt.h>
 
 
 
@@ -40,6 +41,13 @@ rms_tagkey_type * rms_tag_get_datakey(const rms_tag_type *);
 void              rms_tag_free(rms_tag_type *);
 void              rms_tag_free__(void * arg);
 rms_tag_type    * rms_tag_fread_alloc(FILE *, hash_type *, bool , bool *);
+rms_tag_type    * rms_tag_fread_alloc_index(FILE *, hash_type *, bool , bool *);
+rms_tag_type    * rms_tag_fread_alloc_indexed(const rms_tag_type * , FILE * , bool);
+rms_tag_type    * rms_tag_fread_alloc_fmt(rms_fmt_reader_type * , hash_type * , bool *);
+rms_tag_type    * rms_tag_fread_alloc_index_fmt(rms_fmt_reader_type * , hash_type * , bool *);
+void              rms_tag_fwrite_fmt(const rms_tag_type * , FILE * );
+rms_tag_type    * rms_tag_alloc(const char * name);
+rms_tag_type    * rms_tag_alloc_filedata(const char * filetype);
 bool              rms_tag_name_eq(const rms_tag_type *, const char * , const char *, const char *);
 rms_tagkey_type * rms_tag_get_key(const rms_tag_type *, const char *);
 void              rms_tag_fwrite_filedata(const char * , FILE *stream);
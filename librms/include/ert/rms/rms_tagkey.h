@@ -28,6 +28,7 @@ extern "C" {
 #include <ert/util/hash.h>
 
 #include <ert/rms/rms_type.h>
+#include <ert/rms/rms_fmt.h>
 
 #include <ert/ecl/ecl_util.h>
 
@@ -48,6 +49,12 @@ bool              rms_tagkey_char_eq(const rms_tagkey_type *, const char *);
 void              rms_tagkey_free_(void *);
 void            * rms_tagkey_copyc_(const void *);
 void              rms_tagkey_load(rms_tagkey_type *, bool , FILE *, hash_type *);
+void              rms_tagkey_load_index(rms_tagkey_type *, bool , FILE *, hash_type *);
+bool              rms_tagkey_has_data(const rms_tagkey_type * );
+rms_tagkey_type * rms_tagkey_fread_alloc_indexed(const rms_tagkey_type * , FILE * , bool);
+void              rms_tagkey_load_fmt(rms_tagkey_type *, rms_fmt_reader_type * , hash_type *);
+void              rms_tagkey_load_index_fmt(rms_tagkey_type *, rms_fmt_reader_type * , hash_type *);
+void              rms_tagkey_fwrite_fmt(const rms_tagkey_type * , FILE *);
 void            * rms_tagkey_get_data_ref(const rms_tagkey_type *);
 void              rms_tagkey_fwrite(const rms_tagkey_type * , FILE *);
 void              rms_tagkey_fprintf(const rms_tagkey_type * , FILE *);
@@ -30,6 +30,7 @@
 #include <ert/rms/rms_tag.h>
 #include <ert/rms/rms_file.h>
 #include <ert/rms/rms_tagkey.h>
+#include <ert/rms/rms_fmt.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_type.h>
@@ -55,6 +56,8 @@ struct rms_file_struct {
   hash_type    * type_map;
   vector_type  * tag_list;
   FILE         * stream;
+  vector_type  * tag_index;      /* Tags with only the scalar tagkeys loaded - see rms_file_fread_index(). */
+  FILE         * index_stream;   /* Kept open while the index is valid. */
 };
 
 
@@ -65,10 +68,10 @@ struct rms_file_struct {
 
 
 
-static bool rms_fmt_file(const rms_file_type *rms_file) {
+static bool rms_fmt_file(const rms_file_type *rms_file , FILE * stream) {
   bool fmt_file;
   char filetype[9];
-  rms_util_fread_string( filetype , 9 , rms_file->stream);
+  rms_util_fread_string( filetype , 9 , stream);
 
   if (strncmp(filetype , rms_binary_header , 8) == 0)
     fmt_file = false;
@@ -97,7 +100,7 @@ void rms_file_add_dimensions(rms_file_type * rms_file , int nX , int nY , int nZ
     rms_tag_type * dim_tag = rms_tag_alloc_dimensions(nX , nY , nZ);
     rms_file_add_tag(rms_file , dim_tag);
     if (save) 
-      rms_tag_fwrite(dim_tag , rms_file->stream);
+      rms_file_fwrite_tag(rms_file , dim_tag);
   }
 }
 
@@ -108,7 +111,7 @@ rms_tag_type * rms_file_get_tag_ref(const rms_file_type *rms_file ,
                                     const char *keyvalue, bool abort_on_error) {
 
   rms_tag_type *return_tag = NULL;
-  bool cont;
+  bool cont = true;
   {
     int index = 0;
     while (cont) {
@@ -158,8 +161,10 @@ rms_file_type * rms_file_alloc(const char *filename, bool fmt_file) {
 
   hash_insert_hash_owned_ref(rms_file->type_map , "char"   , rms_type_alloc(rms_char_type   , -1) ,  rms_type_free);   /* Char are a f*** mix of vector and scalar */
 
-  rms_file->filename = NULL;
-  rms_file->stream   = NULL;
+  rms_file->filename     = NULL;
+  rms_file->stream       = NULL;
+  rms_file->tag_index    = NULL;
+  rms_file->index_stream = NULL;
   rms_file_set_filename(rms_file , filename , fmt_file);
   return rms_file;
 }
@@ -169,7 +174,20 @@ rms_file_type * rms_file_alloc(const char *filename, bool fmt_file) {
 
 
 
+static void rms_file_free_index(rms_file_type * rms_file) {
+  if (rms_file->tag_index != NULL) {
+    vector_free( rms_file->tag_index );
+    rms_file->tag_index = NULL;
+  }
+  if (rms_file->index_stream != NULL) {
+    fclose( rms_file->index_stream );
+    rms_file->index_stream = NULL;
+  }
+}
+
+
 void rms_file_set_filename(rms_file_type * rms_file , const char *filename , bool fmt_file) {
+  rms_file_free_index(rms_file);
   rms_file->filename = util_realloc_string_copy(rms_file->filename , filename);
   rms_file->fmt_file   = fmt_file;
 }
@@ -183,6 +201,7 @@ void rms_file_free_data(rms_file_type * rms_file) {
 
 
 void rms_file_free(rms_file_type * rms_file) {
+  rms_file_free_index(rms_file);
   rms_file_free_data(rms_file);
   vector_free( rms_file->tag_list );
   hash_free(rms_file->type_map);
@@ -233,19 +252,33 @@ void rms_file_get_dims(const rms_file_type * rms_file , int * dims) {
 FILE * rms_file_get_FILE(const rms_file_type * rms_file) { return rms_file->stream; }
 
 
-static void rms_file_init_fread(rms_file_type * rms_file) {
+/**
+   Reads the file header from @stream, and sets the fmt_file and
+   endian_convert properties of the rms_file. For formatted files the
+   function returns a reader which must be used for all subsequent
+   reads from @stream; for binary files the return value is NULL.
+*/
+
+static rms_fmt_reader_type * rms_file_init_fread(rms_file_type * rms_file , FILE * stream) {
+  rms_fmt_reader_type * reader = NULL;
+  bool eof_tag;
+  rms_tag_type * filedata_tag;
 
-  rms_file->fmt_file = rms_fmt_file( rms_file );
+  rms_file->fmt_file = rms_fmt_file( rms_file , stream );
+  rms_file->endian_convert = false;
   if (rms_file->fmt_file) {
-    fprintf(stderr,"%s only binary files implemented - aborting \n",__func__);
-    abort();
+    /* The comment lines are skipped by the tokenizer. */
+    reader = rms_fmt_reader_alloc(stream);
+    rms_fmt_reader_skip_token(reader);
+    filedata_tag = rms_tag_fread_alloc_fmt(reader , rms_file->type_map , &eof_tag);
+  } else {
+    /* Skipping two comment lines ... */
+    rms_util_fskip_string(stream);
+    rms_util_fskip_string(stream);  
+    filedata_tag = rms_tag_fread_alloc(stream , rms_file->type_map , rms_file->endian_convert , &eof_tag);
   }
-  /* Skipping two comment lines ... */
-  rms_util_fskip_string(rms_file->stream);
-  rms_util_fskip_string(rms_file->stream);  
+
   {
-    bool eof_tag;
-    rms_tag_type    * filedata_tag = rms_tag_fread_alloc(rms_file->stream , rms_file->type_map , rms_file->endian_convert , &eof_tag);
     rms_tagkey_type * byteswap_key = rms_tag_get_key(filedata_tag , "byteswaptest");
     if (byteswap_key == NULL) {
       fprintf(stderr,"%s: failed to find filedata/byteswaptest - aborting \n", __func__);
@@ -258,38 +291,77 @@ static void rms_file_init_fread(rms_file_type * rms_file) {
       rms_file->endian_convert = true;
     rms_tag_free(filedata_tag);
   }
+  return reader;
 }
 
 
+static rms_tag_type * rms_file_fread_alloc_next_tag(rms_file_type * rms_file , FILE * stream , rms_fmt_reader_type * reader , bool index , bool * eof_tag) {
+  if (reader != NULL) {
+    if (index)
+      return rms_tag_fread_alloc_index_fmt(reader , rms_file->type_map , eof_tag);
+    else
+      return rms_tag_fread_alloc_fmt(reader , rms_file->type_map , eof_tag);
+  } else {
+    if (index)
+      return rms_tag_fread_alloc_index(stream , rms_file->type_map , rms_file->endian_convert , eof_tag);
+    else
+      return rms_tag_fread_alloc(stream , rms_file->type_map , rms_file->endian_convert , eof_tag);
+  }
+}
 
-rms_tag_type * rms_file_fread_alloc_tag(rms_file_type * rms_file , const char *tagname , const char * keyname , const char *keyvalue ) {
-  rms_tag_type * tag = NULL;
-  rms_file_fopen_r(rms_file);
-  {
-  
-    bool cont          = true;
-    bool tag_found     = false;
-    long int start_pos = util_ftell(rms_file->stream);
-    util_fseek(rms_file->stream , 0 , SEEK_SET);
-    rms_file_init_fread(rms_file);
-    while (cont) {
-      bool eof_tag;
-      rms_tag_type * tmp_tag = rms_tag_fread_alloc(rms_file->stream , rms_file->type_map , rms_file->endian_convert , &eof_tag);
-      if (rms_tag_name_eq(tmp_tag , tagname , keyname , keyvalue)) {
-        tag_found = true;
-        tag = tmp_tag;
-      } else 
-        rms_tag_free(tmp_tag);
-      if (tag_found || eof_tag)
-        cont = false;
+
+/**
+   The first lookup with rms_file_fread_alloc_tag() or
+   rms_file_fread_alloc_data_tagkey() will scan the file and build an
+   index of all the tags. Only the scalar tagkeys, like the name of a
+   parameter, are loaded; the array data are skipped (with a seek for
+   binary files), and the lookups will subsequently read only the
+   array data of the requested tag. The file is kept open while the
+   index is valid, so several parameters can be loaded from one file
+   with a single open.
+*/
+
+static void rms_file_fread_index(rms_file_type * rms_file) {
+  if (rms_file->tag_index == NULL) {
+    bool eof_tag = false;
+    rms_fmt_reader_type * reader;
+
+    rms_file->index_stream = util_fopen(rms_file->filename , "r");
+    rms_file->tag_index    = vector_alloc_new();
+    reader = rms_file_init_fread(rms_file , rms_file->index_stream);
+    while (!eof_tag) {
+      rms_tag_type * tag = rms_file_fread_alloc_next_tag(rms_file , rms_file->index_stream , reader , true , &eof_tag);
+      if (!eof_tag)
+        vector_append_owned_ref( rms_file->tag_index , tag , rms_tag_free__ );
+      else
+        rms_tag_free(tag);
     }
-    if (tag == NULL) {
-      util_fseek(rms_file->stream , start_pos , SEEK_SET);
-      util_abort("%s: could not find tag: \"%s\" (with %s=%s) in file:%s - aborting.\n",__func__ , tagname , keyname , keyvalue , rms_file->filename);
+
+    if (reader != NULL)
+      rms_fmt_reader_free(reader);
+  }
+}
+
+
+static const rms_tag_type * rms_file_get_index_tag(rms_file_type * rms_file , const char *tagname , const char * keyname , const char *keyvalue ) {
+  rms_file_fread_index(rms_file);
+  {
+    int index;
+    for (index = 0; index < vector_get_size( rms_file->tag_index ); index++) {
+      const rms_tag_type * tag = vector_iget_const( rms_file->tag_index , index );
+      if (rms_tag_name_eq(tag , tagname , keyname , keyvalue))
+        return tag;
     }
   }
-  rms_file_fclose(rms_file);
-  return tag;
+  util_abort("%s: could not find tag: \"%s\" (with %s=%s) in file:%s - aborting.\n",__func__ , tagname , keyname , keyvalue , rms_file->filename);
+  return NULL;
+}
+
+
+
+rms_tag_type * rms_file_fread_alloc_tag(rms_file_type * rms_file , const char *tagname , const char * keyname , const char *keyvalue ) {
+  const rms_tag_type * index_tag = rms_file_get_index_tag(rms_file , tagname , keyname , keyvalue);
+  return rms_tag_fread_alloc_indexed(index_tag , rms_file->index_stream , rms_file->fmt_file);
 }
 
 
@@ -301,6 +373,7 @@ FILE * rms_file_fopen_r(rms_file_type *rms_file) {
 
 
 FILE * rms_file_fopen_w(rms_file_type *rms_file) {
+  rms_file_free_index(rms_file);
   rms_file->stream = util_mkdir_fopen(rms_file->filename , "w");
   return rms_file->stream;
 }
@@ -311,27 +384,31 @@ void rms_file_fclose(rms_file_type * rms_file) {
 }
 
 
+/**
+   Will read only the "data" tagkey of the requested tag from file.
+*/
+
 rms_tagkey_type * rms_file_fread_alloc_data_tagkey(rms_file_type * rms_file , const char *tagname , const char * keyname , const char *keyvalue) {
-  rms_tag_type * tag = rms_file_fread_alloc_tag(rms_file , tagname , keyname , keyvalue);
-  if (tag != NULL) {
-    rms_tagkey_type *tagkey = rms_tagkey_copyc( rms_tag_get_key(tag , "data") );
-    rms_tag_free(tag);
-    return tagkey;
-  } else
-    return NULL;
+  const rms_tag_type * index_tag = rms_file_get_index_tag(rms_file , tagname , keyname , keyvalue);
+  const rms_tagkey_type * index_key = rms_tag_get_datakey(index_tag);
+  if (index_key == NULL)
+    util_abort("%s: tag:%s in file:%s does not have a data tagkey - aborting.\n",__func__ , tagname , rms_file->filename);
+  
+  return rms_tagkey_fread_alloc_indexed(index_key , rms_file->index_stream , rms_file->fmt_file);
 }
 
 
 
 void rms_file_fread(rms_file_type *rms_file) {
+  rms_fmt_reader_type * reader;
   rms_file_fopen_r(rms_file);
-  rms_file_init_fread(rms_file);
+  reader = rms_file_init_fread(rms_file , rms_file->stream);
   
   /* The main read loop */
   {
     bool eof_tag = false;
     while (!eof_tag) {
-      rms_tag_type * tag = rms_tag_fread_alloc(rms_file->stream ,  rms_file->type_map , rms_file->endian_convert , &eof_tag );
+      rms_tag_type * tag = rms_file_fread_alloc_next_tag(rms_file , rms_file->stream , reader , false , &eof_tag);
       if (!eof_tag)
         rms_file_add_tag(rms_file , tag);
       else
@@ -339,6 +416,8 @@ void rms_file_fread(rms_file_type *rms_file) {
       
     }
   }
+  if (reader != NULL)
+    rms_fmt_reader_free(reader);
   rms_file_fclose(rms_file);
 }
 
@@ -346,22 +425,47 @@ void rms_file_fread(rms_file_type *rms_file) {
 
 /*static */
 void rms_file_init_fwrite(const rms_file_type * rms_file , const char * filetype) {
-  if (!rms_file->fmt_file)
+  if (!rms_file->fmt_file) {
     rms_util_fwrite_string(rms_binary_header , rms_file->stream);
-  else {
-    fprintf(stderr,"%s: Sorry only binary writes implemented ... \n",__func__);
-    rms_util_fwrite_string(rms_ascii_header , rms_file->stream);
+    rms_util_fwrite_comment(rms_comment1 , rms_file->stream);
+    rms_util_fwrite_comment(rms_comment2 , rms_file->stream);
+  } else {
+    fprintf(rms_file->stream , "%s\n" , rms_ascii_header);
+    fprintf(rms_file->stream , "#%s#\n" , rms_comment1);
+    fprintf(rms_file->stream , "#%s#\n" , rms_comment2);
   }
   
-  rms_util_fwrite_comment(rms_comment1 , rms_file->stream);
-  rms_util_fwrite_comment(rms_comment2 , rms_file->stream);
-  rms_tag_fwrite_filedata(filetype , rms_file->stream);
+  {
+    rms_tag_type * filedata_tag = rms_tag_alloc_filedata(filetype);
+    rms_file_fwrite_tag(rms_file , filedata_tag);
+    rms_tag_free(filedata_tag);
+  }
+}
+
+
+bool rms_file_get_fmt_file(const rms_file_type * rms_file) {
+  return rms_file->fmt_file;
+}
+
+
+/**
+   Writes @tag to the stream of the rms_file, binary or formatted
+   according to the fmt_file property.
+*/
+
+void rms_file_fwrite_tag(const rms_file_type * rms_file , const rms_tag_type * tag) {
+  if (rms_file->fmt_file)
+    rms_tag_fwrite_fmt(tag , rms_file->stream);
+  else
+    rms_tag_fwrite(tag , rms_file->stream);
 }
 
 
 
 void rms_file_complete_fwrite(const rms_file_type * rms_file) {
-  rms_tag_fwrite_eof(rms_file->stream);
+  rms_tag_type * eof_tag = rms_tag_alloc("eof");
+  rms_file_fwrite_tag(rms_file , eof_tag);
+  rms_tag_free(eof_tag);
 }
 
 
@@ -374,7 +478,7 @@ void rms_file_fwrite(rms_file_type * rms_file, const char * filetype) {
     int tag_index;
     for (tag_index = 0; tag_index < vector_get_size( rms_file->tag_list ); tag_index++) {
       const rms_tag_type *tag = vector_iget_const( rms_file->tag_list , tag_index );
-      rms_tag_fwrite(tag , rms_file->stream);
+      rms_file_fwrite_tag(rms_file , tag);
     }
   }
 
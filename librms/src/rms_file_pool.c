@@ -0,0 +1,283 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_file_pool.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+#ifdef ERT_HAVE_THREAD_POOL
+#include <pthread.h>
+#endif
+
+#include <ert/rms/rms_file.h>
+#include <ert/rms/rms_tag.h>
+#include <ert/rms/rms_tagkey.h>
+#include <ert/rms/rms_file_pool.h>
+
+/*
+  A ROFF file often holds several parameters, which are loaded one at
+  a time by different field instances. The rms_file_pool keeps an
+  opened rms_file for each of the most recently used files, so that
+  the tag index of rms_file_fread_alloc_tag() is built once per file,
+  and not once per parameter.
+
+  A file is opened again when its mtime or size has changed since it
+  was indexed; because the mtime has one second resolution an entry
+  is not trusted if the file was modified in the same second as the
+  index was built. At most max_size files which are not in use are
+  kept open, the least recently used are closed first.
+
+  The pool can be used from several threads concurrently; the reads
+  from one file are serialized on the lock of that file.
+*/
+
+#define RMS_FILE_POOL_TYPE_ID 7732181
+
+typedef struct {
+  char            * filename;
+  time_t            mtime;
+  size_t            size;
+  time_t            load_time;
+  rms_file_type   * rms_file;
+  int               refcount;
+  int               last_used;
+  bool              stale;       /* The file has changed; the node is removed when it is no longer in use. */
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t   read_lock;
+#endif
+} rms_file_node_type;
+
+
+struct rms_file_pool_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int               max_size;
+  int               use_count;
+  vector_type     * nodes;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_t   lock;
+#endif
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( rms_file_pool , RMS_FILE_POOL_TYPE_ID )
+
+
+static rms_file_node_type * rms_file_node_alloc( const char * filename , time_t mtime , size_t size ) {
+  rms_file_node_type * node = util_malloc( sizeof * node );
+  node->filename = util_alloc_string_copy( filename );
+  node->mtime = mtime;
+  node->size = size;
+  node->load_time = time( NULL );
+  node->rms_file = rms_file_alloc( filename , false );
+  node->refcount = 0;
+  node->last_used = 0;
+  node->stale = false;
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &node->read_lock , NULL );
+#endif
+  return node;
+}
+
+
+static void rms_file_node_free( rms_file_node_type * node ) {
+  rms_file_free( node->rms_file );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &node->read_lock );
+#endif
+  free( node->filename );
+  free( node );
+}
+
+
+static void rms_file_node_free__( void * arg ) {
+  rms_file_node_free( arg );
+}
+
+
+static void rms_file_node_lock( rms_file_node_type * node ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &node->read_lock );
+#endif
+}
+
+
+static void rms_file_node_unlock( rms_file_node_type * node ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &node->read_lock );
+#endif
+}
+
+
+static void rms_file_pool_lock( rms_file_pool_type * pool ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_lock( &pool->lock );
+#endif
+}
+
+
+static void rms_file_pool_unlock( rms_file_pool_type * pool ) {
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_unlock( &pool->lock );
+#endif
+}
+
+
+rms_file_pool_type * rms_file_pool_alloc( int max_size ) {
+  rms_file_pool_type * pool = util_malloc( sizeof * pool );
+  UTIL_TYPE_ID_INIT( pool , RMS_FILE_POOL_TYPE_ID );
+  pool->max_size = max_size;
+  pool->use_count = 0;
+  pool->nodes = vector_alloc_new();
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_init( &pool->lock , NULL );
+#endif
+  return pool;
+}
+
+
+void rms_file_pool_free( rms_file_pool_type * pool ) {
+  vector_free( pool->nodes );
+#ifdef ERT_HAVE_THREAD_POOL
+  pthread_mutex_destroy( &pool->lock );
+#endif
+  free( pool );
+}
+
+
+int rms_file_pool_get_size( const rms_file_pool_type * pool ) {
+  return vector_get_size( pool->nodes );
+}
+
+
+/*
+  Closes the least recently used files which are not in use, until the
+  pool holds at most max_size files. Must be called with the pool lock
+  held.
+*/
+
+static void rms_file_pool_evict( rms_file_pool_type * pool ) {
+  while (vector_get_size( pool->nodes ) > pool->max_size) {
+    const rms_file_node_type * lru_node = NULL;
+    int lru_index = -1;
+    int index;
+
+    for (index = 0; index < vector_get_size( pool->nodes ); index++) {
+      const rms_file_node_type * node = vector_iget_const( pool->nodes , index );
+      if ((node->refcount == 0) && ((lru_node == NULL) || (node->last_used < lru_node->last_used))) {
+        lru_node = node;
+        lru_index = index;
+      }
+    }
+
+    if (lru_node == NULL)
+      break;
+
+    vector_idel( pool->nodes , lru_index );
+  }
+}
+
+
+static rms_file_node_type * rms_file_pool_get_node( rms_file_pool_type * pool , const char * filename ) {
+  rms_file_node_type * file_node = NULL;
+  time_t mtime = util_file_mtime( filename );
+  size_t size = util_file_size( filename );
+
+  rms_file_pool_lock( pool );
+  {
+    int index = 0;
+    while (index < vector_get_size( pool->nodes )) {
+      rms_file_node_type * node = vector_iget( pool->nodes , index );
+      if (!node->stale && util_string_equal( node->filename , filename )) {
+        if ((node->mtime == mtime) && (node->size == size) && (node->mtime < node->load_time)) {
+          file_node = node;
+          break;
+        }
+
+        node->stale = true;
+        if (node->refcount == 0) {
+          vector_idel( pool->nodes , index );
+          continue;
+        }
+      }
+      index++;
+    }
+
+    if (file_node == NULL) {
+      file_node = rms_file_node_alloc( filename , mtime , size );
+      vector_append_owned_ref( pool->nodes , file_node , rms_file_node_free__ );
+    }
+    file_node->refcount++;
+    file_node->last_used = ++pool->use_count;
+    rms_file_pool_evict( pool );
+  }
+  rms_file_pool_unlock( pool );
+  return file_node;
+}
+
+
+static void rms_file_pool_release_node( rms_file_pool_type * pool , rms_file_node_type * file_node ) {
+  rms_file_pool_lock( pool );
+  file_node->refcount--;
+  if (file_node->stale && (file_node->refcount == 0)) {
+    int index;
+    for (index = 0; index < vector_get_size( pool->nodes ); index++) {
+      if (vector_iget( pool->nodes , index ) == file_node) {
+        vector_idel( pool->nodes , index );
+        break;
+      }
+    }
+  }
+  rms_file_pool_evict( pool );
+  rms_file_pool_unlock( pool );
+}
+
+
+/*
+  Same as rms_file_fread_alloc_tag() on an rms_file for @filename.
+*/
+
+rms_tag_type * rms_file_pool_fread_alloc_tag( rms_file_pool_type * pool , const char * filename , const char * tagname , const char * keyname , const char * keyvalue ) {
+  rms_file_node_type * file_node = rms_file_pool_get_node( pool , filename );
+  rms_tag_type * tag;
+
+  rms_file_node_lock( file_node );
+  tag = rms_file_fread_alloc_tag( file_node->rms_file , tagname , keyname , keyvalue );
+  rms_file_node_unlock( file_node );
+
+  rms_file_pool_release_node( pool , file_node );
+  return tag;
+}
+
+
+/*
+  Same as rms_file_fread_alloc_data_tagkey() on an rms_file for @filename.
+*/
+
+rms_tagkey_type * rms_file_pool_fread_alloc_data_tagkey( rms_file_pool_type * pool , const char * filename , const char * tagname , const char * keyname , const char * keyvalue ) {
+  rms_file_node_type * file_node = rms_file_pool_get_node( pool , filename );
+  rms_tagkey_type * data_tag;
+
+  rms_file_node_lock( file_node );
+  data_tag = rms_file_fread_alloc_data_tagkey( file_node->rms_file , tagname , keyname , keyvalue );
+  rms_file_node_unlock( file_node );
+
+  rms_file_pool_release_node( pool , file_node );
+  return data_tag;
+}
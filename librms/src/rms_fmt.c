@@ -0,0 +1,352 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_fmt.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include <ert/util/util.h>
+
+#include <ert/rms/rms_type.h>
+#include <ert/rms/rms_fmt.h>
+
+/*
+  Support for formatted (roff-asc) ROFF files. The formatted files
+  are whitespace separated tokens; strings are enclosed in "", and
+  comments are enclosed in ##. The reader is a buffered tokenizer
+  which works directly on a large buffer; the numeric array data are
+  converted in bulk with strtof()/strtod()/strtol() without copying
+  the individual tokens.
+*/
+
+#define READ_BUFFER_SIZE   (1 << 20)
+#define WRITE_BUFFER_SIZE  (1 << 16)
+#define MAX_NUMBER_LENGTH  64       /* Upper limit on the length of one formatted number. */
+
+
+struct rms_fmt_reader_struct {
+  FILE      * stream;
+  char      * buffer;           /* Always \0 terminated at buffer[length]. */
+  int         buffer_size;
+  int         length;           /* Number of valid bytes in the buffer. */
+  int         pos;              /* Position of the next unread byte in the buffer. */
+  long int    offset;           /* File offset of buffer[0]. */
+  bool        eof;              /* The stream has been read to the end. */
+  char      * token;
+  int         token_alloc;
+  bool        token_pending;    /* Set by peek_token(); the next call to next_token() returns the same token. */
+};
+
+
+
+rms_fmt_reader_type * rms_fmt_reader_alloc(FILE * stream) {
+  rms_fmt_reader_type * reader = util_malloc( sizeof * reader );
+  reader->stream        = stream;
+  reader->buffer_size   = READ_BUFFER_SIZE;
+  reader->buffer        = util_malloc( reader->buffer_size + 1 );
+  reader->length        = 0;
+  reader->pos           = 0;
+  reader->offset        = util_ftell( stream );
+  reader->eof           = false;
+  reader->token_alloc   = 256;
+  reader->token         = util_malloc( reader->token_alloc );
+  reader->token_pending = false;
+  reader->buffer[0]     = '\0';
+  reader->token[0]      = '\0';
+  return reader;
+}
+
+
+/**
+   The reader does not take ownership of the stream; the position of
+   the stream after the reader has been used is undefined.
+*/
+
+void rms_fmt_reader_free(rms_fmt_reader_type * reader) {
+  free( reader->buffer );
+  free( reader->token );
+  free( reader );
+}
+
+
+/**
+   Ensures that at least @min_avail bytes are available in the
+   buffer, unless the end of the file has been reached.
+*/
+
+static void rms_fmt_reader_fill(rms_fmt_reader_type * reader , int min_avail) {
+  if (!reader->eof && (reader->length - reader->pos < min_avail)) {
+    int remaining = reader->length - reader->pos;
+    int bytes_read;
+
+    memmove( reader->buffer , &reader->buffer[reader->pos] , remaining );
+    reader->offset += reader->pos;
+    reader->pos     = 0;
+
+    bytes_read = fread( &reader->buffer[remaining] , 1 , reader->buffer_size - remaining , reader->stream );
+    if (bytes_read < reader->buffer_size - remaining)
+      reader->eof = true;
+
+    reader->length = remaining + bytes_read;
+    reader->buffer[reader->length] = '\0';
+  }
+}
+
+
+static int rms_fmt_reader_getc(rms_fmt_reader_type * reader) {
+  if (reader->pos == reader->length)
+    rms_fmt_reader_fill( reader , 1 );
+
+  if (reader->pos == reader->length)
+    return EOF;
+  else
+    return (unsigned char) reader->buffer[reader->pos++];
+}
+
+
+/**
+   Skips whitespace and comments; returns false if the end of the
+   file is reached.
+*/
+
+static bool rms_fmt_reader_skip_space(rms_fmt_reader_type * reader) {
+  while (true) {
+    if (reader->pos == reader->length) {
+      rms_fmt_reader_fill( reader , 1 );
+      if (reader->pos == reader->length)
+        return false;
+    }
+
+    {
+      char c = reader->buffer[reader->pos];
+      if (isspace( (unsigned char) c ))
+        reader->pos++;
+      else if (c == '#') {
+        int cc;
+        reader->pos++;
+        do {
+          cc = rms_fmt_reader_getc( reader );
+        } while ((cc != '#') && (cc != EOF));
+      } else
+        return true;
+    }
+  }
+}
+
+
+static void rms_fmt_reader_append_token(rms_fmt_reader_type * reader , int len , char c) {
+  if (len + 1 >= reader->token_alloc) {
+    reader->token_alloc *= 2;
+    reader->token = util_realloc( reader->token , reader->token_alloc );
+  }
+  reader->token[len] = c;
+}
+
+
+/**
+   Reads the next token, and returns the length of it; if @store is
+   true the token is stored in the token buffer of the reader. The
+   enclosing "" of a string token are not part of the token.
+*/
+
+static int rms_fmt_reader_read_token(rms_fmt_reader_type * reader , bool store) {
+  int len = 0;
+  if (!rms_fmt_reader_skip_space( reader ))
+    util_abort("%s: premature end of formatted ROFF file \n",__func__);
+
+  if (reader->buffer[reader->pos] == '"') {
+    reader->pos++;
+    while (true) {
+      int c = rms_fmt_reader_getc( reader );
+      if (c == EOF)
+        util_abort("%s: premature end of formatted ROFF file - unterminated string \n",__func__);
+
+      if (c == '"')
+        break;
+
+      if (store)
+        rms_fmt_reader_append_token( reader , len , c );
+      len++;
+    }
+  } else {
+    while (true) {
+      char c;
+      if (reader->pos == reader->length) {
+        rms_fmt_reader_fill( reader , 1 );
+        if (reader->pos == reader->length)
+          break;
+      }
+
+      c = reader->buffer[reader->pos];
+      if (isspace( (unsigned char) c ))
+        break;
+
+      if (store)
+        rms_fmt_reader_append_token( reader , len , c );
+      len++;
+      reader->pos++;
+    }
+  }
+
+  if (store)
+    reader->token[len] = '\0';
+  return len;
+}
+
+
+const char * rms_fmt_reader_next_token(rms_fmt_reader_type * reader) {
+  if (reader->token_pending)
+    reader->token_pending = false;
+  else
+    rms_fmt_reader_read_token( reader , true );
+
+  return reader->token;
+}
+
+
+const char * rms_fmt_reader_peek_token(rms_fmt_reader_type * reader) {
+  if (!reader->token_pending) {
+    rms_fmt_reader_read_token( reader , true );
+    reader->token_pending = true;
+  }
+  return reader->token;
+}
+
+
+/**
+   Skips the next token without storing it, and returns the length of
+   the token.
+*/
+
+int rms_fmt_reader_skip_token(rms_fmt_reader_type * reader) {
+  if (reader->token_pending) {
+    reader->token_pending = false;
+    return strlen( reader->token );
+  } else
+    return rms_fmt_reader_read_token( reader , false );
+}
+
+
+/**
+   The file offset of the next unread byte; this is only well defined
+   when no token has been peeked.
+*/
+
+long int rms_fmt_reader_tell(rms_fmt_reader_type * reader) {
+  if (reader->token_pending)
+    util_abort("%s: internal error - offset requested with a peeked token \n",__func__);
+
+  return reader->offset + reader->pos;
+}
+
+
+void rms_fmt_reader_fread_numeric(rms_fmt_reader_type * reader , rms_type_enum rms_type , int size , void * data) {
+  int i;
+  if (reader->token_pending)
+    util_abort("%s: internal error - numeric data requested with a peeked token \n",__func__);
+
+  for (i = 0; i < size; i++) {
+    char * start;
+    char * end;
+
+    if (!rms_fmt_reader_skip_space( reader ))
+      util_abort("%s: premature end of formatted ROFF file - expected %d values, found %d \n",__func__ , size , i);
+
+    rms_fmt_reader_fill( reader , MAX_NUMBER_LENGTH );
+    start = &reader->buffer[reader->pos];
+    switch (rms_type) {
+    case(rms_float_type):
+      ((float *) data)[i] = strtof( start , &end );
+      break;
+    case(rms_double_type):
+      ((double *) data)[i] = strtod( start , &end );
+      break;
+    case(rms_int_type):
+      ((int *) data)[i] = strtol( start , &end , 10 );
+      break;
+    case(rms_bool_type):
+    case(rms_byte_type):
+      ((char *) data)[i] = (char) strtol( start , &end , 10 );
+      break;
+    default:
+      util_abort("%s: rms_type:%d is not numeric \n",__func__ , rms_type);
+      end = start;
+    }
+
+    if (end == start)
+      util_abort("%s: failed to parse a numeric value from: \"%.16s\" \n",__func__ , start);
+
+    reader->pos += end - start;
+  }
+}
+
+
+/*****************************************************************/
+
+
+/**
+   Writes the numeric data in @data formatted, with several values on
+   each line. Floating point values are written with enough digits to
+   be read back exactly, so that the formatted files round trip with
+   the binary files.
+*/
+
+void rms_fmt_fwrite_numeric(FILE * stream , rms_type_enum rms_type , int size , const void * data) {
+  const int values_per_line = ((rms_type == rms_float_type) || (rms_type == rms_double_type)) ? 4 : 10;
+  char * buffer = util_malloc( WRITE_BUFFER_SIZE );
+  int length = 0;
+  int i;
+
+  for (i = 0; i < size; i++) {
+    if (length > WRITE_BUFFER_SIZE - MAX_NUMBER_LENGTH) {
+      util_fwrite( buffer , 1 , length , stream , __func__ );
+      length = 0;
+    }
+
+    switch (rms_type) {
+    case(rms_float_type):
+      length += sprintf( &buffer[length] , " %.9g" , ((const float *) data)[i] );
+      break;
+    case(rms_double_type):
+      length += sprintf( &buffer[length] , " %.17g" , ((const double *) data)[i] );
+      break;
+    case(rms_int_type):
+      length += sprintf( &buffer[length] , " %d" , ((const int *) data)[i] );
+      break;
+    case(rms_bool_type):
+    case(rms_byte_type):
+      length += sprintf( &buffer[length] , " %d" , ((const unsigned char *) data)[i] );
+      break;
+    default:
+      util_abort("%s: rms_type:%d is not numeric \n",__func__ , rms_type);
+    }
+
+    if ((((i + 1) % values_per_line) == 0) || (i == (size - 1)))
+      buffer[length++] = '\n';
+  }
+
+  if (length > 0)
+    util_fwrite( buffer , 1 , length , stream , __func__ );
+  free( buffer );
+}
+
+
+void rms_fmt_fwrite_string(const char * string , FILE * stream) {
+  fprintf( stream , "\"%s\"" , string );
+}
@@ -27,6 +27,7 @@
 #include <ert/rms/rms_tag.h>
 #include <ert/rms/rms_util.h>
 #include <ert/rms/rms_tagkey.h>
+#include <ert/rms/rms_fmt.h>
 
 static const char * rms_eof_tag           = "eof";
 static const char * rms_starttag_string   = "tag";
@@ -190,7 +191,7 @@ void rms_tag_add_tagkey(rms_tag_type *tag , const rms_tagkey_type *tagkey, int m
 
 
 static bool rms_tag_at_endtag(FILE *stream) {
-  const int init_pos = util_ftell(stream);
+  const long int init_pos = util_ftell(stream);
   bool at_endtag;
   char tag[7];
   if (rms_util_fread_string(tag , 7 , stream)) {
@@ -229,6 +230,97 @@ rms_tag_type * rms_tag_fread_alloc(FILE *stream , hash_type *type_map , bool end
 
 
 
+/**
+   Reads the tag at the current position in @stream like
+   rms_tag_fread_alloc(), but only the data of the scalar tagkeys is
+   loaded; the data of the array tagkeys is skipped. The returned
+   tag is suitable for matching with rms_tag_name_eq(), and the
+   complete tag can be read with rms_tag_fread_alloc_indexed().
+*/
+
+rms_tag_type * rms_tag_fread_alloc_index(FILE *stream , hash_type *type_map , bool endian_convert , bool *at_eof) {
+  rms_tag_type *tag = rms_tag_alloc(NULL);
+  rms_tag_fread_header(tag , stream , at_eof);
+  if (!*at_eof) {
+    while (! rms_tag_at_endtag(stream)) {
+      rms_tagkey_type *tagkey = rms_tagkey_alloc_empty(endian_convert);
+      rms_tagkey_load_index(tagkey , endian_convert , stream , type_map);
+      rms_tag_add_tagkey(tag , tagkey , OWNED_REF);
+    }
+  }
+  return tag;
+}
+
+
+rms_tag_type * rms_tag_fread_alloc_indexed(const rms_tag_type * index_tag , FILE * stream , bool fmt_file) {
+  rms_tag_type * tag = rms_tag_alloc(index_tag->name);
+  int i;
+  for (i=0; i < vector_get_size( index_tag->key_list ); i++) {
+    const rms_tagkey_type * index_key = vector_iget_const( index_tag->key_list , i );
+    rms_tag_add_tagkey(tag , rms_tagkey_fread_alloc_indexed(index_key , stream , fmt_file) , OWNED_REF);
+  }
+  return tag;
+}
+
+
+/*****************************************************************/
+/* Formatted (roff-asc) files */
+
+static void rms_tag_fread_header_fmt(rms_tag_type *tag , rms_fmt_reader_type * reader , bool *eof_tag) {
+  *eof_tag = false;
+  if (strcmp(rms_fmt_reader_next_token(reader) , rms_starttag_string) != 0)
+    util_abort("%s: not at tag - header aborting \n",__func__);
+  
+  tag->name = util_alloc_string_copy(rms_fmt_reader_next_token(reader));
+  if (strcmp(tag->name , rms_eof_tag) == 0)
+    *eof_tag = true;
+}
+
+
+static rms_tag_type * rms_tag_fread_alloc_fmt__(rms_fmt_reader_type * reader , hash_type *type_map , bool index , bool *at_eof) {
+  rms_tag_type *tag = rms_tag_alloc(NULL);
+  rms_tag_fread_header_fmt(tag , reader , at_eof);
+  if (!*at_eof) {
+    while (strcmp(rms_fmt_reader_peek_token(reader) , rms_endtag_string) != 0) {
+      rms_tagkey_type *tagkey = rms_tagkey_alloc_empty(false);
+      if (index)
+        rms_tagkey_load_index_fmt(tagkey , reader , type_map);
+      else
+        rms_tagkey_load_fmt(tagkey , reader , type_map);
+      rms_tag_add_tagkey(tag , tagkey , OWNED_REF);
+    }
+    rms_fmt_reader_skip_token(reader);
+  }
+  return tag;
+}
+
+
+rms_tag_type * rms_tag_fread_alloc_fmt(rms_fmt_reader_type * reader , hash_type *type_map , bool *at_eof) {
+  return rms_tag_fread_alloc_fmt__(reader , type_map , false , at_eof);
+}
+
+
+rms_tag_type * rms_tag_fread_alloc_index_fmt(rms_fmt_reader_type * reader , hash_type *type_map , bool *at_eof) {
+  return rms_tag_fread_alloc_fmt__(reader , type_map , true , at_eof);
+}
+
+
+void rms_tag_fwrite_fmt(const rms_tag_type * tag , FILE * stream) {
+  fprintf(stream , "%s %s\n" , rms_starttag_string , tag->name);
+  {
+    int i;
+    for (i=0; i < vector_get_size( tag->key_list ); i++) {
+      const rms_tagkey_type * tagkey = vector_iget_const( tag->key_list , i );
+      rms_tagkey_fwrite_fmt( tagkey , stream);
+    }
+  }
+  fprintf(stream , "%s\n" , rms_endtag_string);
+}
+
+/*****************************************************************/
+
+
+
 void rms_tag_fwrite(const rms_tag_type * tag , FILE * stream) {
   rms_util_fwrite_string("tag"     , stream);
   rms_util_fwrite_string(tag->name , stream);
@@ -267,13 +359,19 @@ void rms_tag_fwrite_eof(FILE *stream) {
 }
 
 
-void rms_tag_fwrite_filedata(const char * filetype, FILE *stream) {
+rms_tag_type * rms_tag_alloc_filedata(const char * filetype) {
   rms_tag_type * tag = rms_tag_alloc("filedata");
 
   rms_tag_add_tagkey(tag , rms_tagkey_alloc_byteswap()         , OWNED_REF);
   rms_tag_add_tagkey(tag , rms_tagkey_alloc_filetype(filetype) , OWNED_REF);
   rms_tag_add_tagkey(tag , rms_tagkey_alloc_creationDate()     , OWNED_REF);
   
+  return tag;
+}
+
+
+void rms_tag_fwrite_filedata(const char * filetype, FILE *stream) {
+  rms_tag_type * tag = rms_tag_alloc_filedata(filetype);
   rms_tag_fwrite(tag , stream);
   rms_tag_free(tag);
 }
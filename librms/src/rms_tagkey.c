@@ -28,6 +28,7 @@
 #include <ert/rms/rms_type.h>
 #include <ert/rms/rms_tagkey.h>
 #include <ert/rms/rms_util.h>
+#include <ert/rms/rms_fmt.h>
 
 static const char * rms_array_string      = "array";
 
@@ -51,6 +52,7 @@ struct rms_tagkey_struct {
   void                *data;
   bool                 endian_convert;
   bool                 shared_data;
+  long int             data_offset;      /* Offset of the data in the file it was read from; -1 if not read from file. */
 };
 
 
@@ -402,6 +404,7 @@ rms_tagkey_type * rms_tagkey_copyc(const rms_tagkey_type *tagkey) {
   new_tagkey->rms_type       = tagkey->rms_type;
   new_tagkey->data           = NULL;
   new_tagkey->shared_data    = tagkey->shared_data;
+  new_tagkey->data_offset    = tagkey->data_offset;
 
   rms_tagkey_alloc_data(new_tagkey);    
   memcpy(new_tagkey->data , tagkey->data , tagkey->data_size);
@@ -552,6 +555,180 @@ void rms_tagkey_load(rms_tagkey_type *tagkey , bool endian_convert , FILE *strea
 }
 
 
+/**
+   Reads the header of the tagkey at the current position in @stream;
+   the data of a scalar tagkey is loaded, whereas for an array tagkey
+   only the offset of the data is recorded, and the data is skipped
+   with a seek. The data of an array tagkey loaded this way can be
+   read later with rms_tagkey_fread_alloc_indexed().
+*/
+
+void rms_tagkey_load_index(rms_tagkey_type *tagkey , bool endian_convert , FILE *stream, hash_type *type_map) {
+  rms_fread_tagkey_header(tagkey , stream , type_map);
+  tagkey->data_offset = util_ftell(stream);
+  if (tagkey->size == 1) {
+    rms_tagkey_alloc_data(tagkey);
+    rms_tagkey_fread_data(tagkey , endian_convert , stream);
+  } else
+    util_fseek(stream , tagkey->data_size , SEEK_CUR);
+}
+
+
+bool rms_tagkey_has_data(const rms_tagkey_type * tagkey) {
+  return (tagkey->data != NULL);
+}
+
+
+/*****************************************************************/
+/* Formatted (roff-asc) files */
+
+
+static void rms_fread_tagkey_header_fmt(rms_tagkey_type *tagkey , rms_fmt_reader_type * reader , hash_type *type_map) {
+  bool is_array = false;
+  const char * type_string = rms_fmt_reader_next_token(reader);
+  
+  if (strcmp(type_string , rms_array_string) == 0) {
+    is_array = true;
+    type_string = rms_fmt_reader_next_token(reader);
+  }
+  
+  if (!hash_has_key(type_map , type_string))
+    util_abort("%s: type:%s not recognized in formatted ROFF file - aborting \n",__func__ , type_string);
+  
+  {
+    __rms_type * rms_t   = hash_get(type_map , type_string);
+    tagkey->rms_type     = rms_t->rms_type;
+    tagkey->sizeof_ctype = rms_t->sizeof_ctype;
+  }
+  
+  tagkey->name = util_realloc_string_copy(tagkey->name , rms_fmt_reader_next_token(reader));
+  if (is_array) {
+    const char * size_string = rms_fmt_reader_next_token(reader);
+    if (!util_sscanf_int(size_string , &tagkey->size))
+      util_abort("%s: failed to parse array size from:%s for tagkey:%s - aborting \n",__func__ , size_string , tagkey->name);
+  } else
+    tagkey->size = 1;
+}
+
+
+
+/**
+   Char data is stored as consecutive \0 terminated strings, i.e. the
+   same layout as in the binary files.
+*/
+
+static void rms_tagkey_fread_data_fmt(rms_tagkey_type *tagkey , rms_fmt_reader_type * reader) {
+  if (tagkey->rms_type == rms_char_type) {
+    char * data    = NULL;
+    int data_size  = 0;
+    int i;
+    for (i=0; i < tagkey->size; i++) {
+      const char * string = rms_fmt_reader_next_token(reader);
+      int len = strlen(string);
+      data = util_realloc(data , data_size + len + 1);
+      memcpy(&data[data_size] , string , len + 1);
+      data_size += len + 1;
+    }
+    tagkey->data_size = data_size;
+    rms_tagkey_alloc_data(tagkey);
+    memcpy(tagkey->data , data , data_size);
+    free(data);
+  } else {
+    tagkey->data_size = tagkey->size * tagkey->sizeof_ctype;
+    rms_tagkey_alloc_data(tagkey);
+    rms_fmt_reader_fread_numeric(reader , tagkey->rms_type , tagkey->size , tagkey->data);
+  }
+}
+
+
+void rms_tagkey_load_fmt(rms_tagkey_type *tagkey , rms_fmt_reader_type * reader , hash_type *type_map) {
+  rms_fread_tagkey_header_fmt(tagkey , reader , type_map);
+  rms_tagkey_fread_data_fmt(tagkey , reader);
+}
+
+
+/**
+   Formatted version of rms_tagkey_load_index(); the array data must
+   be tokenized to be skipped, but it is not converted or stored.
+*/
+
+void rms_tagkey_load_index_fmt(rms_tagkey_type *tagkey , rms_fmt_reader_type * reader , hash_type *type_map) {
+  rms_fread_tagkey_header_fmt(tagkey , reader , type_map);
+  tagkey->data_offset = rms_fmt_reader_tell(reader);
+  if (tagkey->size == 1)
+    rms_tagkey_fread_data_fmt(tagkey , reader);
+  else {
+    int i;
+    if (tagkey->rms_type == rms_char_type) {
+      tagkey->data_size = 0;
+      for (i=0; i < tagkey->size; i++)
+        tagkey->data_size += rms_fmt_reader_skip_token(reader) + 1;
+    } else {
+      tagkey->data_size = tagkey->size * tagkey->sizeof_ctype;
+      for (i=0; i < tagkey->size; i++)
+        rms_fmt_reader_skip_token(reader);
+    }
+  }
+}
+
+
+void rms_tagkey_fwrite_fmt(const rms_tagkey_type * tagkey , FILE *stream) {
+  if (tagkey->size > 1)
+    fprintf(stream , "%s " , rms_array_string);
+  fprintf(stream , "%s %s" , rms_type_names[tagkey->rms_type] , tagkey->name);
+  if (tagkey->size > 1) 
+    fprintf(stream , " %d\n" , tagkey->size);
+  
+  if (tagkey->rms_type == rms_char_type) {
+    const char * string = tagkey->data;
+    int i;
+    for (i=0; i < tagkey->size; i++) {
+      fprintf(stream , " ");
+      rms_fmt_fwrite_string(string , stream);
+      fprintf(stream , "\n");
+      string += strlen(string) + 1;
+    }
+  } else
+    rms_fmt_fwrite_numeric(stream , tagkey->rms_type , tagkey->size , tagkey->data);
+}
+
+
+/*****************************************************************/
+
+
+/**
+   Allocates a complete copy of @index_key, where the data of an
+   array tagkey loaded with rms_tagkey_load_index() or
+   rms_tagkey_load_index_fmt() is read from @stream.
+*/
+
+rms_tagkey_type * rms_tagkey_fread_alloc_indexed(const rms_tagkey_type * index_key , FILE * stream , bool fmt_file) {
+  if (index_key->data != NULL)
+    return rms_tagkey_copyc(index_key);
+  else {
+    rms_tagkey_type * tagkey = rms_tagkey_alloc_empty(index_key->endian_convert);
+    
+    tagkey->size         = index_key->size;
+    tagkey->sizeof_ctype = index_key->sizeof_ctype;
+    tagkey->data_size    = index_key->data_size;
+    tagkey->rms_type     = index_key->rms_type;
+    tagkey->data_offset  = index_key->data_offset;
+    tagkey->name         = util_alloc_string_copy(index_key->name);
+    
+    util_fseek(stream , tagkey->data_offset , SEEK_SET);
+    if (fmt_file) {
+      rms_fmt_reader_type * reader = rms_fmt_reader_alloc(stream);
+      rms_tagkey_fread_data_fmt(tagkey , reader);
+      rms_fmt_reader_free(reader);
+    } else {
+      rms_tagkey_alloc_data(tagkey);
+      rms_tagkey_fread_data(tagkey , tagkey->endian_convert , stream);
+    }
+    return tagkey;
+  }
+}
+
+
 bool rms_tagkey_char_eq(const rms_tagkey_type *tagkey , const char *keyvalue) {
   bool eq = false;
   if (tagkey->rms_type == rms_char_type) {
@@ -572,6 +749,7 @@ rms_tagkey_type * rms_tagkey_alloc_empty(bool endian_convert) {
   tagkey->data            = NULL;
   tagkey->endian_convert  = endian_convert;
   tagkey->shared_data     = false;
+  tagkey->data_offset     = -1;
   
   return tagkey;
   
@@ -703,7 +881,8 @@ int rms_tagkey_get_size(const rms_tagkey_type * tagkey) { return tagkey->size; }
 bool rms_tagkey_cmp(const rms_tagkey_type * tagkey1 , const rms_tagkey_type * tagkey2) {
   if (tagkey1->size     != tagkey2->size)     return false;
   if (tagkey1->rms_type != tagkey2->rms_type) return false;
-  if (memcmp(tagkey1->data , tagkey1->data , tagkey1->size * tagkey1->sizeof_ctype) == 0)
+  if (tagkey1->data_size != tagkey2->data_size) return false;
+  if (memcmp(tagkey1->data , tagkey2->data , tagkey1->data_size) == 0)
     return true;
   else
     return false;
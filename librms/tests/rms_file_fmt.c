@@ -0,0 +1,184 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_file_fmt.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/rms/rms_file.h>
+#include <ert/rms/rms_tag.h>
+#include <ert/rms/rms_tagkey.h>
+
+
+static void write_fmt_file( const char * filename ) {
+  FILE * stream = util_fopen( filename , "w" );
+  fprintf(stream , "roff-asc\n");
+  fprintf(stream , "#ROFF file#\n");
+  fprintf(stream , "#Creator: Handwritten#\n");
+  fprintf(stream , "tag filedata\n");
+  fprintf(stream , "int byteswaptest 1\n");
+  fprintf(stream , "char filetype  \"parameter\"\n");
+  fprintf(stream , "char creationDate  \"01/01/2016 12:00:00\"\n");
+  fprintf(stream , "endtag\n");
+  fprintf(stream , "tag version\nint major 2\nint minor 0\nendtag\n");
+  fprintf(stream , "tag dimensions\nint nX 2\nint nY 3\nint nZ 1\nendtag\n");
+  fprintf(stream , "tag parameter\n");
+  fprintf(stream , "char name \"PORO\"\n");
+  fprintf(stream , "array float data 6\n");
+  fprintf(stream , "  0.1 0.2 0.3 #A comment# 0.4\n 1.5e-3 -7.25\n");
+  fprintf(stream , "endtag\n");
+  fprintf(stream , "tag parameter\n");
+  fprintf(stream , "char name \"DEPTH\"\n");
+  fprintf(stream , "array double data 3\n");
+  fprintf(stream , "  1234.5678901234 0.1 -1e+300\n");
+  fprintf(stream , "endtag\n");
+  fprintf(stream , "tag misc\n");
+  fprintf(stream , "array int ivalues 4 1 -2 3 400000\n");
+  fprintf(stream , "array bool bvalues 3 1 0 1\n");
+  fprintf(stream , "array byte cvalues 3 0 17 255\n");
+  fprintf(stream , "array char names 3 \"A\" \"With space\" \"\"\n");
+  fprintf(stream , "endtag\n");
+  fprintf(stream , "tag eof\nendtag\n");
+  fclose( stream );
+}
+
+
+static void assert_equal_files( rms_file_type * file1 , rms_file_type * file2 ) {
+  const char * tags[] = {"dimensions" , "misc"};
+  const char * keys[] = {"nX" , "nY" , "nZ" , "ivalues" , "bvalues" , "cvalues" , "names"};
+
+  for (int i = 0; i < 3; i++)
+    test_assert_true( rms_tagkey_cmp( rms_tag_get_key( rms_file_get_tag_ref( file1 , tags[0] , NULL , NULL , true ) , keys[i] ),
+                                      rms_tag_get_key( rms_file_get_tag_ref( file2 , tags[0] , NULL , NULL , true ) , keys[i] )));
+
+  for (int i = 3; i < 7; i++)
+    test_assert_true( rms_tagkey_cmp( rms_tag_get_key( rms_file_get_tag_ref( file1 , tags[1] , NULL , NULL , true ) , keys[i] ),
+                                      rms_tag_get_key( rms_file_get_tag_ref( file2 , tags[1] , NULL , NULL , true ) , keys[i] )));
+
+  test_assert_true( rms_tagkey_cmp( rms_tag_get_datakey( rms_file_get_tag_ref( file1 , "parameter" , "name" , "PORO" , true )),
+                                    rms_tag_get_datakey( rms_file_get_tag_ref( file2 , "parameter" , "name" , "PORO" , true ))));
+  test_assert_true( rms_tagkey_cmp( rms_tag_get_datakey( rms_file_get_tag_ref( file1 , "parameter" , "name" , "DEPTH" , true )),
+                                    rms_tag_get_datakey( rms_file_get_tag_ref( file2 , "parameter" , "name" , "DEPTH" , true ))));
+}
+
+
+static void test_load( rms_file_type * rms_file ) {
+  rms_tag_type * misc = rms_file_get_tag_ref( rms_file , "misc" , NULL , NULL , true );
+  int dims[3];
+
+  test_assert_true( rms_file_get_fmt_file( rms_file ));
+  rms_file_get_dims( rms_file , dims );
+  test_assert_int_equal( dims[0] , 2 );
+  test_assert_int_equal( dims[1] , 3 );
+  test_assert_int_equal( dims[2] , 1 );
+
+  {
+    const float * data = rms_tagkey_get_data_ref( rms_tag_get_datakey( rms_file_get_tag_ref( rms_file , "parameter" , "name" , "PORO" , true )));
+    test_assert_float_equal( data[3] , 0.4 );
+    test_assert_float_equal( data[5] , -7.25 );
+  }
+
+  {
+    const double * data = rms_tagkey_get_data_ref( rms_tag_get_datakey( rms_file_get_tag_ref( rms_file , "parameter" , "name" , "DEPTH" , true )));
+    test_assert_double_equal( data[0] , 1234.5678901234 );
+    test_assert_double_equal( data[2] , -1e300 );
+  }
+
+  {
+    const int * ivalues = rms_tagkey_get_data_ref( rms_tag_get_key( misc , "ivalues" ));
+    const unsigned char * cvalues = rms_tagkey_get_data_ref( rms_tag_get_key( misc , "cvalues" ));
+    const char * bvalues = rms_tagkey_get_data_ref( rms_tag_get_key( misc , "bvalues" ));
+    const rms_tagkey_type * names = rms_tag_get_key( misc , "names" );
+    const char * name = rms_tagkey_get_data_ref( names );
+
+    test_assert_int_equal( ivalues[3] , 400000 );
+    test_assert_int_equal( bvalues[1] , 0 );
+    test_assert_int_equal( cvalues[2] , 255 );
+    test_assert_int_equal( rms_tagkey_get_size( names ) , 3 );
+    test_assert_string_equal( name , "A" );
+    test_assert_string_equal( &name[2] , "With space" );
+    test_assert_string_equal( &name[13] , "" );
+  }
+}
+
+
+/*
+  Writes the content of @src to @filename, and reads it back again.
+*/
+
+static rms_file_type * copy_file( rms_file_type * src , const char * filename , bool fmt_file ) {
+  rms_file_type * copy = rms_file_alloc( filename , fmt_file );
+  rms_file_set_filename( src , filename , fmt_file );
+  rms_file_fwrite( src , "parameter" );
+  rms_file_fread( copy );
+  test_assert_bool_equal( rms_file_get_fmt_file( copy ) , fmt_file );
+  return copy;
+}
+
+
+static void test_indexed( const char * filename ) {
+  rms_file_type * rms_file = rms_file_alloc( filename , true );
+  rms_tagkey_type * data_key = rms_file_fread_alloc_data_tagkey( rms_file , "parameter" , "name" , "DEPTH" );
+  rms_tag_type * misc = rms_file_fread_alloc_tag( rms_file , "misc" , NULL , NULL );
+
+  test_assert_int_equal( rms_tagkey_get_size( data_key ) , 3 );
+  test_assert_double_equal( ((const double *) rms_tagkey_get_data_ref( data_key ))[1] , 0.1 );
+  test_assert_string_equal( &((const char *) rms_tagkey_get_data_ref( rms_tag_get_key( misc , "names" )))[2] , "With space" );
+
+  rms_tagkey_free( data_key );
+  data_key = rms_file_fread_alloc_data_tagkey( rms_file , "parameter" , "name" , "PORO" );
+  test_assert_float_equal( ((const float *) rms_tagkey_get_data_ref( data_key ))[4] , 1.5e-3 );
+
+  rms_tagkey_free( data_key );
+  rms_tag_free( misc );
+  rms_file_free( rms_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "rms_file_fmt" );
+  write_fmt_file( "input.roff" );
+  {
+    rms_file_type * rms_file = rms_file_alloc( "input.roff" , true );
+    rms_file_type * bin_file;
+    rms_file_type * fmt_file;
+
+    rms_file_fread( rms_file );
+    test_load( rms_file );
+
+    bin_file = copy_file( rms_file , "copy_bin.roff" , false );
+    assert_equal_files( rms_file , bin_file );
+
+    fmt_file = copy_file( bin_file , "copy_fmt.roff" , true );
+    test_load( fmt_file );
+    assert_equal_files( rms_file , fmt_file );
+
+    rms_file_free( fmt_file );
+    rms_file_free( bin_file );
+    rms_file_free( rms_file );
+  }
+  test_indexed( "input.roff" );
+  test_indexed( "copy_fmt.roff" );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,134 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_file_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/rms/rms_file.h>
+#include <ert/rms/rms_tag.h>
+#include <ert/rms/rms_tagkey.h>
+
+#define NX 10
+#define NY 12
+#define NZ 5
+#define NUM_PARAM 3
+
+static const char * param_names[NUM_PARAM] = {"PORO" , "PERMX" , "NTG"};
+
+
+static float param_value( int iparam , int index ) {
+  return iparam * 1000 + index * 0.25;
+}
+
+
+static void write_file( const char * filename ) {
+  rms_file_type * rms_file = rms_file_alloc( filename , false );
+  float * data = util_calloc( NX * NY * NZ , sizeof * data );
+
+  rms_file_fopen_w( rms_file );
+  rms_file_init_fwrite( rms_file , "parameter" );
+  rms_tag_fwrite_dimensions( NX , NY , NZ , rms_file_get_FILE( rms_file ));
+  for (int iparam = 0; iparam < NUM_PARAM; iparam++) {
+    for (int i = 0; i < NX * NY * NZ; i++)
+      data[i] = param_value( iparam , i );
+    {
+      rms_tagkey_type * data_key = rms_tagkey_alloc_complete( "data" , NX * NY * NZ , rms_float_type , data , true );
+      rms_tag_fwrite_parameter( param_names[iparam] , data_key , rms_file_get_FILE( rms_file ));
+      rms_tagkey_free( data_key );
+    }
+  }
+  rms_file_complete_fwrite( rms_file );
+  rms_file_fclose( rms_file );
+  rms_file_free( rms_file );
+  free( data );
+}
+
+
+static void assert_data( const rms_tagkey_type * data_key , int iparam ) {
+  const float * data = rms_tagkey_get_data_ref( data_key );
+  test_assert_int_equal( rms_tagkey_get_size( data_key ) , NX * NY * NZ );
+  test_assert_int_equal( rms_tagkey_get_rms_type( data_key ) , rms_float_type );
+  for (int i = 0; i < NX * NY * NZ; i++)
+    test_assert_float_equal( data[i] , param_value( iparam , i ));
+}
+
+
+static void test_data_tagkey( const char * filename ) {
+  rms_file_type * rms_file = rms_file_alloc( filename , false );
+  for (int iparam = NUM_PARAM - 1; iparam >= 0; iparam--) {
+    rms_tagkey_type * data_key = rms_file_fread_alloc_data_tagkey( rms_file , "parameter" , "name" , param_names[iparam] );
+    assert_data( data_key , iparam );
+    rms_tagkey_free( data_key );
+  }
+
+  {
+    rms_tagkey_type * data_key = rms_file_fread_alloc_data_tagkey( rms_file , "parameter" , NULL , NULL );
+    assert_data( data_key , 0 );
+    rms_tagkey_free( data_key );
+  }
+  rms_file_free( rms_file );
+}
+
+
+static void test_tag( const char * filename ) {
+  rms_file_type * rms_file = rms_file_alloc( filename , false );
+  rms_tag_type * tag = rms_file_fread_alloc_tag( rms_file , "parameter" , "name" , "PERMX" );
+  test_assert_string_equal( rms_tag_get_name( tag ) , "parameter" );
+  test_assert_string_equal( rms_tag_get_namekey_name( tag ) , "PERMX" );
+  assert_data( rms_tag_get_datakey( tag ) , 1 );
+  rms_tag_free( tag );
+
+  tag = rms_file_fread_alloc_tag( rms_file , "dimensions" , NULL , NULL );
+  test_assert_int_equal( *(int *) rms_tagkey_get_data_ref( rms_tag_get_key( tag , "nY" )) , NY );
+  rms_tag_free( tag );
+  rms_file_free( rms_file );
+}
+
+
+static void test_full_load( const char * filename ) {
+  rms_file_type * rms_file = rms_file_alloc( filename , false );
+  int dims[3];
+
+  rms_file_fread( rms_file );
+  rms_file_get_dims( rms_file , dims );
+  test_assert_int_equal( dims[0] , NX );
+  test_assert_int_equal( dims[2] , NZ );
+  for (int iparam = 0; iparam < NUM_PARAM; iparam++) {
+    const rms_tag_type * tag = rms_file_get_tag_ref( rms_file , "parameter" , "name" , param_names[iparam] , true );
+    assert_data( rms_tag_get_datakey( tag ) , iparam );
+  }
+  rms_file_free( rms_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "rms_file_index" );
+  write_file( "params.roff" );
+
+  test_data_tagkey( "params.roff" );
+  test_tag( "params.roff" );
+  test_full_load( "params.roff" );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
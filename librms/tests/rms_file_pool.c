@@ -0,0 +1,166 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'rms_file_pool.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <utime.h>
+#include <time.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/rms/rms_file.h>
+#include <ert/rms/rms_tag.h>
+#include <ert/rms/rms_tagkey.h>
+#include <ert/rms/rms_file_pool.h>
+
+#define NX 4
+#define NY 5
+#define NZ 3
+#define NUM_PARAM 3
+
+static const char * param_names[NUM_PARAM] = {"PORO" , "PERMX" , "NTG"};
+
+
+static float param_value( int version , int iparam , int index ) {
+  return version * 100000 + iparam * 1000 + index * 0.25;
+}
+
+
+/*
+  The file is written with an mtime in the past, so that the pool
+  trusts the mtime; see the documentation in rms_file_pool.c.
+*/
+
+static void write_file( const char * filename , int version ) {
+  rms_file_type * rms_file = rms_file_alloc( filename , false );
+  float * data = util_calloc( NX * NY * NZ , sizeof * data );
+
+  rms_file_fopen_w( rms_file );
+  rms_file_init_fwrite( rms_file , "parameter" );
+  rms_tag_fwrite_dimensions( NX , NY , NZ , rms_file_get_FILE( rms_file ));
+  for (int iparam = 0; iparam < NUM_PARAM; iparam++) {
+    for (int i = 0; i < NX * NY * NZ; i++)
+      data[i] = param_value( version , iparam , i );
+    {
+      rms_tagkey_type * data_key = rms_tagkey_alloc_complete( "data" , NX * NY * NZ , rms_float_type , data , true );
+      rms_tag_fwrite_parameter( param_names[iparam] , data_key , rms_file_get_FILE( rms_file ));
+      rms_tagkey_free( data_key );
+    }
+  }
+  rms_file_complete_fwrite( rms_file );
+  rms_file_fclose( rms_file );
+  rms_file_free( rms_file );
+  free( data );
+
+  {
+    struct utimbuf times;
+    times.actime = times.modtime = time( NULL ) - 100 + version;
+    test_assert_int_equal( utime( filename , &times ) , 0 );
+  }
+}
+
+
+static void assert_data( rms_file_pool_type * pool , const char * filename , int version , int iparam ) {
+  rms_tagkey_type * data_key = rms_file_pool_fread_alloc_data_tagkey( pool , filename , "parameter" , "name" , param_names[iparam] );
+  const float * data = rms_tagkey_get_data_ref( data_key );
+  test_assert_int_equal( rms_tagkey_get_size( data_key ) , NX * NY * NZ );
+  for (int i = 0; i < NX * NY * NZ; i++)
+    test_assert_float_equal( data[i] , param_value( version , iparam , i ));
+  rms_tagkey_free( data_key );
+}
+
+
+static void test_load( ) {
+  rms_file_pool_type * pool = rms_file_pool_alloc( 2 );
+  test_assert_true( rms_file_pool_is_instance( pool ));
+
+  write_file( "params.roff" , 0 );
+  for (int iparam = NUM_PARAM - 1; iparam >= 0; iparam--)
+    assert_data( pool , "params.roff" , 0 , iparam );
+  test_assert_int_equal( rms_file_pool_get_size( pool ) , 1 );
+
+  {
+    rms_tag_type * tag = rms_file_pool_fread_alloc_tag( pool , "params.roff" , "parameter" , NULL , NULL );
+    test_assert_string_equal( rms_tag_get_namekey_name( tag ) , "PORO" );
+    rms_tag_free( tag );
+  }
+  rms_file_pool_free( pool );
+}
+
+
+/*
+  A file which is replaced with a new file with the same size and mtime
+  is still read from the opened rms_file; that the old content is
+  returned shows that the rms_file is shared. When the mtime changes
+  the file is opened again.
+*/
+
+static void test_reuse( ) {
+  rms_file_pool_type * pool = rms_file_pool_alloc( 2 );
+  time_t mtime;
+
+  write_file( "params.roff" , 0 );
+  mtime = util_file_mtime( "params.roff" );
+  assert_data( pool , "params.roff" , 0 , 1 );
+
+  unlink( "params.roff" );
+  write_file( "params.roff" , 1 );
+  {
+    struct utimbuf times;
+    times.actime = times.modtime = mtime;
+    test_assert_int_equal( utime( "params.roff" , &times ) , 0 );
+  }
+  assert_data( pool , "params.roff" , 0 , 2 );
+
+  write_file( "params.roff" , 2 );
+  assert_data( pool , "params.roff" , 2 , 2 );
+  test_assert_int_equal( rms_file_pool_get_size( pool ) , 1 );
+  rms_file_pool_free( pool );
+}
+
+
+static void test_evict( ) {
+  rms_file_pool_type * pool = rms_file_pool_alloc( 2 );
+  const char * files[3] = {"file0.roff" , "file1.roff" , "file2.roff"};
+
+  for (int ifile = 0; ifile < 3; ifile++) {
+    write_file( files[ifile] , ifile );
+    assert_data( pool , files[ifile] , ifile , 0 );
+  }
+  test_assert_int_equal( rms_file_pool_get_size( pool ) , 2 );
+
+  for (int ifile = 0; ifile < 3; ifile++)
+    assert_data( pool , files[ifile] , ifile , 1 );
+  test_assert_int_equal( rms_file_pool_get_size( pool ) , 2 );
+  rms_file_pool_free( pool );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "rms_file_pool" );
+
+  test_load( );
+  test_reuse( );
+  test_evict( );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
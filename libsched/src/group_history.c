@@ -20,8 +20,10 @@
 #include <stdbool.h>
 
 #include <ert/util/util.h>
+#include <ert/util/hash.h>
 #include <ert/util/size_t_vector.h>
 #include <ert/util/time_t_vector.h>
+#include <ert/util/double_vector.h>
 #include <ert/util/vector.h>
 
 #include <ert/sched/group_history.h>
@@ -30,6 +32,11 @@
 
 #define GROUP_HISTORY_TYPE_ID 5100635
 
+#define OIL_PHASE    0
+#define WATER_PHASE  1
+#define GAS_PHASE    2
+#define NUM_PHASES   3
+
 
 struct group_history_struct {
   UTIL_TYPE_ID_DECLARATION;
@@ -41,6 +48,9 @@ struct group_history_struct {
   size_t_vector_type       * children;
   vector_type              * children_storage;
   int                        __active_step;    /* Internal variable to ensure that several repeated calls to add_child / del_child work on the correct child_hash instance. */
+  bool                       aggregated;       /* Have the rate and total vectors below been evaluated? */
+  double_vector_type       * rates[NUM_PHASES];
+  double_vector_type       * totals[NUM_PHASES];
 };
 
 UTIL_SAFE_CAST_FUNCTION( group_history , GROUP_HISTORY_TYPE_ID )
@@ -70,6 +80,11 @@ group_history_type * group_history_alloc( const char * group_name , const time_t
 
   group_history->parent           = size_t_vector_alloc(0, ( size_t ) NULL );
   group_history->__active_step    = -1;
+  group_history->aggregated       = false;
+  for (int phase = 0; phase < NUM_PHASES; phase++) {
+    group_history->rates[phase]  = double_vector_alloc( 0 , 0 );
+    group_history->totals[phase] = double_vector_alloc( 0 , 0 );
+  }
   return group_history;
 }
 
@@ -79,6 +94,10 @@ void group_history_free( group_history_type * group_history ) {
   vector_free( group_history->children_storage );
   size_t_vector_free( group_history->children );
   size_t_vector_free( group_history->parent );
+  for (int phase = 0; phase < NUM_PHASES; phase++) {
+    double_vector_free( group_history->rates[phase] );
+    double_vector_free( group_history->totals[phase] );
+  }
   
   free( group_history->group_name );
   free( group_history );
@@ -253,110 +272,143 @@ const char * group_history_get_name( const group_history_type * group_history )
 
 /*****************************************************************/
 
-double group_history_iget_GOPRH( const void * __group_history , int report_step ) {
-  const group_history_type * group_history = group_history_safe_cast_const( __group_history );
-  {
-    double GOPRH = 0;
-  
-    hash_type      * child_hash = (hash_type *) size_t_vector_safe_iget( group_history->children , report_step );   /* Get a pointer to child hash instance valid at this report_step. */
-    hash_iter_type * child_iter = hash_iter_alloc( child_hash );
-    while ( !hash_iter_is_complete( child_iter )) {
-      const char * child_name = hash_iter_get_next_key( child_iter );
-      const void * child      = hash_get( child_hash , child_name );
-      if (group_history_is_instance( child ))
-        GOPRH += group_history_iget_GOPRH( child , report_step );
-      else {
-        double WOPRH = well_history_iget_WOPRH( child , report_step );
-        GOPRH += WOPRH;
-      }
+/*
+  The group rates and totals are evaluated for all report steps in
+  one bottom-up pass, and stored in the dense rates[] and totals[]
+  vectors of the group: the rates of a group at report step @i are
+  the sums of the rates of the children at step @i, where the rates
+  of child groups are taken from the (already aggregated) vectors of
+  the child, and the totals are the running sums of rate * days.
+
+  The aggregation is done lazily on the first query. The group tree
+  is only modified while sched_history_update() builds it, and all
+  the group_history instances are recreated by the next
+  sched_history_update(), so the aggregated vectors are never stale.
+*/
+
+static void group_history_load_children( const hash_type * child_hash , vector_type * children ) {
+  hash_iter_type * child_iter = hash_iter_alloc( child_hash );
+  vector_clear( children );
+  while ( !hash_iter_is_complete( child_iter )) {
+    const char * child_name = hash_iter_get_next_key( child_iter );
+    vector_append_ref( children , hash_get( child_hash , child_name ));
+  }
+  hash_iter_free( child_iter );
+}
+
+
+static void group_history_sum_children( const vector_type * children , int report_step , double * rates) {
+  for (int phase = 0; phase < NUM_PHASES; phase++)
+    rates[phase] = 0;
+
+  for (int ichild = 0; ichild < vector_get_size( children ); ichild++) {
+    const void * child = vector_iget_const( children , ichild );
+    if (group_history_is_instance( child )) {
+      rates[OIL_PHASE]   += group_history_iget_GOPRH( child , report_step );
+      rates[WATER_PHASE] += group_history_iget_GWPRH( child , report_step );
+      rates[GAS_PHASE]   += group_history_iget_GGPRH( child , report_step );
+    } else {
+      rates[OIL_PHASE]   += well_history_iget_WOPRH( child , report_step );
+      rates[WATER_PHASE] += well_history_iget_WWPRH( child , report_step );
+      rates[GAS_PHASE]   += well_history_iget_WGPRH( child , report_step );
     }
-    hash_iter_free( child_iter );
-    
-    return GOPRH;
   }
 }
 
 
+static const group_history_type * group_history_aggregate( const void * __group_history ) {
+  group_history_type * group_history = (group_history_type *) group_history_safe_cast_const( __group_history );
+  if (!group_history->aggregated) {
+    int num_steps = time_t_vector_size( group_history->time );
+    vector_type * children = vector_alloc_new();
+    const hash_type * current_hash = NULL;
+    double rates[NUM_PHASES];
+    double totals[NUM_PHASES] = { 0 , 0 , 0 };
 
-double group_history_iget_GWPRH( const void * __group_history , int report_step ) {
-  const group_history_type * group_history = group_history_safe_cast_const( __group_history );
-  {
-    double GWPRH = 0;
-  
-    hash_type      * child_hash = (hash_type *) size_t_vector_safe_iget( group_history->children , report_step );   /* Get a pointer to child hash instance valid at this report_step. */
-    hash_iter_type * child_iter = hash_iter_alloc( child_hash );
-    while ( !hash_iter_is_complete( child_iter )) {
-      const char * child_name = hash_iter_get_next_key( child_iter );
-      const void * child      = hash_get( child_hash , child_name );
-      if (group_history_is_instance( child ))
-        GWPRH += group_history_iget_GWPRH( child , report_step );
-      else
-        GWPRH += well_history_iget_WWPRH( child , report_step );
+    for (int phase = 0; phase < NUM_PHASES; phase++) {
+      double_vector_reset( group_history->rates[phase] );
+      double_vector_reset( group_history->totals[phase] );
     }
-    hash_iter_free( child_iter );
-    
-    return GWPRH;
+
+    for (int tstep = 0; tstep < num_steps; tstep++) {
+      const hash_type * child_hash = (const hash_type *) size_t_vector_safe_iget( group_history->children , tstep );
+      if (child_hash != current_hash) {
+        group_history_load_children( child_hash , children );
+        current_hash = child_hash;
+      }
+      group_history_sum_children( children , tstep , rates );
+
+      if (tstep > 0) {
+        double days = (time_t_vector_iget( group_history->time , tstep ) - time_t_vector_iget( group_history->time , tstep - 1)) * 1.0 / 86400 ;
+        for (int phase = 0; phase < NUM_PHASES; phase++)
+          totals[phase] += rates[phase] * days;
+      }
+
+      for (int phase = 0; phase < NUM_PHASES; phase++) {
+        double_vector_iset( group_history->rates[phase] , tstep , rates[phase] );
+        double_vector_iset( group_history->totals[phase] , tstep , totals[phase] );
+      }
+    }
+
+    vector_free( children );
+    group_history->aggregated = true;
   }
+  return group_history;
 }
 
 
+static double group_history_iget_rate( const void * __group_history , int phase , int report_step ) {
+  const group_history_type * group_history = group_history_aggregate( __group_history );
+  if (report_step < double_vector_size( group_history->rates[phase] ))
+    return double_vector_iget( group_history->rates[phase] , report_step );
+  else {
+    /* Beyond the last report step of the schedule file - evaluated directly. */
+    double rates[NUM_PHASES];
+    vector_type * children = vector_alloc_new();
 
+    group_history_load_children( (const hash_type *) size_t_vector_safe_iget( group_history->children , report_step ) , children );
+    group_history_sum_children( children , report_step , rates );
+    vector_free( children );
 
-double group_history_iget_GGPRH( const void * __group_history , int report_step ) {
-  const group_history_type * group_history = group_history_safe_cast_const( __group_history );
-  {
-    double GGPRH = 0;
-  
-    hash_type      * child_hash = (hash_type *) size_t_vector_safe_iget( group_history->children , report_step );   /* Get a pointer to child hash instance valid at this report_step. */
-    hash_iter_type * child_iter = hash_iter_alloc( child_hash );
-    while ( !hash_iter_is_complete( child_iter )) {
-      const char * child_name = hash_iter_get_next_key( child_iter );
-      const void * child      = hash_get( child_hash , child_name );
-      if (group_history_is_instance( child ))
-        GGPRH += group_history_iget_GGPRH( child , report_step );
-      else
-        GGPRH += well_history_iget_WGPRH( child , report_step );
-    }
-    hash_iter_free( child_iter );
-    
-    return GGPRH;
+    return rates[phase];
   }
 }
 
 
+static double group_history_iget_total( const void * __group_history , int phase , int report_step ) {
+  const group_history_type * group_history = group_history_aggregate( __group_history );
+  return double_vector_iget( group_history->totals[phase] , report_step );
+}
+
+
+
+double group_history_iget_GOPRH( const void * __group_history , int report_step ) {
+  return group_history_iget_rate( __group_history , OIL_PHASE , report_step );
+}
+
+
+double group_history_iget_GWPRH( const void * __group_history , int report_step ) {
+  return group_history_iget_rate( __group_history , WATER_PHASE , report_step );
+}
+
+
+double group_history_iget_GGPRH( const void * __group_history , int report_step ) {
+  return group_history_iget_rate( __group_history , GAS_PHASE , report_step );
+}
+
+
 double group_history_iget_GGPTH( const void * __group_history , int report_step ) {
-  const group_history_type * group_history = group_history_safe_cast_const( __group_history );
-  double GGPTH = 0;
-  for (int tstep = 1; tstep <= report_step; tstep++) {
-    double days = (time_t_vector_iget( group_history->time , tstep ) - time_t_vector_iget( group_history->time , tstep - 1)) * 1.0 / 86400 ;
-    double rate = group_history_iget_GGPRH( __group_history , tstep );
-    GGPTH += rate * days;
-  }
-  return GGPTH;
+  return group_history_iget_total( __group_history , GAS_PHASE , report_step );
 }
 
 
 double group_history_iget_GOPTH( const void * __group_history , int report_step ) {
-  const group_history_type * group_history = group_history_safe_cast_const( __group_history );
-  double GOPTH = 0;
-  for (int tstep = 1; tstep <= report_step; tstep++) {
-    double days = (time_t_vector_iget( group_history->time , tstep ) - time_t_vector_iget( group_history->time , tstep - 1)) * 1.0 / 86400 ;
-    double rate = group_history_iget_GOPRH( __group_history , tstep );
-    GOPTH += rate * days;
-  }
-  return GOPTH;
+  return group_history_iget_total( __group_history , OIL_PHASE , report_step );
 }
 
 
 double group_history_iget_GWPTH( const void * __group_history , int report_step ) {
-  const group_history_type * group_history = group_history_safe_cast_const( __group_history );
-  double GWPTH = 0;
-  for (int tstep = 1; tstep <= report_step; tstep++) {
-    double days = (time_t_vector_iget( group_history->time , tstep ) - time_t_vector_iget( group_history->time , tstep - 1)) * 1.0 / 86400 ;
-    double rate = group_history_iget_GWPRH( __group_history , tstep );
-    GWPTH += rate * days;
-  }
-  return GWPTH;
+  return group_history_iget_total( __group_history , WATER_PHASE , report_step );
 }
 
 
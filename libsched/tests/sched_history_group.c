@@ -0,0 +1,149 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'sched_history_group.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/util.h>
+
+#include <ert/sched/sched_file.h>
+#include <ert/sched/sched_history.h>
+
+
+/*
+  Two levels of groups: FIELD -> PLAT -> {G1 , G2} with G2 moved
+  directly under FIELD in the third block, where the well OP3 is also
+  added to G2.
+*/
+
+static void write_schedule( const char * filename ) {
+  FILE * stream = util_fopen( filename , "w" );
+  fprintf(stream , "WELSPECS\n");
+  fprintf(stream , "  'OP1' 'G1' 1 1 1* 'OIL' /\n");
+  fprintf(stream , "  'OP2' 'G2' 2 2 1* 'OIL' /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "GRUPTREE\n");
+  fprintf(stream , "  'G1' 'PLAT' /\n");
+  fprintf(stream , "  'G2' 'PLAT' /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "WCONHIST\n");
+  fprintf(stream , "  'OP1' 'OPEN' 'RESV' 100 10 1000 /\n");
+  fprintf(stream , "  'OP2' 'OPEN' 'RESV' 200 20 2000 /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "DATES\n  10 'JAN' 2000 /\n/\n\n");
+  fprintf(stream , "WCONHIST\n");
+  fprintf(stream , "  'OP1' 'OPEN' 'RESV' 150 15 1500 /\n");
+  fprintf(stream , "  'OP2' 'OPEN' 'RESV' 250 25 2500 /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "DATES\n  1 'FEB' 2000 /\n/\n\n");
+  fprintf(stream , "GRUPTREE\n");
+  fprintf(stream , "  'G2' 'FIELD' /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "WELSPECS\n");
+  fprintf(stream , "  'OP3' 'G2' 3 3 1* 'OIL' /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "WCONHIST\n");
+  fprintf(stream , "  'OP1' 'OPEN' 'RESV' 150 15 1500 /\n");
+  fprintf(stream , "  'OP2' 'OPEN' 'RESV' 250 25 2500 /\n");
+  fprintf(stream , "  'OP3' 'OPEN' 'RESV'  50  5  500 /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "DATES\n  1 'MAR' 2000 /\n/\n\n");
+  fprintf(stream , "WCONHIST\n");
+  fprintf(stream , "  'OP1' 'SHUT' 'RESV'   0  0    0 /\n");
+  fprintf(stream , "  'OP2' 'OPEN' 'RESV' 300 30 3000 /\n");
+  fprintf(stream , "  'OP3' 'OPEN' 'RESV'  75  8  750 /\n");
+  fprintf(stream , "/\n\n");
+  fprintf(stream , "DATES\n  1 'APR' 2000 /\n/\n\n");
+  fprintf(stream , "END\n");
+  fclose( stream );
+}
+
+
+static double iget( const sched_history_type * sched_history , const char * var , const char * name , int report_step) {
+  char * key = util_alloc_sprintf("%s:%s" , var , name);
+  double value = sched_history_iget( sched_history , key , report_step );
+  free( key );
+  return value;
+}
+
+
+static void test_rates( const sched_history_type * sched_history , const char * var , const char * well_var , int num_steps , int move_step) {
+  for (int step = 0; step < num_steps; step++) {
+    double OP1 = iget( sched_history , well_var , "OP1" , step );
+    double OP2 = iget( sched_history , well_var , "OP2" , step );
+    double OP3 = sched_history_has_key( sched_history , "WOPRH:OP3") ? iget( sched_history , well_var , "OP3" , step ) : 0;
+    double G1 = iget( sched_history , var , "G1" , step );
+    double G2 = iget( sched_history , var , "G2" , step );
+
+    test_assert_double_equal( G1 , OP1 );
+    test_assert_double_equal( G2 , OP2 + OP3 );
+    if (step < move_step)
+      test_assert_double_equal( iget( sched_history , var , "PLAT" , step ) , G1 + G2 );
+    else
+      test_assert_double_equal( iget( sched_history , var , "PLAT" , step ) , G1 );
+    test_assert_double_equal( iget( sched_history , var , "FIELD" , step ) , OP1 + OP2 + OP3 );
+  }
+}
+
+
+static void test_totals( const sched_history_type * sched_history , const char * total_var , const char * rate_var , const char * group , int num_steps) {
+  double total = 0;
+  test_assert_double_equal( iget( sched_history , total_var , group , 0 ) , 0 );
+  for (int step = 1; step < num_steps; step++) {
+    double days = (sched_history_iget_time_t( sched_history , step ) - sched_history_iget_time_t( sched_history , step - 1)) * 1.0 / 86400;
+    total += iget( sched_history , rate_var , group , step ) * days;
+    test_assert_double_equal( iget( sched_history , total_var , group , step ) , total );
+  }
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc( "sched_history_group" );
+  sched_file_type * sched_file;
+  sched_history_type * sched_history = sched_history_alloc( ":" );
+  int num_steps;
+
+  write_schedule( "SCHEDULE.INC" );
+  sched_file = sched_file_parse_alloc( "SCHEDULE.INC" , util_make_date_utc( 1 , 1 , 2000 ));
+  num_steps = sched_file_get_num_restart_files( sched_file );
+  test_assert_int_equal( num_steps , 5 );
+
+  sched_history_update( sched_history , sched_file );
+  test_assert_double_equal( sched_history_iget( sched_history , "FOPRH" , 1 ) , 300 );
+  test_assert_double_equal( sched_history_iget( sched_history , "GOPRH:PLAT" , 3 ) , 150 );
+
+  test_rates( sched_history , "GOPRH" , "WOPRH" , num_steps , 3 );
+  test_rates( sched_history , "GWPRH" , "WWPRH" , num_steps , 3 );
+  test_rates( sched_history , "GGPRH" , "WGPRH" , num_steps , 3 );
+
+  test_totals( sched_history , "GOPTH" , "GOPRH" , "FIELD" , num_steps );
+  test_totals( sched_history , "GWPTH" , "GWPRH" , "PLAT" , num_steps );
+  test_totals( sched_history , "GGPTH" , "GGPRH" , "G2" , num_steps );
+
+  /* The aggregated values must follow a new update. */
+  sched_history_update( sched_history , sched_file );
+  test_rates( sched_history , "GOPRH" , "WOPRH" , num_steps , 3 );
+  test_totals( sched_history , "GOPTH" , "GOPRH" , "FIELD" , num_steps );
+
+  sched_history_free( sched_history );
+  sched_file_free( sched_file );
+  test_work_area_free( work_area );
+  exit(0);
+}